@@ -29,6 +29,7 @@
 
 #include "JavaOpCodes.h"
 #include "GlobalCatalog.h"
+#include "Safepoint.h"
 
 #include "ObjectReference.h"
 
@@ -44,6 +45,28 @@ extern const JavaString c_InstanceInitialisationMethodName;
 const JavaString c_MethodTypeClassName = JavaString::FromCString( JVMX_T( "java/lang/invoke/MethodType" ) );
 const JavaString c_ThrowableClassName = JavaString::FromCString( JVMX_T( "java/lang/Throwable" ) );
 
+namespace
+{
+  // Per thread, direct mapped cache of the inline cache table for each method, so that a call site's cache can be found
+  // without going through the MethodInfo's atomic table pointer. The entry holds a reference to its method, so the
+  // address it is keyed on can't be reused by another method while the entry exists. The tables are kept alive by the
+  // engine. Only methods that have a table are ever cached.
+  struct InlineCacheTableCacheEntry
+  {
+    std::shared_ptr<MethodInfo> m_pMethodInfo;
+    InlineCacheTable *m_pInlineCaches;
+  };
+
+  const size_t c_InlineCacheTableCacheSize = 64;
+
+  thread_local InlineCacheTableCacheEntry t_InlineCacheTableCache[ c_InlineCacheTableCacheSize ];
+
+  size_t GetInlineCacheTableCacheSlot( const MethodInfo *pMethodInfo )
+  {
+    return ( reinterpret_cast<uintptr_t>( pMethodInfo ) >> 4 ) % c_InlineCacheTableCacheSize;
+  }
+}
+
 class StackLevelIncrementer
 {
 public:
@@ -79,27 +102,17 @@ void BasicExecutionEngine::Run( const std::shared_ptr<IVirtualMachineState> &pVi
   StackLevelIncrementer incrementer( pVirtualMachineState->GetStackLevel() );
   intptr_t savedProgramCounter = 0; // Save the program counter before the next instruction is executed, for exception handling.
 
-  std::shared_ptr<IGarbageCollector> pGarbageCollector = GlobalCatalog::GetInstance().Get( "GarbageCollector" );
   pVirtualMachineState->PushAndZeroCallStackDepth();
 
+  // Pause requests and garbage collection are only serviced at safepoints: here, on entry to each method called from
+  // this loop, and on backward branches.
+  PollSafepoint( pVirtualMachineState );
+
   while ( !m_Halted && pVirtualMachineState->GetProgramCounter() < pVirtualMachineState->GetCodeSegmentLength() )
   {
-    if ( pVirtualMachineState->IsPausing() )
-    {
-      pVirtualMachineState->ConfirmPaused();
-    }
-
-    if ( pVirtualMachineState->IsPaused() )
-    {
-      std::this_thread::yield();
-      continue;
-    }
-
-    TryDoGarbageCollection( pVirtualMachineState, pGarbageCollector );
-
     if ( !pVirtualMachineState->HasExceptionOccurred() )
     {
-      if ( e_ImmediateReturnRequired::Yes == ProcessNextOpcode( pVirtualMachineState, GetLogger() ) )
+      if ( e_ImmediateReturnRequired::Yes == DispatchNextInstruction( pVirtualMachineState ) )
       {
         return;
       }
@@ -120,7 +133,7 @@ void BasicExecutionEngine::Run( const std::shared_ptr<IVirtualMachineState> &pVi
         GetLogger()->LogDebug( "Exception cannot be handled in this function. Rewinding the stack, and executing a \"void\" return." );
 #endif // _DEBUG
 
-        RewindOperandStack( pVirtualMachineState, 0 );
+        RewindOperandStack( pVirtualMachineState );
         ExecuteOpCodeReturnVoid( pVirtualMachineState );
 
         if ( 0 == pVirtualMachineState->GetCallStackDepth() )
@@ -141,6 +154,36 @@ void BasicExecutionEngine::Run( const std::shared_ptr<IVirtualMachineState> &pVi
   }
 }
 
+e_ImmediateReturnRequired BasicExecutionEngine::DispatchNextInstruction( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  return ProcessNextOpcode( pVirtualMachineState, GetLogger() );
+}
+
+void BasicExecutionEngine::PollSafepoint( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  // The instructions that allocated them have finished, so anything still in use is reachable from the stack.
+  pVirtualMachineState->ReleaseRecentAllocations();
+
+  if ( Safepoint::IsRequested() )
+  {
+    ServiceSafepoint( pVirtualMachineState );
+  }
+}
+
+void BasicExecutionEngine::ServiceSafepoint( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  if ( Safepoint::TakeCollectionRequest() )
+  {
+    std::shared_ptr<IGarbageCollector> pGarbageCollector = GlobalCatalog::GetInstance().Get( "GarbageCollector" );
+    TryDoGarbageCollection( pVirtualMachineState, pGarbageCollector );
+  }
+
+  if ( pVirtualMachineState->IsPausing() )
+  {
+    Safepoint::Park( *pVirtualMachineState );
+  }
+}
+
 void BasicExecutionEngine::TryDoGarbageCollection( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const std::shared_ptr<IGarbageCollector> &pGarbageCollector )
 {
 #ifdef _DEBUG
@@ -469,6 +512,7 @@ e_ImmediateReturnRequired BasicExecutionEngine::ProcessNextOpcode( const std::sh
       if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeVirtual( pVirtualMachineState ) )
       {
         pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
       }
       break;
 
@@ -476,6 +520,7 @@ e_ImmediateReturnRequired BasicExecutionEngine::ProcessNextOpcode( const std::sh
       if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeSpecial( pVirtualMachineState ) )
       {
         pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
       }
       break;
 
@@ -483,6 +528,7 @@ e_ImmediateReturnRequired BasicExecutionEngine::ProcessNextOpcode( const std::sh
       if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeStatic( pVirtualMachineState ) )
       {
         pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
       }
       break;
 
@@ -490,6 +536,7 @@ e_ImmediateReturnRequired BasicExecutionEngine::ProcessNextOpcode( const std::sh
       if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeInterfaceMethod( pVirtualMachineState ) )
       {
         pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
       }
       break;
 
@@ -743,6 +790,54 @@ e_ImmediateReturnRequired BasicExecutionEngine::ProcessNextOpcode( const std::sh
       ExecuteOpCodeBranchIfNull( pVirtualMachineState );
       break;
 
+    case e_JavaOpCodes::GetStaticQuick:
+      ExecuteOpCodeGetStaticQuick( pVirtualMachineState );
+      break;
+
+    case e_JavaOpCodes::PutStaticQuick:
+      ExecuteOpCodePutStaticQuick( pVirtualMachineState );
+      break;
+
+    case e_JavaOpCodes::GetFieldQuick:
+      ExecuteOpCodeGetFieldQuick( pVirtualMachineState );
+      break;
+
+    case e_JavaOpCodes::PutFieldQuick:
+      ExecuteOpCodePutFieldQuick( pVirtualMachineState );
+      break;
+
+    case e_JavaOpCodes::InvokeVirtualQuick:
+      if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeVirtualQuick( pVirtualMachineState ) )
+      {
+        pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
+      }
+      break;
+
+    case e_JavaOpCodes::InvokeSpecialQuick:
+      if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeSpecialQuick( pVirtualMachineState ) )
+      {
+        pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
+      }
+      break;
+
+    case e_JavaOpCodes::InvokeStaticQuick:
+      if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeStaticQuick( pVirtualMachineState ) )
+      {
+        pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
+      }
+      break;
+
+    case e_JavaOpCodes::InvokeInterfaceQuick:
+      if ( e_IncreaseCallStackDepth::Yes == ExecuteOpCodeInvokeInterfaceMethodQuick( pVirtualMachineState ) )
+      {
+        pVirtualMachineState->IncrementCallStackDepth();
+        PollSafepoint( pVirtualMachineState );
+      }
+      break;
+
     case e_JavaOpCodes::ConvertIntegerToByte:
       ExecuteOpCodeConvertIntegerToByte( pVirtualMachineState );
       break;
@@ -1062,50 +1157,47 @@ uint16_t BasicExecutionEngine::GetNextInstruction( const std::shared_ptr<IVirtua
 
 void BasicExecutionEngine::ExecuteOpCodeGetStatic( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
   // The runtime constant pool item at that index must be a symbolic reference to a field
-  std::shared_ptr<ConstantPoolEntry> fieldEntry = pVirtualMachineState->GetConstantFromCurrentClass( ReadIndex( pVirtualMachineState ) );
-  if ( e_ConstantPoolEntryTypeFieldReference != fieldEntry->GetType() )
+  ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, index );
+  if ( nullptr == pResolved )
   {
-    GetLogger()->LogError( __FUNCTION__ " - Could not resolve field reference for opcode: getstatic" );
-    ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
+    // We would have already thrown a Java Exception
     return;
   }
 
-  const ConstantPoolFieldReference *pFieldRef = dynamic_cast<const ConstantPoolFieldReference *>( fieldEntry->GetValue() );
-  if ( nullptr == pFieldRef )
+  ResolvedConstantPool &resolvedConstantPool = GetCurrentResolvedConstantPool( pVirtualMachineState );
+  if ( !resolvedConstantPool.IsClassInitialised( index ) )
   {
-    throw TypeMismatchException( __FUNCTION__ " - Could not convert constant pool entry to field reference." );
-  }
-
-  JavaString targetClassClassName = *pFieldRef->GetClassName();
-
-  // On successful resolution of the field, the class or interface that declared the resolved field is initialized if that class or
-  // interface has not already been initialized.
-  if ( !pVirtualMachineState->IsClassInitialised( targetClassClassName ) )
-  {
-    pVirtualMachineState->InitialiseClass( targetClassClassName );
-  }
-
-  JavaString referencedClassName = *pFieldRef->GetType();
-  if ( TypeParser::IsReferenceTypeDescriptor( referencedClassName ) && !TypeParser::IsArrayTypeDescriptor( referencedClassName ) )
-  {
-    referencedClassName = TypeParser::ExtractClassNameFromReference( referencedClassName );
     // On successful resolution of the field, the class or interface that declared the resolved field is initialized if that class or
     // interface has not already been initialized.
+    if ( !pResolved->m_pClass->IsInitialsed() )
+    {
+      pVirtualMachineState->InitialiseClass( *pResolved->m_pClass->GetName() );
+    }
 
-    if ( !pVirtualMachineState->IsClassInitialised( referencedClassName ) )
+    JavaString referencedClassName = *pResolved->m_pFieldReference->GetType();
+    if ( TypeParser::IsReferenceTypeDescriptor( referencedClassName ) && !TypeParser::IsArrayTypeDescriptor( referencedClassName ) )
     {
-      pVirtualMachineState->InitialiseClass( referencedClassName );
+      referencedClassName = TypeParser::ExtractClassNameFromReference( referencedClassName );
+
+      if ( !pVirtualMachineState->IsClassInitialised( referencedClassName ) )
+      {
+        pVirtualMachineState->InitialiseClass( referencedClassName );
+      }
+    }
+
+    // Only skip the check next time if initialisation actually started, rather than failing with an exception.
+    if ( pResolved->m_pClass->IsInitialsed() )
+    {
+      resolvedConstantPool.SetClassInitialised( index );
     }
   }
 
   // The value of the class or interface field is fetched and pushed onto the operand stack.
-  std::shared_ptr<FieldInfo> pField = ResolveField( pVirtualMachineState, targetClassClassName, *pFieldRef->GetName() );
-  if ( nullptr == pField )
-  {
-    // We would have already thrown a Java Exception
-    return;
-  }
+  const std::shared_ptr<FieldInfo> &pField = pResolved->m_pField;
 
   //   const CodeAttributeList &attributes = pField->GetAttributes( );
   //   const std::shared_ptr<JavaCodeAttribute> pValue = attributes.at( pField->GetConstantValueIndex( ) );
@@ -1114,6 +1206,12 @@ void BasicExecutionEngine::ExecuteOpCodeGetStatic( const std::shared_ptr<IVirtua
   if ( !pField->IsStatic() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
+    return;
+  }
+
+  if ( resolvedConstantPool.IsClassInitialised( index ) )
+  {
+    QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::GetStaticQuick );
   }
 
   //GetLogger()->LogDebug( "Getting Value of field: %s::%s", className.ToByteArray(), *pFieldRef->GetName( )->ToByteArray( ) );
@@ -1121,6 +1219,17 @@ void BasicExecutionEngine::ExecuteOpCodeGetStatic( const std::shared_ptr<IVirtua
   pVirtualMachineState->PushOperand( pField->GetStaticValue() );
 }
 
+void BasicExecutionEngine::ExecuteOpCodeGetStaticQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not find field." );
+  }
+
+  pVirtualMachineState->PushOperand( pResolved->m_pField->GetStaticValue() );
+}
+
 ConstantPoolIndex BasicExecutionEngine::ReadIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   if ( !pVirtualMachineState->CanReadBytes( sizeof( ConstantPoolIndex ) ) )
@@ -1163,16 +1272,35 @@ void BasicExecutionEngine::ThrowJavaException( IVirtualMachineState *pVirtualMac
   ThrowJavaExceptionInternal( pVirtualMachineState, pExceptionObject );
 }
 
-std::shared_ptr<FieldInfo> BasicExecutionEngine::ResolveField( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const JavaString &className, const JavaString &fieldName )
+ResolvedConstantPool &BasicExecutionEngine::GetCurrentResolvedConstantPool( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  return pVirtualMachineState->GetCurrentMethodInfo()->GetClass()->GetResolvedConstantPool();
+}
+
+const ResolvedConstantPoolEntry *BasicExecutionEngine::ResolveFieldReference( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, ConstantPoolIndex index )
 {
-  auto it = m_ResolvedFields.find( std::make_pair( className, fieldName ) );
-  if ( it != m_ResolvedFields.end() )
+  ResolvedConstantPool &resolvedConstantPool = GetCurrentResolvedConstantPool( pVirtualMachineState );
+
+  const ResolvedConstantPoolEntry *pResolved = resolvedConstantPool.Find( index );
+  if ( nullptr != pResolved )
   {
-    return it->second;
+    return pResolved;
   }
 
-  std::shared_ptr<JavaClass> pClass = ResolveClass( pVirtualMachineState, className );
-  if ( nullptr == pClass )
+  std::shared_ptr<ConstantPoolEntry> pFieldEntry = pVirtualMachineState->GetConstantFromCurrentClass( index );
+  if ( e_ConstantPoolEntryTypeFieldReference != pFieldEntry->GetType() )
+  {
+    GetLogger()->LogError( __FUNCTION__ " - Could not resolve field reference: %hu", index );
+    ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
+    return nullptr;
+  }
+
+  ResolvedConstantPoolEntry entry;
+  entry.m_pFieldReference = pFieldEntry->AsFieldReferencePointer();
+
+  const JavaString &className = *entry.m_pFieldReference->GetClassName();
+  entry.m_pClass = ResolveClass( pVirtualMachineState, className );
+  if ( nullptr == entry.m_pClass )
   {
     GetLogger()->LogError( __FUNCTION__ " - Could not resolve Class %s.", className.ToUtf8String().c_str() );
 
@@ -1180,36 +1308,37 @@ std::shared_ptr<FieldInfo> BasicExecutionEngine::ResolveField( const std::shared
     return nullptr;
   }
 
-  std::shared_ptr<FieldInfo> pResult = pClass->GetFieldByName( fieldName );
-  if ( nullptr == pResult )
+  // Find the class that declares the field, so that its offset within the object can be worked out once here.
+  const JavaString &fieldName = *entry.m_pFieldReference->GetName();
+  std::shared_ptr<JavaClass> pDeclaringClass = entry.m_pClass;
+  while ( nullptr != pDeclaringClass )
   {
-    std::shared_ptr<JavaClass> pSuperClass = pClass->GetSuperClass();
-    while ( nullptr != pSuperClass )
+    entry.m_pField = pDeclaringClass->GetFieldByName( fieldName );
+    if ( nullptr != entry.m_pField )
     {
-      if ( nullptr == pSuperClass )
-      {
-        GetLogger()->LogError( __FUNCTION__ " - Could not resolve Super Class %s.", pClass->GetSuperClass()->GetName()->ToUtf8String().c_str() );
-
-        // We would have already thrown a JavaException.
-        return nullptr;
-      }
+      break;
+    }
 
-      pResult = pSuperClass->GetFieldByName( fieldName );
-      if ( nullptr != pResult )
-      {
-        break;
-      }
+    pDeclaringClass = pDeclaringClass->GetSuperClass();
+  }
 
-      pSuperClass = pSuperClass->GetSuperClass();
-    }
+  if ( nullptr == entry.m_pField )
+  {
+    return nullptr;
   }
 
-  if ( nullptr != pResult )
+  if ( !entry.m_pField->IsStatic() )
   {
-    m_ResolvedFields.insert( std::make_pair( std::make_pair( className, fieldName ), pResult ) );
+    std::shared_ptr<JavaClass> pSuperClass = pDeclaringClass->GetSuperClass();
+    if ( nullptr != pSuperClass )
+    {
+      entry.m_FieldOffset = pSuperClass->CalculateInstanceSizeInBytes();
+    }
+
+    entry.m_FieldOffset += entry.m_pField->GetOffset();
   }
 
-  return pResult;
+  return resolvedConstantPool.Store( index, entry );
 }
 
 std::shared_ptr<JavaClass> BasicExecutionEngine::ResolveClass( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const JavaString &className )
@@ -1245,7 +1374,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadReferenceFromLocalWithSpecifiedIndex
   ExecuteOpCodeLoadReferenceFromLocalIndex( pVirtualMachineState, ReadByteUnsigned( pVirtualMachineState ) );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeLoadReferenceFromLocalIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t index )
+void BasicExecutionEngine::ExecuteOpCodeLoadReferenceFromLocalIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t index )
 {
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
     if (pVirtualMachineState->HasUserCodeStarted())
@@ -1267,7 +1396,7 @@ void BasicExecutionEngine::ExecuteOpCodeReturnVoid( const std::shared_ptr<IVirtu
 
   if ( pVirtualMachineState->GetCurrentMethodInfo()->IsSynchronised() )
   {
-    pVirtualMachineState->PopMonitor()->Unlock( pVirtualMachineState->GetCurrentMethodInfo()->GetFullName().ToUtf8String().c_str() );
+    pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
   }
 
   pVirtualMachineState->PopState();
@@ -1290,8 +1419,17 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStatic( const
     }
 #endif // _DEBUG
 
-  boost::intrusive_ptr<JavaString> pClassName = new JavaString( JavaString::EmptyString() );
-  std::shared_ptr<MethodInfo> pMethodInfo = ResolveMethodReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ), *pClassName );
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
+  ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, index );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not resolve method." );
+  }
+
+  const std::shared_ptr<MethodInfo> &pMethodInfo = pResolved->m_pMethod;
+  boost::intrusive_ptr<JavaString> pClassName = pResolved->m_pMethodReference->GetClassName();
   if ( !pMethodInfo->IsStatic() || pMethodInfo->IsAbstract() )
   {
     pVirtualMachineState->LogLocalVariables();
@@ -1306,11 +1444,41 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStatic( const
 
   // On successful resolution of the field, the class or interface that declared the resolved field is initialized if that class or
   // interface has not already been initialized.
-  if ( !pVirtualMachineState->IsClassInitialised( *pClassName ) )
+  ResolvedConstantPool &resolvedConstantPool = GetCurrentResolvedConstantPool( pVirtualMachineState );
+  if ( !resolvedConstantPool.IsClassInitialised( index ) )
+  {
+    if ( !pVirtualMachineState->IsClassInitialised( *pClassName ) )
+    {
+      pVirtualMachineState->InitialiseClass( *pClassName );
+    }
+
+    if ( pVirtualMachineState->IsClassInitialised( *pClassName ) )
+    {
+      resolvedConstantPool.SetClassInitialised( index );
+    }
+  }
+
+  if ( resolvedConstantPool.IsClassInitialised( index ) )
   {
-    pVirtualMachineState->InitialiseClass( *pClassName );
+    QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::InvokeStaticQuick );
   }
 
+  return InvokeStaticMethod( pVirtualMachineState, pMethodInfo, pClassName );
+}
+
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStaticQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not resolve method." );
+  }
+
+  return InvokeStaticMethod( pVirtualMachineState, pResolved->m_pMethod, pResolved->m_pMethodReference->GetClassName() );
+}
+
+e_IncreaseCallStackDepth BasicExecutionEngine::InvokeStaticMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const std::shared_ptr<MethodInfo> &pMethodInfo, boost::intrusive_ptr<JavaString> pClassName )
+{
 #if defined(_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
   {
@@ -1329,7 +1497,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStatic( const
       }
 #endif // _DEBUG
 
-    pVirtualMachineState->PushMonitor( pMethodInfo->GetClass()->MonitorEnter( pMethodInfo->GetFullName().ToUtf8String().c_str() ) );
+    pVirtualMachineState->PushMonitor( pMethodInfo->GetClass()->MonitorEnter( __FUNCTION__ ) );
   }
 
   if ( pMethodInfo->IsNative() )
@@ -1360,7 +1528,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStatic( const
     if ( pMethodInfo->IsSynchronised() )
     {
       pVirtualMachineState->PopMonitor();
-      pMethodInfo->GetClass()->MonitorExit( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+      pMethodInfo->GetClass()->MonitorExit( __FUNCTION__ );
     }
 
     return e_IncreaseCallStackDepth::No;
@@ -1369,7 +1537,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStatic( const
   {
     // values are consecutively made the values of local variables of the new frame, with arg1 in local variable 0 (or, if arg1 is of type long or double, in local variables 0 and 1) and so on
     //pVirtualMachineState->PushState( *pClassName, *(pMethodInfo->GetName()), *(pMethodInfo->GetType()) );
-    pVirtualMachineState->PushState( *( pMethodInfo->GetClass()->GetName() ), *( pMethodInfo->GetName() ), *( pMethodInfo->GetType() ), pMethodInfo );
+    pVirtualMachineState->PushState( pMethodInfo );
     pVirtualMachineState->SetCodeSegment( pMethodInfo->GetCodeInfo() );
     pVirtualMachineState->SetupLocalVariables( pMethodInfo );
   }
@@ -1377,30 +1545,137 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeStatic( const
   return e_IncreaseCallStackDepth::Yes;
 }
 
-std::shared_ptr<MethodInfo> BasicExecutionEngine::ResolveMethodReference( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t methodIndex, JavaString &className )
+const ResolvedConstantPoolEntry *BasicExecutionEngine::ResolveMethodReference( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, ConstantPoolIndex index )
 {
-  // The runtime constant pool item at that index must be a symbolic reference to a field
-  std::shared_ptr<ConstantPoolEntry> methodEntry = pVirtualMachineState->GetConstantFromCurrentClass( methodIndex );
-  if ( e_ConstantPoolEntryTypeMethodReference != methodEntry->GetType() )
+  ResolvedConstantPool &resolvedConstantPool = GetCurrentResolvedConstantPool( pVirtualMachineState );
+
+  const ResolvedConstantPoolEntry *pResolved = resolvedConstantPool.Find( index );
+  if ( nullptr != pResolved )
   {
-    GetLogger()->LogError( __FUNCTION__ " - Could not resolve method reference: %hu", methodIndex );
+    return pResolved;
+  }
+
+  // The runtime constant pool item at that index must be a symbolic reference to a method
+  std::shared_ptr<ConstantPoolEntry> pMethodEntry = pVirtualMachineState->GetConstantFromCurrentClass( index );
+  if ( e_ConstantPoolEntryTypeMethodReference != pMethodEntry->GetType() && e_ConstantPoolEntryTypeInterfaceMethodReference != pMethodEntry->GetType() )
+  {
+    GetLogger()->LogError( __FUNCTION__ " - Could not resolve method reference: %hu", index );
     ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
     return nullptr;
   }
 
-  const ConstantPoolMethodReference *pMethodRef = dynamic_cast<const ConstantPoolMethodReference *>( methodEntry->GetValue() );
-  if ( nullptr == pMethodRef )
+  ResolvedConstantPoolEntry entry;
+  entry.m_pMethodReference = pMethodEntry->AsMethodReference();
+  entry.m_pMethod = pVirtualMachineState->ResolveMethodOnClass( entry.m_pMethodReference->GetClassName(), entry.m_pMethodReference.get() );
+  if ( nullptr == entry.m_pMethod )
+  {
+    return nullptr;
+  }
+
+  entry.m_pClass = GetClassLibrary()->FindClass( *entry.m_pMethodReference->GetClassName() );
+  entry.m_ArgumentCount = TypeParser::ParseMethodType( *entry.m_pMethodReference->GetType() ).parameters.size();
+
+  return resolvedConstantPool.Store( index, entry );
+}
+
+void BasicExecutionEngine::QuickenInstruction( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uintptr_t programCounter, e_JavaOpCodes quickOpCode )
+{
+  // Only code that belongs to a method is ever rewritten.
+  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
+  if ( nullptr == pMethodInfo || nullptr == pMethodInfo->GetCodeInfo() || pMethodInfo->GetCodeInfo()->GetCode().ToByteArray() != pVirtualMachineState->GetCodeSegmentStart() )
+  {
+    return;
+  }
+
+  pMethodInfo->GetCodeInfo()->QuickenOpCode( programCounter, static_cast<uint8_t>( quickOpCode ) );
+}
+
+InlineCache *BasicExecutionEngine::GetInlineCache( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uintptr_t programCounter )
+{
+  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
+  if ( nullptr == pMethodInfo )
+  {
+    return nullptr;
+  }
+
+  InlineCacheTableCacheEntry &entry = t_InlineCacheTableCache[ GetInlineCacheTableCacheSlot( pMethodInfo.get() ) ];
+  if ( entry.m_pMethodInfo != pMethodInfo )
+  {
+    InlineCacheTable *pInlineCaches = GetInlineCacheTable( pVirtualMachineState, pMethodInfo );
+    if ( nullptr == pInlineCaches )
+    {
+      // Not cached, so that the lookup is tried again once the method is running its own code.
+      return nullptr;
+    }
+
+    entry.m_pMethodInfo = std::move( pMethodInfo );
+    entry.m_pInlineCaches = pInlineCaches;
+  }
+
+  return entry.m_pInlineCaches->GetInlineCache( programCounter );
+}
+
+InlineCacheTable *BasicExecutionEngine::GetInlineCacheTable( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const std::shared_ptr<MethodInfo> &pMethodInfo )
+{
+  if ( nullptr == pMethodInfo || nullptr == pMethodInfo->GetCodeInfo() || pMethodInfo->GetCodeInfo()->GetCode().ToByteArray() != pVirtualMachineState->GetCodeSegmentStart() )
+  {
+    return nullptr;
+  }
+
+  std::shared_ptr<InlineCacheTable> pResult = pMethodInfo->GetInlineCaches();
+  if ( nullptr == pResult )
+  {
+    std::shared_ptr<InlineCacheTable> pNewTable = std::make_shared<InlineCacheTable>( pMethodInfo->GetCodeInfo()->GetCode() );
+    if ( pMethodInfo->SetInlineCaches( pNewTable ) )
+    {
+      std::lock_guard<std::mutex> lock( m_InlineCacheTablesMutex );
+      m_InlineCacheTables.push_back( pNewTable );
+    }
+
+    pResult = pMethodInfo->GetInlineCaches();
+  }
+
+  return pResult.get();
+}
+
+std::shared_ptr<MethodInfo> BasicExecutionEngine::FindSelectedMethod( InlineCache *pInlineCache, const JavaClass *pReceiverClass )
+{
+  if ( nullptr == pInlineCache || pInlineCache->IsMegamorphic() )
+  {
+    return nullptr;
+  }
+
+  return pInlineCache->Lookup( pReceiverClass );
+}
+
+void BasicExecutionEngine::AddSelectedMethod( InlineCache *pInlineCache, const JavaClass *pReceiverClass, const std::shared_ptr<MethodInfo> &pSelectedMethod )
+{
+  if ( nullptr == pInlineCache || pInlineCache->IsMegamorphic() )
   {
-    throw TypeMismatchException( __FUNCTION__ " - Could not convert constant pool entry to field reference." );
+    return;
   }
 
-  // The referenced field is resolved
-  boost::intrusive_ptr<JavaString> pClassName = pMethodRef->GetClassName();
-  className = *pClassName;
+  pInlineCache->Add( pReceiverClass, pSelectedMethod );
+}
+
+void BasicExecutionEngine::LogStatistics( const std::shared_ptr<ILogger> &pLogger )
+{
+  static const char *c_StateNames[] = { "empty", "monomorphic", "polymorphic", "megamorphic" };
 
-  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->ResolveMethodOnClass( pClassName, pMethodRef );
+  InlineCacheStatistics statistics;
+  {
+    std::lock_guard<std::mutex> lock( m_InlineCacheTablesMutex );
+    for ( const auto &pTable : m_InlineCacheTables )
+    {
+      pTable->AddStatistics( statistics );
+    }
+  }
 
-  return pMethodInfo;
+  pLogger->LogInformation( "Inline cache statistics:" );
+  for ( size_t state = 0; state < 4; ++ state )
+  {
+    pLogger->LogInformation( "  %s call sites: %Iu, hits: %llu, misses: %llu.", c_StateNames[ state ], statistics.m_CallSiteCount[ state ], statistics.m_Hits[ state ], statistics.m_Misses[ state ] );
+  }
 }
 
 void BasicExecutionEngine::ExecuteOpCodeMonitorEnter( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -1422,7 +1697,7 @@ void BasicExecutionEngine::ExecuteOpCodeMonitorEnter( const std::shared_ptr<IVir
     }
 #endif // _DEBUG
 
-    pReference->GetContainedObject()->MonitorEnter( pVirtualMachineState->GetCurrentMethodInfo()->GetFullName().ToUtf8String().c_str() );
+    pReference->GetContainedObject()->MonitorEnter( __FUNCTION__ );
   }
   else if ( e_JavaVariableTypes::Array == pOperand->GetVariableType() )
   {
@@ -1432,7 +1707,7 @@ void BasicExecutionEngine::ExecuteOpCodeMonitorEnter( const std::shared_ptr<IVir
       throw InvalidStateException( __FUNCTION__ " - Expected array on operand stack." );
     }
 
-    pReference->GetContainedArray()->MonitorEnter( pVirtualMachineState->GetCurrentClassAndMethodName().ToUtf8String().c_str() );
+    pReference->GetContainedArray()->MonitorEnter( __FUNCTION__ );
   }
   else if ( e_JavaVariableTypes::ClassReference == pOperand->GetVariableType() )
   {
@@ -1442,7 +1717,7 @@ void BasicExecutionEngine::ExecuteOpCodeMonitorEnter( const std::shared_ptr<IVir
       throw InvalidStateException( __FUNCTION__ " - Expected class on operand stack." );
     }
 
-    pReference->GetClassFile()->MonitorEnter( pVirtualMachineState->GetCurrentClassAndMethodName().ToUtf8String().c_str() );
+    pReference->GetClassFile()->MonitorEnter( __FUNCTION__ );
   }
   else
   {
@@ -1480,8 +1755,8 @@ void BasicExecutionEngine::ExecuteOpCodeNewMultiDimentionalArray( const std::sha
   std::vector<int32_t> dimentionSizes;
   for ( uint8_t i = 0; i < dimentionCount; ++i )
   {
-    JVMX_ASSERT( e_JavaVariableTypes::Integer == pVirtualMachineState->PeekOperand()->GetVariableType() );
-    dimentionSizes.push_back( boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() )->ToHostInt32() );
+    JVMX_ASSERT( e_JavaVariableTypes::Integer == pVirtualMachineState->PeekOperandType() );
+    dimentionSizes.push_back( pVirtualMachineState->PopInteger() );
   }
 
   std::shared_ptr<ConstantPoolEntry> pConstantPoolEntry = pVirtualMachineState->GetConstantFromCurrentClass( index );
@@ -1498,6 +1773,10 @@ void BasicExecutionEngine::ExecuteOpCodeNewMultiDimentionalArray( const std::sha
 
   boost::intrusive_ptr<ObjectReference> pFirstDimention = pVirtualMachineState->CreateArray( e_JavaArrayTypes::Reference, dimentionSizes[ 0 ] );
 
+  // The outer array goes on the operand stack before the inner ones are allocated, as any of those allocations may
+  // collect, and pFirstDimention is not a root. Each inner array is stored in its parent before the next is allocated.
+  pVirtualMachineState->PushOperand( pFirstDimention );
+
   int32_t currentDimention = 0;
   InitialiseDimention( dimentionSizes, pVirtualMachineState, pFirstDimention, dimentionCount, currentDimention, finalDimentionType );
 
@@ -1507,8 +1786,6 @@ void BasicExecutionEngine::ExecuteOpCodeNewMultiDimentionalArray( const std::sha
       GetLogger()->LogDebug("New Multi Array: %s", pFirstDimention->ToString().ToUtf8String().c_str());
   }
 #endif
-
-  pVirtualMachineState->PushOperand( pFirstDimention );
 }
 
 void BasicExecutionEngine::InitialiseDimention( const std::vector<int32_t> &dimentionSizes, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, boost::intrusive_ptr<ObjectReference> pFirstDimention, uint8_t dimentionCount, int32_t currentDimention, e_JavaArrayTypes finalDimentionType )
@@ -1542,14 +1819,14 @@ void BasicExecutionEngine::InitialiseDimention( const std::vector<int32_t> &dime
 
 void BasicExecutionEngine::ExecuteOpCodeLoadDoubleFromArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t index = pVirtualMachineState->PopInteger();
 
-  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected Array on the operand stack." );
   }
@@ -1566,20 +1843,18 @@ void BasicExecutionEngine::ExecuteOpCodeLoadDoubleFromArray( const std::shared_p
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || pIndex->ToHostInt32() > static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
+  if ( index < 0 || index >= static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
     return;
   }
 
-  JavaDouble *pTempDouble = dynamic_cast<JavaDouble *>( pArray->GetContainedArray()->At( pIndex->ToHostInt32() ) );
-  if ( nullptr == pTempDouble )
+  if ( e_JavaArrayTypes::Double != pArray->GetContainedArray()->GetContainedType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected double in array." );
   }
 
-  boost::intrusive_ptr<JavaDouble> pDouble = new JavaDouble( JavaDouble::FromHostDouble( pTempDouble->ToHostDouble() ) );
-  pVirtualMachineState->PushOperand( pDouble );
+  pVirtualMachineState->PushDouble( pArray->GetContainedArray()->GetElementAt<double>( index ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeORLong( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -1594,7 +1869,7 @@ void BasicExecutionEngine::ExecuteOpCodeORLong( const std::shared_ptr<IVirtualMa
   int64_t long2 = GetLongFromOperandStack( pVirtualMachineState );
   int64_t long1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( long1 | long2 ) ) );
+  pVirtualMachineState->PushLong( long1 | long2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -1634,12 +1909,12 @@ void BasicExecutionEngine::ExecuteOpCodeLookupSwitch( const std::shared_ptr<IVir
     jumpTable.push_back( std::make_pair( match, offset ) );
   }
 
-  boost::intrusive_ptr< JavaInteger > pKey = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t key = pVirtualMachineState->PopInteger();
 
   intptr_t targetAddress = 0;
   for ( int i = 0; i < npairs; ++ i )
   {
-    if ( jumpTable[i].first == pKey->ToHostInt32() )
+    if ( jumpTable[i].first == key )
     {
       targetAddress = startingAddress + jumpTable[ i ].second;
       break;
@@ -1687,9 +1962,10 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntoDoubleArray( const std::shared_
     ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
   }
 
-  if ( pIndex->ToHostInt32() < 0 || static_cast<size_t>( pIndex->ToHostInt32() ) > pArray->GetContainedArray()->GetNumberOfElements() )
+  if ( pIndex->ToHostInt32() < 0 || static_cast<size_t>( pIndex->ToHostInt32() ) >= pArray->GetContainedArray()->GetNumberOfElements() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
+    return;
   }
 
   pArray->GetContainedArray()->SetAt( *pIndex, pValue.get() );
@@ -1740,14 +2016,9 @@ void BasicExecutionEngine::ExecuteOpCodeDuplicateTopOperandOrTwox1( const std::s
 
 void BasicExecutionEngine::ExecuteOpCodeConvertIntegerToShort( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaInteger > pInteger1 = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pInteger1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be integer type." );
-  }
+  int32_t integer1 = pVirtualMachineState->PopInteger();
 
-  boost::intrusive_ptr<JavaShort> pFinalShort = new JavaShort( JavaShort::FromHostInt16( static_cast<uint16_t>( pInteger1->ToHostInt32() ) ) );
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromShort( *pFinalShort ) ) );
+  pVirtualMachineState->PushInteger( static_cast<int16_t>( integer1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeFloatAdd( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -1758,23 +2029,10 @@ void BasicExecutionEngine::ExecuteOpCodeFloatAdd( const std::shared_ptr<IVirtual
         pVirtualMachineState->LogOperandStack();
     }
 #endif // _DEBUG
-  boost::intrusive_ptr<IJavaVariableType> pOperand2 = pVirtualMachineState->PopOperand();
-  boost::intrusive_ptr<IJavaVariableType> pOperand1 = pVirtualMachineState->PopOperand();
+  float value2 = pVirtualMachineState->PopFloat();
+  float value1 = pVirtualMachineState->PopFloat();
 
-  if ( e_JavaVariableTypes::Float != pOperand2->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected a float on the operand stack." );
-  }
-
-  if ( e_JavaVariableTypes::Float != pOperand1->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected a float on the operand stack." );
-  }
-
-  float value2 = boost::dynamic_pointer_cast<JavaFloat>( pOperand2 )->ToHostFloat();
-  float value1 = boost::dynamic_pointer_cast<JavaFloat>( pOperand1 )->ToHostFloat();
-
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostFloat( value1 + value2 ) ) );
+  pVirtualMachineState->PushFloat( value1 + value2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -1786,20 +2044,20 @@ void BasicExecutionEngine::ExecuteOpCodeFloatAdd( const std::shared_ptr<IVirtual
 
 void BasicExecutionEngine::ExecuteOpCodePushDouble( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, double value )
 {
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( value ) ) );
+  pVirtualMachineState->PushDouble( value );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeFloatSubtract( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  float float2 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() )->ToHostFloat();
-  float float1 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() )->ToHostFloat();
+  float float2 = pVirtualMachineState->PopFloat();
+  float float1 = pVirtualMachineState->PopFloat();
 
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostFloat( float1 - float2 ) ) );
+  pVirtualMachineState->PushFloat( float1 - float2 );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeStoreFloatInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeStoreFloatInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  if ( e_JavaVariableTypes::Float != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Float != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected float on the operand stack." );
   }
@@ -1811,7 +2069,7 @@ void BasicExecutionEngine::ExecuteOpCodeStoreFloatInLocal( const std::shared_ptr
   }
 #endif // _DEBUG
 
-  pVirtualMachineState->SetLocalVariable( localVariableIndex, pVirtualMachineState->PopOperand() );
+  pVirtualMachineState->StoreOperandInLocalVariable( localVariableIndex );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeStoreFloatInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -1829,32 +2087,51 @@ void BasicExecutionEngine::ExecuteOpCodePutStatic( const std::shared_ptr<IVirtua
     }
 #endif // _DEBUG
 
-  // The runtime constant pool item at that index must be a symbolic reference to a field
-  std::shared_ptr<ConstantPoolFieldReference> pFieldEntry = pVirtualMachineState->GetConstantFromCurrentClass( ReadIndex( pVirtualMachineState ) )->AsFieldReferencePointer();
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
 
-  //std::shared_ptr<FieldInfo> pFieldInfo = ResolveField( pVirtualMachineState->GetCurrentClassName(), *pFieldEntry->GetName() );
-  std::shared_ptr<FieldInfo> pFieldInfo = ResolveField( pVirtualMachineState, *pFieldEntry->GetClassName(), *pFieldEntry->GetName() );
-  if ( nullptr == pFieldInfo )
+  // The runtime constant pool item at that index must be a symbolic reference to a field
+  ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, index );
+  if ( nullptr == pResolved )
   {
-    GetLogger()->LogError( __FUNCTION__ " - Could not resolve field reference for opcode: getstatic" );
+    GetLogger()->LogError( __FUNCTION__ " - Could not resolve field reference for opcode: putstatic" );
     ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
     return;
   }
 
-  if ( !pVirtualMachineState->IsClassInitialised( *pFieldEntry->GetClassName() ) )
+  const std::shared_ptr<ConstantPoolFieldReference> &pFieldEntry = pResolved->m_pFieldReference;
+  const std::shared_ptr<FieldInfo> &pFieldInfo = pResolved->m_pField;
+
+  ResolvedConstantPool &resolvedConstantPool = GetCurrentResolvedConstantPool( pVirtualMachineState );
+  if ( !resolvedConstantPool.IsClassInitialised( index ) )
   {
-    pVirtualMachineState->InitialiseClass( *pFieldEntry->GetClassName() );
+    if ( !pResolved->m_pClass->IsInitialsed() )
+    {
+      pVirtualMachineState->InitialiseClass( *pResolved->m_pClass->GetName() );
+    }
+
+    if ( pResolved->m_pClass->IsInitialsed() )
+    {
+      resolvedConstantPool.SetClassInitialised( index );
+    }
   }
 
   if ( !pFieldInfo->IsStatic() )
   {
     GetLogger()->LogError( __FUNCTION__ " - Throwing Java Exception because field is not static." );
     ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
+    return;
   }
 
   if ( pFieldInfo->IsFinal() && !( pVirtualMachineState->GetCurrentMethodName() == c_ClassInitialisationMethodName ) )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaIllegalAccessErrorException );
+    return;
+  }
+
+  if ( resolvedConstantPool.IsClassInitialised( index ) )
+  {
+    QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::PutStaticQuick );
   }
 
   boost::intrusive_ptr<IJavaVariableType> pOperand = pVirtualMachineState->PopOperand();
@@ -1868,6 +2145,23 @@ void BasicExecutionEngine::ExecuteOpCodePutStatic( const std::shared_ptr<IVirtua
   pFieldInfo->SetStaticValue( pOperand );
 }
 
+void BasicExecutionEngine::ExecuteOpCodePutStaticQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not find field." );
+  }
+
+  boost::intrusive_ptr<IJavaVariableType> pOperand = pVirtualMachineState->PopOperand();
+
+#ifdef _DEBUG
+  ValidateStaticFieldType( pResolved->m_pFieldReference, pResolved->m_pField, pOperand );
+#endif // _DEBUG
+
+  pResolved->m_pField->SetStaticValue( pOperand );
+}
+
 const char *BasicExecutionEngine::TranslateOpCode( uint16_t opcode )
 {
   switch ( (e_JavaOpCodes)opcode )
@@ -2421,6 +2715,38 @@ const char *BasicExecutionEngine::TranslateOpCode( uint16_t opcode )
       return "ifnull";
       break;
 
+    case e_JavaOpCodes::GetStaticQuick:
+      return "getstatic_quick";
+      break;
+
+    case e_JavaOpCodes::PutStaticQuick:
+      return "putstatic_quick";
+      break;
+
+    case e_JavaOpCodes::GetFieldQuick:
+      return "getfield_quick";
+      break;
+
+    case e_JavaOpCodes::PutFieldQuick:
+      return "putfield_quick";
+      break;
+
+    case e_JavaOpCodes::InvokeVirtualQuick:
+      return "invokevirtual_quick";
+      break;
+
+    case e_JavaOpCodes::InvokeSpecialQuick:
+      return "invokespecial_quick";
+      break;
+
+    case e_JavaOpCodes::InvokeStaticQuick:
+      return "invokestatic_quick";
+      break;
+
+    case e_JavaOpCodes::InvokeInterfaceQuick:
+      return "invokeinterface_quick";
+      break;
+
     case e_JavaOpCodes::ConvertIntegerToByte:
       return "i2b";
       break;
@@ -2652,32 +2978,57 @@ void BasicExecutionEngine::ExecuteOpCodeLoadReferenceFromConstantPool( const std
 
 e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeVirtual( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  std::shared_ptr<ConstantPoolEntry> pConstant = pVirtualMachineState->GetConstantFromCurrentClass( ReadIndex( pVirtualMachineState ) );
-  if ( pConstant->GetType() != e_ConstantPoolEntryTypeMethodReference )
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
+  ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
+  if ( pVirtualMachineState->GetConstantFromCurrentClass( index )->GetType() != e_ConstantPoolEntryTypeMethodReference )
   {
     pVirtualMachineState->LogCallStack();
     throw InvalidStateException( __FUNCTION__ " - Expected Method reference." );
   }
 
-  return ExecuteVirtualMethod( pVirtualMachineState, pConstant );
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, index );
+  if ( nullptr == pResolved )
+  {
+#if defined (_DEBUG)
+    pVirtualMachineState->LogCallStack();
+    pVirtualMachineState->LogOperandStack();
+    pVirtualMachineState->LogLocalVariables();
+#endif
+
+    throw InvalidStateException( __FUNCTION__ " - Could not resolve method on class." );
+  }
+
+  QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::InvokeVirtualQuick );
+
+  return ExecuteVirtualMethod( pVirtualMachineState, pResolved->m_pMethod, GetInlineCache( pVirtualMachineState, programCounter ) );
+}
+
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeVirtualQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not resolve method on class." );
+  }
+
+  return ExecuteVirtualMethod( pVirtualMachineState, pResolved->m_pMethod, GetInlineCache( pVirtualMachineState, programCounter ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodePushInt( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, int value )
 {
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( value ) ) );
+  pVirtualMachineState->PushInteger( value );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeNewArrayOfReference( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
 
-  boost::intrusive_ptr< JavaInteger > pCount = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pCount )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected an operand of type int." );
-  }
+  int32_t count = pVirtualMachineState->PopInteger();
 
-  if ( pCount->ToHostInt32() < 0 )
+  if ( count < 0 )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaNegativeArraySizeExceptionException );
     return;
@@ -2692,11 +3043,11 @@ void BasicExecutionEngine::ExecuteOpCodeNewArrayOfReference( const std::shared_p
   }
 #endif
 
-  boost::intrusive_ptr<ObjectReference> pArray = pVirtualMachineState->CreateArray( e_JavaArrayTypes::Reference, pCount->ToHostInt32() );
+  boost::intrusive_ptr<ObjectReference> pArray = pVirtualMachineState->CreateArray( e_JavaArrayTypes::Reference, count );
 
   pVirtualMachineState->PushOperand( pArray );
 
-  //pVirtualMachineState->PushOperand( new JavaArray( e_JavaArrayTypes::Reference, pCount->ToHostInt32() ) );
+  //pVirtualMachineState->PushOperand( new JavaArray( e_JavaArrayTypes::Reference, count ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeNew( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -2733,13 +3084,28 @@ void BasicExecutionEngine::ExecuteOpCodeNew( const std::shared_ptr<IVirtualMachi
 
 std::shared_ptr<JavaClass> BasicExecutionEngine::ResolveClassFromIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, ConstantPoolIndex index )
 {
+  ResolvedConstantPool &resolvedConstantPool = GetCurrentResolvedConstantPool( pVirtualMachineState );
+
+  const ResolvedConstantPoolEntry *pResolved = resolvedConstantPool.Find( index );
+  if ( nullptr != pResolved )
+  {
+    return pResolved->m_pClass;
+  }
+
   std::shared_ptr<ConstantPoolClassReference> pClassRef = pVirtualMachineState->GetConstantFromCurrentClass( index )->AsClassReferencePointer();
   if ( nullptr == pClassRef )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected index to be a reference to a class/interface/array." );
   }
 
-  return ResolveClass( pVirtualMachineState, *pClassRef->GetClassName() );
+  ResolvedConstantPoolEntry entry;
+  entry.m_pClass = ResolveClass( pVirtualMachineState, *pClassRef->GetClassName() );
+  if ( nullptr == entry.m_pClass )
+  {
+    return nullptr;
+  }
+
+  return resolvedConstantPool.Store( index, entry )->m_pClass;
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDuplicateTopOperand( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -2752,8 +3118,7 @@ void BasicExecutionEngine::ExecuteOpCodeDuplicateTopOperand( const std::shared_p
     }
 #endif // _DEBUG
 
-  auto pTop = pVirtualMachineState->PeekOperand();
-  pVirtualMachineState->PushOperand( pTop );
+  pVirtualMachineState->DuplicateTopOperand();
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -2789,16 +3154,19 @@ void BasicExecutionEngine::ExecuteOpCodeDuplicateTopOperandx1( const std::shared
 
 e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
 
-  std::shared_ptr<ConstantPoolMethodReference> pMethodRef = pVirtualMachineState->GetConstantFromCurrentClass( index )->AsMethodReference();
-  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->ResolveMethodOnClass( pMethodRef->GetClassName(), pMethodRef.get() );
+  ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
 
-  if ( nullptr == pMethodInfo )
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, index );
+  if ( nullptr == pResolved )
   {
     throw InvalidStateException( __FUNCTION__ " - Could not resolve method." );
   }
 
+  const std::shared_ptr<ConstantPoolMethodReference> &pMethodRef = pResolved->m_pMethodReference;
+  std::shared_ptr<MethodInfo> pMethodInfo = pResolved->m_pMethod;
+
   // Finally, if the resolved method is protected, and it is a member of a superclass of the current class, and the method is not
   // declared in the same runtime package as the current class, then the class of *objectref* must be either the current class or a subclass of the current class.
   if ( pMethodInfo->IsProtected() )
@@ -2855,6 +3223,28 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
     }
   }
 
+  // Calls that select a superclass method are left as they are, as the resolved entry only records the resolved method.
+  if ( pFinalMethod == pMethodInfo )
+  {
+    QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::InvokeSpecialQuick );
+  }
+
+  return InvokeSpecialMethod( pVirtualMachineState, pFinalMethod, pFinalClass );
+}
+
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecialQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not resolve method." );
+  }
+
+  return InvokeSpecialMethod( pVirtualMachineState, pResolved->m_pMethod, pResolved->m_pClass );
+}
+
+e_IncreaseCallStackDepth BasicExecutionEngine::InvokeSpecialMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<MethodInfo> pFinalMethod, std::shared_ptr<JavaClass> pFinalClass )
+{
   boost::intrusive_ptr<JavaString> pFinalMethodName = pFinalMethod->GetName();
   boost::intrusive_ptr<JavaString> pFinalMethodType = pFinalMethod->GetType();
   boost::intrusive_ptr<JavaString> pFinalClassName = pFinalClass->GetName();
@@ -2863,7 +3253,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
   {
     //If the method is not native, the nargs argument values and objectref are popped from the operand stack.
 
-    pVirtualMachineState->PushState( *pFinalClassName, *pFinalMethodName, *pFinalMethodType, pFinalMethod );
+    pVirtualMachineState->PushState( pFinalMethod );
     boost::intrusive_ptr<ObjectReference> pObject = pVirtualMachineState->SetupLocalVariables( pFinalMethod );
 
     if ( pFinalMethod->IsSynchronised() )
@@ -2874,10 +3264,10 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
             GetLogger()->LogDebug("Special Method is synchronized _ 3: %s.", pFinalMethodType->ToUtf8String().c_str());
         }
 #endif // _DEBUG
-      pVirtualMachineState->PushMonitor( pObject->GetContainedObject()->MonitorEnter( pFinalMethod->GetFullName().ToUtf8String().c_str() ) );
+      pObject->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+      pVirtualMachineState->PushMonitor( pObject );
     }
 
-    pVirtualMachineState->UpdateCurrentClassName( pFinalClassName );
     pVirtualMachineState->SetCodeSegment( pFinalMethod->GetCodeInfo() );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
@@ -2921,7 +3311,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
             GetLogger()->LogDebug("Special Method is synchronized _ 1: %s.", pFinalMethodType->ToUtf8String().c_str());
         }
 #endif // _DEBUG
-      pVirtualMachineState->PushMonitor( pFinalClass->MonitorEnter( pFinalMethod->GetFullName().ToUtf8String().c_str() ) );
+      pVirtualMachineState->PushMonitor( pFinalClass->MonitorEnter( __FUNCTION__ ) );
     }
 
     std::shared_ptr<JavaNativeInterface> pJNI = pVirtualMachineState->GetJavaNativeInterface();
@@ -2935,7 +3325,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
 
     if ( pFinalMethod->IsSynchronised() )
     {
-      pVirtualMachineState->PopMonitor()->Unlock( pFinalMethod->GetFullName().ToUtf8String().c_str() );
+      pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
     }
   }
   else
@@ -2948,7 +3338,8 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
             GetLogger()->LogDebug("Method is synchronized _ 2 : %s.", pFinalMethodType->ToUtf8String().c_str());
         }
 #endif // _DEBUG
-      pVirtualMachineState->PushMonitor( pObject->GetContainedObject()->MonitorEnter( pFinalMethod->GetFullName().ToUtf8String().c_str() ) );
+      pObject->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+      pVirtualMachineState->PushMonitor( pObject );
     }
 
     std::shared_ptr<JavaNativeInterface> pJNI = pVirtualMachineState->GetJavaNativeInterface();
@@ -2962,7 +3353,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeSpecial( const
 
     if ( pFinalMethod->IsSynchronised() )
     {
-      pVirtualMachineState->PopMonitor()->Unlock( pFinalMethod->GetFullName().ToUtf8String().c_str() );
+      pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
     }
 
   }
@@ -3001,9 +3392,9 @@ bool BasicExecutionEngine::IsSuperClassOfCurrentClass( const std::shared_ptr<IVi
   return IsSuperClassOf( pVirtualMachineState, pClassName, pVirtualMachineState->GetCurrentClass()->GetName() );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeStoreLongInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeStoreLongInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  if ( e_JavaVariableTypes::Long != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Long != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected long on the operand stack." );
   }
@@ -3017,7 +3408,7 @@ void BasicExecutionEngine::ExecuteOpCodeStoreLongInLocal( const std::shared_ptr<
   }
 #endif
 
-  pVirtualMachineState->SetLocalVariable( localVariableIndex, pVirtualMachineState->PopOperand() );
+  pVirtualMachineState->StoreOperandInLocalVariable( localVariableIndex );
   //pVirtualMachineState->SetLocalVariable( localVariableIndex + 1,new ObjectReference(nullptr) );
 
 #if defined(_DEBUG) && defined(JVMX_LOG_VERBOSE)
@@ -3069,13 +3460,9 @@ int8_t BasicExecutionEngine::ReadByteSigned( const std::shared_ptr<IVirtualMachi
 
 void BasicExecutionEngine::ExecuteOpCodeNewArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaInteger > pCount = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pCount )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected an operand of type int." );
-  }
+  int32_t count = pVirtualMachineState->PopInteger();
 
-  if ( pCount->ToHostInt32() < 0 )
+  if ( count < 0 )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaNegativeArraySizeExceptionException );
     return;
@@ -3091,7 +3478,7 @@ void BasicExecutionEngine::ExecuteOpCodeNewArray( const std::shared_ptr<IVirtual
   }
 #endif
 
-  boost::intrusive_ptr<ObjectReference> pArray = pVirtualMachineState->CreateArray( static_cast<e_JavaArrayTypes>( type ), pCount->ToHostInt32() );
+  boost::intrusive_ptr<ObjectReference> pArray = pVirtualMachineState->CreateArray( static_cast<e_JavaArrayTypes>( type ), count );
 
   pVirtualMachineState->PushOperand( pArray );
 }
@@ -3167,9 +3554,10 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntoIntArray( const std::shared_ptr
     ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
   }
 
-  if ( pIndex->ToHostInt32() < 0 || static_cast<size_t>( pIndex->ToHostInt32() ) > pArray->GetContainedArray()->GetNumberOfElements() )
+  if ( pIndex->ToHostInt32() < 0 || static_cast<size_t>( pIndex->ToHostInt32() ) >= pArray->GetContainedArray()->GetNumberOfElements() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
+    return;
   }
 
   pArray->GetContainedArray()->SetAt( *pIndex, *pValue );
@@ -3177,22 +3565,26 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntoIntArray( const std::shared_ptr
 
 void BasicExecutionEngine::ExecuteOpCodeGetField( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  std::shared_ptr<ConstantPoolFieldReference> pFieldRef = pVirtualMachineState->GetConstantFromCurrentClass( ReadIndex( pVirtualMachineState ) )->AsFieldReferencePointer();
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
 
-  std::shared_ptr<FieldInfo> pFieldInfo = ResolveField( pVirtualMachineState, *pFieldRef->GetClassName(), *pFieldRef->GetName() );
-
-  if ( nullptr == pFieldInfo )
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
   {
     throw InvalidStateException( __FUNCTION__ " - Could not find field." );
   }
 
+  const std::shared_ptr<ConstantPoolFieldReference> &pFieldRef = pResolved->m_pFieldReference;
+  const std::shared_ptr<FieldInfo> &pFieldInfo = pResolved->m_pField;
+
   if ( pFieldInfo->IsStatic() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaIncompatibleClassChangeErrorException );
     return;
   }
 
-  if ( pVirtualMachineState->PeekOperand()->GetVariableType() == e_JavaVariableTypes::NullReference )
+  QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::GetFieldQuick );
+
+  if ( pVirtualMachineState->PeekOperandType() == e_JavaVariableTypes::NullReference )
   {
 #ifdef _DEBUG
     GetLogger()->LogDebug( "Null reference trying to get field: %s.%s", pFieldRef->GetClassName()->ToUtf8String().c_str(), pFieldRef->GetName()->ToUtf8String().c_str() );
@@ -3218,7 +3610,7 @@ void BasicExecutionEngine::ExecuteOpCodeGetField( const std::shared_ptr<IVirtual
     // TODO: Implement this check.
   }
 
-  auto pFieldValue = pObject->GetContainedObject()->GetFieldByName( *pFieldInfo->GetName() );
+  auto pFieldValue = pObject->GetContainedObject()->GetFieldAtOffset( pResolved->m_FieldOffset, pFieldInfo->GetVariableType() );
   if ( nullptr == pFieldValue )
   {
     __asm int 3;
@@ -3233,6 +3625,46 @@ void BasicExecutionEngine::ExecuteOpCodeGetField( const std::shared_ptr<IVirtual
   pVirtualMachineState->PushOperand( pFieldValue );
 }
 
+void BasicExecutionEngine::ExecuteOpCodeGetFieldQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not find field." );
+  }
+
+  if ( pVirtualMachineState->PeekOperandType() == e_JavaVariableTypes::NullReference )
+  {
+    ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
+    return;
+  }
+
+  boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pVirtualMachineState->PopOperand() );
+  JavaObject *pContainedObject = pObject->GetContainedObject();
+
+  // The wide primitive types go onto the operand stack straight from the field's slot. The narrow ones stay boxed, as
+  // the operand stack expects.
+  e_JavaVariableTypes fieldType = pResolved->m_pField->GetVariableType();
+  switch ( fieldType )
+  {
+    case e_JavaVariableTypes::Integer:
+      pVirtualMachineState->PushInteger( pContainedObject->GetSlotAtOffset<int32_t>( pResolved->m_FieldOffset ) );
+      break;
+    case e_JavaVariableTypes::Long:
+      pVirtualMachineState->PushLong( pContainedObject->GetSlotAtOffset<int64_t>( pResolved->m_FieldOffset ) );
+      break;
+    case e_JavaVariableTypes::Float:
+      pVirtualMachineState->PushFloat( pContainedObject->GetSlotAtOffset<float>( pResolved->m_FieldOffset ) );
+      break;
+    case e_JavaVariableTypes::Double:
+      pVirtualMachineState->PushDouble( pContainedObject->GetSlotAtOffset<double>( pResolved->m_FieldOffset ) );
+      break;
+    default:
+      pVirtualMachineState->PushOperand( pContainedObject->GetFieldAtOffset( pResolved->m_FieldOffset, fieldType ) );
+      break;
+  }
+}
+
 int16_t BasicExecutionEngine::ReadOffset( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   if ( !pVirtualMachineState->CanReadBytes( sizeof( ConstantPoolIndex ) ) )
@@ -3335,58 +3767,19 @@ void BasicExecutionEngine::ExecuteOpCodeArrayLength( const std::shared_ptr<IVirt
   }
 #endif // _DEBUG
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( static_cast<int32_t>( pArrayRef->GetContainedArray()->GetNumberOfElements() ) ) ) );
+  pVirtualMachineState->PushInteger( static_cast<int32_t>( pArrayRef->GetContainedArray()->GetNumberOfElements() ) );
 }
 
 int BasicExecutionEngine::GetIntegerFromOperandStack( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState ) const
 {
-  boost::intrusive_ptr<IJavaVariableType> pOperand = pVirtualMachineState->PopOperand();
-
-  int result = 0;
-  switch ( pOperand->GetVariableType() )
-  {
-    case e_JavaVariableTypes::Integer:
-      result = boost::dynamic_pointer_cast<JavaInteger>( pOperand )->ToHostInt32();
-      break;
-
-    case e_JavaVariableTypes::Char:
-      result = boost::dynamic_pointer_cast<JavaChar>( pOperand )->ToUInt16();
-      break;
-
-    case e_JavaVariableTypes::Bool:
-      result = boost::dynamic_pointer_cast<JavaBool>( pOperand )->ToUint16();
-      break;
-
-    case e_JavaVariableTypes::Byte:
-      result = boost::dynamic_pointer_cast<JavaByte>( pOperand )->ToHostInt8();
-      break;
-
-    case e_JavaVariableTypes::Short:
-      result = boost::dynamic_pointer_cast<JavaShort>( pOperand )->ToHostInt16();
-      break;
-
-    default:
-      throw InvalidStateException( __FUNCTION__ " - Value on the operand stack was not of type integer." );
-  }
-
-  return result;
+  // Char, bool, byte and short operands are widened by the operand stack.
+  return pVirtualMachineState->PopInteger();
 }
 
 uint64_t BasicExecutionEngine::GetLongFromOperandStack( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  auto pOperand = pVirtualMachineState->PopOperand();
-
-  if ( e_JavaVariableTypes::Long == pOperand->GetVariableType() )
-  {
-    return boost::dynamic_pointer_cast<JavaLong>( pOperand )->ToHostInt64();
-  }
-
-  if ( !pOperand->IsIntegerCompatible() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Value on the operand stack was not of type long or integer." );
-  }
-
-  return TypeParser::UpCastToInteger( pOperand.get() )->ToHostInt32();
+  // Integer compatible operands are accepted and widened, as before.
+  return static_cast<uint64_t>( pVirtualMachineState->PopLong() );
 }
 
 void BasicExecutionEngine::ExecutedOpBranchIfIntegerEquals( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -3479,9 +3872,9 @@ void BasicExecutionEngine::ExecuteOpCodeStoreReferenceInLocalWithIndex( const st
   ExecuteOpCodeStoreReferenceInLocal( pVirtualMachineState, ReadByteUnsigned( pVirtualMachineState ) );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeStoreReferenceInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeStoreReferenceInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  e_JavaVariableTypes type = pVirtualMachineState->PeekOperand()->GetVariableType();
+  e_JavaVariableTypes type = pVirtualMachineState->PeekOperandType();
   if ( !IsReference( type ) )
   {
 #ifdef _DEBUG
@@ -3491,7 +3884,7 @@ void BasicExecutionEngine::ExecuteOpCodeStoreReferenceInLocal( const std::shared
     throw InvalidStateException( __FUNCTION__ " - Expected reference on the operand stack." );
   }
 
-  pVirtualMachineState->SetLocalVariable( localVariableIndex, pVirtualMachineState->PopOperand() );
+  pVirtualMachineState->StoreOperandInLocalVariable( localVariableIndex );
 }
 
 bool BasicExecutionEngine::IsReference( e_JavaVariableTypes type )
@@ -3507,6 +3900,11 @@ void BasicExecutionEngine::ExecuteOpCodeGoto( const std::shared_ptr<IVirtualMach
 void BasicExecutionEngine::AdjustProgramCounterByOffset( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, int16_t offset )
 {
   pVirtualMachineState->AdvanceProgramCounter( offset - ( sizeof( int16_t ) + sizeof( int8_t ) ) );
+
+  if ( offset < 0 )
+  {
+    PollSafepoint( pVirtualMachineState );
+  }
 }
 
 void BasicExecutionEngine::ExecuteOpCodeReturnReference( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -3524,7 +3922,7 @@ void BasicExecutionEngine::ExecuteOpCodeReturnReference( const std::shared_ptr<I
   std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
   if ( pMethodInfo->IsSynchronised() )
   {
-    pVirtualMachineState->PopMonitor()->Unlock( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+    pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
   }
 
   pVirtualMachineState->PopState();
@@ -3549,7 +3947,7 @@ void BasicExecutionEngine::ExecuteOpCodeMonitorExit( const std::shared_ptr<IVirt
       throw InvalidStateException( __FUNCTION__ " - Expected object on operand stack." );
     }
 
-    pReference->GetContainedObject()->MonitorExit( pVirtualMachineState->GetCurrentClassAndMethodName().ToUtf8String().c_str() );
+    pReference->GetContainedObject()->MonitorExit( __FUNCTION__ );
   }
   else if ( e_JavaVariableTypes::Array == pOperand->GetVariableType() )
   {
@@ -3559,7 +3957,7 @@ void BasicExecutionEngine::ExecuteOpCodeMonitorExit( const std::shared_ptr<IVirt
       throw InvalidStateException( __FUNCTION__ " - Expected array on operand stack." );
     }
 
-    pReference->GetContainedArray()->MonitorExit( pVirtualMachineState->GetCurrentClassAndMethodName().ToUtf8String().c_str() );
+    pReference->GetContainedArray()->MonitorExit( __FUNCTION__ );
   }
   else if ( e_JavaVariableTypes::ClassReference == pOperand->GetVariableType() )
   {
@@ -3569,7 +3967,7 @@ void BasicExecutionEngine::ExecuteOpCodeMonitorExit( const std::shared_ptr<IVirt
       throw InvalidStateException( __FUNCTION__ " - Expected array on operand stack." );
     }
 
-    pReference->GetClassFile()->MonitorExit( pVirtualMachineState->GetCurrentClassAndMethodName().ToUtf8String().c_str() );
+    pReference->GetClassFile()->MonitorExit( __FUNCTION__ );
   }
   else
   {
@@ -3614,7 +4012,7 @@ void BasicExecutionEngine::ExecuteOpCodeReturnInteger( const std::shared_ptr<IVi
   std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
   if ( pMethodInfo->IsSynchronised() )
   {
-    pVirtualMachineState->PopMonitor()->Unlock( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+    pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
   }
 
   if ( pVirtualMachineState->HasExceptionOccurred() )
@@ -3647,12 +4045,12 @@ void BasicExecutionEngine::ExecuteOpCodeIntegerRemainder( const std::shared_ptr<
   int integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 % integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 % integer2 );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeStoreIntegerInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeStoreIntegerInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
@@ -3664,7 +4062,7 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntegerInLocal( const std::shared_p
   }
 #endif // _DEBUG
 
-  pVirtualMachineState->SetLocalVariable( localVariableIndex, pVirtualMachineState->PopOperand() );
+  pVirtualMachineState->StoreOperandInLocalVariable( localVariableIndex );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeStoreIntegerInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -3677,7 +4075,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromLocalWithIndex( const std
   ExecuteOpCodeLoadIntegerFromLocal( pVirtualMachineState, ReadByteUnsigned( pVirtualMachineState ) );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
     if (pVirtualMachineState->HasUserCodeStarted())
@@ -3687,11 +4085,18 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromLocal( const std::shared_
     }
 #endif
 
-  auto pLocalValue = pVirtualMachineState->GetLocalVariable( localVariableIndex );
-  if ( !pLocalValue->IsIntegerCompatible() )
+  switch ( pVirtualMachineState->GetLocalVariableType( localVariableIndex ) )
   {
-    pVirtualMachineState->LogLocalVariables();
-    throw InvalidStateException( __FUNCTION__ " - Expected integer in local variable." );
+    case e_JavaVariableTypes::Integer:
+    case e_JavaVariableTypes::Char:
+    case e_JavaVariableTypes::Bool:
+    case e_JavaVariableTypes::Byte:
+    case e_JavaVariableTypes::Short:
+      break;
+
+    default:
+      pVirtualMachineState->LogLocalVariables();
+      throw InvalidStateException( __FUNCTION__ " - Expected integer in local variable." );
   }
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
@@ -3701,7 +4106,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromLocal( const std::shared_
   }
 #endif // _DEBUG
 
-  pVirtualMachineState->PushOperand( TypeParser::UpCastToInteger( pVirtualMachineState->GetLocalVariable( localVariableIndex ).get() ) );
+  pVirtualMachineState->PushInteger( pVirtualMachineState->GetLocalInteger( localVariableIndex ) );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -3713,14 +4118,14 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromLocal( const std::shared_
 
 void BasicExecutionEngine::ExecuteOpCodeLoadReferenceFromArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t index = pVirtualMachineState->PopInteger();
 
-  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected Array on the operand stack." );
   }
@@ -3738,14 +4143,13 @@ void BasicExecutionEngine::ExecuteOpCodeLoadReferenceFromArray( const std::share
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || pIndex->ToHostInt32() > static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
+  if ( index < 0 || index >= static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
     return;
   }
 
-  IJavaVariableType *pTempReference = pArray->GetContainedArray()->At( pIndex->ToHostInt32() );
-  boost::intrusive_ptr<ObjectReference> ref = new ObjectReference( *dynamic_cast<const ObjectReference *>( pTempReference ) );
+  boost::intrusive_ptr<ObjectReference> ref = new ObjectReference( pArray->GetContainedArray()->GetElementAt<ObjectIndexT>( index ) );
 
   pVirtualMachineState->PushOperand( ref );
 }
@@ -3759,14 +4163,14 @@ void BasicExecutionEngine::ExecuteOpCodeLoadCharacterFromArray( const std::share
     }
 #endif
 
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t index = pVirtualMachineState->PopInteger();
 
-  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected Array on the operand stack." );
   }
@@ -3784,7 +4188,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadCharacterFromArray( const std::share
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || pIndex->ToHostInt32() > static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
+  if ( index < 0 || index >= static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
   {
 #ifdef _DEBUG
     pVirtualMachineState->LogCallStack();
@@ -3796,13 +4200,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadCharacterFromArray( const std::share
 
   JVMX_ASSERT( pArray->GetContainedArray()->GetContainedType() == e_JavaArrayTypes::Char );
 
-  const JavaChar *pChar = dynamic_cast<const JavaChar *>( pArray->GetContainedArray()->At( pIndex->ToHostInt32() ) );
-  if ( nullptr == pChar )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Could not convert from array contained type to char." );
-  }
-
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromChar( *pChar ) ) );
+  pVirtualMachineState->PushInteger( pArray->GetContainedArray()->GetElementAt<char16_t>( index ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeLoadFloatFromLocalWithIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -3810,56 +4208,47 @@ void BasicExecutionEngine::ExecuteOpCodeLoadFloatFromLocalWithIndex( const std::
   ExecuteOpLoadFloatFromLocal( pVirtualMachineState, ReadByteUnsigned( pVirtualMachineState ) );
 }
 
-void BasicExecutionEngine::ExecuteOpLoadFloatFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpLoadFloatFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  if ( e_JavaVariableTypes::Float != pVirtualMachineState->GetLocalVariable( localVariableIndex )->GetVariableType() )
+  if ( e_JavaVariableTypes::Float != pVirtualMachineState->GetLocalVariableType( localVariableIndex ) )
   {
     pVirtualMachineState->LogLocalVariables();
     throw InvalidStateException( __FUNCTION__ " - Expected float in local variable." );
   }
 
-  pVirtualMachineState->PushOperand( pVirtualMachineState->GetLocalVariable( localVariableIndex ) );
+  pVirtualMachineState->PushFloat( pVirtualMachineState->GetLocalFloat( localVariableIndex ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodePushFloatConstant( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, float value )
 {
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostFloat( value ) ) );
+  pVirtualMachineState->PushFloat( value );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeFloatComparisonL( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( CompareFloatValues( pVirtualMachineState, -1 ) ) ) );
+  pVirtualMachineState->PushInteger( CompareFloatValues( pVirtualMachineState, -1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeFloatComparisonG( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( CompareFloatValues( pVirtualMachineState, 1 ) ) ) );
+  pVirtualMachineState->PushInteger( CompareFloatValues( pVirtualMachineState, 1 ) );
 }
 
 int BasicExecutionEngine::CompareFloatValues( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, int nanResult )
 {
-  boost::intrusive_ptr<JavaFloat> pFloat2 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pFloat2 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be float type." );
-  }
-
-  boost::intrusive_ptr<JavaFloat> pFloat1 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pFloat1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected second operand to be float type." );
-  }
+  float float2 = pVirtualMachineState->PopFloat();
+  float float1 = pVirtualMachineState->PopFloat();
 
   int32_t result = 0;
-  if ( _isnan( pFloat1->ToHostFloat() ) || _isnan( pFloat2->ToHostFloat() ) )
+  if ( _isnan( float1 ) || _isnan( float2 ) )
   {
     result = nanResult;
   }
-  else if ( *pFloat1 > *pFloat2 )
+  else if ( float1 > float2 )
   {
     result = 1;
   }
-  else if ( *pFloat1 < *pFloat2 )
+  else if ( float1 < float2 )
   {
     result = -1;
   }
@@ -3873,28 +4262,19 @@ int BasicExecutionEngine::CompareFloatValues( const std::shared_ptr<IVirtualMach
 
 int BasicExecutionEngine::CompareDoubleValues( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, int nanResult )
 {
-  boost::intrusive_ptr<JavaDouble> pDouble2 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pDouble2 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be double type." );
-  }
-
-  boost::intrusive_ptr<JavaDouble> pDouble1 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pDouble1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected second operand to be double type." );
-  }
+  double double2 = pVirtualMachineState->PopDouble();
+  double double1 = pVirtualMachineState->PopDouble();
 
   int32_t result = 0;
-  if ( _isnan( pDouble1->ToHostDouble() ) || _isnan( pDouble2->ToHostDouble() ) )
+  if ( _isnan( double1 ) || _isnan( double2 ) )
   {
     result = nanResult;
   }
-  else if ( *pDouble1 > *pDouble2 )
+  else if ( double1 > double2 )
   {
     result = 1;
   }
-  else if ( *pDouble1 < *pDouble2 )
+  else if ( double1 < double2 )
   {
     result = -1;
   }
@@ -3916,15 +4296,18 @@ void BasicExecutionEngine::ExecuteOpCodePutField( const std::shared_ptr<IVirtual
     }
 #endif // _DEBUG
 
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
   ConstantPoolIndex index = ReadIndex( pVirtualMachineState );
 
-  std::shared_ptr<ConstantPoolFieldReference> pFieldReference = pVirtualMachineState->GetConstantFromCurrentClass( index )->AsFieldReferencePointer();
-  if ( nullptr == pFieldReference )
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, index );
+  if ( nullptr == pResolved )
   {
-    throw InvalidStateException( __FUNCTION__ " - Expected constant to be a field reference" );
+    throw InvalidStateException( __FUNCTION__ " - Could not find field." );
   }
 
-  std::shared_ptr<FieldInfo> pFieldInfo = ResolveField( pVirtualMachineState, *pFieldReference->GetClassName(), *pFieldReference->GetName() );
+  const std::shared_ptr<ConstantPoolFieldReference> &pFieldReference = pResolved->m_pFieldReference;
+  const std::shared_ptr<FieldInfo> &pFieldInfo = pResolved->m_pField;
 
   boost::intrusive_ptr<IJavaVariableType> pValue = pVirtualMachineState->PopOperand();
   boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pVirtualMachineState->PopOperand() );
@@ -3969,6 +4352,8 @@ void BasicExecutionEngine::ExecuteOpCodePutField( const std::shared_ptr<IVirtual
     }
   }
 
+  QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::PutFieldQuick );
+
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
   {
@@ -3978,7 +4363,7 @@ void BasicExecutionEngine::ExecuteOpCodePutField( const std::shared_ptr<IVirtual
 
   try
   {
-    pObject->GetContainedObject()->SetField( *pFieldInfo->GetName(), pValue );
+    pObject->GetContainedObject()->SetFieldAtOffset( pResolved->m_FieldOffset, pFieldInfo->GetVariableType(), pValue.get() );
   }
   catch ( ... )
   {
@@ -3989,6 +4374,59 @@ void BasicExecutionEngine::ExecuteOpCodePutField( const std::shared_ptr<IVirtual
   }
 }
 
+void BasicExecutionEngine::ExecuteOpCodePutFieldQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const ResolvedConstantPoolEntry *pResolved = ResolveFieldReference( pVirtualMachineState, ReadIndex( pVirtualMachineState ) );
+  if ( nullptr == pResolved )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not find field." );
+  }
+
+  e_JavaVariableTypes fieldType = pResolved->m_pField->GetVariableType();
+  switch ( fieldType )
+  {
+    case e_JavaVariableTypes::Integer:
+      PutFieldUnboxed( pVirtualMachineState, pResolved->m_FieldOffset, pVirtualMachineState->PopInteger() );
+      return;
+    case e_JavaVariableTypes::Long:
+      PutFieldUnboxed( pVirtualMachineState, pResolved->m_FieldOffset, pVirtualMachineState->PopLong() );
+      return;
+    case e_JavaVariableTypes::Float:
+      PutFieldUnboxed( pVirtualMachineState, pResolved->m_FieldOffset, pVirtualMachineState->PopFloat() );
+      return;
+    case e_JavaVariableTypes::Double:
+      PutFieldUnboxed( pVirtualMachineState, pResolved->m_FieldOffset, pVirtualMachineState->PopDouble() );
+      return;
+    default:
+      break;
+  }
+
+  boost::intrusive_ptr<IJavaVariableType> pValue = pVirtualMachineState->PopOperand();
+  boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pVirtualMachineState->PopOperand() );
+
+  if ( nullptr == pObject || pObject->IsNull() )
+  {
+    ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
+    return;
+  }
+
+  pObject->GetContainedObject()->SetFieldAtOffset( pResolved->m_FieldOffset, fieldType, pValue.get() );
+}
+
+template <typename T>
+void BasicExecutionEngine::PutFieldUnboxed( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, size_t fieldOffset, T value )
+{
+  boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pVirtualMachineState->PopOperand() );
+
+  if ( nullptr == pObject || pObject->IsNull() )
+  {
+    ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
+    return;
+  }
+
+  pObject->GetContainedObject()->SetSlotAtOffset( fieldOffset, value );
+}
+
 bool BasicExecutionEngine::AreTypesCompatibile( boost::intrusive_ptr<JavaString> referenceType, boost::intrusive_ptr<JavaString> valueType )
 {
   if ( referenceType == valueType )
@@ -4037,31 +4475,72 @@ bool BasicExecutionEngine::AreTypesCompatibile( boost::intrusive_ptr<JavaString>
 
 bool BasicExecutionEngine::IsSuperClassOf( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, boost::intrusive_ptr<JavaString> pPossibleSuperClassName, boost::intrusive_ptr<JavaString> pDerivedClassName ) const
 {
-  auto pDerivedClass = pVirtualMachineState->LoadClass( *pDerivedClassName );
+  std::shared_ptr<JavaClass> pDerivedClass = GetClassLibrary()->FindClass( *pDerivedClassName );
+  if ( nullptr == pDerivedClass )
+  {
+    pDerivedClass = pVirtualMachineState->LoadClass( *pDerivedClassName );
+  }
 
-  if ( nullptr == pDerivedClass->GetSuperClass() )
+  // A class that has not been loaded yet cannot be the superclass of one that has.
+  std::shared_ptr<JavaClass> pPossibleSuperClass = GetClassLibrary()->FindClass( *pPossibleSuperClassName );
+  if ( nullptr == pPossibleSuperClass || pPossibleSuperClass->IsInterface() || pPossibleSuperClass == pDerivedClass )
   {
     return false;
   }
 
-  //auto pSuperClass = GetClassLibrary()->FindClass( *(pDerivedClass->GetSuperClassName()) );
-  std::shared_ptr<JavaClass> pSuperClass = pDerivedClass->GetSuperClass();
-  while ( nullptr != pSuperClass )
+  return IsSubtypeOf( pVirtualMachineState, pDerivedClass.get(), pPossibleSuperClass.get() );
+}
+
+bool BasicExecutionEngine::IsSubtypeOf( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const JavaClass *pClass, const JavaClass *pPossibleSuperType ) const
+{
+  if ( pClass == pPossibleSuperType )
+  {
+    return true;
+  }
+
+  const SuperTypeDisplay *pDisplay = GetSuperTypeDisplay( pVirtualMachineState, pClass );
+  const SuperTypeDisplay *pPossibleSuperTypeDisplay = GetSuperTypeDisplay( pVirtualMachineState, pPossibleSuperType );
+  if ( nullptr == pDisplay || nullptr == pPossibleSuperTypeDisplay )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Could not load the super types of a class." );
+  }
+
+  return pDisplay->IsSubtypeOf( *pPossibleSuperTypeDisplay );
+}
+
+const SuperTypeDisplay *BasicExecutionEngine::GetSuperTypeDisplay( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const JavaClass *pClass ) const
+{
+  const SuperTypeDisplay *pResult = pClass->GetSuperTypeDisplay();
+  if ( nullptr == pResult )
+  {
+    LoadSuperTypes( pVirtualMachineState, *pClass );
+    pResult = pClass->GetSuperTypeDisplay();
+  }
+
+  return pResult;
+}
+
+void BasicExecutionEngine::LoadSuperTypes( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const JavaClass &javaClass ) const
+{
+  // Loading a class does not load its interfaces, and may not have loaded its superclass either.
+  boost::intrusive_ptr<JavaString> pSuperClassName = javaClass.GetSuperClassName();
+  if ( !pSuperClassName->IsEmpty() )
   {
-    if ( *pSuperClass->GetName() == *pPossibleSuperClassName )
+    std::shared_ptr<JavaClass> pSuperClass = pVirtualMachineState->LoadClass( *pSuperClassName );
+    if ( nullptr == pSuperClass->GetSuperTypeDisplay() )
     {
-      return true;
+      LoadSuperTypes( pVirtualMachineState, *pSuperClass );
     }
+  }
 
-    if ( nullptr == pSuperClass->GetSuperClass() )
+  for ( size_t index = 0; index < javaClass.GetInterfacesCount(); ++ index )
+  {
+    std::shared_ptr<JavaClass> pInterface = pVirtualMachineState->LoadClass( javaClass.GetInterfaceName( index ) );
+    if ( nullptr == pInterface->GetSuperTypeDisplay() )
     {
-      return false;
+      LoadSuperTypes( pVirtualMachineState, *pInterface );
     }
-
-    pSuperClass = pSuperClass->GetSuperClass();
   }
-
-  return false;
 }
 
 void BasicExecutionEngine::ExecuteOpCodeBranchIfNotNull( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -4087,7 +4566,7 @@ void BasicExecutionEngine::ExecuteOpCodeIntegerAdd( const std::shared_ptr<IVirtu
   int integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 + integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 + integer2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -4109,7 +4588,7 @@ void BasicExecutionEngine::ExecuteOpCodeIntegerMultiply( const std::shared_ptr<I
   int integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 * integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 * integer2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeIntegerSubtract( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -4117,7 +4596,7 @@ void BasicExecutionEngine::ExecuteOpCodeIntegerSubtract( const std::shared_ptr<I
   int integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 - integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 - integer2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeStoreIntoCharArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -4195,9 +4674,10 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntoReferenceArray( const std::shar
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || static_cast<size_t>( pIndex->ToHostInt32() ) > pArray->GetContainedArray()->GetNumberOfElements() )
+  if ( pIndex->ToHostInt32() < 0 || static_cast<size_t>( pIndex->ToHostInt32() ) >= pArray->GetContainedArray()->GetNumberOfElements() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
+    return;
   }
 
   pArray->GetContainedArray()->SetAt( *pIndex, pValue.get() );
@@ -4231,16 +4711,16 @@ void BasicExecutionEngine::ExecuteOpCodeTableSwitch( const std::shared_ptr<IVirt
     jumpTable[ i ] = Read32BitOffset( pVirtualMachineState );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t index = pVirtualMachineState->PopInteger();
 
   intptr_t targetAddress = 0;
-  if ( pIndex->ToHostInt32() < low || pIndex->ToHostInt32() > high )
+  if ( index < low || index > high )
   {
     targetAddress = startingAddress + deflt;
   }
   else
   {
-    int32_t jumpTableIndex = pIndex->ToHostInt32() - low;
+    int32_t jumpTableIndex = index - low;
     targetAddress = startingAddress + jumpTable[ jumpTableIndex ];
   }
 
@@ -4264,62 +4744,37 @@ int32_t BasicExecutionEngine::Read32BitOffset( const std::shared_ptr<IVirtualMac
 
 void BasicExecutionEngine::ExecuteOpCodeConvertIntegerToFloat( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaInteger > pInteger1 = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pInteger1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be integer type." );
-  }
+  int32_t integer1 = pVirtualMachineState->PopInteger();
 
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostFloat( static_cast<float>( pInteger1->ToHostInt32() ) ) ) );
+  pVirtualMachineState->PushFloat( static_cast<float>( integer1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertIntegerToDouble( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaInteger > pInteger1 = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pInteger1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be integer type." );
-  }
+  int32_t integer1 = pVirtualMachineState->PopInteger();
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( static_cast<double>( pInteger1->ToHostInt32() ) ) ) );
+  pVirtualMachineState->PushDouble( static_cast<double>( integer1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeFloatMultiply( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr<JavaFloat> pFloat2 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pFloat2 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be float type." );
-  }
+  float float2 = pVirtualMachineState->PopFloat();
+  float float1 = pVirtualMachineState->PopFloat();
 
-  boost::intrusive_ptr<JavaFloat> pFloat1 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pFloat1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected second operand to be float type." );
-  }
-
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostFloat( pFloat1->ToHostFloat() * pFloat2->ToHostFloat() ) ) );
+  pVirtualMachineState->PushFloat( float1 * float2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertFloatToInteger( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr<JavaFloat> pFloat = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pFloat )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be float type." );
-  }
+  float value = pVirtualMachineState->PopFloat();
 
-  boost::intrusive_ptr< JavaInteger > result = new JavaInteger( JavaInteger::FromDefault() );
-  if ( pFloat->IsNan() )
-  {
-    result = new JavaInteger( JavaInteger::FromHostInt32( 0 ) );
-  }
-  else
+  int32_t result = 0;
+  if ( !_isnan( value ) )
   {
-    result = new JavaInteger( JavaInteger::FromHostInt32( static_cast<int32_t>( pFloat->ToHostFloat() ) ) );
+    result = static_cast<int32_t>( value );
   }
 
-  pVirtualMachineState->PushOperand( result );
+  pVirtualMachineState->PushInteger( result );
 }
 
 std::shared_ptr<MethodInfo> BasicExecutionEngine::IdentifyVirtualMethodToCall( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<MethodInfo> pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject )
@@ -4328,10 +4783,18 @@ std::shared_ptr<MethodInfo> BasicExecutionEngine::IdentifyVirtualMethodToCall( c
   std::shared_ptr<MethodInfo> pOldMethod = pMethodInfo;
 #endif // _DEBUG
 
+  std::shared_ptr<JavaClass> pClass = pObject->GetContainedObject()->GetClass();
+
+  std::shared_ptr<MethodInfo> pMethodToExecute = pClass->SelectVirtualMethod( *pMethodInfo );
+  if ( nullptr != pMethodToExecute )
+  {
+    return pMethodToExecute;
+  }
+
+  // The vtable could not answer, for example because the method is private. Search by name instead.
   JavaString methodName = *( pMethodInfo->GetName() );
   JavaString methodType = *( pMethodInfo->GetType() );
-  std::shared_ptr<MethodInfo> pMethodToExecute = pObject->GetContainedObject()->GetClass()->GetMethodByNameAndType( methodName, methodType );
-  std::shared_ptr<JavaClass> pClass = pObject->GetContainedObject()->GetClass();
+  pMethodToExecute = pClass->GetMethodByNameAndType( methodName, methodType );
 
   if ( nullptr == pMethodToExecute )
   {
@@ -4386,7 +4849,7 @@ void BasicExecutionEngine::ExecuteOpCodeIsInstanceOf( const std::shared_ptr<IVir
   {
     if ( e_JavaVariableTypes::NullReference == pOperand->GetVariableType() )
     {
-      pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( 0 ) ) );
+      pVirtualMachineState->PushInteger( 0 );
       return;
     }
 
@@ -4408,17 +4871,8 @@ void BasicExecutionEngine::ExecuteOpCodeIsInstanceOf( const std::shared_ptr<IVir
   if ( e_JavaVariableTypes::Object == pOperand->GetVariableType() )
   {
     boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pOperand );
-    if ( !pResolvedClass->IsInterface() )
-    {
-      pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( IsInstanceOf( pVirtualMachineState, pResolvedClass->GetName(), pObject->GetContainedObject()->GetClass()->GetName() ) ? 1 : 0 ) ) );
-      return;
-    }
-    else
-    {
-      bool bFound = DoesClassImplementInterface( pVirtualMachineState, pObject->GetContainedObject()->GetClass(), pResolvedClass->GetName() );
-      pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( bFound ? 1 : 0 ) ) );
-      return;
-    }
+    pVirtualMachineState->PushInteger( IsSubtypeOf( pVirtualMachineState, pObject->GetContainedObject()->GetClass().get(), pResolvedClass.get() ) ? 1 : 0 );
+    return;
   }
   else if ( e_JavaVariableTypes::ClassReference == pOperand->GetVariableType() )
   {
@@ -4440,7 +4894,7 @@ void BasicExecutionEngine::ExecuteOpCodeIsInstanceOf( const std::shared_ptr<IVir
         throw InvalidStateException( __FUNCTION__ " - Expected argument of to be of type Object." );
       }
 
-      pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( 1 ) ) );
+      pVirtualMachineState->PushInteger( 1 );
       return;
     }
     else
@@ -4450,7 +4904,7 @@ void BasicExecutionEngine::ExecuteOpCodeIsInstanceOf( const std::shared_ptr<IVir
            *pResolvedClass->GetName() == JavaString::FromCString( "java/io/Serializable" )
          )
       {
-        pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( 1 ) ) );
+        pVirtualMachineState->PushInteger( 1 );
         return;
       }
     }
@@ -4458,12 +4912,12 @@ void BasicExecutionEngine::ExecuteOpCodeIsInstanceOf( const std::shared_ptr<IVir
     // TODO: If T is an array type TC[], that is, an array of components of type TC, then one of the following must be true:
     // - TC and SC are the same primitive type.
     // - TC and SC are reference types, and type SC can be cast to TC by these runtime rules.
-    pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( 0 ) ) );
+    pVirtualMachineState->PushInteger( 0 );
     return;
   }
 
   JVMX_ASSERT( false );
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( 0 ) ) );
+  pVirtualMachineState->PushInteger( 0 );
 }
 
 bool BasicExecutionEngine::IsInstanceOf( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, boost::intrusive_ptr<JavaString> pPossibleSuperClassName, boost::intrusive_ptr<JavaString> pDerivedClassName ) const
@@ -4552,7 +5006,7 @@ void BasicExecutionEngine::ExecuteOpCodeCheckCast( const std::shared_ptr<IVirtua
 
 void BasicExecutionEngine::ExecuteOpCodePopOperandStack( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  pVirtualMachineState->PopOperand();
+  pVirtualMachineState->DiscardOperand();
 }
 
 // TODO: Debug here
@@ -4618,51 +5072,42 @@ void BasicExecutionEngine::ExecuteOpCodeIncrementLocalVariable( const std::share
   uint8_t index = ReadByteUnsigned( pVirtualMachineState );
   int8_t constantValue = ReadByteSigned( pVirtualMachineState );
 
-  boost::intrusive_ptr< JavaInteger > pIntValue = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->GetLocalVariable( index ) );
-  if ( nullptr == pIntValue )
+  IncrementLocalVariable( pVirtualMachineState, index, constantValue );
+}
+
+void BasicExecutionEngine::IncrementLocalVariable( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t index, int16_t constantValue )
+{
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->GetLocalVariableType( index ) )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer in local variable" );
   }
 
-  int32_t finalValue = pIntValue->ToHostInt32() + constantValue;
+  int32_t intValue = pVirtualMachineState->GetLocalInteger( index );
+  int32_t finalValue = intValue + constantValue;
 
 #ifdef _DEBUG
-  if ( finalValue < pIntValue->ToHostInt32() && constantValue > 0 )
+  if ( finalValue < intValue && constantValue > 0 )
   {
     JVMX_ASSERT( false );
   }
 #endif // _DEBUG
 
-  pVirtualMachineState->SetLocalVariable( index, new JavaInteger( JavaInteger::FromHostInt32( finalValue ) ) );
+  pVirtualMachineState->SetLocalInteger( index, finalValue );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeNegateInteger( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   int32_t value = GetIntegerFromOperandStack( pVirtualMachineState );
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( value * -1 ) ) );
+  pVirtualMachineState->PushInteger( value * -1 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertIntegerToChar( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaInteger > pInteger1 = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pInteger1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be integer type." );
-  }
+  int32_t integer1 = pVirtualMachineState->PopInteger();
 
-  uint16_t characterValue = static_cast<uint16_t>( pInteger1->ToHostInt32() );
+  uint16_t characterValue = static_cast<uint16_t>( integer1 );
 
-  //boost::intrusive_ptr<JavaChar> pFinalChar = new JavaChar( JavaChar::FromUInt16( characterValue & 0x00FF ) );
-  boost::intrusive_ptr<JavaChar> pFinalChar = new JavaChar( JavaChar::FromUInt16( characterValue & 0xFFFF ) );
-  /*
-  #ifdef _DEBUG
-    if ( pFinalChar->ToUInt16() > UCHAR_MAX )
-    {
-      _asm int 3;
-    }
-  #endif // _DEBUG
-  */
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromChar( *pFinalChar ) ) );
+  pVirtualMachineState->PushInteger( characterValue );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeShiftIntegerLeft( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -4670,7 +5115,7 @@ void BasicExecutionEngine::ExecuteOpCodeShiftIntegerLeft( const std::shared_ptr<
   int32_t value2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int32_t value1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( value1 << ( value2 & 0x1F ) ) ) );
+  pVirtualMachineState->PushInteger( value1 << ( value2 & 0x1F ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeShiftIntegerRightArithmetic( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -4678,7 +5123,7 @@ void BasicExecutionEngine::ExecuteOpCodeShiftIntegerRightArithmetic( const std::
   int32_t value2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int32_t value1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( value1 >> ( value2 & 0x1F ) ) ) );
+  pVirtualMachineState->PushInteger( value1 >> ( value2 & 0x1F ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeShiftIntegerRightLogical( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -4702,7 +5147,7 @@ void BasicExecutionEngine::ExecuteOpCodeShiftIntegerRightLogical( const std::sha
 
   JVMX_ASSERT( result == ( ( uint32_t )value1 ) >> value2 );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( result ) ) );
+  pVirtualMachineState->PushInteger( result );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -4712,41 +5157,53 @@ void BasicExecutionEngine::ExecuteOpCodeShiftIntegerRightLogical( const std::sha
 #endif // _DEBUG
 }
 
-bool BasicExecutionEngine::DoesClassImplementInterface( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<JavaClass> pClass, boost::intrusive_ptr<JavaString> nameOfInterface )
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeInterfaceMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  for ( size_t i = 0; i < pClass->GetInterfacesCount(); ++ i )
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
+  ConstantPoolIndex methodIndex = ReadIndex( pVirtualMachineState );
+  uint8_t count = ReadByteUnsigned( pVirtualMachineState );
+  ReadByteUnsigned( pVirtualMachineState );
+
+  std::shared_ptr<ConstantPoolEntry> pConstant = pVirtualMachineState->GetConstantFromCurrentClass( methodIndex );
+  if ( pConstant->GetType() != e_ConstantPoolEntryTypeInterfaceMethodReference )
   {
-    if ( pClass->GetInterfaceName( i ) == *nameOfInterface )
-    {
-      return true;
-    }
+    throw InvalidStateException( __FUNCTION__ " - Expected Method reference." );
   }
 
-  if ( nullptr != pClass->GetSuperClass() )
+  // The method is still selected on the class of the object each time, so resolving it on the interface here only
+  // serves to cache the reference and its argument count for the quick form.
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, methodIndex );
+  if ( nullptr != pResolved )
   {
-    return DoesClassImplementInterface( pVirtualMachineState, ResolveClass( pVirtualMachineState, *pClass->GetSuperClass()->GetName() ), nameOfInterface );
+    QuickenInstruction( pVirtualMachineState, programCounter, e_JavaOpCodes::InvokeInterfaceQuick );
+    return InvokeInterfaceMethod( pVirtualMachineState, pResolved->m_pMethodReference, pResolved->m_ArgumentCount, pResolved->m_pMethod.get(), GetInlineCache( pVirtualMachineState, programCounter ) );
   }
 
-  return false;
+  std::shared_ptr<ConstantPoolMethodReference> pMethodRef = pConstant->AsMethodReference();
+
+  return InvokeInterfaceMethod( pVirtualMachineState, pMethodRef, TypeParser::ParseMethodType( *pMethodRef->GetType() ).parameters.size(), nullptr, nullptr );
 }
 
-e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeInterfaceMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeInterfaceMethodQuick( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
+  uintptr_t programCounter = pVirtualMachineState->GetProgramCounter() - 1;
+
   ConstantPoolIndex methodIndex = ReadIndex( pVirtualMachineState );
-  uint8_t count = ReadByteUnsigned( pVirtualMachineState );
-  ReadByteUnsigned( pVirtualMachineState );
+  pVirtualMachineState->AdvanceProgramCounter( 2 ); // count, and a zero byte
 
-  std::shared_ptr<ConstantPoolEntry> pConstant = pVirtualMachineState->GetConstantFromCurrentClass( methodIndex );
-  if ( pConstant->GetType() != e_ConstantPoolEntryTypeInterfaceMethodReference )
+  const ResolvedConstantPoolEntry *pResolved = ResolveMethodReference( pVirtualMachineState, methodIndex );
+  if ( nullptr == pResolved )
   {
-    throw InvalidStateException( __FUNCTION__ " - Expected Method reference." );
+    throw InvalidStateException( __FUNCTION__ " - Could not resolve method." );
   }
 
-  std::shared_ptr<ConstantPoolMethodReference> pMethodRef = pConstant->AsMethodReference();
-
-  auto params = TypeParser::ParseMethodType( *pMethodRef->GetType() );
+  return InvokeInterfaceMethod( pVirtualMachineState, pResolved->m_pMethodReference, pResolved->m_ArgumentCount, pResolved->m_pMethod.get(), GetInlineCache( pVirtualMachineState, programCounter ) );
+}
 
-  boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pVirtualMachineState->PeekOperandFromBack( static_cast< uint8_t >( params.parameters.size() ) + 1 ) );
+e_IncreaseCallStackDepth BasicExecutionEngine::InvokeInterfaceMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const std::shared_ptr<ConstantPoolMethodReference> &pMethodRef, size_t argumentCount, const MethodInfo *pResolvedMethod, InlineCache *pInlineCache )
+{
+  boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pVirtualMachineState->PeekOperandFromBack( static_cast< uint8_t >( argumentCount ) + 1 ) );
   if ( nullptr == pObject )
   {
 #if defined (_DEBUG)
@@ -4770,7 +5227,26 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeInterfaceMetho
     return e_IncreaseCallStackDepth::No;
   }
 
-  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->ResolveMethodOnClass( pObject->GetContainedObject()->GetClass()->GetName(), pMethodRef.get() );
+  const JavaClass *pReceiverClass = pObject->GetContainedObject()->GetClass().get();
+  std::shared_ptr<MethodInfo> pMethodInfo = FindSelectedMethod( pInlineCache, pReceiverClass );
+  if ( nullptr == pMethodInfo )
+  {
+    if ( nullptr != pResolvedMethod )
+    {
+      pMethodInfo = pReceiverClass->SelectInterfaceMethod( *pResolvedMethod );
+    }
+
+    if ( nullptr == pMethodInfo )
+    {
+      pMethodInfo = pVirtualMachineState->ResolveMethodOnClass( pObject->GetContainedObject()->GetClass()->GetName(), pMethodRef.get() );
+    }
+
+    if ( nullptr != pMethodInfo )
+    {
+      AddSelectedMethod( pInlineCache, pReceiverClass, pMethodInfo );
+    }
+  }
+
   if ( nullptr == pMethodInfo )
   {
 #if defined (_DEBUG)
@@ -4794,14 +5270,11 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteOpCodeInvokeInterfaceMetho
   }
 #endif // _DEBUG
 
-  return ExecuteVirtualMethodInternal( pVirtualMachineState, pMethodInfo, pObject, paramArray, e_MethodAlreadyIdentified::Yes );
+  return ExecuteVirtualMethodInternal( pVirtualMachineState, pMethodInfo, pObject, paramArray, e_MethodAlreadyIdentified::Yes, nullptr );
 }
 
-e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<ConstantPoolEntry> pConstant )
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<MethodInfo> pMethodInfo, InlineCache *pInlineCache )
 {
-  std::shared_ptr<ConstantPoolMethodReference> pMethodRef = pConstant->AsMethodReference();
-  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->ResolveMethodOnClass( pMethodRef->GetClassName(), pMethodRef.get() );
-
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
   {
@@ -4809,18 +5282,6 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethod( const std::
   }
 #endif
 
-  if ( nullptr == pMethodInfo )
-  {
-#if defined (_DEBUG)
-    pVirtualMachineState->LogCallStack();
-    pVirtualMachineState->LogOperandStack();
-    pVirtualMachineState->LogLocalVariables();
-#endif
-
-    GetLogger()->LogError( "Could not resolve method (%s) on class: (%s).", pMethodInfo->GetName()->ToUtf8String().c_str(), pMethodInfo->GetClass()->GetName()->ToUtf8String().c_str() );
-    throw InvalidStateException( __FUNCTION__ " - Could not resolve method on class." );
-  }
-
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
   {
@@ -4833,7 +5294,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethod( const std::
 
   if ( paramArray[ 0 ]->GetVariableType() == e_JavaVariableTypes::Object )
   {
-    return ExecuteVirtualMethodForObject( pVirtualMachineState, paramArray, pMethodInfo );
+    return ExecuteVirtualMethodForObject( pVirtualMachineState, paramArray, pMethodInfo, pInlineCache );
   }
   else if ( paramArray[ 0 ]->GetVariableType() == e_JavaVariableTypes::Array )
   {
@@ -4859,6 +5320,13 @@ void BasicExecutionEngine::ExecuteVirtualMethodForArray( const std::shared_ptr<I
     throw InvalidStateException( __FUNCTION__ " - Expected class name to be Object." );
   }
 
+  // Arrays only have the methods of java/lang/Object, so they dispatch through its vtable.
+  std::shared_ptr<MethodInfo> pSelectedMethod = pMethodInfo->GetClass()->SelectVirtualMethod( *pMethodInfo );
+  if ( nullptr != pSelectedMethod )
+  {
+    pMethodInfo = pSelectedMethod;
+  }
+
   if ( *pMethodInfo->GetName() == JavaString::FromCString( "clone" ) )
   {
     std::shared_ptr<IThreadManager> pThreadManager = GlobalCatalog::GetInstance().Get( "ThreadManager" );
@@ -4877,7 +5345,7 @@ void BasicExecutionEngine::ExecuteVirtualMethodForArray( const std::shared_ptr<I
 #endif // _DEBUG
 }
 
-e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodForObject( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, std::shared_ptr<MethodInfo> pMethodInfo )
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodForObject( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, std::shared_ptr<MethodInfo> pMethodInfo, InlineCache *pInlineCache )
 {
   boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( paramArray[ 0 ] );
 
@@ -4899,16 +5367,16 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodForObject( co
   }
 #endif // _DEBUG
 
-  return ExecuteVirtualMethodInternal( pVirtualMachineState, pMethodInfo, pObject, paramArray, e_MethodAlreadyIdentified::No );
+  return ExecuteVirtualMethodInternal( pVirtualMachineState, pMethodInfo, pObject, paramArray, e_MethodAlreadyIdentified::No, pInlineCache );
 }
 
 void BasicExecutionEngine::ExecuteOpCodePushShortConstant( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   int16_t value = ReadShort( pVirtualMachineState );
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromShort( JavaShort::FromHostInt16( value ) ) ) );
+  pVirtualMachineState->PushInteger( value );
 }
 
-e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<MethodInfo> &pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, e_MethodAlreadyIdentified methodAlreadyIdentified )
+e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, std::shared_ptr<MethodInfo> &pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, e_MethodAlreadyIdentified methodAlreadyIdentified, InlineCache *pInlineCache )
 {
   if ( pMethodInfo->IsProtected() )
   {
@@ -4920,7 +5388,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( con
       if ( pVirtualMachineState->GetCurrentClass()->GetPackageName() != pMethodInfo->GetPackageName() )
       {
         // then the class of *objectref* must be either the current class or a subclass of the current class.
-        if ( !IsInstanceOf( pVirtualMachineState, pVirtualMachineState->GetCurrentClass()->GetName(), pObject->GetContainedObject()->GetClass()->GetName() ) )
+        if ( !IsSubtypeOf( pVirtualMachineState, pObject->GetContainedObject()->GetClass().get(), pVirtualMachineState->GetCurrentClass().get() ) )
         {
           throw InvalidStateException( __FUNCTION__ " - Expected object reference to be of the current class or a subclass." );
         }
@@ -4937,12 +5405,21 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( con
   {
     if ( e_MethodAlreadyIdentified::No == methodAlreadyIdentified )
     {
-      pMethodInfo = IdentifyVirtualMethodToCall( pVirtualMachineState, pMethodInfo, pObject );
-      if ( nullptr == pMethodInfo )
+      const JavaClass *pReceiverClass = pObject->GetContainedObject()->GetClass().get();
+      std::shared_ptr<MethodInfo> pSelectedMethod = FindSelectedMethod( pInlineCache, pReceiverClass );
+      if ( nullptr == pSelectedMethod )
       {
-        ThrowJavaException( pVirtualMachineState, c_JavaAbstractMethodErrorException );
-        return e_IncreaseCallStackDepth::No;
+        pSelectedMethod = IdentifyVirtualMethodToCall( pVirtualMachineState, pMethodInfo, pObject );
+        if ( nullptr == pSelectedMethod )
+        {
+          ThrowJavaException( pVirtualMachineState, c_JavaAbstractMethodErrorException );
+          return e_IncreaseCallStackDepth::No;
+        }
+
+        AddSelectedMethod( pInlineCache, pReceiverClass, pSelectedMethod );
       }
+
+      pMethodInfo = pSelectedMethod;
     }
 
     try
@@ -4961,7 +5438,8 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( con
           }
 #endif // _DEBUG
 
-        pVirtualMachineState->PushMonitor( pObject->GetContainedObject()->MonitorEnter( pMethodInfo->GetFullName().ToUtf8String().c_str() ) );
+        pObject->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+        pVirtualMachineState->PushMonitor( pObject );
       }
 
       if ( !pMethodInfo->IsNative() )
@@ -4975,7 +5453,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( con
 #endif
 
         //If the method is not native, the nargs argument values and objectref are popped from the operand stack.
-        pVirtualMachineState->PushState( *( pMethodInfo->GetClass()->GetName() ), *( pMethodInfo->GetName() ), *( pMethodInfo->GetType() ), pMethodInfo );
+        pVirtualMachineState->PushState( pMethodInfo );
         pVirtualMachineState->SetupLocalVariables( pMethodInfo, pObject, paramArray );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
@@ -5035,7 +5513,7 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( con
 
         if ( pMethodInfo->IsSynchronised() )
         {
-          pVirtualMachineState->PopMonitor()->Unlock( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+          pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
         }
         return e_IncreaseCallStackDepth::No;
       }
@@ -5071,23 +5549,9 @@ e_IncreaseCallStackDepth BasicExecutionEngine::ExecuteVirtualMethodInternal( con
 void BasicExecutionEngine::CheckCastForObjects( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, boost::intrusive_ptr<IJavaVariableType> pOperand, std::shared_ptr<JavaClass> pResolvedClass )
 {
   boost::intrusive_ptr<ObjectReference> pOperandAsObject = boost::dynamic_pointer_cast<ObjectReference>( pOperand );
-  if ( !pResolvedClass->IsInterface() )
-  {
-    if ( !IsInstanceOf( pVirtualMachineState, pResolvedClass->GetName(), pOperandAsObject->GetContainedObject()->GetClass()->GetName() ) )
-    {
-      ThrowJavaException( pVirtualMachineState, c_JavaClassCastException );
-      return;
-    }
-  }
-  else
+  if ( !IsSubtypeOf( pVirtualMachineState, pOperandAsObject->GetContainedObject()->GetClass().get(), pResolvedClass.get() ) )
   {
-    if ( DoesClassImplementInterface( pVirtualMachineState, pOperandAsObject->GetContainedObject()->GetClass(), pResolvedClass->GetName() ) )
-    {
-      return;
-    }
-
     ThrowJavaException( pVirtualMachineState, c_JavaClassCastException );
-    return;
   }
 }
 
@@ -5144,13 +5608,13 @@ void BasicExecutionEngine::CheckCastForArrays( const std::shared_ptr<IVirtualMac
     }
     else
     {
-      if ( 0 == pOperandAsArray->GetContainedArray()->GetNumberOfElements() || e_JavaVariableTypes::NullReference == pOperandAsArray->GetContainedArray()->At( 0 )->GetVariableType() )
+      if ( 0 == pOperandAsArray->GetContainedArray()->GetNumberOfElements() || 0 == pOperandAsArray->GetContainedArray()->GetElementAt<ObjectIndexT>( 0 ) )
       {
         // We don't know what's inside this array, but since it's empty it can still hold any object type.
         return;
       }
 
-      const ObjectReference *pArrayElement = dynamic_cast<const ObjectReference *>( pOperandAsArray->GetContainedArray()->At( 0 ) );
+      boost::intrusive_ptr<ObjectReference> pArrayElement = new ObjectReference( pOperandAsArray->GetContainedArray()->GetElementAt<ObjectIndexT>( 0 ) );
       JVMX_ASSERT( nullptr != pArrayElement );
       if ( IsInstanceOf( pVirtualMachineState, pClassName, pArrayElement->GetContainedObject()->GetClass()->GetName() ) )
       {
@@ -5167,12 +5631,12 @@ void BasicExecutionEngine::ExecuteOpCodeIntegerDivide( const std::shared_ptr<IVi
   int integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 / integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 / integer2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodePushLong( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, int64_t value )
 {
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( value ) ) );
+  pVirtualMachineState->PushLong( value );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeLoadLongFromLocalWithIndex( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -5180,7 +5644,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadLongFromLocalWithIndex( const std::s
   ExecuteOpCodeLoadLongFromLocal( pVirtualMachineState, ReadByteUnsigned( pVirtualMachineState ) );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeLoadLongFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeLoadLongFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
 #if defined (_DEBUG) && defined (JVMX_LOG_VERBOSE)
     if (pVirtualMachineState->HasUserCodeStarted())
@@ -5189,41 +5653,27 @@ void BasicExecutionEngine::ExecuteOpCodeLoadLongFromLocal( const std::shared_ptr
     }
 #endif // _DEBUG) && defined (JVMX_LOG_VERBOSE)
 
-  boost::intrusive_ptr<IJavaVariableType> pLocalVariable = pVirtualMachineState->GetLocalVariable( localVariableIndex );
-  boost::intrusive_ptr<JavaLong> pLongValue = nullptr;
-
-  if ( e_JavaVariableTypes::Long == pLocalVariable->GetVariableType() )
-  {
-    pLongValue = boost::dynamic_pointer_cast<JavaLong>( pVirtualMachineState->GetLocalVariable( localVariableIndex ) );
-  }
-  else if ( pLocalVariable->IsIntegerCompatible() )
-  {
-    boost::intrusive_ptr<JavaInteger> pIntValue = TypeParser::UpCastToInteger( pLocalVariable.get() );
-    pLongValue = new JavaLong( JavaLong::FromHostInt64( pIntValue->ToHostInt32() ) );
-  }
-  else
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected long in local variable." );
-  }
+  // Integer compatible values are widened, as before.
+  int64_t longValue = pVirtualMachineState->GetLocalLong( localVariableIndex );
 
 #if defined(_DEBUG) && defined (JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
   {
-      GetLogger()->LogDebug("Loading Long %s from local variable %d", pLongValue->ToString().ToUtf8String().c_str(), localVariableIndex);
+      GetLogger()->LogDebug("Loading Long %lld from local variable %d", longValue, localVariableIndex);
   }
 #endif // _DEBUG
-  pVirtualMachineState->PushOperand( pLongValue );
+  pVirtualMachineState->PushLong( longValue );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeLoadByteOrBooleanFromArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
-  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  int32_t index = pVirtualMachineState->PopInteger();
+  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected Array on the operand stack." );
   }
@@ -5240,7 +5690,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadByteOrBooleanFromArray( const std::s
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || pIndex->ToHostInt32() > static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
+  if ( index < 0 || index >= static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
     return;
@@ -5251,22 +5701,13 @@ void BasicExecutionEngine::ExecuteOpCodeLoadByteOrBooleanFromArray( const std::s
     throw InvalidStateException( __FUNCTION__ " - Expected boolean or byte in the array." );
   }
 
-  IJavaVariableType *pArrayValueAtIndex = pArray->GetContainedArray()->At( pIndex->ToHostInt32() );
-  JVMX_ASSERT( pArrayValueAtIndex->IsIntegerCompatible() );
-
-  if ( e_JavaVariableTypes::Bool == pArrayValueAtIndex->GetVariableType() )
+  if ( e_JavaArrayTypes::Boolean == pArray->GetContainedArray()->GetContainedType() )
   {
-    JavaBool *pValueAsBool = dynamic_cast<JavaBool *>( pArrayValueAtIndex );
-    boost::intrusive_ptr<JavaInteger> valueAsInt = new JavaInteger( JavaInteger::FromHostInt32( pValueAsBool->ToBool() ? 1 : 0 ) );
-
-    pVirtualMachineState->PushOperand( valueAsInt );
+    pVirtualMachineState->PushInteger( pArray->GetContainedArray()->GetElementAt<bool>( index ) ? 1 : 0 );
   }
   else
   {
-    JavaByte *pValueAsByte = dynamic_cast<JavaByte *>( pArrayValueAtIndex );
-    boost::intrusive_ptr<JavaInteger> valueAsInt = new JavaInteger( JavaInteger::FromHostInt32( static_cast<int32_t>( pValueAsByte->ToHostInt8() ) ) );
-
-    pVirtualMachineState->PushOperand( valueAsInt );
+    pVirtualMachineState->PushInteger( pArray->GetContainedArray()->GetElementAt<int8_t>( index ) );
   }
 }
 
@@ -5282,7 +5723,7 @@ void BasicExecutionEngine::ExecuteOpCodeXORInteger( const std::shared_ptr<IVirtu
   int integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 ^ integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 ^ integer2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -5460,7 +5901,7 @@ void BasicExecutionEngine::ExecuteOpCodeConvertIntegerToByte( const std::shared_
 
   int32_t value = ConvertIntegerToByte( pInteger1 );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( value ) ) );
+  pVirtualMachineState->PushInteger( value );
 }
 
 void BasicExecutionEngine::StoreIntoArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, boost::intrusive_ptr< JavaInteger > pValue )
@@ -5489,9 +5930,10 @@ void BasicExecutionEngine::StoreIntoArray( const std::shared_ptr<IVirtualMachine
     ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
   }
 
-  if ( pIndex->ToHostInt32() < 0 || static_cast< size_t >( pIndex->ToHostInt32() ) > pArray->GetContainedArray()->GetNumberOfElements() )
+  if ( pIndex->ToHostInt32() < 0 || static_cast< size_t >( pIndex->ToHostInt32() ) >= pArray->GetContainedArray()->GetNumberOfElements() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
+    return;
   }
 
   pArray->GetContainedArray()->SetAt( *pIndex, *pValue );
@@ -5522,18 +5964,29 @@ std::shared_ptr<ExceptionTableEntry> BasicExecutionEngine::FindLocalExceptionTab
     throw InvalidStateException( __FUNCTION__ " - Expected code attributes to be non-null." );
   }
 
+  const JavaClass *pExceptionClass = pVirtualMachineState->GetException()->GetContainedObject()->GetClass().get();
+
   const ExceptionTable &exceptionTable = pCodeAttributes->GetExceptionTable();
-  for ( auto it : exceptionTable )
+  for ( const auto &it : exceptionTable )
   {
+    if ( programCounterBeforeLastInstruction < it.GetStartPosition() ||
+         programCounterBeforeLastInstruction >= it.GetEndPosition() )
+    {
+      continue;
+    }
+
     std::shared_ptr<ConstantPoolClassReference> pCatchType = it.GetCatchType();
-    if ( nullptr == pCatchType ||
-         IsInstanceOf( pVirtualMachineState, pCatchType->GetClassName(), pVirtualMachineState->GetException()->GetContainedObject()->GetClass()->GetName() ) )
+    if ( nullptr == pCatchType )
     {
-      if ( programCounterBeforeLastInstruction >= it.GetStartPosition() &&
-           programCounterBeforeLastInstruction < it.GetEndPosition() )
-      {
-        return std::make_shared<ExceptionTableEntry>( it );
-      }
+      return std::make_shared<ExceptionTableEntry>( it );
+    }
+
+    // Every superclass of the exception's class was loaded when the exception was created, so a catch type that has not
+    // been loaded cannot match.
+    std::shared_ptr<JavaClass> pCatchClass = GetClassLibrary()->FindClass( *pCatchType->GetClassName() );
+    if ( nullptr != pCatchClass && IsSubtypeOf( pVirtualMachineState, pExceptionClass, pCatchClass.get() ) )
+    {
+      return std::make_shared<ExceptionTableEntry>( it );
     }
   }
 
@@ -5568,7 +6021,7 @@ void BasicExecutionEngine::CatchException( const std::shared_ptr<IVirtualMachine
   JVMX_ASSERT( adjustment < 0xF000 );
 
   // the operand stack of the current frame is cleared,
-  RewindOperandStack( pVirtualMachineState, pEntry->GetStartPosition() ); // Rewindin must happen first, because we use the current PC.
+  RewindOperandStack( pVirtualMachineState );
 
   // If an exception handler that matches objectref is found, it contains
   // the location of the code intended to handle this exception.The pc
@@ -5587,7 +6040,7 @@ void BasicExecutionEngine::CatchException( const std::shared_ptr<IVirtualMachine
   pVirtualMachineState->ResetException();
 }
 
-void BasicExecutionEngine::RewindOperandStack( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, size_t exceptionStartRegion )
+void BasicExecutionEngine::RewindOperandStack( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
     if (pVirtualMachineState->HasUserCodeStarted())
@@ -5597,7 +6050,7 @@ void BasicExecutionEngine::RewindOperandStack( const std::shared_ptr<IVirtualMac
     }
 #endif // defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
 
-  size_t numberOfFieldsToClear = pVirtualMachineState->CalculateNumberOfStackItemsToClear( exceptionStartRegion );
+  size_t numberOfFieldsToClear = pVirtualMachineState->CalculateNumberOfStackItemsToClear();
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -5639,7 +6092,7 @@ void BasicExecutionEngine::ExecuteOpCodeLongComparison( const std::shared_ptr<IV
     result = 0;
   }
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( result ) ) );
+  pVirtualMachineState->PushInteger( result );
 }
 
 void BasicExecutionEngine::ExecuteOpCodePushDoubleOrLongFromConstantPoolWide( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -5718,7 +6171,7 @@ void BasicExecutionEngine::ExecuteOpCodeReturnLong( const std::shared_ptr<IVirtu
   std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
   if ( pMethodInfo->IsSynchronised() )
   {
-    pVirtualMachineState->PopMonitor()->Unlock( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+    pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
   }
 
   if ( pVirtualMachineState->HasExceptionOccurred() )
@@ -5754,7 +6207,7 @@ void BasicExecutionEngine::ExecuteOpCodeXORLong( const std::shared_ptr<IVirtualM
   int64_t long2 = GetLongFromOperandStack( pVirtualMachineState );
   int64_t long1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( long1 ^ long2 ) ) );
+  pVirtualMachineState->PushLong( long1 ^ long2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -5776,7 +6229,7 @@ void BasicExecutionEngine::ExecuteOpCodeANDLong( const std::shared_ptr<IVirtualM
   int64_t long2 = GetLongFromOperandStack( pVirtualMachineState );
   int64_t long1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( long1 & long2 ) ) );
+  pVirtualMachineState->PushLong( long1 & long2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -5798,7 +6251,7 @@ void BasicExecutionEngine::ExecuteOpCodeLongMultiply( const std::shared_ptr<IVir
   int64_t long2 = GetLongFromOperandStack( pVirtualMachineState );
   int64_t long1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( long1 * long2 ) ) );
+  pVirtualMachineState->PushLong( long1 * long2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -5820,7 +6273,7 @@ void BasicExecutionEngine::ExecuteOpCodeLongAdd( const std::shared_ptr<IVirtualM
   int64_t long2 = GetLongFromOperandStack( pVirtualMachineState );
   int64_t long1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( long1 + long2 ) ) );
+  pVirtualMachineState->PushLong( long1 + long2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -5835,7 +6288,7 @@ void BasicExecutionEngine::ExecuteOpCodeShiftLongRight( const std::shared_ptr<IV
   int32_t value2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int64_t value1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( value1 >> ( value2 & 0x1F ) ) ) );
+  pVirtualMachineState->PushLong( value1 >> ( value2 & 0x1F ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeShiftLongLeft( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -5843,51 +6296,38 @@ void BasicExecutionEngine::ExecuteOpCodeShiftLongLeft( const std::shared_ptr<IVi
   int32_t value2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int64_t value1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( value1 << ( value2 & 0x1F ) ) ) );
+  pVirtualMachineState->PushLong( value1 << ( value2 & 0x1F ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertLongToInteger( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   int64_t value1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( value1 & 0xFFFFFFFF ) ) );
+  pVirtualMachineState->PushInteger( value1 & 0xFFFFFFFF );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertIntegerToLong( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   int32_t value1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( value1 & 0xFFFFFFFF ) ) );
+  pVirtualMachineState->PushLong( value1 & 0xFFFFFFFF );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertLongToDouble( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
   int64_t value1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostInt64( value1 ) ) );
+  pVirtualMachineState->PushDouble( static_cast<double>( value1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDoubleDivide( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr<IJavaVariableType> pOperand2 = pVirtualMachineState->PopOperand();
-  boost::intrusive_ptr<IJavaVariableType> pOperand1 = pVirtualMachineState->PopOperand();
-
-  if ( e_JavaVariableTypes::Double != pOperand2->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected double as second parameter." );
-  }
-
-  if ( e_JavaVariableTypes::Double != pOperand1->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected double as first parameter." );
-  }
-
-  double value1 = boost::dynamic_pointer_cast<JavaDouble>( pOperand1 )->ToHostDouble();
-  double value2 = boost::dynamic_pointer_cast<JavaDouble>( pOperand2 )->ToHostDouble();
+  double value2 = pVirtualMachineState->PopDouble();
+  double value1 = pVirtualMachineState->PopDouble();
 
   double result = value1 / value2;
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( result ) ) );
+  pVirtualMachineState->PushDouble( result );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeReturnDouble( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -5899,7 +6339,7 @@ void BasicExecutionEngine::ExecuteOpCodeReturnDouble( const std::shared_ptr<IVir
   std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
   if ( pMethodInfo->IsSynchronised() )
   {
-    pVirtualMachineState->PopMonitor()->Unlock( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+    pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
   }
 
   if ( pVirtualMachineState->HasExceptionOccurred() )
@@ -5923,9 +6363,9 @@ void BasicExecutionEngine::ExecuteOpCodeReturnDouble( const std::shared_ptr<IVir
 #endif // _DEBUG
 }
 
-void BasicExecutionEngine::ExecuteOpCodeStoreDoubleInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeStoreDoubleInLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  if ( e_JavaVariableTypes::Double != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Double != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected double on the operand stack." );
   }
@@ -5945,7 +6385,7 @@ void BasicExecutionEngine::ExecuteOpCodeStoreDoubleInLocal( const std::shared_pt
   }
 #endif
 
-  pVirtualMachineState->SetLocalVariable( localVariableIndex, pVirtualMachineState->PopOperand() );
+  pVirtualMachineState->StoreOperandInLocalVariable( localVariableIndex );
   pVirtualMachineState->SetLocalVariable( localVariableIndex + 1, new ObjectReference( nullptr ) );
 
 #if defined(_DEBUG) && defined(JVMX_LOG_VERBOSE)
@@ -5967,29 +6407,29 @@ void BasicExecutionEngine::ExecuteOpCodeLoadDoubleFromLocalWithIndex( const std:
   ExecuteOpCodeLoadDoubleFromLocal( pVirtualMachineState, ReadByteUnsigned( pVirtualMachineState ) );
 }
 
-void BasicExecutionEngine::ExecuteOpCodeLoadDoubleFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint8_t localVariableIndex )
+void BasicExecutionEngine::ExecuteOpCodeLoadDoubleFromLocal( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, uint16_t localVariableIndex )
 {
-  if ( e_JavaVariableTypes::Double != pVirtualMachineState->GetLocalVariable( localVariableIndex )->GetVariableType() )
+  if ( e_JavaVariableTypes::Double != pVirtualMachineState->GetLocalVariableType( localVariableIndex ) )
   {
     pVirtualMachineState->LogLocalVariables();
     throw InvalidStateException( __FUNCTION__ " - Expected Double in local variable." );
   }
 
-  pVirtualMachineState->PushOperand( pVirtualMachineState->GetLocalVariable( localVariableIndex ) );
+  pVirtualMachineState->PushDouble( pVirtualMachineState->GetLocalDouble( localVariableIndex ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeNegateDouble( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  if ( e_JavaVariableTypes::Double != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Double != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected double on the operand stack." );
   }
 
-  boost::intrusive_ptr<JavaDouble> pOperand = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
+  double operandValue = pVirtualMachineState->PopDouble();
 
-  double negatedValue = ( - pOperand->ToHostDouble() ); // Apply operator -()
+  double negatedValue = ( - operandValue ); // Apply operator -()
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( negatedValue ) ) );
+  pVirtualMachineState->PushDouble( negatedValue );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeANDInteger( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -6004,7 +6444,7 @@ void BasicExecutionEngine::ExecuteOpCodeANDInteger( const std::shared_ptr<IVirtu
   int32_t int2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int32_t int1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( int1 & int2 ) ) );
+  pVirtualMachineState->PushInteger( int1 & int2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -6057,12 +6497,12 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromArray( const std::shared_
     }
 #endif
 
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t index = pVirtualMachineState->PopInteger();
 
 #if 0
   GetLogger()->LogDebug("Before");
@@ -6072,7 +6512,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromArray( const std::shared_
   GetLogger()->LogDebug("After");
 #endif
 
-  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected Array on the operand stack." );
   }
@@ -6090,7 +6530,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromArray( const std::shared_
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || pIndex->ToHostInt32() > static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
+  if ( index < 0 || index >= static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
     return;
@@ -6098,13 +6538,7 @@ void BasicExecutionEngine::ExecuteOpCodeLoadIntegerFromArray( const std::shared_
 
   JVMX_ASSERT( pArray->GetContainedArray()->GetContainedType() == e_JavaArrayTypes::Integer );
 
-  const JavaInteger *pResult = dynamic_cast<const JavaInteger *>( pArray->GetContainedArray()->At( pIndex->ToHostInt32() ) );
-  if ( nullptr == pResult )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Could not convert from array contained type to integer." );
-  }
-
-  pVirtualMachineState->PushOperand( new JavaInteger( *pResult ) );
+  pVirtualMachineState->PushInteger( pArray->GetContainedArray()->GetElementAt<int32_t>( index ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeReturnFloat( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -6116,7 +6550,7 @@ void BasicExecutionEngine::ExecuteOpCodeReturnFloat( const std::shared_ptr<IVirt
   std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
   if ( pMethodInfo->IsSynchronised() )
   {
-    pVirtualMachineState->PopMonitor()->Unlock( pMethodInfo->GetFullName().ToUtf8String().c_str() );
+    pVirtualMachineState->PopMonitor().Unlock( __FUNCTION__ );
   }
 
   if ( pVirtualMachineState->HasExceptionOccurred() )
@@ -6145,7 +6579,7 @@ void BasicExecutionEngine::ExecuteOpCodeLongSubtract( const std::shared_ptr<IVir
   int64_t integer2 = GetLongFromOperandStack( pVirtualMachineState );
   int64_t integer1 = GetLongFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaLong( JavaLong::FromHostInt64( integer1 - integer2 ) ) );
+  pVirtualMachineState->PushLong( integer1 - integer2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeORInteger( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -6153,7 +6587,7 @@ void BasicExecutionEngine::ExecuteOpCodeORInteger( const std::shared_ptr<IVirtua
   int32_t integer2 = GetIntegerFromOperandStack( pVirtualMachineState );
   int32_t integer1 = GetIntegerFromOperandStack( pVirtualMachineState );
 
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( integer1 | integer2 ) ) );
+  pVirtualMachineState->PushInteger( integer1 | integer2 );
 }
 
 bool BasicExecutionEngine::IsCategoryTwoType( boost::intrusive_ptr<IJavaVariableType> pValue )
@@ -6168,74 +6602,40 @@ bool BasicExecutionEngine::IsCategoryOneType( boost::intrusive_ptr<IJavaVariable
 
 void BasicExecutionEngine::ExecuteOpCodeConvertDoubleToInt( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr<JavaDouble> pDouble = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pDouble )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be float type." );
-  }
+  double value = pVirtualMachineState->PopDouble();
 
-  boost::intrusive_ptr< JavaInteger > result = new JavaInteger( JavaInteger::FromDefault() );
-  if ( pDouble->IsNan() )
-  {
-    result = new JavaInteger( JavaInteger::FromHostInt32( 0 ) );
-  }
-  else
+  int32_t result = 0;
+  if ( !_isnan( value ) )
   {
-    result = new JavaInteger( JavaInteger::FromHostInt32( static_cast<int32_t>( pDouble->ToHostDouble() ) ) );
+    result = static_cast<int32_t>( value );
   }
 
-  pVirtualMachineState->PushOperand( result );
+  pVirtualMachineState->PushInteger( result );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeFloatDivide( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr<IJavaVariableType> pOperand2 = pVirtualMachineState->PopOperand();
-  boost::intrusive_ptr<IJavaVariableType> pOperand1 = pVirtualMachineState->PopOperand();
-
-  if ( e_JavaVariableTypes::Float != pOperand2->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected float as second parameter." );
-  }
-
-  if ( e_JavaVariableTypes::Float != pOperand1->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected float as first parameter." );
-  }
-
-  float value1 = boost::dynamic_pointer_cast<JavaFloat>( pOperand1 )->ToHostFloat();
-  float value2 = boost::dynamic_pointer_cast<JavaFloat>( pOperand2 )->ToHostFloat();
+  float value2 = pVirtualMachineState->PopFloat();
+  float value1 = pVirtualMachineState->PopFloat();
 
   float result = value1 / value2;
 
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostFloat( result ) ) );
+  pVirtualMachineState->PushFloat( result );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeConvertDoubleToFloat( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaDouble > pDouble1 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pDouble1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be double type." );
-  }
+  double double1 = pVirtualMachineState->PopDouble();
 
-  pVirtualMachineState->PushOperand( new JavaFloat( JavaFloat::FromHostDouble( static_cast<double>( pDouble1->ToHostDouble() ) ) ) );
+  pVirtualMachineState->PushFloat( static_cast<float>( static_cast<double>( double1 ) ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDoubleMultiply( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr<JavaDouble> pDouble2 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pDouble2 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be float type." );
-  }
-
-  boost::intrusive_ptr<JavaDouble> pDouble1 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pDouble1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected second operand to be float type." );
-  }
+  double double2 = pVirtualMachineState->PopDouble();
+  double double1 = pVirtualMachineState->PopDouble();
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( pDouble1->ToHostDouble() * pDouble2->ToHostDouble() ) ) );
+  pVirtualMachineState->PushDouble( double1 * double2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDoubleAdd( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -6246,23 +6646,10 @@ void BasicExecutionEngine::ExecuteOpCodeDoubleAdd( const std::shared_ptr<IVirtua
         pVirtualMachineState->LogOperandStack();
     }
 #endif // _DEBUG
-  boost::intrusive_ptr<IJavaVariableType> pOperand2 = pVirtualMachineState->PopOperand();
-  boost::intrusive_ptr<IJavaVariableType> pOperand1 = pVirtualMachineState->PopOperand();
-
-  if ( e_JavaVariableTypes::Double != pOperand2->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected a float on the operand stack." );
-  }
+  double value2 = pVirtualMachineState->PopDouble();
+  double value1 = pVirtualMachineState->PopDouble();
 
-  if ( e_JavaVariableTypes::Double != pOperand1->GetVariableType() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Expected a float on the operand stack." );
-  }
-
-  double value2 = boost::dynamic_pointer_cast<JavaDouble>( pOperand2 )->ToHostDouble();
-  double value1 = boost::dynamic_pointer_cast<JavaDouble>( pOperand1 )->ToHostDouble();
-
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( value1 + value2 ) ) );
+  pVirtualMachineState->PushDouble( value1 + value2 );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (pVirtualMachineState->HasUserCodeStarted())
@@ -6274,25 +6661,21 @@ void BasicExecutionEngine::ExecuteOpCodeDoubleAdd( const std::shared_ptr<IVirtua
 
 void BasicExecutionEngine::ExecuteOpCodeConvertFloatToDouble( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  boost::intrusive_ptr< JavaFloat > pFloat1 = boost::dynamic_pointer_cast<JavaFloat>( pVirtualMachineState->PopOperand() );
-  if ( nullptr == pFloat1 )
-  {
-    throw InvalidArgumentException( __FUNCTION__ " - Expected first operand to be float type." );
-  }
+  float float1 = pVirtualMachineState->PopFloat();
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( static_cast< double >( pFloat1->ToHostFloat() ) ) ) );
+  pVirtualMachineState->PushDouble( static_cast< double >( float1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeLoadFloatFromArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Integer != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected integer on the operand stack." );
   }
 
-  boost::intrusive_ptr< JavaInteger > pIndex = boost::dynamic_pointer_cast<JavaInteger>( pVirtualMachineState->PopOperand() );
+  int32_t index = pVirtualMachineState->PopInteger();
 
-  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperand()->GetVariableType() )
+  if ( e_JavaVariableTypes::Array != pVirtualMachineState->PeekOperandType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected Array on the operand stack." );
   }
@@ -6309,20 +6692,18 @@ void BasicExecutionEngine::ExecuteOpCodeLoadFloatFromArray( const std::shared_pt
     return;
   }
 
-  if ( pIndex->ToHostInt32() < 0 || pIndex->ToHostInt32() > static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
+  if ( index < 0 || index >= static_cast<int32_t>( pArray->GetContainedArray()->GetNumberOfElements() ) )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
     return;
   }
 
-  JavaFloat *pTempFloat = dynamic_cast<JavaFloat *>( pArray->GetContainedArray()->At( pIndex->ToHostInt32() ) );
-  if ( nullptr == pTempFloat )
+  if ( e_JavaArrayTypes::Float != pArray->GetContainedArray()->GetContainedType() )
   {
     throw InvalidStateException( __FUNCTION__ " - Expected float in array." );
   }
 
-  boost::intrusive_ptr<JavaFloat> pFloat = new JavaFloat( JavaFloat::FromHostFloat( pTempFloat->ToHostFloat() ) );
-  pVirtualMachineState->PushOperand( pFloat );
+  pVirtualMachineState->PushFloat( pArray->GetContainedArray()->GetElementAt<float>( index ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeStoreIntoFloatArray( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
@@ -6358,9 +6739,10 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntoFloatArray( const std::shared_p
     ThrowJavaException( pVirtualMachineState, c_JavaNullPointerExceptionException );
   }
 
-  if ( pIndex->ToHostInt32() < 0 || static_cast< size_t >( pIndex->ToHostInt32() ) > pArray->GetContainedArray()->GetNumberOfElements() )
+  if ( pIndex->ToHostInt32() < 0 || static_cast< size_t >( pIndex->ToHostInt32() ) >= pArray->GetContainedArray()->GetNumberOfElements() )
   {
     ThrowJavaException( pVirtualMachineState, c_JavaArrayIndexOutOfBoundsException );
+    return;
   }
 
   pArray->GetContainedArray()->SetAt( *pIndex, pValue.get() );
@@ -6368,20 +6750,20 @@ void BasicExecutionEngine::ExecuteOpCodeStoreIntoFloatArray( const std::shared_p
 
 void BasicExecutionEngine::ExecuteOpCodeDoubleComparisonL( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( CompareDoubleValues( pVirtualMachineState, -1 ) ) ) );
+  pVirtualMachineState->PushInteger( CompareDoubleValues( pVirtualMachineState, -1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDoubleComparisonG( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  pVirtualMachineState->PushOperand( new JavaInteger( JavaInteger::FromHostInt32( CompareDoubleValues( pVirtualMachineState, 1 ) ) ) );
+  pVirtualMachineState->PushInteger( CompareDoubleValues( pVirtualMachineState, 1 ) );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDoubleSubtract( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
 {
-  double double2 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() )->ToHostDouble();
-  double double1 = boost::dynamic_pointer_cast<JavaDouble>( pVirtualMachineState->PopOperand() )->ToHostDouble();
+  double double2 = pVirtualMachineState->PopDouble();
+  double double1 = pVirtualMachineState->PopDouble();
 
-  pVirtualMachineState->PushOperand( new JavaDouble( JavaDouble::FromHostDouble( double1 - double2 ) ) );
+  pVirtualMachineState->PushDouble( double1 - double2 );
 }
 
 void BasicExecutionEngine::ExecuteOpCodeDuplicateTopOperandx2( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
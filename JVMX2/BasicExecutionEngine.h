@@ -2,14 +2,21 @@
 #define _BASICEXECUTIONENGINE__H_
 
 #include <map>
+#include <mutex>
+#include <vector>
 #include <wallaroo/collaborator.h>
 
 class ExceptionTableEntry;
 class StackFrame;
+class ResolvedConstantPool;
+struct ResolvedConstantPoolEntry;
 
 #include "ImmediateReturnRequired.h"
 #include "IncreaseCallStackDepth.h"
 #include "MethodAlreadyIdentified.h"
+#include "JavaOpCodes.h"
+#include "InlineCache.h"
+#include "SuperTypeDisplay.h"
 
 #include "IExecutionEngine.h"
 
@@ -31,7 +38,12 @@ public:
 
   virtual std::shared_ptr<MethodInfo> IdentifyVirtualMethodToCall( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<MethodInfo> pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject ) JVMX_OVERRIDE;
 
-private:
+  virtual void LogStatistics( const std::shared_ptr<ILogger> &pLogger ) JVMX_OVERRIDE;
+
+protected:
+  // Executes at least one instruction. Derived engines override this to change how instructions are dispatched.
+  virtual e_ImmediateReturnRequired DispatchNextInstruction( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+
   uint16_t GetNextInstruction( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
   ConstantPoolIndex ReadIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -43,14 +55,29 @@ private:
   //int8_t ReadSignedByte( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   int32_t Read32BitOffset( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
-  std::shared_ptr<FieldInfo> ResolveField( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const JavaString &className, const JavaString &fieldName );
-
   std::shared_ptr<JavaClass> ResolveClass( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const JavaString &className );
 
   //std::shared_ptr<JavaClassFile> LoadClass( JavaString className );
 
-  // ClassName is returned
-  std::shared_ptr<MethodInfo> ResolveMethodReference( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t methodIndex, JavaString &className );
+  // The resolved constant pool of the class whose method is currently executing.
+  ResolvedConstantPool &GetCurrentResolvedConstantPool( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+
+  // These resolve on first use, and return the cached entry after that. nullptr is returned if the reference could not be
+  // resolved, in which case a Java exception may already have been thrown.
+  const ResolvedConstantPoolEntry *ResolveFieldReference( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, ConstantPoolIndex index );
+  const ResolvedConstantPoolEntry *ResolveMethodReference( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, ConstantPoolIndex index );
+
+  // Rewrites the instruction at programCounter in the current method to quickOpCode. Only call this once everything the
+  // quick form relies on has been resolved and stored.
+  void QuickenInstruction( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uintptr_t programCounter, e_JavaOpCodes quickOpCode );
+
+  // The inline cache for the virtual or interface call at programCounter in the current method, or nullptr if there is none.
+  InlineCache *GetInlineCache( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uintptr_t programCounter );
+  InlineCacheTable *GetInlineCacheTable( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const std::shared_ptr<MethodInfo> &pMethodInfo );
+
+  // Both accept a NULL inline cache. Megamorphic call sites always miss, and are left to the receiver's dispatch tables.
+  std::shared_ptr<MethodInfo> FindSelectedMethod( InlineCache *pInlineCache, const JavaClass *pReceiverClass );
+  void AddSelectedMethod( InlineCache *pInlineCache, const JavaClass *pReceiverClass, const std::shared_ptr<MethodInfo> &pSelectedMethod );
   //std::shared_ptr<MethodInfo> ResolveMethodOnClass( boost::intrusive_ptr<JavaString> pClassName, const ConstantPoolMethodReference * pMethodRef );
   std::shared_ptr<JavaClass> ResolveClassFromIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, ConstantPoolIndex index );
 
@@ -58,6 +85,12 @@ private:
   bool IsSuperClassOf( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, boost::intrusive_ptr<JavaString> pPossibleSuperClassName, boost::intrusive_ptr<JavaString> pDerivedClassName ) const;
   bool IsInstanceOf( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, boost::intrusive_ptr<JavaString> pPossibleSuperClassName, boost::intrusive_ptr<JavaString> pDerivedClassName ) const;
 
+  // True if pClass can be assigned to pPossibleSuperType, which may be a class or an interface. Any super types that
+  // have not been loaded yet are loaded first.
+  bool IsSubtypeOf( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const JavaClass *pClass, const JavaClass *pPossibleSuperType ) const;
+  const SuperTypeDisplay *GetSuperTypeDisplay( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const JavaClass *pClass ) const;
+  void LoadSuperTypes( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const JavaClass &javaClass ) const;
+
   static const char *TranslateOpCode( uint16_t opcode );
 
   int GetIntegerFromOperandStack( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState ) const;
@@ -72,15 +105,13 @@ private:
 
   bool AreTypesCompatibile( boost::intrusive_ptr<JavaString> referenceType, boost::intrusive_ptr<JavaString> valueType );
 
-  bool DoesClassImplementInterface( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<JavaClass> pClass, boost::intrusive_ptr<JavaString> nameOfInterface );
-
-  e_IncreaseCallStackDepth ExecuteVirtualMethod( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<ConstantPoolEntry> pConstant );
+  e_IncreaseCallStackDepth ExecuteVirtualMethod( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<MethodInfo> pMethodInfo, InlineCache *pInlineCache );
 
   void ExecuteVirtualMethodForArray( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, std::shared_ptr<MethodInfo> pMethodInfo );
 
-  e_IncreaseCallStackDepth ExecuteVirtualMethodForObject( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, std::shared_ptr<MethodInfo> pMethodInfo );
+  e_IncreaseCallStackDepth ExecuteVirtualMethodForObject( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, std::shared_ptr<MethodInfo> pMethodInfo, InlineCache *pInlineCache );
 
-  e_IncreaseCallStackDepth ExecuteVirtualMethodInternal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<MethodInfo> &pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, e_MethodAlreadyIdentified methodAlreadyIdentified );
+  e_IncreaseCallStackDepth ExecuteVirtualMethodInternal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<MethodInfo> &pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject, std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray, e_MethodAlreadyIdentified methodAlreadyIdentified, InlineCache *pInlineCache );
 
   void CheckCastForArrays( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, boost::intrusive_ptr<IJavaVariableType> pOperand, std::shared_ptr<JavaClass> pResolvedClass, bool isClassRefArray, boost::intrusive_ptr<JavaString> className );
   void CheckCastForObjects( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, boost::intrusive_ptr<IJavaVariableType> pOperand, std::shared_ptr<JavaClass> pResolvedClass );
@@ -90,6 +121,9 @@ private:
   std::shared_ptr<IClassLibrary> GetClassLibrary() const;
   std::shared_ptr<ILogger> GetLogger() const;
 
+  // Only called on method entry and on backward branches. Costs a single load unless a safepoint has been requested.
+  void PollSafepoint( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState );
+  void ServiceSafepoint( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState );
   void TryDoGarbageCollection( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const std::shared_ptr<IGarbageCollector> &pGarbageCollector );
 
   //boost::intrusive_ptr<ObjectReference> CreateMetodTypeFromMethodReference( std::shared_ptr<ConstantPoolMethodReference> pMethodReference );
@@ -112,7 +146,7 @@ private:
   std::shared_ptr<ExceptionTableEntry> FindLocalExceptionTableEntry( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, intptr_t programCounterBeforeLastInstruction );
 
   void CatchException( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, intptr_t programCounterBeforeLastInstruction );
-  void RewindOperandStack( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, size_t exceptionStartRegion );
+  void RewindOperandStack( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
   bool IsCategoryTwoType( boost::intrusive_ptr<IJavaVariableType> pValue );
   bool IsCategoryOneType( boost::intrusive_ptr<IJavaVariableType> pValue );
@@ -120,10 +154,10 @@ private:
   void InitialiseDimention( const std::vector<int32_t> &dimentionSizes, const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, boost::intrusive_ptr<ObjectReference> pFirstDimention, uint8_t dimentionCount, int32_t currentDimention, e_JavaArrayTypes finalDimentionType );
 
   // Op Codes
-private:
+protected:
   void ExecuteOpCodeGetStatic( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeLoadReferenceFromLocalWithSpecifiedIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeLoadReferenceFromLocalIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t index );
+  void ExecuteOpCodeLoadReferenceFromLocalIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t index );
   void ExecuteOpCodeReturnVoid( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   e_IncreaseCallStackDepth ExecuteOpCodeInvokeStatic( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeMonitorEnter( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -144,7 +178,7 @@ private:
   void ExecuteOpCodeDuplicateTopOperandx1( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   e_IncreaseCallStackDepth ExecuteOpCodeInvokeSpecial( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeStoreLongInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeStoreLongInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeStoreLongInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodePushIntImmediateByte( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeNewArray( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
@@ -170,19 +204,19 @@ private:
   void ExecuteOpCodeBranchIfNull( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
   void ExecuteOpCodeStoreReferenceInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeStoreReferenceInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeStoreReferenceInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeGoto( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeReturnReference( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeReturnInteger( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeIntegerRemainder( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeStoreIntegerInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeStoreIntegerInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeStoreIntegerInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
   void ExecuteOpCodeLoadIntegerFromLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeLoadIntegerFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeLoadIntegerFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeLoadReferenceFromArray( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeLoadFloatFromLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpLoadFloatFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpLoadFloatFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodePushFloatConstant( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, float value );
   void ExecuteOpCodeFloatComparisonL( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeFloatComparisonG( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -207,6 +241,7 @@ private:
   void ExecuteOpCodeBranchIfReferencesAreEqual( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeBranchIfReferencesAreNotEqual( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeIncrementLocalVariable( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  void IncrementLocalVariable( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t index, int16_t constantValue );
   void ExecuteOpCodeLoadCharacterFromArray( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeNegateInteger( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeConvertIntegerToChar( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -218,7 +253,7 @@ private:
   void ExecuteOpCodeIntegerDivide( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodePushLong( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, int64_t value );
   void ExecuteOpCodeLoadLongFromLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeLoadLongFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeLoadLongFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeLoadByteOrBooleanFromArray( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeXORInteger( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeThrowReference( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -238,10 +273,10 @@ private:
   void ExecuteOpCodeConvertLongToDouble( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeDoubleDivide( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeReturnDouble( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeStoreDoubleInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeStoreDoubleInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeStoreDoubleInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeLoadDoubleFromLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeLoadDoubleFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeLoadDoubleFromLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeNegateDouble( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeANDInteger( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeDuplicateTopOperandOrTwo( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -258,7 +293,7 @@ private:
   void ExecuteOpCodeFloatDivide( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeConvertDoubleToInt( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeStoreFloatInLocalWithIndex( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
-  void ExecuteOpCodeStoreFloatInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint8_t localVariableIndex );
+  void ExecuteOpCodeStoreFloatInLocal( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, uint16_t localVariableIndex );
   void ExecuteOpCodeFloatSubtract( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodePushDouble( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, double value );
   void ExecuteOpCodeDoubleComparisonL( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
@@ -273,17 +308,36 @@ private:
   void ExecuteOpCodeLoadDoubleFromArray( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
   void ExecuteOpCodeORLong( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
 
+  // Quick forms. These run once the original instruction has been resolved, and skip resolution and the checks that can
+  // only fail the first time.
+  void ExecuteOpCodeGetStaticQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  void ExecuteOpCodePutStaticQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  void ExecuteOpCodeGetFieldQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  void ExecuteOpCodePutFieldQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  e_IncreaseCallStackDepth ExecuteOpCodeInvokeVirtualQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  e_IncreaseCallStackDepth ExecuteOpCodeInvokeSpecialQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  e_IncreaseCallStackDepth ExecuteOpCodeInvokeStaticQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+  e_IncreaseCallStackDepth ExecuteOpCodeInvokeInterfaceMethodQuick( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+
+  // The parts of the invoke instructions that are shared with their quick forms.
+  e_IncreaseCallStackDepth InvokeStaticMethod( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const std::shared_ptr<MethodInfo> &pMethodInfo, boost::intrusive_ptr<JavaString> pClassName );
+  e_IncreaseCallStackDepth InvokeSpecialMethod( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, std::shared_ptr<MethodInfo> pFinalMethod, std::shared_ptr<JavaClass> pFinalClass );
+  e_IncreaseCallStackDepth InvokeInterfaceMethod( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, const std::shared_ptr<ConstantPoolMethodReference> &pMethodRef, size_t argumentCount, const MethodInfo *pResolvedMethod, InlineCache *pInlineCache );
+
+  // Stores a value that has already been popped unboxed into the field of the object beneath it on the operand stack.
+  template <typename T> void PutFieldUnboxed( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState, size_t fieldOffset, T value );
+
   private:
 #ifdef _DEBUG
   int64_t m_InstructionsExecuted;
 #endif // _DEBUG
 
-  // TODO: Consider moving this to the constant pool
-  std::map< std::pair< JavaString, JavaString>, std::shared_ptr<FieldInfo> > m_ResolvedFields;
-
   volatile bool m_Halted;
-  // TODO: Cache References so they only have to be resolved once.
- 
+
+  // Every inline cache table handed out, so that their statistics can be logged. This also keeps them alive for the
+  // per-thread lookup cache.
+  std::vector<std::shared_ptr<InlineCacheTable> > m_InlineCacheTables;
+  std::mutex m_InlineCacheTablesMutex;
 };
 
 #endif // _BASICEXECUTIONENGINE__H_
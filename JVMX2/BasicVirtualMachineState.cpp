@@ -19,7 +19,6 @@
 
 #include "JavaCodeAttribute.h"
 #include "ClassAttributeCode.h"
-#include "CodeSegmentDataBuffer.h"
 #include "ThreadManager.h"
 #include "VirtualMachine.h"
 
@@ -33,6 +32,7 @@
 #include "GlobalCatalog.h"
 #include "ObjectReference.h"
 #include "ObjectRegistryLocalMachine.h"
+#include "Safepoint.h"
 
 #include "BasicVirtualMachineState.h"
 #include "ClassAttributeSourceFile.h"
@@ -54,12 +54,25 @@ extern const JavaString c_JavaLangClassName = JavaString::FromCString( JVMX_T( "
 extern const JavaString c_SyntheticField_ClassName = JavaString::FromCString( JVMX_T( "__class" ) );
 
 const uint32_t c_NullReferenceValue = UINT32_MAX;
+const size_t c_InitialOperandStackCapacity = 1024;
+
+namespace
+{
+  // Returned by reference while no Java frame is active.
+  const JavaString &GetEmptyName()
+  {
+    static const JavaString emptyName = JavaString::EmptyString();
+    return emptyName;
+  }
+}
 
 BasicVirtualMachineState::BasicVirtualMachineState( std::shared_ptr<VirtualMachine> pVM, bool hasUserCodeStarted)
   : m_pVM( pVM )
   , m_LocalVariableStackFramePointer( 0 )
+  , m_OperandStackFramePointer( 0 )
   , m_isShuttingDown( false )
   , m_CurrentClassAndMethodName( JavaString::EmptyString() )
+  , m_pCurrentClassAndMethodNameOwner( nullptr )
   , m_ExitCode( 0 )
   , m_isPaused( false )
   , m_isPausing( false )
@@ -68,12 +81,15 @@ BasicVirtualMachineState::BasicVirtualMachineState( std::shared_ptr<VirtualMachi
   , m_CallStackDepth( 0 )
   , m_StackLevel( 0 )
   , m_isInterrupted( false )
+  , m_pWaitingOnMonitor( nullptr )
   , m_NativeExecutionCount( 0 )
   , m_hasUserCodeStarted(hasUserCodeStarted)
 {
   m_CurrentRegisters.m_ProgramCounter = 0;
   m_CurrentRegisters.m_pCodeSegmentStart = nullptr;
   m_CurrentRegisters.m_CodeSegmentLength = 0;
+
+  m_OperandStack.reserve( c_InitialOperandStackCapacity );
 }
 
 BasicVirtualMachineState::~BasicVirtualMachineState() JVMX_NOEXCEPT
@@ -84,19 +100,11 @@ BasicVirtualMachineState::~BasicVirtualMachineState() JVMX_NOEXCEPT
 void BasicVirtualMachineState::ReleaseMemory()
 {
   m_OperandStack.clear();
+  m_OperandStackFramePointer = 0;
   m_LocalVariableStack.clear();
 
-  while ( !m_RegisterStack.empty() )
-  {
-    m_RegisterStack.pop_back();
-  }
-
-  m_CurrentDisplayCallStackEntry.m_ClassName = JavaString::EmptyString();
-  m_CurrentDisplayCallStackEntry.m_MethodName = JavaString::EmptyString();
-  m_CurrentDisplayCallStackEntry.m_MethodType = JavaString::EmptyString();
-  m_CurrentDisplayCallStackEntry.m_ProgramCounter = 0;
-
-  m_DisplayCallStack.clear();
+  m_CallFrameStack.clear();
+  m_pCurrentClassAndMethodNameOwner = nullptr;
 }
 
 bool BasicVirtualMachineState::IsShuttingDown() const
@@ -139,13 +147,18 @@ void BasicVirtualMachineState::ResetException()
 
 void BasicVirtualMachineState::PushMonitor( std::shared_ptr<Lockable> pMutex )
 {
-  m_MutexStack.push( pMutex );
+  m_MutexStack.push_back( HeldMonitor( pMutex ) );
 }
 
-std::shared_ptr<Lockable> BasicVirtualMachineState::PopMonitor()
+void BasicVirtualMachineState::PushMonitor( boost::intrusive_ptr<ObjectReference> pObject )
 {
-  std::shared_ptr<Lockable> pMutex = m_MutexStack.top();
-  m_MutexStack.pop();
+  m_MutexStack.push_back( HeldMonitor( pObject ) );
+}
+
+HeldMonitor BasicVirtualMachineState::PopMonitor()
+{
+  HeldMonitor pMutex = m_MutexStack.back();
+  m_MutexStack.pop_back();
   return pMutex;
 }
 
@@ -153,10 +166,15 @@ void BasicVirtualMachineState::PushAndZeroCallStackDepth()
 {
   m_CallStackDepthStack.push( m_CallStackDepth );
   m_CallStackDepth = 0;
+
+  m_RecentAllocationsStartStack.push( m_RecentAllocations.size() );
 }
 
 uint16_t BasicVirtualMachineState::PopCallStackDepth()
 {
+  // Whatever the call allocated since its last safepoint stays a root, as the caller may be holding the result.
+  m_RecentAllocationsStartStack.pop();
+
   m_CallStackDepth = m_CallStackDepthStack.top();
   m_CallStackDepthStack.pop();
   return m_CallStackDepth;
@@ -209,21 +227,19 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::GetCallStackOfCl
     }
 #endif
 
-  size_t arraySize = m_DisplayCallStack.size() - 1;
+  // The current frame is not part of the result, only its callers are.
+  size_t arraySize = m_CallFrameStack.empty() ? 0 : m_CallFrameStack.size() - 1;
   boost::intrusive_ptr<ObjectReference> pResult = CreateArray( e_JavaArrayTypes::Reference, arraySize );
 
   size_t arrayIndex = 0;
 
-  for ( auto it = m_DisplayCallStack.crbegin(); it != m_DisplayCallStack.crend(); ++ it )
+  for ( size_t frameIndex = arraySize; frameIndex > 0; -- frameIndex )
   {
-    boost::intrusive_ptr<JavaString> pName = new JavaString( it->m_ClassName );
+    boost::intrusive_ptr<JavaString> pName = m_CallFrameStack[ frameIndex - 1 ].m_pMethodInfo->GetClass()->GetName();
 
-    if ( !pName->IsEmpty() )
-    {
-      boost::intrusive_ptr<ObjectReference> pClassObject = CreateJavaLangClassFromClassName( pName );
-      pResult->GetContainedArray()->SetAt( arrayIndex, pClassObject.get() );
-      ++ arrayIndex;
-    }
+    boost::intrusive_ptr<ObjectReference> pClassObject = CreateJavaLangClassFromClassName( pName );
+    pResult->GetContainedArray()->SetAt( arrayIndex, pClassObject.get() );
+    ++ arrayIndex;
 
     JVMX_ASSERT( arrayIndex <= arraySize );
   }
@@ -257,7 +273,14 @@ uint16_t BasicVirtualMachineState::GetLineNumber( int stackPos )
 {
   uint16_t lineNumber = 0;
 
-  for ( auto attribute : m_MethodInfoStack[ stackPos ]->GetAttributes() )
+  // A caller's current position is the return address saved in the frame above it.
+  uintptr_t programCounter = m_CurrentRegisters.m_ProgramCounter;
+  if ( static_cast<size_t>( stackPos ) + 1 < m_CallFrameStack.size() )
+  {
+    programCounter = m_CallFrameStack[ stackPos + 1 ].m_ReturnRegisters.m_ProgramCounter;
+  }
+
+  for ( auto attribute : m_CallFrameStack[ stackPos ].m_pMethodInfo->GetAttributes() )
   {
     if ( e_JavaAttributeTypeCode != attribute->GetType() )
     {
@@ -276,7 +299,7 @@ uint16_t BasicVirtualMachineState::GetLineNumber( int stackPos )
 
       for ( uint16_t i = 0; i < pLineNumberTable->GetNumberOfLineNumbers(); ++i )
       {
-        if ( m_RegisterStack[ stackPos ].m_ProgramCounter >= pLineNumberTable->GetStartPositionAt( i ) )
+        if ( programCounter >= pLineNumberTable->GetStartPositionAt( i ) )
         {
           if ( i >= pLineNumberTable->GetNumberOfLineNumbers() - 1 )
           {
@@ -284,7 +307,7 @@ uint16_t BasicVirtualMachineState::GetLineNumber( int stackPos )
             break;
           }
 
-          if ( m_RegisterStack[ stackPos ].m_ProgramCounter < pLineNumberTable->GetStartPositionAt( i + 1 ) )
+          if ( programCounter < pLineNumberTable->GetStartPositionAt( i + 1 ) )
           {
             lineNumber = pLineNumberTable->GetLineNumberAt( i );
             break;
@@ -332,15 +355,17 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::GetCallStackOfSt
   std::shared_ptr<MethodInfo> pConstructorMethodInfo = ResolveMethod( pClassOfStackTraceElement.get(), c_InstanceInitialisationMethodName, c_MethodType );
   // Done with prep work.
 
-  size_t arraySize = m_MethodInfoStack.size();// - 1;
+  size_t arraySize = m_CallFrameStack.size();
   boost::intrusive_ptr<ObjectReference> pResult = CreateArray( e_JavaArrayTypes::Reference, arraySize );
 
   size_t arrayIndex = 0;
 
-  for ( int stackPos = m_MethodInfoStack.size() - 1; stackPos >= 0; -- stackPos )
+  for ( int stackPos = static_cast<int>( m_CallFrameStack.size() ) - 1; stackPos >= 0; -- stackPos )
   {
+    // Taken by value, as running the constructor below pushes frames and may reallocate the call frame stack.
+    std::shared_ptr<MethodInfo> pMethodInfo = m_CallFrameStack[ stackPos ].m_pMethodInfo;
 
-    if ( !m_MethodInfoStack[stackPos]->GetFullName().IsEmpty() )
+    if ( !pMethodInfo->GetName()->IsEmpty() )
     {
       boost::intrusive_ptr<ObjectReference> pStackTraceElement = CreateObject( pClassOfStackTraceElement );
 
@@ -348,10 +373,11 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::GetCallStackOfSt
       //////////////////////////////////////////////////////////////////////////
       if ( pConstructorMethodInfo->IsSynchronised() )
       {
-        PushMonitor( pStackTraceElement->GetContainedObject()->MonitorEnter( GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+        pStackTraceElement->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+        PushMonitor( pStackTraceElement );
       }
 
-      boost::intrusive_ptr<JavaString> pFileName = GetSoureFileName( m_MethodInfoStack[ stackPos ] );
+      boost::intrusive_ptr<JavaString> pFileName = GetSoureFileName( pMethodInfo );
       uint16_t lineNumber = GetLineNumber( stackPos );
 
       PushOperand( pStackTraceElement );
@@ -373,9 +399,9 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::GetCallStackOfSt
         PushOperand( boost::intrusive_ptr<JavaInteger>( new JavaInteger( JavaInteger::FromHostInt32( static_cast< int32_t >( lineNumber ) ) ) ) );
       }
 
-      PushOperand( CreateStringObject( *m_MethodInfoStack[ stackPos ]->GetClass()->GetName() ) );
-      PushOperand( CreateStringObject( *m_MethodInfoStack[ stackPos ]->GetName() ) );
-      PushOperand( boost::intrusive_ptr<JavaBool>( new JavaBool( JavaBool::FromBool( m_MethodInfoStack[ stackPos ]->IsNative() ) ) ) );
+      PushOperand( CreateStringObject( *pMethodInfo->GetClass()->GetName() ) );
+      PushOperand( CreateStringObject( *pMethodInfo->GetName() ) );
+      PushOperand( boost::intrusive_ptr<JavaBool>( new JavaBool( JavaBool::FromBool( pMethodInfo->IsNative() ) ) ) );
 
       ExecuteMethod( *pClassOfStackTraceElement->GetName(), c_InstanceInitialisationMethodName, c_MethodType, pConstructorMethodInfo );
       //////////////////////////////////////////////////////////////////////////
@@ -458,17 +484,18 @@ void BasicVirtualMachineState::Execute( const JavaString &startingClassName, con
 
 void BasicVirtualMachineState::Execute( const MethodInfo &method )
 {
-  ClassAttributeCode code = FindCodeAttribute( method );
+  // The code attribute is owned by the method, so the registers can point straight at its byte code.
+  const ClassAttributeCode *pCodeInfo = method.GetCodeInfo();
+  if ( nullptr == pCodeInfo )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Code Attribute not found." );
+  }
 
-  CodeSegmentDataBuffer codeSegment( code.GetCode() );
-  m_CurrentRegisters.m_pCodeSegmentStart = codeSegment.GetRawDataPointer();
-  m_CurrentRegisters.m_CodeSegmentLength = codeSegment.GetByteLength();
-  m_CurrentRegisters.m_ProgramCounter = 0;
+  SetCodeSegment( pCodeInfo );
 
 #if defined (_DEBUG) && defined(JVMX_LOG_VERBOSE)
   if (HasUserCodeStarted())
   {
-      //GetLogger()->LogDebug( "Executing Method: %s::%s", m_CurrentDisplayCallStackEntry.m_ClassName.ToUtf8String().c_str(), method.GetName()->ToUtf8String().c_str() );
       GetLogger()->LogDebug("Executing Method: %s::%s", method.GetClass()->GetName()->ToUtf8String().c_str(), method.GetName()->ToUtf8String().c_str());
       AssertValid();
   }
@@ -510,43 +537,9 @@ std::shared_ptr<JavaClass> BasicVirtualMachineState::GetClassByName( std::shared
   return pClass;
 }
 
-ClassAttributeCode BasicVirtualMachineState::FindCodeAttribute( const MethodInfo &method )
-{
-  const CodeAttributeList &attributes = method.GetAttributes();
-  for ( auto attrib : attributes )
-  {
-    if ( c_AttributeNameCode == attrib->GetName() )
-    {
-      return attrib->ToCode();
-    }
-  }
-
-  throw InvalidStateException( __FUNCTION__ " - Code Attribute not found." );
-}
-
-void BasicVirtualMachineState::PushMethodStack( const JavaString &newClassName, const JavaString &newMethodName, const JavaString &newMethodType )
-{
-  m_DisplayCallStack.push_back( m_CurrentDisplayCallStackEntry );
-
-  UpdateCurrentClassName( newClassName );
-  m_CurrentDisplayCallStackEntry.m_MethodName = newMethodName;
-  m_CurrentDisplayCallStackEntry.m_MethodType = newMethodType;
-  m_CurrentDisplayCallStackEntry.m_ProgramCounter = m_CurrentRegisters.m_ProgramCounter;
-
-  m_CurrentClassAndMethodName = BuildCurrentClassAndMethodName();
-}
-
 bool BasicVirtualMachineState::IsInitialRun() const JVMX_NOEXCEPT
 {
-  return m_CurrentDisplayCallStackEntry.m_ClassName.IsEmpty() && m_CurrentDisplayCallStackEntry.m_MethodName.IsEmpty();
-}
-
-void BasicVirtualMachineState::PopMethodStack()
-{
-  m_CurrentDisplayCallStackEntry = m_DisplayCallStack.back();
-  m_DisplayCallStack.pop_back();
-
-  m_CurrentClassAndMethodName = BuildCurrentClassAndMethodName();
+  return m_CallFrameStack.empty();
 }
 
 uintptr_t BasicVirtualMachineState::GetProgramCounter() const
@@ -581,12 +574,12 @@ bool BasicVirtualMachineState::CanReadBytes( int byteCount ) const
 
 std::shared_ptr<ConstantPoolEntry> BasicVirtualMachineState::GetConstantFromCurrentClass( ConstantPoolIndex index )
 {
-  return GetClassLibrary()->GetConstant( m_CurrentDisplayCallStackEntry.m_ClassName, index );
+  return GetClassLibrary()->GetConstant( GetCurrentClassName(), index );
 }
 
 std::shared_ptr<MethodInfo> BasicVirtualMachineState::GetMethod( size_t index )
 {
-  return GetClassLibrary()->GetMethod( m_CurrentDisplayCallStackEntry.m_ClassName, index );
+  return GetClassLibrary()->GetMethod( GetCurrentClassName(), index );
 }
 
 bool BasicVirtualMachineState::IsClassInitialised( const JavaString &className )
@@ -596,61 +589,83 @@ bool BasicVirtualMachineState::IsClassInitialised( const JavaString &className )
 
 std::shared_ptr<JavaClass> BasicVirtualMachineState::GetCurrentClass()
 {
-  return GetClassLibrary()->FindClass( m_CurrentDisplayCallStackEntry.m_ClassName );
+  return GetClassLibrary()->FindClass( GetCurrentClassName() );
 }
 
-void BasicVirtualMachineState::PushState( const JavaString &newClassName, const JavaString &newMethodName, const JavaString &newMethodType, std::shared_ptr<MethodInfo> pNewMethodInfo )
+void BasicVirtualMachineState::PushState( std::shared_ptr<MethodInfo> pNewMethodInfo )
 {
-  PushMethodStack( newClassName, newMethodName, newMethodType );
-  m_MethodInfoStack.push_back( pNewMethodInfo );
-  m_RegisterStack.push_back( m_CurrentRegisters );
-  m_LocalVariableStackFrameStack.push( m_LocalVariableStackFramePointer );
+  if ( nullptr == pNewMethodInfo )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Method was NULL." );
+  }
+
+  CallFrame frame;
+  frame.m_pMethodInfo = std::move( pNewMethodInfo );
+  frame.m_ReturnRegisters = m_CurrentRegisters;
+  frame.m_ReturnLocalVariableStackFramePointer = m_LocalVariableStackFramePointer;
+  frame.m_ReturnOperandStackFramePointer = m_OperandStackFramePointer;
+  m_CallFrameStack.push_back( std::move( frame ) );
+
+  // The arguments of the new frame are still on the operand stack at this point. PopOperand() lowers the frame
+  // pointer as they are consumed.
+  m_OperandStackFramePointer = m_OperandStack.size();
 }
 
 void BasicVirtualMachineState::PopState()
 {
+  CallFrame &frame = m_CallFrameStack.back();
+
   m_LocalVariableStack.resize( m_LocalVariableStackFramePointer );
-  m_LocalVariableStackFramePointer = m_LocalVariableStackFrameStack.top();
-  m_LocalVariableStackFrameStack.pop();
+  m_LocalVariableStackFramePointer = frame.m_ReturnLocalVariableStackFramePointer;
 
-  m_MethodInfoStack.pop_back();
-  m_CurrentRegisters = m_RegisterStack.back();
-  m_RegisterStack.pop_back();
+  // The operand stack is not truncated here, because callers expect the stack depth to be unchanged by a return.
+  m_OperandStackFramePointer = frame.m_ReturnOperandStackFramePointer;
 
-  PopMethodStack();
+  m_CurrentRegisters = frame.m_ReturnRegisters;
+  m_CallFrameStack.pop_back();
 }
 
 const CodeAttributeStackMapTable *BasicVirtualMachineState::GetCurrentStackMap()
 {
-  return GetMethodByNameAndType( m_CurrentDisplayCallStackEntry.m_ClassName, m_CurrentDisplayCallStackEntry.m_MethodName, m_CurrentDisplayCallStackEntry.m_MethodType, GetClassLibrary() )->GetFrame();
+  return GetCurrentMethodInfo()->GetFrame();
 }
 
 const ClassAttributeCode *BasicVirtualMachineState::GetCurrentCodeInfo()
 {
-  return GetMethodByNameAndType( m_CurrentDisplayCallStackEntry.m_ClassName, m_CurrentDisplayCallStackEntry.m_MethodName, m_CurrentDisplayCallStackEntry.m_MethodType, GetClassLibrary() )->GetCodeInfo();
+  return GetCurrentMethodInfo()->GetCodeInfo();
 }
 
 const JavaString &BasicVirtualMachineState::GetCurrentClassAndMethodName() const
 {
+  const MethodInfo *pCurrentMethod = m_CallFrameStack.empty() ? nullptr : m_CallFrameStack.back().m_pMethodInfo.get();
+  if ( pCurrentMethod != m_pCurrentClassAndMethodNameOwner )
+  {
+    m_CurrentClassAndMethodName = BuildCurrentClassAndMethodName();
+    m_pCurrentClassAndMethodNameOwner = pCurrentMethod;
+  }
+
   return m_CurrentClassAndMethodName;
 }
 
 JavaString BasicVirtualMachineState::BuildCurrentClassAndMethodName() const
 {
-  size_t length = m_CurrentDisplayCallStackEntry.m_ClassName.GetLengthInCodePoints() + 2 + m_CurrentDisplayCallStackEntry.m_MethodName.GetLengthInCodePoints() + sizeof( uint16_t );
+  const JavaString &className = GetCurrentClassName();
+  const JavaString &methodName = GetCurrentMethodName();
+
+  size_t length = className.GetLengthInCodePoints() + 2 + methodName.GetLengthInCodePoints() + sizeof( uint16_t );
   char *pBuffer = new char[ length * sizeof( char16_t ) ];
   char *pPos = pBuffer;
 
   try
   {
-    memcpy( pPos, m_CurrentDisplayCallStackEntry.m_ClassName.ToCharacterArray(), m_CurrentDisplayCallStackEntry.m_ClassName.GetLengthInBytes() );
-    pPos += m_CurrentDisplayCallStackEntry.m_ClassName.GetLengthInBytes();
+    memcpy( pPos, className.ToCharacterArray(), className.GetLengthInBytes() );
+    pPos += className.GetLengthInBytes();
 
     memcpy( pPos, u"::", 2 * sizeof( char16_t ) );
     pPos += 2 * sizeof( char16_t );
 
-    memcpy( pBuffer + m_CurrentDisplayCallStackEntry.m_ClassName.GetLengthInBytes() + 2 * sizeof( char16_t ), m_CurrentDisplayCallStackEntry.m_MethodName.ToCharacterArray(), m_CurrentDisplayCallStackEntry.m_MethodName.GetLengthInBytes() );
-    pPos += m_CurrentDisplayCallStackEntry.m_MethodName.GetLengthInBytes();
+    memcpy( pBuffer + className.GetLengthInBytes() + 2 * sizeof( char16_t ), methodName.ToCharacterArray(), methodName.GetLengthInBytes() );
+    pPos += methodName.GetLengthInBytes();
 
     pPos[ 0 ] = ( '\0' );
     pPos[ 1 ] = ( '\0' );
@@ -674,6 +689,14 @@ void BasicVirtualMachineState::SetCodeSegment( const ClassAttributeCode *pCodeIn
   m_CurrentRegisters.m_pCodeSegmentStart = pCodeInfo->GetCode().ToByteArray();
   m_CurrentRegisters.m_CodeSegmentLength = pCodeInfo->GetCode().GetByteLength();
   m_CurrentRegisters.m_ProgramCounter = 0;
+
+  // Make sure the new frame can never reallocate the operand stack while it runs.
+  size_t requiredCapacity = m_OperandStack.size() + pCodeInfo->GetMaximumOperandStackDepth();
+  if ( requiredCapacity > m_OperandStack.capacity() )
+  {
+    size_t newCapacity = m_OperandStack.capacity() * 2;
+    m_OperandStack.reserve( newCapacity > requiredCapacity ? newCapacity : requiredCapacity );
+  }
 }
 
 void BasicVirtualMachineState::PushOperand( const boost::intrusive_ptr<IJavaVariableType> &pOperand )
@@ -683,9 +706,7 @@ void BasicVirtualMachineState::PushOperand( const boost::intrusive_ptr<IJavaVari
     throw InvalidArgumentException( __FUNCTION__ " - Invalid argument passed. Operand was NULL" );
   }
 
-  // TODO: There should be a way to avoid the string copies here. This is too expensive and kills performance.
-
-  m_OperandStack.push_back( { pOperand, GetProgramCounter(), m_DisplayCallStack.size(), GetCurrentClassName(), GetCurrentMethodName(), GetCurrentMethodType() } );
+  m_OperandStack.push_back( JavaValueSlot::FromBoxed( pOperand ) );
 }
 
 boost::intrusive_ptr<IJavaVariableType> BasicVirtualMachineState::PopOperand()
@@ -695,25 +716,154 @@ boost::intrusive_ptr<IJavaVariableType> BasicVirtualMachineState::PopOperand()
     throw InvalidStateException( __FUNCTION__ " - PopOperand called on empty operand stack." );
   }
 
-  boost::intrusive_ptr<IJavaVariableType> pOperand = PeekOperand();
-  m_OperandStack.pop_back();
+  boost::intrusive_ptr<IJavaVariableType> pOperand = m_OperandStack.back().ToBoxed();
+  RemoveTopOperand();
 
   return pOperand;
 }
 
+void BasicVirtualMachineState::PushInteger( int32_t value )
+{
+  m_OperandStack.push_back( JavaValueSlot::FromHostInt32( value ) );
+}
+
+void BasicVirtualMachineState::PushLong( int64_t value )
+{
+  m_OperandStack.push_back( JavaValueSlot::FromHostInt64( value ) );
+}
+
+void BasicVirtualMachineState::PushFloat( float value )
+{
+  m_OperandStack.push_back( JavaValueSlot::FromHostFloat( value ) );
+}
+
+void BasicVirtualMachineState::PushDouble( double value )
+{
+  m_OperandStack.push_back( JavaValueSlot::FromHostDouble( value ) );
+}
+
+int32_t BasicVirtualMachineState::PopInteger()
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - PopInteger called on empty operand stack." );
+  }
+
+  int32_t value = m_OperandStack.back().ToHostInt32();
+  RemoveTopOperand();
+
+  return value;
+}
+
+int64_t BasicVirtualMachineState::PopLong()
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - PopLong called on empty operand stack." );
+  }
+
+  int64_t value = m_OperandStack.back().ToHostInt64();
+  RemoveTopOperand();
+
+  return value;
+}
+
+float BasicVirtualMachineState::PopFloat()
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - PopFloat called on empty operand stack." );
+  }
+
+  float value = m_OperandStack.back().ToHostFloat();
+  RemoveTopOperand();
+
+  return value;
+}
+
+double BasicVirtualMachineState::PopDouble()
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - PopDouble called on empty operand stack." );
+  }
+
+  double value = m_OperandStack.back().ToHostDouble();
+  RemoveTopOperand();
+
+  return value;
+}
+
+e_JavaVariableTypes BasicVirtualMachineState::PeekOperandType() const
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - PeekOperandType called on empty operand stack." );
+  }
+
+  return m_OperandStack.back().GetVariableType();
+}
+
+void BasicVirtualMachineState::DiscardOperand()
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - DiscardOperand called on empty operand stack." );
+  }
+
+  RemoveTopOperand();
+}
+
+void BasicVirtualMachineState::DuplicateTopOperand()
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - DuplicateTopOperand called on empty operand stack." );
+  }
+
+  JavaValueSlot top = m_OperandStack.back();
+  m_OperandStack.push_back( std::move( top ) );
+}
+
+void BasicVirtualMachineState::RemoveTopOperand()
+{
+  m_OperandStack.pop_back();
+
+  if ( m_OperandStack.size() < m_OperandStackFramePointer )
+  {
+    m_OperandStackFramePointer = m_OperandStack.size();
+  }
+}
+
 const JavaString &BasicVirtualMachineState::GetCurrentClassName() const
 {
-  return m_CurrentDisplayCallStackEntry.m_ClassName;
+  if ( m_CallFrameStack.empty() )
+  {
+    return GetEmptyName();
+  }
+
+  // The class and method own these strings, and both outlive the frame.
+  return *m_CallFrameStack.back().m_pMethodInfo->GetClass()->GetName();
 }
 
 const JavaString &BasicVirtualMachineState::GetCurrentMethodName() const
 {
-  return m_CurrentDisplayCallStackEntry.m_MethodName;
+  if ( m_CallFrameStack.empty() )
+  {
+    return GetEmptyName();
+  }
+
+  return *m_CallFrameStack.back().m_pMethodInfo->GetName();
 }
 
 const JavaString &BasicVirtualMachineState::GetCurrentMethodType() const
 {
-  return m_CurrentDisplayCallStackEntry.m_MethodType;
+  if ( m_CallFrameStack.empty() )
+  {
+    return GetEmptyName();
+  }
+
+  return *m_CallFrameStack.back().m_pMethodInfo->GetType();
 }
 
 boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::SetupLocalVariables( std::shared_ptr<MethodInfo> pMethodInfo )
@@ -1099,7 +1249,7 @@ void BasicVirtualMachineState::SetLocalVariable( uint16_t localVariableIndex, bo
     throw NullPointerException( __FUNCTION__ " - Value argument was NULL." );
   }
 
-  m_LocalVariableStack[ m_LocalVariableStackFramePointer + localVariableIndex ].m_pValue = pValue;
+  m_LocalVariableStack[ m_LocalVariableStackFramePointer + localVariableIndex ].m_Value = JavaValueSlot::FromBoxed( pValue );
 }
 
 void BasicVirtualMachineState::NameLocalVariable( uint16_t localVariableIndex, boost::intrusive_ptr<JavaString> pName )
@@ -1114,7 +1264,7 @@ void BasicVirtualMachineState::NameLocalVariable( uint16_t localVariableIndex, b
 
 boost::intrusive_ptr<IJavaVariableType> BasicVirtualMachineState::GetLocalVariable( uint16_t localVariableIndex )
 {
-  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_pValue;
+  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value.ToBoxed();
 }
 
 const boost::intrusive_ptr<JavaString> &BasicVirtualMachineState::GetLocalVariableName( uint16_t localVariableIndex )
@@ -1122,6 +1272,47 @@ const boost::intrusive_ptr<JavaString> &BasicVirtualMachineState::GetLocalVariab
   return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_pName;
 }
 
+e_JavaVariableTypes BasicVirtualMachineState::GetLocalVariableType( uint16_t localVariableIndex ) const
+{
+  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value.GetVariableType();
+}
+
+int32_t BasicVirtualMachineState::GetLocalInteger( uint16_t localVariableIndex ) const
+{
+  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value.ToHostInt32();
+}
+
+int64_t BasicVirtualMachineState::GetLocalLong( uint16_t localVariableIndex ) const
+{
+  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value.ToHostInt64();
+}
+
+float BasicVirtualMachineState::GetLocalFloat( uint16_t localVariableIndex ) const
+{
+  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value.ToHostFloat();
+}
+
+double BasicVirtualMachineState::GetLocalDouble( uint16_t localVariableIndex ) const
+{
+  return m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value.ToHostDouble();
+}
+
+void BasicVirtualMachineState::SetLocalInteger( uint16_t localVariableIndex, int32_t value )
+{
+  m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value = JavaValueSlot::FromHostInt32( value );
+}
+
+void BasicVirtualMachineState::StoreOperandInLocalVariable( uint16_t localVariableIndex )
+{
+  if ( m_OperandStack.empty() )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Operand stack was empty." );
+  }
+
+  m_LocalVariableStack.at( m_LocalVariableStackFramePointer + localVariableIndex ).m_Value = std::move( m_OperandStack.back() );
+  RemoveTopOperand();
+}
+
 std::shared_ptr<JavaClass> BasicVirtualMachineState::LoadClass( const JavaString &className, const JavaString &path )
 {
   DefaultClassLoader loader;
@@ -1174,7 +1365,7 @@ boost::intrusive_ptr<IJavaVariableType> BasicVirtualMachineState::PeekOperand()
     return nullptr;
   }
 
-  return m_OperandStack.back().pOperand;
+  return m_OperandStack.back().ToBoxed();
 }
 
 void BasicVirtualMachineState::InitialiseLocalVariables( size_t numberofLocalVariables, std::shared_ptr<CodeAttributeLocalVariableTable> pLocalVariableTable, std::shared_ptr<ConstantPool> pConstantPool )
@@ -1222,23 +1413,6 @@ void BasicVirtualMachineState::InitialiseLocalVariables( size_t numberofLocalVar
   }
 }
 
-void BasicVirtualMachineState::UpdateCurrentClassName( boost::intrusive_ptr<JavaString> pNewName )
-{
-  if ( m_CurrentDisplayCallStackEntry.m_ClassName.IsEmpty() )
-  {
-    throw InvalidStateException( __FUNCTION__ " - Tried to update the current class name when it already exists." );
-  }
-
-  UpdateCurrentClassName( *pNewName );
-}
-
-void BasicVirtualMachineState::UpdateCurrentClassName( JavaString newName )
-{
-  m_CurrentDisplayCallStackEntry.m_ClassName = newName;
-
-  AssertValid();
-}
-
 void BasicVirtualMachineState::ReleaseLocalVariables()
 {
   // Do nothing. This was done in PopState;
@@ -1248,12 +1422,12 @@ std::shared_ptr<MethodInfo> BasicVirtualMachineState::GetCurrentMethodInfo()
 {
   AssertValid();
 
-  if ( m_MethodInfoStack.empty() )
+  if ( m_CallFrameStack.empty() )
   {
     return nullptr;
   }
 
-  return m_MethodInfoStack.back();
+  return m_CallFrameStack.back().m_pMethodInfo;
 }
 
 boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::CreateObject( std::shared_ptr<JavaClass> pClass )
@@ -1535,12 +1709,19 @@ void BasicVirtualMachineState::LogCallStack()
   AssertValid();
 
   GetLogger()->LogDebug( "Current Call Stack:" );
-  for ( auto callStackEntry : m_DisplayCallStack )
+  for ( size_t frameIndex = 0; frameIndex < m_CallFrameStack.size(); ++ frameIndex )
   {
-    GetLogger()->LogDebug( "\t%s::%s%s - %lld", callStackEntry.m_ClassName.ToUtf8String().c_str(), callStackEntry.m_MethodName.ToUtf8String().c_str(), callStackEntry.m_MethodType.ToUtf8String().c_str(), callStackEntry.m_ProgramCounter );
-  }
+    const MethodInfo *pMethodInfo = m_CallFrameStack[ frameIndex ].m_pMethodInfo.get();
 
-  GetLogger()->LogDebug( "\t%s::%s%s - %lld", m_CurrentDisplayCallStackEntry.m_ClassName.ToUtf8String().c_str(), m_CurrentDisplayCallStackEntry.m_MethodName.ToUtf8String().c_str(), m_CurrentDisplayCallStackEntry.m_MethodType.ToUtf8String().c_str(), ( int64_t )m_CurrentRegisters.m_ProgramCounter );
+    // Each frame's position is the return address saved by its callee.
+    uintptr_t programCounter = m_CurrentRegisters.m_ProgramCounter;
+    if ( frameIndex + 1 < m_CallFrameStack.size() )
+    {
+      programCounter = m_CallFrameStack[ frameIndex + 1 ].m_ReturnRegisters.m_ProgramCounter;
+    }
+
+    GetLogger()->LogDebug( "\t%s::%s%s - %lld", pMethodInfo->GetClass()->GetName()->ToUtf8String().c_str(), pMethodInfo->GetName()->ToUtf8String().c_str(), pMethodInfo->GetType()->ToUtf8String().c_str(), ( int64_t )programCounter );
+  }
 }
 
 void BasicVirtualMachineState::LogOperandStack()
@@ -1548,9 +1729,9 @@ void BasicVirtualMachineState::LogOperandStack()
   AssertValid();
 
   GetLogger()->LogDebug( "Current Operand Stack:" );
-  for ( auto entry : m_OperandStack )
+  for ( size_t i = m_OperandStackFramePointer; i < m_OperandStack.size(); ++ i )
   {
-    auto pOperand = entry.pOperand;
+    const auto &pOperand = m_OperandStack[ i ].ToBoxed();
     std::string variableType = TypeParser::ConvertTypeToString( pOperand->GetVariableType() ).ToUtf8String();
     std::string operandAsString = pOperand->ToString().ToUtf8String();
 
@@ -1591,7 +1772,7 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::CreateAndInitial
   }
 
   std::vector<boost::intrusive_ptr<IJavaVariableType> > paramArray;
-  PushState( *( pClass->GetName() ), c_InstanceInitialisationMethodName, c_InstanceInitialisationMethodType, pMethodInfo );
+  PushState( pMethodInfo );
   SetupLocalVariables( pMethodInfo, pObject, paramArray );
   Execute( *pMethodInfo );
 
@@ -1606,12 +1787,6 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::CreateArray( e_J
   return HelperTypes::CreateArray( type, size );
 }
 
-BasicVirtualMachineState::DisplayCallStackEntry::DisplayCallStackEntry()
-  : m_ClassName( JavaString::EmptyString() )
-  , m_MethodName( JavaString::EmptyString() )
-  , m_MethodType( JavaString::EmptyString() )
-{}
-
 std::vector<boost::intrusive_ptr<IJavaVariableType> > BasicVirtualMachineState::PopulateParameterArrayFromOperandStack( std::shared_ptr<MethodInfo> pMethodInfo )
 {
   TypeParser::ParsedMethodType parsedType = TypeParser::ParseMethodType( *( pMethodInfo->GetType() ) );
@@ -1642,18 +1817,12 @@ std::vector<boost::intrusive_ptr<IJavaVariableType> > BasicVirtualMachineState::
 
 boost::intrusive_ptr<IJavaVariableType> BasicVirtualMachineState::PeekOperandFromBack( uint8_t count )
 {
-  uint8_t index = 1;
-  for ( auto it = m_OperandStack.rbegin(); it != m_OperandStack.rend(); ++ it )
+  if ( 0 == count || count > m_OperandStack.size() )
   {
-    if ( index == count )
-    {
-      return it->pOperand;
-    }
-
-    ++index;
+    return nullptr;
   }
 
-  return nullptr;
+  return m_OperandStack[ m_OperandStack.size() - count ].ToBoxed();
 }
 
 boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::CreateJavaLangClassFromClassName( const boost::intrusive_ptr<JavaString> &pClassName )
@@ -1710,7 +1879,7 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::CreateJavaLangCl
 void BasicVirtualMachineState::AssertValid() const
 {
 #ifdef _DEBUG
-  JVMX_ASSERT( IsInitialRun() || !m_CurrentDisplayCallStackEntry.m_ClassName.IsEmpty() );
+  JVMX_ASSERT( IsInitialRun() || !GetCurrentClassName().IsEmpty() );
 #endif // _DEBUG
 }
 
@@ -1728,11 +1897,7 @@ boost::intrusive_ptr<ObjectReference> BasicVirtualMachineState::FindJavaLangClas
 
 void BasicVirtualMachineState::ExecuteMethod( const JavaString &className, const JavaString &methodName, const JavaString &methodType, std::shared_ptr<MethodInfo> pInitialMethod )
 {
-  // #ifdef _DEBUG
-  //   uint32_t displayStackDepth = m_DisplayCallStack.size();
-  // #endif // _DEBUG
-
-  PushState( className, methodName, methodType, pInitialMethod );
+  PushState( pInitialMethod );
 
   DoSynchronisation( pInitialMethod );
 
@@ -1743,11 +1908,6 @@ void BasicVirtualMachineState::ExecuteMethod( const JavaString &className, const
 #endif // _DEBUG
 
   Execute( *pInitialMethod );
-
-  // #ifdef _DEBUG
-  //   AssertValid();
-  //   JVMX_ASSERT( m_DisplayCallStack.size() == displayStackDepth );
-  // #endif // _DEBUG
 }
 
 void BasicVirtualMachineState::DoSynchronisation( std::shared_ptr<MethodInfo> pInitialMethod )
@@ -1756,7 +1916,7 @@ void BasicVirtualMachineState::DoSynchronisation( std::shared_ptr<MethodInfo> pI
   {
     if ( pInitialMethod->IsStatic() )
     {
-      PushMonitor( pInitialMethod->GetClass()->MonitorEnter( GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+      PushMonitor( pInitialMethod->GetClass()->MonitorEnter( __FUNCTION__ ) );
     }
     else
     {
@@ -1764,12 +1924,14 @@ void BasicVirtualMachineState::DoSynchronisation( std::shared_ptr<MethodInfo> pI
       if ( e_JavaVariableTypes::Object == pTopOperand->GetVariableType() )
       {
         boost::intrusive_ptr<ObjectReference> pObject = boost::dynamic_pointer_cast<ObjectReference>( pTopOperand );
-        PushMonitor( pObject->GetContainedObject()->MonitorEnter( GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+        pObject->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+        PushMonitor( pObject );
       }
       else if ( e_JavaVariableTypes::Array == pTopOperand->GetVariableType() )
       {
         boost::intrusive_ptr<ObjectReference> pArray = boost::dynamic_pointer_cast<ObjectReference>( pTopOperand );
-        PushMonitor( pArray->GetContainedArray()->MonitorEnter( GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+        pArray->GetContainedArray()->MonitorEnter( __FUNCTION__ );
+        PushMonitor( pArray );
       }
       else
       {
@@ -1779,27 +1941,16 @@ void BasicVirtualMachineState::DoSynchronisation( std::shared_ptr<MethodInfo> pI
   }
 }
 
-size_t BasicVirtualMachineState::CalculateNumberOfStackItemsToClear( size_t exceptionRegionStart ) const
+size_t BasicVirtualMachineState::CalculateNumberOfStackItemsToClear() const
 {
-  size_t numberOfItemsToClear = 0;
-
-  for ( auto it = m_OperandStack.crbegin(); it != m_OperandStack.crend(); ++ it )
+  // Everything above the frame pointer belongs to the current frame, including anything left behind by callees that
+  // were unwound by the exception.
+  if ( m_OperandStack.size() <= m_OperandStackFramePointer )
   {
-    bool isOperandInExceptionScope = it->allocatedProgramCount >= exceptionRegionStart;
-
-    // This implementation does *not* guard against recursive methods that throw exceptions. It will most probably
-    // do the wrong thing in that case.
-    // if ( !IsCurrentMethod( JavaString::FromCString( (const char16_t *)it->m_pClassName ), JavaString::FromCString( (const char16_t *)it->m_MethodName), JavaString::FromCString( (const char16_t *)it->m_MethodType) )it->m_MethodType ) )
-    if ( !IsCurrentMethod( it->m_pClassName, it->m_MethodName, it->m_MethodType )
-         || !isOperandInExceptionScope )
-    {
-      break;
-    }
-
-    ++ numberOfItemsToClear;
+    return 0;
   }
 
-  return numberOfItemsToClear;
+  return m_OperandStack.size() - m_OperandStackFramePointer;
 }
 
 void BasicVirtualMachineState::DoGarbageCollection()
@@ -1840,21 +1991,20 @@ std::vector<boost::intrusive_ptr<IJavaVariableType>> BasicVirtualMachineState::G
 {
   std::vector<boost::intrusive_ptr<IJavaVariableType>> roots;
 
-  for ( auto entry : m_OperandStack )
+  // Unboxed slots never hold references, so only the existing boxes need to be looked at.
+  for ( const auto &operand : m_OperandStack )
   {
-    if ( e_JavaVariableTypes::Object == entry.pOperand->GetVariableType() ||
-         e_JavaVariableTypes::Array == entry.pOperand->GetVariableType() )
+    if ( operand.IsObjectOrArray() )
     {
-      roots.push_back( entry.pOperand );
+      roots.push_back( operand.GetExistingBox() );
     }
   }
 
-  for ( auto entry : m_LocalVariableStack )
+  for ( const auto &entry : m_LocalVariableStack )
   {
-    if ( e_JavaVariableTypes::Object == entry.m_pValue->GetVariableType() ||
-         e_JavaVariableTypes::Array == entry.m_pValue->GetVariableType() )
+    if ( entry.m_Value.IsObjectOrArray() )
     {
-      roots.push_back( entry.m_pValue );
+      roots.push_back( entry.m_Value.GetExistingBox() );
     }
   }
 
@@ -1879,6 +2029,20 @@ std::vector<boost::intrusive_ptr<IJavaVariableType>> BasicVirtualMachineState::G
     }
   }
 
+  for ( const auto &entry : m_RecentAllocations )
+  {
+    roots.push_back( entry );
+  }
+
+  // A locked object must stay alive, and stay where its reference says it is, until it is unlocked.
+  for ( const auto &monitor : m_MutexStack )
+  {
+    if ( nullptr != monitor.GetObject() )
+    {
+      roots.push_back( monitor.GetObject() );
+    }
+  }
+
   if ( m_ExceptionOccurred )
   {
     roots.push_back( m_pException );
@@ -1938,7 +2102,46 @@ bool BasicVirtualMachineState::GetInterruptedFlag()
 
 void BasicVirtualMachineState::Interrupt()
 {
+  // The flag is set before the monitor is looked at, and WaitOnMonitor publishes the monitor before it looks at the flag,
+  // so at least one of the two threads sees the other.
   m_isInterrupted = true;
+
+  std::lock_guard<std::mutex> lock( m_WaitingOnMonitorMutex );
+  if ( nullptr != m_pWaitingOnMonitor )
+  {
+    m_pWaitingOnMonitor->Interrupt();
+  }
+}
+
+void BasicVirtualMachineState::SetWaitingOnMonitor( ObjectMonitor *pMonitor )
+{
+  std::lock_guard<std::mutex> lock( m_WaitingOnMonitorMutex );
+  m_pWaitingOnMonitor = pMonitor;
+}
+
+bool BasicVirtualMachineState::WaitOnMonitor( ObjectMonitor &monitor, std::chrono::nanoseconds timeout )
+{
+  ObjectMonitor::e_WaitResult result = ObjectMonitor::e_WaitResult::TimedOut;
+
+  SetWaitingOnMonitor( &monitor );
+  try
+  {
+    result = monitor.Wait( ThinLock::GetCurrentThreadId(), timeout, m_isInterrupted );
+  }
+  catch ( ... )
+  {
+    SetWaitingOnMonitor( nullptr );
+    throw;
+  }
+  SetWaitingOnMonitor( nullptr );
+
+  if ( ObjectMonitor::e_WaitResult::Interrupted == result )
+  {
+    m_isInterrupted = false;
+    return true;
+  }
+
+  return false;
 }
 
 void BasicVirtualMachineState::AddGlobalReference( boost::intrusive_ptr<ObjectReference> pObject )
@@ -1975,6 +2178,20 @@ void BasicVirtualMachineState::DeleteLocalReference( boost::intrusive_ptr<Object
   JVMX_ASSERT( false );
 }
 
+void BasicVirtualMachineState::AddRecentAllocation( const boost::intrusive_ptr<ObjectReference> &pObject )
+{
+  m_RecentAllocations.push_back( pObject );
+}
+
+void BasicVirtualMachineState::ReleaseRecentAllocations()
+{
+  size_t start = m_RecentAllocationsStartStack.empty() ? 0 : m_RecentAllocationsStartStack.top();
+  if ( m_RecentAllocations.size() > start )
+  {
+    m_RecentAllocations.erase( m_RecentAllocations.begin() + start, m_RecentAllocations.end() );
+  }
+}
+
 void BasicVirtualMachineState::AddLocalReferenceFrame()
 {
   m_LocalReferenceFrames.push_back( std::list<boost::intrusive_ptr<ObjectReference>>() );
@@ -1990,12 +2207,24 @@ void BasicVirtualMachineState::SetExecutingNative()
 {
   JVMX_ASSERT( m_NativeExecutionCount >= 0 );
   ++ m_NativeExecutionCount;
+
+  // Native code cannot touch the heap without coming back through here, so the thread is safe for a collection now.
+  if ( m_isPausing && !m_isPaused )
+  {
+    Safepoint::AcknowledgeFromNative( *this );
+  }
 }
 
 void BasicVirtualMachineState::SetExecutingHosted()
 {
   -- m_NativeExecutionCount;
   JVMX_ASSERT( m_NativeExecutionCount >= 0 );
+
+  // Native code counts as paused, so a thread coming back from it during a collection must wait for it to finish.
+  if ( 0 == m_NativeExecutionCount && m_isPaused )
+  {
+    Safepoint::Park( *this );
+  }
 }
 
 bool BasicVirtualMachineState::IsExecutingNative() const
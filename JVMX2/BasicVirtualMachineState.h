@@ -4,6 +4,7 @@
 #include <stack>
 #include <list>
 #include <map>
+#include <mutex>
 
 #include <wallaroo/collaborator.h>
 
@@ -14,6 +15,7 @@
 #include "IExecutionEngine.h"
 #include "IVirtualMachineState.h"
 #include "JVMRegisters.h"
+#include "JavaValueSlot.h"
 
 class JavaNativeInterface;
 
@@ -55,7 +57,7 @@ public:
   virtual std::shared_ptr<MethodInfo> GetMethodByNameAndType( const JavaString &className, const JavaString &methodName, const JavaString &methodType, std::shared_ptr<IClassLibrary> pConstantPool ) JVMX_OVERRIDE;
   virtual std::shared_ptr<JavaClass> GetClassByName( std::shared_ptr<IClassLibrary> pConstantPool, const JavaString &className );
 
-  virtual void PushState( const JavaString &newClassName, const JavaString &newMethodName, const JavaString &newMethodType, std::shared_ptr<MethodInfo> pNewMethodInfo ) JVMX_OVERRIDE;
+  virtual void PushState( std::shared_ptr<MethodInfo> pNewMethodInfo ) JVMX_OVERRIDE;
   virtual void PopState() JVMX_OVERRIDE;
 
   virtual const CodeAttributeStackMapTable *GetCurrentStackMap() JVMX_OVERRIDE;
@@ -69,6 +71,20 @@ public:
   virtual boost::intrusive_ptr<IJavaVariableType> PeekOperand() JVMX_OVERRIDE;
   virtual boost::intrusive_ptr<IJavaVariableType> PeekOperandFromBack( uint8_t count ) JVMX_OVERRIDE;
 
+  virtual void PushInteger( int32_t value ) JVMX_OVERRIDE;
+  virtual void PushLong( int64_t value ) JVMX_OVERRIDE;
+  virtual void PushFloat( float value ) JVMX_OVERRIDE;
+  virtual void PushDouble( double value ) JVMX_OVERRIDE;
+
+  virtual int32_t PopInteger() JVMX_OVERRIDE;
+  virtual int64_t PopLong() JVMX_OVERRIDE;
+  virtual float PopFloat() JVMX_OVERRIDE;
+  virtual double PopDouble() JVMX_OVERRIDE;
+
+  virtual e_JavaVariableTypes PeekOperandType() const JVMX_OVERRIDE;
+  virtual void DiscardOperand() JVMX_OVERRIDE;
+  virtual void DuplicateTopOperand() JVMX_OVERRIDE;
+
   virtual boost::intrusive_ptr<ObjectReference> SetupLocalVariables( std::shared_ptr<MethodInfo> pMethodInfo ) JVMX_OVERRIDE;
   virtual void SetupLocalVariables( std::shared_ptr<MethodInfo> pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject, const std::vector<boost::intrusive_ptr<IJavaVariableType> > &paramArray ) JVMX_OVERRIDE;
 
@@ -81,11 +97,17 @@ public:
   virtual void SetLocalVariable( uint16_t localVariableIndex, boost::intrusive_ptr<IJavaVariableType> pValue ) JVMX_OVERRIDE;
   virtual void SetLocalVariable( uint16_t localVariableIndex, IJavaVariableType *pValue ) JVMX_FN_DELETE;
 
+  virtual e_JavaVariableTypes GetLocalVariableType( uint16_t localVariableIndex ) const JVMX_OVERRIDE;
+  virtual int32_t GetLocalInteger( uint16_t localVariableIndex ) const JVMX_OVERRIDE;
+  virtual int64_t GetLocalLong( uint16_t localVariableIndex ) const JVMX_OVERRIDE;
+  virtual float GetLocalFloat( uint16_t localVariableIndex ) const JVMX_OVERRIDE;
+  virtual double GetLocalDouble( uint16_t localVariableIndex ) const JVMX_OVERRIDE;
+  virtual void SetLocalInteger( uint16_t localVariableIndex, int32_t value ) JVMX_OVERRIDE;
 
-  virtual void NameLocalVariable( uint16_t localVariableIndex, boost::intrusive_ptr<JavaString> pName );
+  virtual void StoreOperandInLocalVariable( uint16_t localVariableIndex ) JVMX_OVERRIDE;
 
-  virtual void UpdateCurrentClassName( boost::intrusive_ptr<JavaString> pNewName ) JVMX_OVERRIDE;
-  virtual void UpdateCurrentClassName( JavaString pNewName );
+
+  virtual void NameLocalVariable( uint16_t localVariableIndex, boost::intrusive_ptr<JavaString> pName );
 
   virtual std::shared_ptr<JavaClass> LoadClass( const JavaString &className, const JavaString &path = JavaString::EmptyString() ) JVMX_OVERRIDE;
 
@@ -123,7 +145,7 @@ public:
 
   void DoSynchronisation( std::shared_ptr<MethodInfo> pInitialMethod );
 
-  virtual size_t CalculateNumberOfStackItemsToClear( size_t exceptionRegionStart ) const JVMX_OVERRIDE;
+  virtual size_t CalculateNumberOfStackItemsToClear() const JVMX_OVERRIDE;
 
   virtual void DoGarbageCollection() JVMX_OVERRIDE;
 
@@ -144,7 +166,8 @@ public:
   virtual void ResetException() JVMX_OVERRIDE;
 
   virtual void PushMonitor( std::shared_ptr<Lockable> pMutex ) JVMX_OVERRIDE;
-  virtual std::shared_ptr<Lockable> PopMonitor() JVMX_OVERRIDE;
+  virtual void PushMonitor( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_OVERRIDE;
+  virtual HeldMonitor PopMonitor() JVMX_OVERRIDE;
 
   virtual void PushAndZeroCallStackDepth() JVMX_OVERRIDE;
   virtual uint16_t PopCallStackDepth() JVMX_OVERRIDE;
@@ -181,6 +204,7 @@ public:
   //virtual bool GetAndClearInterruptedFlag() JVMX_OVERRIDE;
   virtual bool GetInterruptedFlag() JVMX_OVERRIDE;
   virtual void Interrupt() JVMX_OVERRIDE;
+  virtual bool WaitOnMonitor( ObjectMonitor &monitor, std::chrono::nanoseconds timeout ) JVMX_OVERRIDE;
 
   virtual void AddGlobalReference( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_OVERRIDE;
   virtual void DeleteGlobalReference( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_OVERRIDE;
@@ -191,6 +215,9 @@ public:
   virtual void AddLocalReference( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_OVERRIDE;
   virtual void DeleteLocalReference( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_OVERRIDE;
 
+  virtual void AddRecentAllocation( const boost::intrusive_ptr<ObjectReference> &pObject ) JVMX_OVERRIDE;
+  virtual void ReleaseRecentAllocations() JVMX_OVERRIDE;
+
   virtual void SetExecutingNative() JVMX_OVERRIDE;
   virtual void SetExecutingHosted() JVMX_OVERRIDE;
   virtual bool IsExecutingNative() const JVMX_OVERRIDE;
@@ -207,16 +234,13 @@ private:
   virtual void PushOperand( const IJavaVariableType *pOperand ) JVMX_FN_DELETE;
   virtual void PushOperand( IJavaVariableType *pOperand ) JVMX_FN_DELETE;
 
-  ClassAttributeCode FindCodeAttribute( const MethodInfo &method );
-
-  void PushMethodStack( const JavaString &newClassName, const JavaString &newMethodName, const JavaString &newMethodType );
-  void PopMethodStack();
 
   bool IsInitialRun() const JVMX_NOEXCEPT;
 
   //size_t CalculateNumberOfParameters( const JavaString &type );
 
   void InitialiseLocalVariables( size_t numberofLocalVarialbes, std::shared_ptr<CodeAttributeLocalVariableTable> pLocalVariableTable, std::shared_ptr<ConstantPool> pConstantPool );
+  void RemoveTopOperand();
 
   //void AddFieldsToObject( std::shared_ptr<JavaClass> pClass, boost::intrusive_ptr<ObjectReference> pObject );
 
@@ -231,13 +255,14 @@ private:
   const boost::intrusive_ptr<JavaString> GetSoureFileName( const std::shared_ptr<MethodInfo> pMethodInfo ) const;
   uint16_t GetLineNumber( int stackPos );
 
+  void SetWaitingOnMonitor( ObjectMonitor *pMonitor );
+
 private:
   std::shared_ptr<ILogger> m_pLogger;
   std::shared_ptr<IClassLibrary> m_pClassLibrary;
   std::shared_ptr<VirtualMachine> m_pVM;
 
   size_t m_LocalVariableStackFramePointer;
-  std::stack<size_t> m_LocalVariableStackFrameStack;
 
   bool m_isShuttingDown;
 
@@ -245,57 +270,57 @@ private:
 
   struct LocalVariableEntry
   {
-    boost::intrusive_ptr<IJavaVariableType> m_pValue;
+    JavaValueSlot m_Value;
     boost::intrusive_ptr<JavaString> m_pName;
   };
 
   std::vector<LocalVariableEntry> m_LocalVariableStack;
 
 private:
-  struct OperandStackEntry
-  {
-    boost::intrusive_ptr<IJavaVariableType> pOperand;
-    size_t allocatedProgramCount;
-    size_t m_callStackDepth;
-
-    JavaString m_pClassName;
-    JavaString m_MethodName;
-    JavaString m_MethodType;
-  };
-  std::list< OperandStackEntry > m_OperandStack;
+  // One contiguous operand stack per thread. Each frame owns the slots from its frame pointer upwards.
+  std::vector< JavaValueSlot > m_OperandStack;
+  size_t m_OperandStackFramePointer;
 
 private:
-  struct DisplayCallStackEntry
+  // One entry per active Java frame. Pushing a frame copies no strings; display names are built on demand from the
+  // method.
+  struct CallFrame
   {
-    DisplayCallStackEntry();
+    std::shared_ptr<MethodInfo> m_pMethodInfo;
 
-    JavaString m_ClassName;
-    JavaString m_MethodName;
-    JavaString m_MethodType;
-    int64_t m_ProgramCounter;
+    // State of the caller, restored by PopState().
+    JVMRegisters m_ReturnRegisters;
+    size_t m_ReturnLocalVariableStackFramePointer;
+    size_t m_ReturnOperandStackFramePointer;
   };
 
-  std::list<DisplayCallStackEntry> m_DisplayCallStack;
-
-  DisplayCallStackEntry m_CurrentDisplayCallStackEntry;
+  std::vector<CallFrame> m_CallFrameStack;
 
 private:
-  std::vector<JVMRegisters> m_RegisterStack;
-  std::vector< std::shared_ptr<MethodInfo> > m_MethodInfoStack;
-  std::stack< std::shared_ptr<Lockable> > m_MutexStack;
+  // A vector rather than a stack, so that the locked objects can be reported as roots.
+  std::vector< HeldMonitor > m_MutexStack;
   std::weak_ptr<JavaNativeInterface> m_pJNI;
-  JavaString m_CurrentClassAndMethodName;
+
+  // Built lazily by GetCurrentClassAndMethodName() and only rebuilt when the current method changes.
+  mutable JavaString m_CurrentClassAndMethodName;
+  mutable const MethodInfo *m_pCurrentClassAndMethodNameOwner;
 
   JVMRegisters m_CurrentRegisters;
 
   int m_ExitCode;
 
-  volatile bool m_isPaused;
-  volatile bool m_isPausing;
-  int m_NativeExecutionCount;
+  // Sequentially consistent, so that a thread entering native code and a collector asking it to pause cannot both miss
+  // the other.
+  std::atomic<bool> m_isPaused;
+  std::atomic<bool> m_isPausing;
+  std::atomic<int> m_NativeExecutionCount;
   bool m_hasUserCodeStarted;
 
-  bool m_isInterrupted;
+  // Set by other threads. A thread that is waiting publishes its monitor, so that Interrupt can wake it. The mutex keeps
+  // the monitor from being freed, along with its object, while Interrupt is still using it.
+  std::atomic<bool> m_isInterrupted;
+  std::mutex m_WaitingOnMonitorMutex;
+  ObjectMonitor *m_pWaitingOnMonitor;
 
   bool m_ExceptionOccurred;
   boost::intrusive_ptr<ObjectReference> m_pException;
@@ -309,6 +334,11 @@ private:
 
   std::list< std::list<boost::intrusive_ptr<ObjectReference>> > m_LocalReferenceFrames;
 
+  // Where each call into Java, from PushAndZeroCallStackDepth, started in m_RecentAllocations. A safepoint only releases
+  // the allocations made since then, as the C++ code that made the call may still be holding the earlier ones.
+  std::vector<boost::intrusive_ptr<ObjectReference>> m_RecentAllocations;
+  std::stack<size_t> m_RecentAllocationsStartStack;
+
 #if _DEBUG
   unsigned long m_ThreadId;
 #endif
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <deque>
 #include <exception>
+#include <thread>
 #include <vector>
 #include <set>
 
@@ -13,6 +16,11 @@
 #include "ILogger.h"
 #include "OutOfMemoryException.h"
 #include "InvalidStateException.h"
+#include "InvalidArgumentException.h"
+#include "Safepoint.h"
+#include "ReferenceMap.h"
+#include "OsFunctions.h"
+#include "JavaNativeInterface.h"
 
 #include "CheneyGarbageCollector.h"
 #include <cinttypes>
@@ -22,19 +30,129 @@ const JavaString c_FinalizeMethodType = JavaString::FromCString( JVMX_T( "()V" )
 
 const size_t c_MaxRecentAllocations = 100;
 
-struct GCHeader
+// Each thread takes to-space a buffer at a time. Anything bigger than a quarter of a buffer bypasses it.
+const size_t c_AllocationBufferSize = 32 * 1024;
+const size_t c_MaximumBufferedAllocationSize = c_AllocationBufferSize / 4;
+
+// Each parallel copy worker takes to-space a buffer at a time too. Anything bigger than an eighth of a buffer bypasses
+// it, so that no more than that is left unused at the end of a full buffer.
+const size_t c_CopyBufferSize = 64 * 1024;
+const size_t c_MaximumBufferedCopySize = c_CopyBufferSize / 8;
+
+// Stored in an object's forwarding address by the worker that is copying it, until the copy is complete.
+char *const c_CopyInProgress = reinterpret_cast<char *>( static_cast<uintptr_t>( 1 ) );
+
+// The old generation is collected when less than this fraction of it is free after a nursery collection.
+const size_t c_OldGenerationFreeSpaceDivisor = 4;
+
+// Semi-spaces are committed and decommitted in whole multiples of this, which is Windows' allocation granularity.
+const size_t c_SemiSpaceGranularity = 64 * 1024;
+
+// After a collection the pool is resized if the live data is outside these bounds, so that it fills the target fraction.
+const size_t c_MinimumOccupancyPercent = 30;
+const size_t c_MaximumOccupancyPercent = 70;
+const size_t c_TargetOccupancyPercent = 50;
+
+static size_t RoundUpSemiSpaceSize( size_t sizeInBytes )
+{
+  return ( ( sizeInBytes + c_SemiSpaceGranularity - 1 ) / c_SemiSpaceGranularity ) * c_SemiSpaceGranularity;
+}
+
+struct ThreadLocalAllocationBuffer
+{
+  const CheneyGarbageCollector *m_pOwner;
+
+  // The state of the Java thread that owns the buffer, or null if the thread wasn't one when the buffer was handed out.
+  IVirtualMachineState *m_pVMState;
+
+  // The buffer is only valid while the collector's epoch is unchanged. Every collection starts a new epoch.
+  uint64_t m_Epoch;
+  char *m_pTop;
+  char *m_pEnd;
+
+  // Added to the collector's count when the buffer is retired, to keep the allocation path free of shared writes.
+  size_t m_AllocationCount;
+};
+
+namespace
+{
+  thread_local ThreadLocalAllocationBuffer t_AllocationBuffer = { nullptr, nullptr, 0, nullptr, nullptr, 0 };
+}
+
+struct CheneyGarbageCollector::ParallelCopyWorker
 {
-  e_GarbageCollectionObjectTypes type;
-  size_t size;
-  char *forwardingAddress;
+  ParallelCopyWorker()
+    : m_pTop( nullptr )
+    , m_pEnd( nullptr )
+  {}
+
+  // Objects that have been copied but not scanned. The owner works from the back, and thieves take from the front.
+  void Push( GCHeader *pHeader )
+  {
+    std::lock_guard<std::mutex> lock( m_Mutex );
+    m_GreyObjects.push_back( pHeader );
+  }
+
+  bool Pop( GCHeader *&pHeader )
+  {
+    std::lock_guard<std::mutex> lock( m_Mutex );
+    if ( m_GreyObjects.empty() )
+    {
+      return false;
+    }
+
+    pHeader = m_GreyObjects.back();
+    m_GreyObjects.pop_back();
+    return true;
+  }
+
+  bool Steal( GCHeader *&pHeader )
+  {
+    std::lock_guard<std::mutex> lock( m_Mutex );
+    if ( m_GreyObjects.empty() )
+    {
+      return false;
+    }
+
+    pHeader = m_GreyObjects.front();
+    m_GreyObjects.pop_front();
+    return true;
+  }
+
+  bool IsEmpty()
+  {
+    std::lock_guard<std::mutex> lock( m_Mutex );
+    return m_GreyObjects.empty();
+  }
+
+  std::mutex m_Mutex;
+  std::deque<GCHeader *> m_GreyObjects;
+
+  char *m_pTop;
+  char *m_pEnd;
+
+  std::vector<OldToNewPointerMapping> m_PointersToUpdate;
+  std::exception_ptr m_pException;
 };
 
 CheneyGarbageCollector::CheneyGarbageCollector( std::shared_ptr<IThreadManager> pThreadManager, size_t poolSizeInBytes )
-  : m_PoolSizeInBytes( poolSizeInBytes )
-  , m_pMemoryPool( new char[ poolSizeInBytes ] )
+  : CheneyGarbageCollector( pThreadManager, poolSizeInBytes, poolSizeInBytes )
+{
+}
+
+CheneyGarbageCollector::CheneyGarbageCollector( std::shared_ptr<IThreadManager> pThreadManager, size_t initialPoolSizeInBytes, size_t maximumPoolSizeInBytes )
+  : m_PoolSizeInBytes( 0 )
+  , m_MinimumPoolSizeInBytes( RoundUpSemiSpaceSize( initialPoolSizeInBytes / 2 ) * 2 )
+  , m_MaximumPoolSizeInBytes( RoundUpSemiSpaceSize( maximumPoolSizeInBytes / 2 ) * 2 )
+  , m_pMemoryPool( nullptr )
   , m_AllocationCountSinceLastCollect( 0 )
   , m_pThreadManager( pThreadManager )
   , m_IsCollecting( false )
+  , m_Epoch( 0 )
+  , m_PromotionAge( 0 )
+  , m_PromotionFailed( false )
+  , m_ScannedPromotedObjectCount( 0 )
+  , m_CopyThreadCount( 1 )
 {
   //   initialize() =
   //     tospace = 0
@@ -42,16 +160,65 @@ CheneyGarbageCollector::CheneyGarbageCollector( std::shared_ptr<IThreadManager>
   //     allocPtr = tospace
   //     scanPtr = whatever -- only used during collection
 
+  if ( m_MinimumPoolSizeInBytes > m_MaximumPoolSizeInBytes )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Initial heap size must not be more than the maximum heap size." );
+  }
+
+  m_pMemoryPool = static_cast<char *>( OsFunctions::GetInstance().ReserveMemory( m_MaximumPoolSizeInBytes ) );
+  if ( nullptr == m_pMemoryPool )
+  {
+    throw OutOfMemoryException( __FUNCTION__ " - Could not reserve address space for the heap." );
+  }
+
   m_pToSpace = m_pMemoryPool;
-  m_pFromSpace = m_pToSpace + ( m_PoolSizeInBytes / 2 );
+  m_pFromSpace = m_pToSpace + ( m_MaximumPoolSizeInBytes / 2 );
 
   m_pAllocPtr = m_pToSpace;
   m_pScanPtr = m_pToSpace;
+
+  if ( !ResizeSemiSpaces( m_MinimumPoolSizeInBytes / 2 ) )
+  {
+    OsFunctions::GetInstance().ReleaseMemory( m_pMemoryPool, m_MaximumPoolSizeInBytes );
+    throw OutOfMemoryException( __FUNCTION__ " - Could not commit the initial heap." );
+  }
+}
+
+CheneyGarbageCollector::CheneyGarbageCollector( std::shared_ptr<IThreadManager> pThreadManager, size_t nurserySizeInBytes, size_t oldGenerationSizeInBytes, uint8_t promotionAge )
+  : CheneyGarbageCollector( pThreadManager, nurserySizeInBytes )
+{
+  if ( 0 == promotionAge )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Promotion age must be at least 1." );
+  }
+
+  m_pOldGeneration.reset( new OldGeneration( oldGenerationSizeInBytes ) );
+  m_PromotionAge = promotionAge;
 }
 
 bool CheneyGarbageCollector::IsPointerValid( void const *const pBytes ) const
 {
-  return pBytes >= m_pMemoryPool && pBytes < m_pMemoryPool + m_PoolSizeInBytes;
+  return ( pBytes >= m_pMemoryPool && pBytes < m_pMemoryPool + m_MaximumPoolSizeInBytes ) || IsInOldGeneration( pBytes );
+}
+
+void CheneyGarbageCollector::SetCopyThreadCount( size_t threadCount )
+{
+  if ( 0 == threadCount )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - At least one copy thread is needed." );
+  }
+
+  m_CopyThreadCount = threadCount;
+}
+
+bool CheneyGarbageCollector::IsInOldGeneration( const void *pAddress ) const
+{
+  return nullptr != m_pOldGeneration && m_pOldGeneration->Contains( pAddress );
+}
+
+bool CheneyGarbageCollector::IsInNursery( const void *pAddress ) const
+{
+  return pAddress >= m_pMemoryPool && pAddress < m_pMemoryPool + m_MaximumPoolSizeInBytes;
 }
 
 void *CheneyGarbageCollector::AllocateBytes( size_t sizeInBytes )
@@ -79,28 +246,38 @@ void CheneyGarbageCollector::RunAllFinalizers( const std::shared_ptr<IVirtualMac
   }
 #endif // _DEBUG
 
-  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
-  for ( auto i = pObjectRegistry->GetFirst(); pObjectRegistry->HasMore( i ); i = pObjectRegistry->GetNext( i ) )
+  // Every object that has a finalizer which hasn't run yet is queued, reachable or not, and the queue is then run on the
+  // calling thread. m_Mutex keeps a collection from moving anything while the registry is walked.
   {
-    boost::intrusive_ptr<ObjectReference> pObjectToFinalize = new ObjectReference( pObjectRegistry->GetIndexAt( i ) );
-    if ( e_JavaVariableTypes::Object == pObjectToFinalize->GetVariableType() )
+    std::lock_guard<std::recursive_mutex> lock( m_Mutex );
+
+    std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
+    for ( auto pI = pObjectRegistry->GetFirst(); pObjectRegistry->HasMore( pI ); pI = pObjectRegistry->GetNext( pI ) )
     {
-      std::shared_ptr<MethodInfo> pMethodInfo = pVMState->ResolveMethod( pObjectToFinalize->GetContainedObject()->GetClass().get(), c_FinalizeMethodName, c_FinalizeMethodType );
-      if ( nullptr != pMethodInfo )
+      boost::intrusive_ptr<ObjectReference> pObject = new ObjectReference( pObjectRegistry->GetIndexAt( pI ) );
+      if ( e_JavaVariableTypes::Object != pObject->GetVariableType() )
       {
-        pVMState->PushOperand( pObjectToFinalize );
-        //pVMState->ExecuteMethod( *pObjectToFinalize->GetContainedObject()->GetClass()->GetName(), c_FinalizeMethodName, c_FinalizeMethodType, pMethodInfo );
-        pVMState->ExecuteMethod( *pMethodInfo->GetClass()->GetName(), c_FinalizeMethodName, c_FinalizeMethodType, pMethodInfo );
+        continue;
+      }
+
+      GCHeader *pHeader = GetHeader( *pObject );
+      if ( !pHeader->isFinalized && HasFinalizer( pObject->GetContainedObject()->GetClass() ) )
+      {
+        pHeader->isFinalized = true;
+
+        std::lock_guard<std::mutex> queueLock( m_FinalizationMutex );
+        m_FinalizationQueue.push_back( pObject );
       }
     }
   }
+
+  while ( RunNextFinalizer( pVMState ) )
+  {
+  }
 }
 
 void *CheneyGarbageCollector::Allocate( size_t sizeInBytes, e_GarbageCollectionObjectTypes type )
 {
-  std::lock_guard<std::recursive_mutex> lock( m_Mutex );
-  ++ m_AllocationCountSinceLastCollect;
-
   //   allocate( n ) =
   //     If allocPtr + n > tospace + N / 2
   //     collect()
@@ -111,38 +288,201 @@ void *CheneyGarbageCollector::Allocate( size_t sizeInBytes, e_GarbageCollectionO
   //     o = allocPtr
   //     allocPtr = allocPtr + n
   //     return o
+  //
+  // allocPtr is only moved under the lock, a buffer at a time. Each thread then bump allocates inside its own buffer.
+  //
+  // Bumping without the lock is only safe for a Java thread running hosted code, because a collection waits for every
+  // such thread to stop before it starts a new epoch. A thread in native code, such as a JNI call creating an object,
+  // counts as stopped without being waited for. So it, any thread that isn't a Java thread, and any thread allocating
+  // while a stop is pending or a collection is running, takes the locked path, which can't run during a collection.
 
   size_t finalSize = sizeInBytes + sizeof( GCHeader );
 
-  if ( ( m_pAllocPtr + finalSize ) > m_pToSpace + ( m_PoolSizeInBytes / 2 ) )
+  ThreadLocalAllocationBuffer &buffer = t_AllocationBuffer;
+  if ( buffer.m_pOwner == this && buffer.m_Epoch == m_Epoch.load( std::memory_order_acquire ) && static_cast<size_t>( buffer.m_pEnd - buffer.m_pTop ) >= finalSize &&
+       nullptr != buffer.m_pVMState && !buffer.m_pVMState->IsExecutingNative() && !Safepoint::IsRequested() && !m_IsCollecting.load( std::memory_order_acquire ) )
+  {
+    char *pResult = buffer.m_pTop;
+    buffer.m_pTop += finalSize;
+    ++ buffer.m_AllocationCount;
+
+    return InitialiseHeader( pResult, sizeInBytes, type );
+  }
+
+  return AllocateAndRefill( sizeInBytes, type );
+}
+
+void *CheneyGarbageCollector::AllocateAndRefill( size_t sizeInBytes, e_GarbageCollectionObjectTypes type )
+{
+  uint64_t epoch = m_Epoch.load( std::memory_order_acquire );
+
+  void *pResult = TryAllocateAndRefill( sizeInBytes, type, false );
+  if ( nullptr != pResult )
+  {
+    return pResult;
+  }
+
+  // Growing the heap, where the reservation allows it, is always better than collecting in the middle of an allocation.
+  pResult = TryAllocateAndRefill( sizeInBytes, type, true );
+  if ( nullptr != pResult )
+  {
+    return pResult;
+  }
+
+  // Collecting here, rather than at the next safepoint, is a last resort, because the only alternative is to fail the
+  // allocation. The caller's C++ locals are not roots, but everything this thread has allocated since its last safepoint
+  // is, so the objects it is still building survive. Other threads that block on m_Mutex meanwhile count as stopped, so
+  // they don't hold the collection up.
+  {
+    std::unique_lock<std::recursive_mutex> lock = LockAtSafepoint();
+
+    // Another thread that ran out of space at the same time may have collected already.
+    if ( epoch == m_Epoch.load( std::memory_order_acquire ) )
+    {
+      CollectNow();
+    }
+  }
+
+  pResult = TryAllocateAndRefill( sizeInBytes, type, true );
+  if ( nullptr == pResult )
   {
     throw OutOfMemoryException( __FUNCTION__ " - Out of memory." );
   }
 
-  //   if ( (m_pAllocPtr + finalSize) > m_pToSpace + (m_PoolSizeInBytes / 2) )
-  //   {
-  //     throw std::exception( "Not enough memory." );
-  //   }
+  return pResult;
+}
+
+void *CheneyGarbageCollector::TryAllocateAndRefill( size_t sizeInBytes, e_GarbageCollectionObjectTypes type, bool canGrow )
+{
+  std::unique_lock<std::recursive_mutex> lock = LockAtSafepoint();
+
+  ThreadLocalAllocationBuffer &buffer = t_AllocationBuffer;
+  RetireAllocationBuffer( buffer );
+  ++ m_AllocationCountSinceLastCollect;
+
+  size_t finalSize = sizeInBytes + sizeof( GCHeader );
+  size_t freeSpace = GetFreeHeapSpace();
+
+  if ( finalSize > freeSpace )
+  {
+    if ( !canGrow || !GrowToFit( finalSize ) )
+    {
+      return nullptr;
+    }
+
+    freeSpace = GetFreeHeapSpace();
+  }
 
   char *pResult = m_pAllocPtr;
-  GCHeader *pHeader = reinterpret_cast<GCHeader *>( pResult );
 
-  pResult += sizeof( GCHeader );
+  if ( finalSize > c_MaximumBufferedAllocationSize )
+  {
+    // Large allocations would waste most of a buffer, so they come straight from to-space.
+    m_pAllocPtr += finalSize;
+  }
+  else
+  {
+    size_t bufferSize = c_AllocationBufferSize < freeSpace ? c_AllocationBufferSize : freeSpace;
+
+    buffer.m_pOwner = this;
+    buffer.m_pVMState = m_pThreadManager->FindCurrentThreadState().get();
+    buffer.m_Epoch = m_Epoch.load( std::memory_order_relaxed );
+    buffer.m_pTop = m_pAllocPtr + finalSize;
+    buffer.m_pEnd = m_pAllocPtr + bufferSize;
+    buffer.m_AllocationCount = 0;
+
+    m_pAllocPtr += bufferSize;
+  }
+
+  // Collection happens at the next safepoint, where the allocating thread's stack is walkable.
+  if ( MustCollect() )
+  {
+    Safepoint::RequestCollection();
+  }
+
+  return InitialiseHeader( pResult, sizeInBytes, type );
+}
+
+void CheneyGarbageCollector::RetireAllocationBuffer( ThreadLocalAllocationBuffer &buffer )
+{
+  if ( buffer.m_pOwner != this || buffer.m_Epoch != m_Epoch.load( std::memory_order_relaxed ) )
+  {
+    // The buffer was in the old to-space, and has been thrown away with it.
+    return;
+  }
+
+  m_AllocationCountSinceLastCollect += buffer.m_AllocationCount;
+  buffer.m_AllocationCount = 0;
+
+  // Fill the unused end of the buffer with a dead block, so that to-space is still a sequence of headers.
+  size_t unusedSize = buffer.m_pEnd - buffer.m_pTop;
+  if ( unusedSize >= sizeof( GCHeader ) )
+  {
+    InitialiseHeader( buffer.m_pTop, unusedSize - sizeof( GCHeader ), e_GarbageCollectionObjectTypes::Bytes );
+  }
+
+  buffer.m_pTop = buffer.m_pEnd;
+}
+
+void *CheneyGarbageCollector::InitialiseHeader( char *pBlock, size_t sizeInBytes, e_GarbageCollectionObjectTypes type )
+{
+  GCHeader *pHeader = reinterpret_cast<GCHeader *>( pBlock );
   pHeader->size = sizeInBytes;
   pHeader->type = type;
+  pHeader->age = 0;
+  pHeader->isMarked = false;
+  pHeader->isFinalized = false;
   pHeader->forwardingAddress = nullptr;
 
-  m_pAllocPtr += finalSize;
-
-  return static_cast<void *>( pResult );
+  return static_cast<void *>( pBlock + sizeof( GCHeader ) );
 }
 
 CheneyGarbageCollector::~CheneyGarbageCollector()
 {
-  delete[] m_pMemoryPool;
+  OsFunctions::GetInstance().ReleaseMemory( m_pMemoryPool, m_MaximumPoolSizeInBytes );
+}
+
+std::unique_lock<std::recursive_mutex> CheneyGarbageCollector::LockAtSafepoint()
+{
+  std::unique_lock<std::recursive_mutex> lock( m_Mutex, std::try_to_lock );
+  if ( lock.owns_lock() )
+  {
+    return lock;
+  }
+
+  // The thread holding m_Mutex may be collecting, and waiting for this one to stop. So the wait counts as native code,
+  // which a collection does not wait for. It is over by the time the lock is released, so nothing parks below.
+  std::shared_ptr<IVirtualMachineState> pVMState = m_pThreadManager->FindCurrentThreadState();
+  if ( nullptr != pVMState )
+  {
+    pVMState->SetExecutingNative();
+  }
+
+  lock.lock();
+
+  if ( nullptr != pVMState )
+  {
+    pVMState->SetExecutingHosted();
+  }
+
+  return lock;
 }
 
 void CheneyGarbageCollector::Collect()
+{
+  std::unique_lock<std::recursive_mutex> lock = LockAtSafepoint();
+
+  // We do this to handle a possible race condition. If two threads were blocking on m_Mutex,
+  // then we want the first one to collect, and the second to just jump out of here.
+  if ( m_AllocationCountSinceLastCollect < 10 )
+  {
+    return;
+  }
+
+  CollectNow();
+}
+
+void CheneyGarbageCollector::CollectNow()
 {
   std::lock_guard<std::recursive_mutex> lock( m_Mutex );
 
@@ -156,13 +496,6 @@ void CheneyGarbageCollector::Collect()
   m_debugReAllocBytes = 0;
 #endif // _DEBUG
 
-  // We do this to handle a possible race condition. If two threads were blocking on m_Mutex,
-  // then we want the first one to collect, and the second to just jump out of here.
-  if ( m_AllocationCountSinceLastCollect < 10 )
-  {
-    return;
-  }
-
 #if defined(_DEBUG)
   {
     std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
@@ -191,7 +524,10 @@ void CheneyGarbageCollector::Collect()
   m_IsCollecting = true;
 
   m_pThreadManager->PauseAllThreads();
-  if ( !m_pThreadManager->WaitForThreadsToPause() )
+  bool allPaused = m_pThreadManager->WaitForThreadsToPause();
+  LogTimeToSafepoint();
+
+  if ( !allPaused )
   {
 #if defined(_DEBUG)
     {
@@ -206,9 +542,16 @@ void CheneyGarbageCollector::Collect()
     return;
   }
 
+  // Every thread's allocation buffer is in the space about to become from-space.
+  m_Epoch.fetch_add( 1, std::memory_order_acq_rel );
+
+  size_t fromSpaceUsed = m_pAllocPtr - m_pToSpace;
+
   SwapSpaces();
   m_pAllocPtr = m_pToSpace;
   m_pScanPtr = m_pToSpace;
+  m_PromotionFailed = false;
+  m_ScannedPromotedObjectCount = 0;
 
   try
   {
@@ -222,55 +565,93 @@ void CheneyGarbageCollector::Collect()
       unqiueRoots.insert( *it );
     }
 
-    // Make sure that we keep the last c_MaxRecentAllocations recent objects. This is because we sometimes allocate
-    // objects in the C++ code, which the GC doesn't know is still being used.
+    // Each Java thread keeps the objects it has allocated since its last safepoint as roots. The last
+    // c_MaxRecentAllocations objects are kept as well, for threads that aren't Java threads.
     for ( auto it = m_RecentAllocations.begin(); it != m_RecentAllocations.end(); ++ it )
     {
       unqiueRoots.insert( *it );
     }
 
-    for ( auto root : unqiueRoots )
+    // Objects waiting for the finalizer thread are kept, along with everything they refer to, until finalize has run.
     {
-      boost::intrusive_ptr<ObjectReference> pRootObject = boost::dynamic_pointer_cast<ObjectReference>( root );
+      std::lock_guard<std::mutex> lock( m_FinalizationMutex );
+      unqiueRoots.insert( m_FinalizationQueue.begin(), m_FinalizationQueue.end() );
+    }
 
-      //ObjectRegistry::GetInstance().UpdateObjectPointer( *pRootObject, Copy( pRootObject ) );
-      IJavaVariableType *pResult = Copy( *pRootObject );
-      m_PointersToUpdate.push_back( { *pRootObject, pResult } );
-      //root = Copy( root );
+    // Old objects whose cards were dirtied since the last collection may be the only references to young objects.
+    std::vector<GCHeader *> rememberedObjects;
+    if ( nullptr != m_pOldGeneration )
+    {
+      m_pOldGeneration->GetObjectsInDirtyCards( rememberedObjects );
     }
 
-    while ( m_pScanPtr < m_pAllocPtr )
+    // A parallel copy leaves some of to-space unused at the ends of the workers' buffers. It is only used if to-space can
+    // be made big enough for the worst case before it starts, so that it can't run out part way through. Otherwise the
+    // copy is serial, and a serial copy never needs more to-space than from-space had in use.
+    if ( m_CopyThreadCount > 1 && MakeRoomForParallelCopy( fromSpaceUsed ) && CopyInParallel( unqiueRoots, rememberedObjects ) )
     {
-      GCHeader *pHeader = reinterpret_cast<GCHeader *>( m_pScanPtr );
-      if ( pHeader->type == e_GarbageCollectionObjectTypes::Object )
+      // The workers have scanned everything they copied.
+      m_pScanPtr = m_pAllocPtr;
+      m_ScannedPromotedObjectCount = m_PromotedObjects.size();
+    }
+    else
+    {
+      for ( auto root : unqiueRoots )
       {
-        CopyObjectFields( pHeader );
+        boost::intrusive_ptr<ObjectReference> pRootObject = boost::dynamic_pointer_cast<ObjectReference>( root );
+
+        //ObjectRegistry::GetInstance().UpdateObjectPointer( *pRootObject, Copy( pRootObject ) );
+        IJavaVariableType *pResult = Copy( *pRootObject );
+        m_PointersToUpdate.push_back( { *pRootObject, pResult } );
+        //root = Copy( root );
       }
-      else if ( pHeader->type == e_GarbageCollectionObjectTypes::Array )
+
+      for ( GCHeader *pHeader : rememberedObjects )
       {
-        CopyReferencesInArray( pHeader );
+        CopyReferences( pHeader );
       }
-      else if ( pHeader->type == e_GarbageCollectionObjectTypes::Bytes )
+
+      ScanCopiedObjects();
+    }
+
+    CopyUnreachableFinalizableObjects();
+
+    UpdatePointers();
+
+    if ( nullptr != m_pOldGeneration )
+    {
+      // Copying into promoted objects went through the write barrier. Their cards are worked out again below.
+      m_pOldGeneration->ClearCards();
+    }
+
+    std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
+    if ( nullptr != m_pOldGeneration )
+    {
+      if ( MustCollectOldGeneration() )
       {
-        // Bytes can't contain references to objects.
+        CollectOldGeneration( unqiueRoots, rememberedObjects );
       }
       else
       {
-        throw InvalidStateException( __FUNCTION__ " - Unknown type of object in garbage collector." );
+        // Old objects are only touched by a nursery collection when they are reachable from the nursery, so none of
+        // them are freed.
+        pObjectRegistry->Cleanup( m_pOldGeneration->GetStart(), m_pOldGeneration->GetEnd(), nullptr );
       }
 
-      m_pScanPtr += pHeader->size + sizeof( GCHeader );
+      RememberReferencesToNursery( rememberedObjects );
+      RememberReferencesToNursery( m_PromotedObjects );
+      m_PromotedObjects.clear();
+    }
+    else
+    {
+      pObjectRegistry->Cleanup();
     }
 
-    UpdatePointers();
-
-    RunFinalisersForOldObjects();
-
-    std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
-    pObjectRegistry->Cleanup();
+    ResizeAfterCollection();
   }
   catch ( ... )
   {
+    m_PromotedObjects.clear();
     m_pThreadManager->ResumeAllThreads();
     m_IsCollecting = false;
     throw;
@@ -292,6 +673,40 @@ void CheneyGarbageCollector::Collect()
 
   m_pThreadManager->ResumeAllThreads();
   m_IsCollecting = false;
+
+  WakeFinalizerThread();
+}
+
+void CheneyGarbageCollector::ScanCopiedObjects()
+{
+  // Promoted objects are not in to-space, so they have their own scan position.
+  while ( m_pScanPtr < m_pAllocPtr || m_ScannedPromotedObjectCount < m_PromotedObjects.size() )
+  {
+    if ( m_pScanPtr < m_pAllocPtr )
+    {
+      GCHeader *pHeader = reinterpret_cast<GCHeader *>( m_pScanPtr );
+      CopyReferences( pHeader );
+
+      m_pScanPtr += pHeader->size + sizeof( GCHeader );
+    }
+    else
+    {
+      CopyReferences( m_PromotedObjects[ m_ScannedPromotedObjectCount ++ ] );
+    }
+  }
+}
+
+void CheneyGarbageCollector::LogTimeToSafepoint() const
+{
+  SafepointStatistics statistics = Safepoint::GetLastStopStatistics();
+  std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
+
+  pLogger->LogDebug( "Time to safepoint: %lld us. Parked: %Iu, in native code: %Iu. Slowest thread took %lld us, in %s.", static_cast<long long>( statistics.m_TimeToSafepoint.count() ), statistics.m_ThreadsParked, statistics.m_ThreadsInNativeCode, static_cast<long long>( statistics.m_SlowestThreadTime.count() ), statistics.m_SlowestThreadLocation.c_str() );
+
+  if ( statistics.m_ThreadsNotStopped > 0 )
+  {
+    pLogger->LogWarning( "%Iu thread(s) did not reach a safepoint within %lld us.", statistics.m_ThreadsNotStopped, static_cast<long long>( statistics.m_TimeToSafepoint.count() ) );
+  }
 }
 
 void CheneyGarbageCollector::GetJavaLangClasses( std::vector<boost::intrusive_ptr<IJavaVariableType>> &roots )
@@ -311,119 +726,200 @@ void CheneyGarbageCollector::CopyObjectFields( GCHeader *pHeader )
     throw InvalidStateException( __FUNCTION__ " - Pointer does not point to an object, as expected." );
   }
 
-  CopyObjectFieldsInternal( pOldObject, pOldObject->GetClass() );
-
+  ForEachReference( pHeader, [ this ]( ObjectReference &field )
+  {
+    // Just record which pointers should be updated. Don't update them here yet.
+    IJavaVariableType *pResult = Copy( field );
+    m_PointersToUpdate.push_back( { field, pResult } );
+  } );
 }
 
-void CheneyGarbageCollector::CopyObjectFieldsInternal( JavaObject *pOldObject, std::shared_ptr<JavaClass> pClass )
+void CheneyGarbageCollector::CopyUnreachableFinalizableObjects()
 {
-  //for ( size_t i = 0; i < pOldObject->GetClass()->GetLocalFieldCount(); ++ i )
-  for ( size_t i = 0; i < pClass->GetLocalFieldCount( e_PublicOnly::No ); ++ i )
+#if defined(_DEBUG)
   {
-    auto pFieldInfo = pClass->GetFieldByIndex( i );
+    std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
+    pLogger->LogDebug( "Garbage Collection Queueing Objects For Finalization..." );
+  }
+#endif // _DEBUG
 
-    if ( pFieldInfo->IsStatic() )
+  // Everything reachable has been copied, but the registry has not been updated yet, so a nursery object that has no
+  // forwarding address is unreachable. They are all found before any are copied, as copying one may reach another.
+  std::vector<boost::intrusive_ptr<ObjectReference>> objectsToFinalize;
+
+  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
+  for ( auto pI = pObjectRegistry->GetFirst(); pObjectRegistry->HasMore( pI ); pI = pObjectRegistry->GetNext( pI ) )
+  {
+    boost::intrusive_ptr<ObjectReference> pObject = new ObjectReference( pObjectRegistry->GetIndexAt( pI ) );
+    if ( e_JavaVariableTypes::Object != pObject->GetVariableType() )
     {
       continue;
     }
 
-    auto pTempField = pOldObject->GetFieldByName( *pFieldInfo->GetName() );
-    const IJavaVariableType *pField = pTempField.get();
-
-    //pOldObject->GetFieldByIndex( i );
-    if ( e_JavaVariableTypes::Object == pField->GetVariableType() || e_JavaVariableTypes::Array == pField->GetVariableType() )
+    GCHeader *pHeader = GetHeader( *pObject );
+    if ( !IsInOldGeneration( pHeader ) && nullptr == pHeader->forwardingAddress.load( std::memory_order_relaxed ) && !pHeader->isFinalized && HasFinalizer( pObject->GetContainedObject()->GetClass() ) )
     {
-      boost::intrusive_ptr<ObjectReference> pFieldObject = new ObjectReference( *dynamic_cast<const ObjectReference *>( pField ) );
-
-      // Just record which pointers should be updated. Don't update them here yet.
-      IJavaVariableType *pResult = Copy( *pFieldObject );
-      m_PointersToUpdate.push_back( { *pFieldObject, pResult } );
+      pHeader->isFinalized = true;
+      objectsToFinalize.push_back( pObject );
     }
   }
 
-  if ( nullptr != pClass->GetSuperClass() )
+  if ( objectsToFinalize.empty() )
+  {
+    return;
+  }
+
+  for ( auto pObject : objectsToFinalize )
   {
-    CopyObjectFieldsInternal( pOldObject, pClass->GetSuperClass() );
+    IJavaVariableType *pResult = Copy( *pObject );
+    m_PointersToUpdate.push_back( { *pObject, pResult } );
   }
+
+  ScanCopiedObjects();
+
+  std::lock_guard<std::mutex> lock( m_FinalizationMutex );
+  m_FinalizationQueue.insert( m_FinalizationQueue.end(), objectsToFinalize.begin(), objectsToFinalize.end() );
 }
 
-void CheneyGarbageCollector::RunFinalisersForOldObjects() const
+bool CheneyGarbageCollector::HasFinalizer( const std::shared_ptr<JavaClass> &pClass )
 {
-#if defined(_DEBUG)
+  auto it = m_HasFinalizerByClass.find( pClass.get() );
+  if ( m_HasFinalizerByClass.end() != it )
   {
-    std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
-    pLogger->LogDebug( "Garbage Collection Running Finalizers..." );
+    return it->second;
   }
-#endif // _DEBUG
 
-  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
-  for ( auto pI = pObjectRegistry->GetFirst(); pObjectRegistry->HasMore( pI ); pI = pObjectRegistry->GetNext( pI ) )
+  // java/lang/Object's own finalize does nothing, so only the classes below it that declare one need to be finalized.
+  bool hasFinalizer = false;
+  for ( std::shared_ptr<JavaClass> pCurrentClass = pClass; nullptr != pCurrentClass->GetSuperClass(); pCurrentClass = pCurrentClass->GetSuperClass() )
   {
-    if ( !pObjectRegistry->HasBeenUpdatedAt( pI ) )
+    if ( nullptr != pCurrentClass->GetMethodByNameAndType( c_FinalizeMethodName, c_FinalizeMethodType ) )
     {
-      std::shared_ptr<IVirtualMachineState>  pVMState = m_pThreadManager->GetCurrentThreadState();
-      boost::intrusive_ptr<ObjectReference> pObjectToFinalize = new ObjectReference( pObjectRegistry->GetIndexAt( pI ) );
-      if ( e_JavaVariableTypes::Object == pObjectToFinalize->GetVariableType() )
-      {
-        std::shared_ptr<MethodInfo> pMethodInfo = pVMState->ResolveMethod( pObjectToFinalize->GetContainedObject()->GetClass().get(), c_FinalizeMethodName, c_FinalizeMethodType );
-        if ( nullptr != pMethodInfo )
-        {
-          pVMState->PushOperand( pObjectToFinalize );
-          pVMState->ExecuteMethod( *pObjectToFinalize->GetContainedObject()->GetClass()->GetName(), c_FinalizeMethodName, c_FinalizeMethodType, pMethodInfo );
-        }
-      }
+      hasFinalizer = true;
+      break;
     }
   }
+
+  m_HasFinalizerByClass[ pClass.get() ] = hasFinalizer;
+  return hasFinalizer;
 }
 
-void CheneyGarbageCollector::UpdatePointers()
+void CheneyGarbageCollector::WakeFinalizerThread()
 {
-#if defined(_DEBUG)
+  std::lock_guard<std::mutex> lock( m_FinalizationMutex );
+
+  if ( m_FinalizationQueue.empty() )
   {
-    std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
-    pLogger->LogDebug( "Garbage Collection Updating Pointers..." );
+    return;
   }
-#endif // _DEBUG
 
-  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
-  for ( auto it : m_PointersToUpdate )
+  if ( nullptr == m_pFinalizerThread )
   {
-    pObjectRegistry->UpdateObjectPointer( it.pOld, it.pNew );
+    std::shared_ptr<IVirtualMachineState> pFinalizerState = m_pThreadManager->GetCurrentThreadState()->CreateNewState();
+    m_pFinalizerThread = std::make_shared<boost::thread>( &CheneyGarbageCollector::RunFinalizerThread, shared_from_this(), pFinalizerState );
+
+    // The new thread can't take anything off the queue until this lock is released, by which time it will be stopped
+    // along with every other thread. It has no java.lang.Thread, and is detached at shutdown like a daemon.
+    m_pThreadManager->AddThread( m_pFinalizerThread, nullptr, pFinalizerState );
   }
 
-  m_PointersToUpdate.clear();
+  m_FinalizationQueueChanged.notify_one();
 }
 
-void CheneyGarbageCollector::AddRecentAllocation( boost::intrusive_ptr<ObjectReference> object )
+void CheneyGarbageCollector::RunFinalizerThread( std::shared_ptr<IVirtualMachineState> pVMState )
 {
-  if ( m_RecentAllocations.size() >= c_MaxRecentAllocations )
+#ifdef _DEBUG
+  OsFunctions::GetInstance().SetThreadName( "Finalizer" );
+#endif // _DEBUG
+
+  std::shared_ptr<JavaNativeInterface> pJNI = std::make_shared<JavaNativeInterface>();
+  pVMState->SetJavaNativeInterface( pJNI );
+  pJNI->SetVMState( pVMState );
+
+  pVMState->RegisterNativeMethods( pJNI );
+
+  for ( ;; )
   {
-    m_RecentAllocations.pop_back();
+    // Waiting counts as being in native code, so collections don't wait for this thread. Nothing on the heap is touched
+    // until it is hosted again, which parks it if a collection is under way.
+    pVMState->SetExecutingNative();
+    {
+      std::unique_lock<std::mutex> lock( m_FinalizationMutex );
+      m_FinalizationQueueChanged.wait( lock, [this]() { return !m_FinalizationQueue.empty(); } );
+    }
+    pVMState->SetExecutingHosted();
+
+    RunNextFinalizer( pVMState );
   }
+}
 
-  m_RecentAllocations.push_front( object );
+bool CheneyGarbageCollector::RunNextFinalizer( const std::shared_ptr<IVirtualMachineState> &pVMState )
+{
+  boost::intrusive_ptr<ObjectReference> pObject;
+  {
+    std::lock_guard<std::mutex> lock( m_FinalizationMutex );
+    if ( m_FinalizationQueue.empty() )
+    {
+      return false;
+    }
+
+    // The object is on the operand stack, which is a root, before it leaves the queue, which is another.
+    pObject = m_FinalizationQueue.front();
+    pVMState->PushOperand( pObject );
+    m_FinalizationQueue.pop_front();
+  }
+
+  std::shared_ptr<MethodInfo> pMethodInfo = pVMState->ResolveMethod( pObject->GetContainedObject()->GetClass().get(), c_FinalizeMethodName, c_FinalizeMethodType );
+  pVMState->ExecuteMethod( *pMethodInfo->GetClass()->GetName(), c_FinalizeMethodName, c_FinalizeMethodType, pMethodInfo );
+
+  // Anything thrown by finalize is ignored, and finalization of the object stops.
+  if ( pVMState->HasExceptionOccurred() )
+  {
+    pVMState->ResetException();
+  }
+
+  return true;
 }
 
-void CheneyGarbageCollector::InitialiseObject( const GCHeader *pHeader, char *newObjectAddress )
+void CheneyGarbageCollector::UpdatePointers()
 {
-  char *pFinalAddress = newObjectAddress + sizeof( GCHeader );
+#if defined(_DEBUG)
+  {
+    std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
+    pLogger->LogDebug( "Garbage Collection Updating Pointers..." );
+  }
+#endif // _DEBUG
 
-  if ( e_GarbageCollectionObjectTypes::Object == pHeader->type )
+  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
+  for ( auto it : m_PointersToUpdate )
   {
-    const JavaObject *pOldObject = reinterpret_cast<const JavaObject *>( reinterpret_cast<const char *>( pHeader ) + sizeof( GCHeader ) );
-    new ( pFinalAddress ) JavaObject( pOldObject->GetClass() );
+    pObjectRegistry->UpdateObjectPointer( it.pOld, it.pNew );
   }
-  else if ( e_GarbageCollectionObjectTypes::Array == pHeader->type )
+
+  m_PointersToUpdate.clear();
+}
+
+void CheneyGarbageCollector::AddRecentAllocation( boost::intrusive_ptr<ObjectReference> object )
+{
+  IVirtualMachineState *pVMState = t_AllocationBuffer.m_pOwner == this ? t_AllocationBuffer.m_pVMState : nullptr;
+  std::shared_ptr<IVirtualMachineState> pFoundVMState;
+  if ( nullptr == pVMState )
   {
-    const JavaArray *pOldObject = reinterpret_cast<const JavaArray *>( reinterpret_cast<const char *>( pHeader ) + sizeof( GCHeader ) );
-    new ( pFinalAddress ) JavaArray( pOldObject->GetContainedType(), pOldObject->GetNumberOfElements() );
+    pFoundVMState = m_pThreadManager->FindCurrentThreadState();
+    pVMState = pFoundVMState.get();
   }
-  else
+
+  if ( nullptr != pVMState )
   {
-#ifdef _DEBUG
-    memset( pFinalAddress, 0, pHeader->size );
-#endif // _DEBUG
+    pVMState->AddRecentAllocation( object );
   }
+
+  if ( m_RecentAllocations.size() >= c_MaxRecentAllocations )
+  {
+    m_RecentAllocations.pop_back();
+  }
+
+  m_RecentAllocations.push_front( object );
 }
 
 void CheneyGarbageCollector::CopyReferencesInArray( GCHeader *pHeader )
@@ -442,14 +938,13 @@ void CheneyGarbageCollector::CopyReferencesInArray( GCHeader *pHeader )
 
   for ( size_t i = 0; i < pArray->GetNumberOfElements(); ++ i )
   {
-    IJavaVariableType *pElement = pArray->At( i );
-    if ( pElement->GetVariableType() == e_JavaVariableTypes::Object ||
-         pElement->GetVariableType() == e_JavaVariableTypes::Array )
+    ObjectIndexT index = pArray->GetElementAt<ObjectIndexT>( i );
+    if ( 0 != index )
     {
-      ObjectReference *pElementReference = dynamic_cast<ObjectReference *>( pElement );
+      ObjectReference elementReference( index );
 
-      IJavaVariableType *pResult = Copy( *pElementReference );
-      m_PointersToUpdate.push_back( { *pElementReference, pResult } );
+      IJavaVariableType *pResult = Copy( elementReference );
+      m_PointersToUpdate.push_back( { elementReference, pResult } );
     }
   }
 }
@@ -467,6 +962,12 @@ void CheneyGarbageCollector::SwapSpaces()
 }
 
 IJavaVariableType *CheneyGarbageCollector::Copy( ObjectReference &object )
+{
+  GCHeader *pHeader = Copy( GetHeader( object ) );
+  return reinterpret_cast<IJavaVariableType *>( reinterpret_cast<char *>( pHeader ) + sizeof( GCHeader ) );
+}
+
+GCHeader *CheneyGarbageCollector::GetHeader( ObjectReference &object )
 {
   char *pObjectStart = nullptr;
   if ( e_JavaVariableTypes::Object == object.GetVariableType() )
@@ -482,9 +983,7 @@ IJavaVariableType *CheneyGarbageCollector::Copy( ObjectReference &object )
     JVMX_ASSERT( false );
   }
 
-  GCHeader *pOldHeader = reinterpret_cast<GCHeader *>( pObjectStart - sizeof( GCHeader ) );
-  GCHeader *pHeader = Copy( pOldHeader );
-  return reinterpret_cast<IJavaVariableType *>( reinterpret_cast<char *>( pHeader ) + sizeof( GCHeader ) );
+  return reinterpret_cast<GCHeader *>( pObjectStart - sizeof( GCHeader ) );
 }
 
 GCHeader *CheneyGarbageCollector::Copy( GCHeader *pHeader )
@@ -498,13 +997,29 @@ GCHeader *CheneyGarbageCollector::Copy( GCHeader *pHeader )
   //     EndIf
   //     return forwarding-address( o )
 
-  if ( nullptr != pHeader->forwardingAddress )
+  if ( IsInOldGeneration( pHeader ) )
   {
-    return reinterpret_cast<GCHeader *>( pHeader->forwardingAddress );
+    // Old objects never move during a nursery collection.
+    return pHeader;
+  }
+
+  if ( nullptr != pHeader->forwardingAddress.load( std::memory_order_relaxed ) )
+  {
+    return reinterpret_cast<GCHeader *>( pHeader->forwardingAddress.load( std::memory_order_relaxed ) );
+  }
+
+  if ( nullptr != m_pOldGeneration && e_GarbageCollectionObjectTypes::Bytes != pHeader->type && pHeader->age + 1 >= m_PromotionAge )
+  {
+    GCHeader *pPromotedHeader = Promote( pHeader );
+    if ( nullptr != pPromotedHeader )
+    {
+      pHeader->forwardingAddress = reinterpret_cast<char *>( pPromotedHeader );
+      return pPromotedHeader;
+    }
   }
 
 #ifdef _DEBUG
-  if ( !( m_pAllocPtr + pHeader->size + sizeof( GCHeader ) < m_pMemoryPool + m_PoolSizeInBytes ) )
+  if ( !( m_pAllocPtr + pHeader->size + sizeof( GCHeader ) <= m_pToSpace + ( m_PoolSizeInBytes / 2 ) ) )
   {
     __asm int 3;
   }
@@ -518,45 +1033,88 @@ GCHeader *CheneyGarbageCollector::Copy( GCHeader *pHeader )
 
   m_pAllocPtr += pHeader->size + sizeof( GCHeader );
 
-  InitialiseObject( pHeader, newObjectAddress );
   CopyObjectInternal( pHeader, newObjectAddress );
   CopyHeaderInternal( newObjectAddress, pHeader );
 
   pHeader->forwardingAddress = newObjectAddress;
 
-  return reinterpret_cast<GCHeader *>( pHeader->forwardingAddress );
+  return reinterpret_cast<GCHeader *>( newObjectAddress );
 }
 
-void CheneyGarbageCollector::CopyHeaderInternal( char *newObjectAddress, GCHeader *pHeader )
+GCHeader *CheneyGarbageCollector::Promote( GCHeader *pHeader )
 {
-  GCHeader *pNewHeader = reinterpret_cast<GCHeader *>( newObjectAddress );
-  pNewHeader->size = pHeader->size;
-  pNewHeader->type = pHeader->type;
-  pNewHeader->forwardingAddress = nullptr;
+  GCHeader *pNewHeader = nullptr;
+  {
+    std::lock_guard<std::mutex> lock( m_PromotionMutex );
+
+    pNewHeader = m_pOldGeneration->Allocate( pHeader->size );
+    if ( nullptr == pNewHeader )
+    {
+      // The object stays in the nursery for now, and the old generation is collected at the end of this collection.
+      m_PromotionFailed = true;
+      return nullptr;
+    }
+
+    m_PromotedObjects.push_back( pNewHeader );
+  }
+
+  char *newObjectAddress = reinterpret_cast<char *>( pNewHeader );
+
+  // The old generation's block may be bigger than the object, and its header has to keep the block's size.
+  size_t blockSize = pNewHeader->size;
+
+  CopyObjectInternal( pHeader, newObjectAddress );
+  CopyHeaderInternal( newObjectAddress, pHeader );
+  pNewHeader->size = blockSize;
+
+  return pNewHeader;
 }
 
-void CheneyGarbageCollector::CopyObjectInternal( GCHeader *pHeader, char *newObjectAddress )
+void CheneyGarbageCollector::CopyReferences( GCHeader *pHeader )
 {
-  if ( e_GarbageCollectionObjectTypes::Object == pHeader->type )
+  if ( pHeader->type == e_GarbageCollectionObjectTypes::Object )
   {
-    JavaObject *pOldObject = reinterpret_cast<JavaObject *>( reinterpret_cast<char *>( pHeader ) + sizeof( GCHeader ) );
-    JavaObject *pNewObject = reinterpret_cast<JavaObject *>( newObjectAddress + sizeof( GCHeader ) );
-    pNewObject->DeepClone( pOldObject );
+    CopyObjectFields( pHeader );
   }
-  else if ( e_GarbageCollectionObjectTypes::Array == pHeader->type )
+  else if ( pHeader->type == e_GarbageCollectionObjectTypes::Array )
   {
-    JavaArray *pOldArray = reinterpret_cast<JavaArray *>( reinterpret_cast<char *>( pHeader ) + sizeof( GCHeader ) );
-    JavaArray *pNewArray = reinterpret_cast<JavaArray *>( newObjectAddress + sizeof( GCHeader ) );
-    pNewArray->DeepClone( pOldArray );
+    CopyReferencesInArray( pHeader );
+  }
+  else if ( pHeader->type == e_GarbageCollectionObjectTypes::Bytes )
+  {
+    // Bytes can't contain references to objects.
   }
   else
   {
-    memcpy( newObjectAddress + sizeof( GCHeader ), reinterpret_cast< const char * >( pHeader ) + sizeof( GCHeader ), pHeader->size );
+    throw InvalidStateException( __FUNCTION__ " - Unknown type of object in garbage collector." );
   }
 }
 
+void CheneyGarbageCollector::CopyHeaderInternal( char *newObjectAddress, GCHeader *pHeader )
+{
+  GCHeader *pNewHeader = reinterpret_cast<GCHeader *>( newObjectAddress );
+  pNewHeader->size = pHeader->size;
+  pNewHeader->type = pHeader->type;
+  pNewHeader->age = pHeader->age < UINT8_MAX ? pHeader->age + 1 : pHeader->age;
+  pNewHeader->isMarked = false;
+  pNewHeader->isFinalized = pHeader->isFinalized;
+  pNewHeader->forwardingAddress = nullptr;
+}
+
+void CheneyGarbageCollector::CopyObjectInternal( GCHeader *pHeader, char *newObjectAddress )
+{
+  // Objects and arrays are relocatable, so they are moved bit for bit, like everything else. Ownership of whatever they
+  // point to moves with them, which is why the old copy is never destroyed.
+  memcpy( newObjectAddress + sizeof( GCHeader ), reinterpret_cast< const char * >( pHeader ) + sizeof( GCHeader ), pHeader->size );
+}
+
 size_t CheneyGarbageCollector::GetHeapSize() const
 {
+  if ( nullptr != m_pOldGeneration )
+  {
+    return m_PoolSizeInBytes + m_pOldGeneration->GetSize();
+  }
+
   return m_PoolSizeInBytes;
 }
 
@@ -570,7 +1128,7 @@ bool CheneyGarbageCollector::MustCollect() const
   double x = static_cast<double>( GetHeapSize() ) / 2;
   double z = static_cast<double>( GetFreeHeapSpace() );
 
-  double percentageSpaceLeft = ( static_cast<double>( GetFreeHeapSpace() ) / ( static_cast<double>( GetHeapSize() ) / static_cast<double>( 2 ) ) ) * 100.0;
+  double percentageSpaceLeft = ( static_cast<double>( GetFreeHeapSpace() ) / ( static_cast<double>( m_PoolSizeInBytes ) / static_cast<double>( 2 ) ) ) * 100.0;
   if ( percentageSpaceLeft < 10.0 )
   {
     return m_AllocationCountSinceLastCollect >= 100;
@@ -584,3 +1142,563 @@ size_t CheneyGarbageCollector::GetFreeHeapSpace() const
   return ( m_pToSpace + ( m_PoolSizeInBytes / 2 ) ) - m_pAllocPtr;
 }
 
+bool CheneyGarbageCollector::ResizeSemiSpaces( size_t semiSpaceSizeInBytes )
+{
+  size_t currentSize = m_PoolSizeInBytes / 2;
+  OsFunctions &osFunctions = OsFunctions::GetInstance();
+
+  if ( semiSpaceSizeInBytes > currentSize )
+  {
+    size_t growth = semiSpaceSizeInBytes - currentSize;
+    if ( !osFunctions.CommitMemory( m_pToSpace + currentSize, growth ) || !osFunctions.CommitMemory( m_pFromSpace + currentSize, growth ) )
+    {
+      osFunctions.DecommitMemory( m_pToSpace + currentSize, growth );
+      osFunctions.DecommitMemory( m_pFromSpace + currentSize, growth );
+      return false;
+    }
+  }
+  else if ( semiSpaceSizeInBytes < currentSize )
+  {
+    JVMX_ASSERT( m_pAllocPtr <= m_pToSpace + semiSpaceSizeInBytes );
+
+    size_t shrinkage = currentSize - semiSpaceSizeInBytes;
+    osFunctions.DecommitMemory( m_pToSpace + semiSpaceSizeInBytes, shrinkage );
+    osFunctions.DecommitMemory( m_pFromSpace + semiSpaceSizeInBytes, shrinkage );
+  }
+
+  m_PoolSizeInBytes = semiSpaceSizeInBytes * 2;
+  return true;
+}
+
+void CheneyGarbageCollector::ResizeAfterCollection()
+{
+  size_t semiSpaceSize = m_PoolSizeInBytes / 2;
+  size_t liveSize = m_pAllocPtr - m_pToSpace;
+  size_t occupancyPercent = ( liveSize * 100 ) / semiSpaceSize;
+
+  if ( occupancyPercent >= c_MinimumOccupancyPercent && occupancyPercent <= c_MaximumOccupancyPercent )
+  {
+    return;
+  }
+
+  size_t targetSize = RoundUpSemiSpaceSize( ( liveSize * 100 ) / c_TargetOccupancyPercent );
+  targetSize = std::max( targetSize, m_MinimumPoolSizeInBytes / 2 );
+  targetSize = std::min( targetSize, m_MaximumPoolSizeInBytes / 2 );
+
+  // If the memory can't be committed the pool just stays the size it is.
+  ResizeSemiSpaces( targetSize );
+}
+
+bool CheneyGarbageCollector::GrowToFit( size_t sizeInBytes )
+{
+  size_t currentSize = m_PoolSizeInBytes / 2;
+  size_t requiredSize = RoundUpSemiSpaceSize( ( m_pAllocPtr - m_pToSpace ) + sizeInBytes );
+
+  if ( requiredSize <= currentSize )
+  {
+    return true;
+  }
+
+  if ( requiredSize > m_MaximumPoolSizeInBytes / 2 )
+  {
+    return false;
+  }
+
+  // Doubling, where there is room to, saves growing again straight away.
+  size_t doubledSize = std::min( currentSize * 2, m_MaximumPoolSizeInBytes / 2 );
+  return ( doubledSize > requiredSize && ResizeSemiSpaces( doubledSize ) ) || ResizeSemiSpaces( requiredSize );
+}
+
+
+bool CheneyGarbageCollector::MustCollectOldGeneration() const
+{
+  if ( nullptr == m_pOldGeneration )
+  {
+    return false;
+  }
+
+  return m_PromotionFailed || m_pOldGeneration->GetFreeSpace() < m_pOldGeneration->GetSize() / c_OldGenerationFreeSpaceDivisor;
+}
+
+void CheneyGarbageCollector::CollectOldGeneration( const std::set<boost::intrusive_ptr<IJavaVariableType>> &roots, std::vector<GCHeader *> &rememberedObjects )
+{
+#if defined(_DEBUG)
+  {
+    std::shared_ptr<ILogger> pLogger = GlobalCatalog::GetInstance().Get( "Logger" );
+    pLogger->LogDebug( "Garbage Collection Collecting Old Generation..." );
+  }
+#endif // _DEBUG
+
+  // Called after the nursery collection has updated the registry, so every reference resolves to its new address.
+  // Everything that survived in to-space is treated as live, which is enough to find all the live old objects.
+  std::vector<GCHeader *> markStack;
+
+  for ( auto root : roots )
+  {
+    boost::intrusive_ptr<ObjectReference> pRootObject = boost::dynamic_pointer_cast<ObjectReference>( root );
+    MarkReference( *pRootObject, markStack );
+  }
+
+  for ( char *pScan = m_pToSpace; pScan < m_pAllocPtr; pScan += reinterpret_cast<GCHeader *>( pScan )->size + sizeof( GCHeader ) )
+  {
+    MarkReferencesFrom( reinterpret_cast<GCHeader *>( pScan ), markStack );
+  }
+
+  // Objects queued for finalization by this collection may have been promoted, and the queue is their only root.
+  {
+    std::lock_guard<std::mutex> lock( m_FinalizationMutex );
+    for ( auto pObject : m_FinalizationQueue )
+    {
+      MarkReference( *pObject, markStack );
+    }
+  }
+
+  DrainMarkStack( markStack );
+
+  QueueUnmarkedFinalizableObjects( markStack );
+
+  auto isDead = []( const GCHeader *pHeader ) { return !pHeader->isMarked; };
+  rememberedObjects.erase( std::remove_if( rememberedObjects.begin(), rememberedObjects.end(), isDead ), rememberedObjects.end() );
+  m_PromotedObjects.erase( std::remove_if( m_PromotedObjects.begin(), m_PromotedObjects.end(), isDead ), m_PromotedObjects.end() );
+
+  // The registry entries of the unmarked objects are freed, and the objects destroyed, in the same pass that frees the
+  // nursery's dead entries, and before the sweep puts their blocks on the free list. A dead old object may still have
+  // been updated, if it was only reached from another dead old object's dirty card, so the mark decides, not the update.
+  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
+  pObjectRegistry->Cleanup( m_pOldGeneration->GetStart(), m_pOldGeneration->GetEnd(), []( const IJavaVariableType *pObject )
+  {
+    return reinterpret_cast<const GCHeader *>( reinterpret_cast<const char *>( pObject ) - sizeof( GCHeader ) )->isMarked;
+  } );
+
+  m_pOldGeneration->Sweep();
+}
+
+void CheneyGarbageCollector::DrainMarkStack( std::vector<GCHeader *> &markStack )
+{
+  while ( !markStack.empty() )
+  {
+    GCHeader *pHeader = markStack.back();
+    markStack.pop_back();
+
+    MarkReferencesFrom( pHeader, markStack );
+  }
+}
+
+void CheneyGarbageCollector::QueueUnmarkedFinalizableObjects( std::vector<GCHeader *> &markStack )
+{
+  // As CopyUnreachableFinalizableObjects, for the old generation. Marking them keeps them, and what they refer to, out
+  // of the sweep. Anything they refer to in the nursery has already been copied, through the remembered set.
+  std::vector<boost::intrusive_ptr<ObjectReference>> objectsToFinalize;
+
+  std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
+  for ( auto pI = pObjectRegistry->GetFirst(); pObjectRegistry->HasMore( pI ); pI = pObjectRegistry->GetNext( pI ) )
+  {
+    boost::intrusive_ptr<ObjectReference> pObject = new ObjectReference( pObjectRegistry->GetIndexAt( pI ) );
+    if ( e_JavaVariableTypes::Object != pObject->GetVariableType() )
+    {
+      continue;
+    }
+
+    GCHeader *pHeader = GetHeader( *pObject );
+    if ( IsInOldGeneration( pHeader ) && !pHeader->isMarked && !pHeader->isFinalized && HasFinalizer( pObject->GetContainedObject()->GetClass() ) )
+    {
+      pHeader->isFinalized = true;
+      objectsToFinalize.push_back( pObject );
+    }
+  }
+
+  for ( auto pObject : objectsToFinalize )
+  {
+    MarkReference( *pObject, markStack );
+  }
+
+  DrainMarkStack( markStack );
+
+  std::lock_guard<std::mutex> lock( m_FinalizationMutex );
+  m_FinalizationQueue.insert( m_FinalizationQueue.end(), objectsToFinalize.begin(), objectsToFinalize.end() );
+}
+
+void CheneyGarbageCollector::MarkReference( ObjectReference &object, std::vector<GCHeader *> &markStack )
+{
+  if ( e_JavaVariableTypes::Object != object.GetVariableType() && e_JavaVariableTypes::Array != object.GetVariableType() )
+  {
+    return;
+  }
+
+  GCHeader *pHeader = GetHeader( object );
+  if ( IsInOldGeneration( pHeader ) && !pHeader->isMarked )
+  {
+    pHeader->isMarked = true;
+    markStack.push_back( pHeader );
+  }
+}
+
+void CheneyGarbageCollector::MarkReferencesFrom( GCHeader *pHeader, std::vector<GCHeader *> &markStack )
+{
+  ForEachReference( pHeader, [ this, &markStack ]( ObjectReference &reference )
+  {
+    MarkReference( reference, markStack );
+  } );
+}
+
+void CheneyGarbageCollector::RememberReferencesToNursery( const std::vector<GCHeader *> &candidates )
+{
+  for ( GCHeader *pHeader : candidates )
+  {
+    if ( HasReferencesToNursery( pHeader ) )
+    {
+      m_pOldGeneration->DirtyCard( pHeader );
+    }
+  }
+}
+
+bool CheneyGarbageCollector::HasReferencesToNursery( GCHeader *pHeader )
+{
+  bool result = false;
+  ForEachReference( pHeader, [ this, &result ]( ObjectReference &reference )
+  {
+    result = result || IsInNursery( GetHeader( reference ) );
+  } );
+
+  return result;
+}
+
+const ReferenceMap *CheneyGarbageCollector::GetReferenceMap( const JavaObject &object )
+{
+  const ReferenceMap *pReferenceMap = object.GetClass()->GetReferenceMap();
+  if ( nullptr == pReferenceMap )
+  {
+    // The class and its superclasses were all loaded when the object was created, so this can't happen.
+    throw InvalidStateException( __FUNCTION__ " - Object's class has no reference map." );
+  }
+
+  return pReferenceMap;
+}
+
+template <typename Visitor>
+void CheneyGarbageCollector::ForEachReference( GCHeader *pHeader, Visitor visit )
+{
+  if ( e_GarbageCollectionObjectTypes::Object == pHeader->type )
+  {
+    JavaObject *pObject = reinterpret_cast<JavaObject *>( reinterpret_cast<char *>( pHeader ) + sizeof( GCHeader ) );
+
+    const ReferenceMap *pReferenceMap = GetReferenceMap( *pObject );
+    const uint32_t *pOffsets = pReferenceMap->GetOffsets();
+    for ( size_t i = 0; i < pReferenceMap->GetCount(); ++ i )
+    {
+      ObjectIndexT index = pObject->GetReferenceIndexAtOffset( pOffsets[ i ] );
+      if ( 0 != index )
+      {
+        // Fields hold bare indices. Collection moves the object, not its index, so a copy is all the visitor needs.
+        ObjectReference field( index );
+        visit( field );
+      }
+    }
+  }
+  else if ( e_GarbageCollectionObjectTypes::Array == pHeader->type )
+  {
+    JavaArray *pArray = reinterpret_cast<JavaArray *>( reinterpret_cast<char *>( pHeader ) + sizeof( GCHeader ) );
+    if ( pArray->GetContainedType() != e_JavaArrayTypes::Reference )
+    {
+      return;
+    }
+
+    for ( size_t i = 0; i < pArray->GetNumberOfElements(); ++ i )
+    {
+      ObjectIndexT index = pArray->GetElementAt<ObjectIndexT>( i );
+      if ( 0 != index )
+      {
+        ObjectReference element( index );
+        visit( element );
+      }
+    }
+  }
+}
+
+size_t CheneyGarbageCollector::GetParallelCopySpaceNeeded( size_t fromSpaceUsed ) const
+{
+  // No more than fromSpaceUsed is copied. A worker only gives up on a buffer when an object of at most
+  // c_MaximumBufferedCopySize doesn't fit in it, so each full buffer holds at least the rest. Every worker's last buffer
+  // may be left almost empty.
+  size_t leastUsedPerBuffer = c_CopyBufferSize - c_MaximumBufferedCopySize - sizeof( GCHeader );
+  size_t fullBufferCount = fromSpaceUsed / leastUsedPerBuffer + 1;
+
+  return fromSpaceUsed + fullBufferCount * ( c_MaximumBufferedCopySize + sizeof( GCHeader ) ) + m_CopyThreadCount * c_CopyBufferSize;
+}
+
+bool CheneyGarbageCollector::MakeRoomForParallelCopy( size_t fromSpaceUsed )
+{
+  size_t requiredSize = RoundUpSemiSpaceSize( GetParallelCopySpaceNeeded( fromSpaceUsed ) );
+  if ( requiredSize <= m_PoolSizeInBytes / 2 )
+  {
+    return true;
+  }
+
+  if ( requiredSize > m_MaximumPoolSizeInBytes / 2 )
+  {
+    return false;
+  }
+
+  // The pool is resized again after the collection, to fit what survived.
+  return ResizeSemiSpaces( requiredSize );
+}
+
+bool CheneyGarbageCollector::CopyInParallel( const std::set<boost::intrusive_ptr<IJavaVariableType>> &roots, const std::vector<GCHeader *> &rememberedObjects )
+{
+  std::vector<boost::intrusive_ptr<IJavaVariableType>> rootList( roots.begin(), roots.end() );
+
+  std::unique_ptr<ParallelCopyWorker[]> pWorkers( new ParallelCopyWorker[ m_CopyThreadCount ] );
+  std::atomic<size_t> activeWorkerCount( m_CopyThreadCount );
+  std::atomic<bool> hasFailed( false );
+
+  // The workers wait until they have all been started. If one can't be, the others are told to give up before they
+  // have copied anything, so that the caller can copy serially instead.
+  enum class e_StartState { Waiting, Started, Abandoned };
+  std::atomic<e_StartState> startState( e_StartState::Waiting );
+
+  // The collecting thread is worker 0.
+  std::vector<std::thread> threads;
+  try
+  {
+    for ( size_t i = 1; i < m_CopyThreadCount; ++ i )
+    {
+      threads.emplace_back( [ this, i, &pWorkers, &rootList, &rememberedObjects, &activeWorkerCount, &hasFailed, &startState ]()
+      {
+        while ( e_StartState::Waiting == startState.load() )
+        {
+          std::this_thread::yield();
+        }
+
+        if ( e_StartState::Started == startState.load() )
+        {
+          RunCopyWorker( i, pWorkers.get(), rootList, rememberedObjects, activeWorkerCount, hasFailed );
+        }
+      } );
+    }
+  }
+  catch ( ... )
+  {
+    startState = e_StartState::Abandoned;
+  }
+
+  if ( e_StartState::Abandoned == startState.load() )
+  {
+    for ( auto &thread : threads )
+    {
+      thread.join();
+    }
+
+    return false;
+  }
+
+  startState = e_StartState::Started;
+  RunCopyWorker( 0, pWorkers.get(), rootList, rememberedObjects, activeWorkerCount, hasFailed );
+
+  for ( auto &thread : threads )
+  {
+    thread.join();
+  }
+
+  std::exception_ptr pException;
+  for ( size_t i = 0; i < m_CopyThreadCount; ++ i )
+  {
+    // Leave to-space as an unbroken sequence of headers, for the old generation's mark phase.
+    RetireCopyBuffer( pWorkers[ i ] );
+    m_PointersToUpdate.insert( m_PointersToUpdate.end(), pWorkers[ i ].m_PointersToUpdate.begin(), pWorkers[ i ].m_PointersToUpdate.end() );
+
+    if ( nullptr == pException )
+    {
+      pException = pWorkers[ i ].m_pException;
+    }
+  }
+
+  if ( nullptr != pException )
+  {
+    std::rethrow_exception( pException );
+  }
+
+  return true;
+}
+
+void CheneyGarbageCollector::RunCopyWorker( size_t workerIndex, ParallelCopyWorker *pWorkers, const std::vector<boost::intrusive_ptr<IJavaVariableType>> &roots, const std::vector<GCHeader *> &rememberedObjects, std::atomic<size_t> &activeWorkerCount, std::atomic<bool> &hasFailed )
+{
+  ParallelCopyWorker &worker = pWorkers[ workerIndex ];
+
+  try
+  {
+    // Roots and dirty cards are dealt out round robin. After that, the work is balanced by stealing.
+    for ( size_t i = workerIndex; i < roots.size() && !hasFailed; i += m_CopyThreadCount )
+    {
+      boost::intrusive_ptr<ObjectReference> pRootObject = boost::dynamic_pointer_cast<ObjectReference>( roots[ i ] );
+
+      GCHeader *pNewHeader = ParallelCopy( GetHeader( *pRootObject ), worker );
+      worker.m_PointersToUpdate.push_back( { *pRootObject, reinterpret_cast<IJavaVariableType *>( reinterpret_cast<char *>( pNewHeader ) + sizeof( GCHeader ) ) } );
+    }
+
+    for ( size_t i = workerIndex; i < rememberedObjects.size() && !hasFailed; i += m_CopyThreadCount )
+    {
+      ParallelCopyReferences( rememberedObjects[ i ], worker );
+    }
+
+    while ( !hasFailed )
+    {
+      GCHeader *pHeader = nullptr;
+      if ( worker.Pop( pHeader ) || StealWork( workerIndex, pWorkers, pHeader ) )
+      {
+        ParallelCopyReferences( pHeader, worker );
+        continue;
+      }
+
+      // Only active workers can push grey objects. Once none are active, and every deque is empty, we are done.
+      -- activeWorkerCount;
+
+      while ( !hasFailed && 0 != activeWorkerCount.load() && !IsWorkAvailable( pWorkers ) )
+      {
+        std::this_thread::yield();
+      }
+
+      if ( hasFailed || 0 == activeWorkerCount.load() )
+      {
+        return;
+      }
+
+      ++ activeWorkerCount;
+    }
+  }
+  catch ( ... )
+  {
+    worker.m_pException = std::current_exception();
+    hasFailed = true;
+  }
+}
+
+GCHeader *CheneyGarbageCollector::ParallelCopy( GCHeader *pHeader, ParallelCopyWorker &worker )
+{
+  if ( IsInOldGeneration( pHeader ) )
+  {
+    return pHeader;
+  }
+
+  char *pForwardingAddress = nullptr;
+  if ( pHeader->forwardingAddress.compare_exchange_strong( pForwardingAddress, c_CopyInProgress, std::memory_order_acq_rel ) )
+  {
+    // This worker has claimed the object, so it is the only one that will copy it.
+    GCHeader *pNewHeader = nullptr;
+    if ( nullptr != m_pOldGeneration && e_GarbageCollectionObjectTypes::Bytes != pHeader->type && pHeader->age + 1 >= m_PromotionAge )
+    {
+      pNewHeader = Promote( pHeader );
+    }
+
+    if ( nullptr == pNewHeader )
+    {
+      char *newObjectAddress = AllocateForCopy( pHeader->size + sizeof( GCHeader ), worker );
+
+      CopyObjectInternal( pHeader, newObjectAddress );
+      CopyHeaderInternal( newObjectAddress, pHeader );
+
+      pNewHeader = reinterpret_cast<GCHeader *>( newObjectAddress );
+    }
+
+    pHeader->forwardingAddress.store( reinterpret_cast<char *>( pNewHeader ), std::memory_order_release );
+    worker.Push( pNewHeader );
+
+    return pNewHeader;
+  }
+
+  // Another worker got there first. Copies are small, so waiting for it to finish is cheaper than anything else.
+  while ( c_CopyInProgress == pForwardingAddress )
+  {
+    std::this_thread::yield();
+    pForwardingAddress = pHeader->forwardingAddress.load( std::memory_order_acquire );
+  }
+
+  return reinterpret_cast<GCHeader *>( pForwardingAddress );
+}
+
+void CheneyGarbageCollector::ParallelCopyReferences( GCHeader *pHeader, ParallelCopyWorker &worker )
+{
+  ForEachReference( pHeader, [ this, &worker ]( ObjectReference &reference )
+  {
+    GCHeader *pNewHeader = ParallelCopy( GetHeader( reference ), worker );
+    worker.m_PointersToUpdate.push_back( { reference, reinterpret_cast<IJavaVariableType *>( reinterpret_cast<char *>( pNewHeader ) + sizeof( GCHeader ) ) } );
+  } );
+}
+
+bool CheneyGarbageCollector::StealWork( size_t workerIndex, ParallelCopyWorker *pWorkers, GCHeader *&pHeader ) const
+{
+  for ( size_t i = 1; i < m_CopyThreadCount; ++ i )
+  {
+    if ( pWorkers[ ( workerIndex + i ) % m_CopyThreadCount ].Steal( pHeader ) )
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool CheneyGarbageCollector::IsWorkAvailable( ParallelCopyWorker *pWorkers ) const
+{
+  for ( size_t i = 0; i < m_CopyThreadCount; ++ i )
+  {
+    if ( !pWorkers[ i ].IsEmpty() )
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+char *CheneyGarbageCollector::AllocateForCopy( size_t blockSize, ParallelCopyWorker &worker )
+{
+  // MakeRoomForParallelCopy committed enough to-space for the worst case before the copy started, so none of this can
+  // run out of space.
+  if ( blockSize > c_MaximumBufferedCopySize )
+  {
+    std::lock_guard<std::mutex> lock( m_CopyBufferMutex );
+    JVMX_ASSERT( blockSize <= GetFreeHeapSpace() );
+
+    char *pResult = m_pAllocPtr;
+    m_pAllocPtr += blockSize;
+
+    return pResult;
+  }
+
+  // Whatever is left in the buffer must be big enough for a filler header.
+  size_t bufferSpace = worker.m_pEnd - worker.m_pTop;
+  if ( bufferSpace != blockSize && bufferSpace < blockSize + sizeof( GCHeader ) )
+  {
+    RetireCopyBuffer( worker );
+
+    std::lock_guard<std::mutex> lock( m_CopyBufferMutex );
+
+    size_t freeSpace = GetFreeHeapSpace();
+    JVMX_ASSERT( blockSize <= freeSpace );
+
+    size_t bufferSize = std::min( c_CopyBufferSize, freeSpace );
+    if ( bufferSize - blockSize < sizeof( GCHeader ) )
+    {
+      bufferSize = blockSize;
+    }
+
+    worker.m_pTop = m_pAllocPtr;
+    worker.m_pEnd = m_pAllocPtr + bufferSize;
+    m_pAllocPtr += bufferSize;
+  }
+
+  char *pResult = worker.m_pTop;
+  worker.m_pTop += blockSize;
+
+  return pResult;
+}
+
+void CheneyGarbageCollector::RetireCopyBuffer( ParallelCopyWorker &worker )
+{
+  if ( worker.m_pTop < worker.m_pEnd )
+  {
+    InitialiseHeader( worker.m_pTop, worker.m_pEnd - worker.m_pTop - sizeof( GCHeader ), e_GarbageCollectionObjectTypes::Bytes );
+  }
+
+  worker.m_pTop = worker.m_pEnd;
+}
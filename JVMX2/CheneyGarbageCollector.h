@@ -2,25 +2,40 @@
 #ifndef _CHENEYGARBAGECOLLECTOR__H_
 #define _CHENEYGARBAGECOLLECTOR__H_
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <set>
+#include <unordered_map>
 
 #include "ThreadManager.h"
 #include "IGarbageCollector.h"
-
-enum class e_GarbageCollectionObjectTypes : uint8_t
-{
-  Invalid = 0,
-  Object = 1,
-  Array = 2,
-  Bytes = 3
-};
-
-struct GCHeader;
-
+#include "GCHeader.h"
+#include "OldGeneration.h"
+
+struct ThreadLocalAllocationBuffer;
+class ReferenceMap;
+
+// A semi-space copying collector. In generational mode the two semi-spaces are the nursery, objects that survive
+// promotionAge nursery collections are promoted into a mark-sweep old generation, and the old generation is only
+// collected when it is running out of space.
+// With more than one copy thread, the nursery is copied by that many workers. Each one copies into its own buffer in
+// to-space, and keeps the objects it has copied but not yet scanned in a deque that idle workers steal from. The
+// buffers waste some space, so a collection only copies in parallel if to-space can hold the worst case. Otherwise it
+// copies serially.
+// Unreachable objects whose class overrides finalize are not freed. They are kept, with everything they refer to, and
+// queued, and finalize is run on them by a finalizer thread once the world has been resumed. They are freed by the first
+// collection that finds them unreachable again, and finalize is never run on an object twice.
 class CheneyGarbageCollector : public IGarbageCollector, public std::enable_shared_from_this<CheneyGarbageCollector>
 {
 public:
   CheneyGarbageCollector( std::shared_ptr<IThreadManager> pThreadManager, size_t poolSizeInBytes );
+
+  // Address space for maximumPoolSizeInBytes is reserved up front, but only what the pool currently needs is committed.
+  // The pool grows and shrinks after each collection, to keep the live data at around half of a semi-space.
+  CheneyGarbageCollector( std::shared_ptr<IThreadManager> pThreadManager, size_t initialPoolSizeInBytes, size_t maximumPoolSizeInBytes );
+  CheneyGarbageCollector( std::shared_ptr<IThreadManager> pThreadManager, size_t nurserySizeInBytes, size_t oldGenerationSizeInBytes, uint8_t promotionAge );
   virtual ~CheneyGarbageCollector();
 
   bool IsPointerValid( void const * const pBytes ) const;
@@ -40,28 +55,93 @@ public:
 
   virtual void AddRecentAllocation( boost::intrusive_ptr<ObjectReference> object ) JVMX_OVERRIDE;
 
+  // Must be called before any Java threads are started. 1, the default, copies on the collecting thread alone.
+  void SetCopyThreadCount( size_t threadCount );
+
 private:
+  struct ParallelCopyWorker;
+
+
   void SwapSpaces();
+  void CollectNow();
+
+  // Resizes both semi-spaces, committing or decommitting the memory behind them. Returns false if it could not be committed.
+  bool ResizeSemiSpaces( size_t semiSpaceSizeInBytes );
+  void ResizeAfterCollection();
+  bool GrowToFit( size_t sizeInBytes );
+  void LogTimeToSafepoint() const;
   GCHeader *Copy( GCHeader *pHeader );
   IJavaVariableType *Copy( ObjectReference &object );
+  GCHeader *Promote( GCHeader *pHeader );
+  void CopyReferences( GCHeader *pHeader );
+
+  static GCHeader *GetHeader( ObjectReference &object );
+  static const ReferenceMap *GetReferenceMap( const JavaObject &object );
+
+  // Calls visit with each non-null reference held by the object or array. Allocates nothing.
+  template <typename Visitor> static void ForEachReference( GCHeader *pHeader, Visitor visit );
+
+  bool IsInOldGeneration( const void *pAddress ) const;
+  bool IsInNursery( const void *pAddress ) const;
+  bool MustCollectOldGeneration() const;
+  void CollectOldGeneration( const std::set<boost::intrusive_ptr<IJavaVariableType>> &roots, std::vector<GCHeader *> &rememberedObjects );
+  void DrainMarkStack( std::vector<GCHeader *> &markStack );
+  void MarkReference( ObjectReference &object, std::vector<GCHeader *> &markStack );
+  void MarkReferencesFrom( GCHeader *pHeader, std::vector<GCHeader *> &markStack );
+  void RememberReferencesToNursery( const std::vector<GCHeader *> &candidates );
+  bool HasReferencesToNursery( GCHeader *pHeader );
 
   static void CopyHeaderInternal( char * newObjectAddress, GCHeader * pHeader );
   static void CopyObjectInternal( GCHeader * pHeader, char * newObjectAddress );
-  static void InitialiseObject( const GCHeader *pHeader, char * newObjectAddress );
+
+  // Takes m_Mutex. If another thread holds it, the calling thread counts as stopped while it waits.
+  std::unique_lock<std::recursive_mutex> LockAtSafepoint();
 
   void *Allocate( size_t sizeInBytes, e_GarbageCollectionObjectTypes type );
+  void *AllocateAndRefill( size_t sizeInBytes, e_GarbageCollectionObjectTypes type );
+
+  // Returns nullptr if there is not enough free space.
+  void *TryAllocateAndRefill( size_t sizeInBytes, e_GarbageCollectionObjectTypes type, bool canGrow );
+  void RetireAllocationBuffer( ThreadLocalAllocationBuffer &buffer );
+  static void *InitialiseHeader( char *pBlock, size_t sizeInBytes, e_GarbageCollectionObjectTypes type );
 
   void CopyReferencesInArray( GCHeader *pHeader );
   void CopyObjectFields( GCHeader *pHeader );
 
-  void CopyObjectFieldsInternal( JavaObject *pOldObject, std::shared_ptr<JavaClass> pClass );
+  void ScanCopiedObjects();
+
+  void CopyUnreachableFinalizableObjects();
+  void QueueUnmarkedFinalizableObjects( std::vector<GCHeader *> &markStack );
+  bool HasFinalizer( const std::shared_ptr<JavaClass> &pClass );
+  void WakeFinalizerThread();
+  void RunFinalizerThread( std::shared_ptr<IVirtualMachineState> pVMState );
+
+  // Runs finalize on the object at the front of the queue, on the calling thread. Returns false if the queue is empty.
+  bool RunNextFinalizer( const std::shared_ptr<IVirtualMachineState> &pVMState );
+
+  // The most to-space a parallel copy of fromSpaceUsed bytes can need, counting what is left unused in the buffers.
+  size_t GetParallelCopySpaceNeeded( size_t fromSpaceUsed ) const;
+  bool MakeRoomForParallelCopy( size_t fromSpaceUsed );
 
-  void RunFinalisersForOldObjects() const;
+  // Returns false, having copied nothing, if the worker threads could not be started.
+  bool CopyInParallel( const std::set<boost::intrusive_ptr<IJavaVariableType>> &roots, const std::vector<GCHeader *> &rememberedObjects );
+  void RunCopyWorker( size_t workerIndex, ParallelCopyWorker *pWorkers, const std::vector<boost::intrusive_ptr<IJavaVariableType>> &roots, const std::vector<GCHeader *> &rememberedObjects, std::atomic<size_t> &activeWorkerCount, std::atomic<bool> &hasFailed );
+  GCHeader *ParallelCopy( GCHeader *pHeader, ParallelCopyWorker &worker );
+  void ParallelCopyReferences( GCHeader *pHeader, ParallelCopyWorker &worker );
+  bool StealWork( size_t workerIndex, ParallelCopyWorker *pWorkers, GCHeader *&pHeader ) const;
+  bool IsWorkAvailable( ParallelCopyWorker *pWorkers ) const;
+  char *AllocateForCopy( size_t blockSize, ParallelCopyWorker &worker );
+  static void RetireCopyBuffer( ParallelCopyWorker &worker );
 
   void UpdatePointers();
 
   private:
+  // The size of both semi-spaces together, as currently committed.
   size_t m_PoolSizeInBytes;
+  size_t m_MinimumPoolSizeInBytes;
+  size_t m_MaximumPoolSizeInBytes;
+
+  // The start of the reservation. The second semi-space starts half way through it.
   char *m_pMemoryPool;
 
   char *m_pAllocPtr;
@@ -91,7 +171,36 @@ private:
 
   std::recursive_mutex m_Mutex;
 
-  bool m_IsCollecting;
+  // Read without m_Mutex by the allocation fast path.
+  std::atomic<bool> m_IsCollecting;
+
+  std::atomic<uint64_t> m_Epoch;
+
+  // Only used in generational mode.
+  std::unique_ptr<OldGeneration> m_pOldGeneration;
+  uint8_t m_PromotionAge;
+  std::atomic<bool> m_PromotionFailed;
+
+  // Guards the old generation's free list, and m_PromotedObjects, while copying in parallel.
+  std::mutex m_PromotionMutex;
+
+  // Objects promoted during the current collection. Their fields are scanned in the same way as to-space's.
+  std::vector<GCHeader *> m_PromotedObjects;
+  size_t m_ScannedPromotedObjectCount;
+
+  size_t m_CopyThreadCount;
+
+  // Guards m_pAllocPtr while copying in parallel. The collecting thread holds m_Mutex, which the workers can't take.
+  std::mutex m_CopyBufferMutex;
+
+  // Objects waiting to have finalize run on them. They are roots until it has.
+  std::mutex m_FinalizationMutex;
+  std::condition_variable m_FinalizationQueueChanged;
+  std::deque<boost::intrusive_ptr<ObjectReference>> m_FinalizationQueue;
+  std::shared_ptr<boost::thread> m_pFinalizerThread;
+
+  // Only used with m_Mutex held.
+  std::unordered_map<const JavaClass *, bool> m_HasFinalizerByClass;
 };
 
 
@@ -143,6 +143,11 @@ const DataBuffer & ClassAttributeCode::GetCode() const
   return m_Code;
 }
 
+void ClassAttributeCode::QuickenOpCode( uintptr_t programCounter, uint8_t quickOpCode ) const
+{
+  CodeSegmentDataBuffer( m_Code ).ReplaceByte( programCounter, quickOpCode );
+}
+
 uint16_t ClassAttributeCode::GetLocalVariableArraySizeIncludingPassedParameters() const
 {
   return m_LocalVariableArraySizeIncludingPassedParameters;
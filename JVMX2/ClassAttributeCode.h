@@ -34,6 +34,9 @@ public:
   virtual uint16_t GetMaximumOperandStackDepth() const;
   virtual uint16_t GetLocalVariableArraySizeIncludingPassedParameters() const;
   virtual const DataBuffer &GetCode() const;
+
+  // Rewrites the opcode at programCounter to its quick form. The rest of the instruction is left unchanged.
+  virtual void QuickenOpCode( uintptr_t programCounter, uint8_t quickOpCode ) const;
   virtual const ExceptionTable &GetExceptionTable() const;
   virtual const CodeAttributeList &GetAttributeList() const;
 
@@ -1,3 +1,6 @@
+#include <atomic>
+
+#include "IndexOutOfBoundsException.h"
 
 #include "CodeSegmentDataBuffer.h"
 
@@ -16,3 +19,15 @@ size_t CodeSegmentDataBuffer::GetByteLength() const
   return m_Data.GetByteLength();
 }
 
+void CodeSegmentDataBuffer::ReplaceByte( size_t offset, uint8_t value ) const
+{
+  if ( offset >= m_Data.GetByteLength() )
+  {
+    throw IndexOutOfBoundsException( __FUNCTION__ " - Offset was beyond the end of the code segment." );
+  }
+
+  // Anything the new byte depends on must be visible to other threads before the byte itself is.
+  std::atomic_thread_fence( std::memory_order_release );
+  *const_cast<volatile uint8_t *>( m_Data.m_pBytes + offset ) = value;
+}
+
@@ -12,6 +12,9 @@ public:
   const uint8_t *GetRawDataPointer() const;
   size_t GetByteLength() const;
 
+  // Overwrites a single byte of code that may be executing on other threads at the same time.
+  void ReplaceByte( size_t offset, uint8_t value ) const;
+
 private:
   CodeSegmentDataBuffer operator=(const CodeSegmentDataBuffer &other);
 
@@ -323,7 +323,6 @@ uint16_t DefaultClassLoader::ReadFieldCount()
 FieldInfoList DefaultClassLoader::ReadFields( const ConstantPool &pPool, size_t count )
 {
   FieldInfoList result;
-  intptr_t offset = 0;
   for ( size_t i = 0; i < count; ++i )
   {
     uint16_t accessFlags = m_fileStream.ReadUint16();
@@ -334,17 +333,47 @@ FieldInfoList DefaultClassLoader::ReadFields( const ConstantPool &pPool, size_t
     boost::intrusive_ptr<JavaString> pName = pPool.GetConstant( pMethodRef->GetNameIndex() )->AsString();
     boost::intrusive_ptr<JavaString> pType = pPool.GetConstant( pMethodRef->GetTypeDescriptorIndex() )->AsString();
 
-    auto pNewField = std::make_shared<FieldInfo>( pPool, accessFlags, pName, pType, attributes, offset );
-    result.push_back( pNewField );
-    if ( !pNewField->IsStatic() )
-    {
-      offset += pNewField->GetByteSize();
-    }
+    result.push_back( std::make_shared<FieldInfo>( pPool, accessFlags, pName, pType, attributes, 0 ) );
   }
 
+  LayOutInstanceFields( result );
+
   return result;
 }
 
+void DefaultClassLoader::LayOutInstanceFields( const FieldInfoList &fields )
+{
+  // The class's own fields get a block of their own, after the superclass's. Slots are packed widest first, so each one
+  // is naturally aligned without padding. References all share one width, and are placed together at the start of it.
+  const size_t c_SlotWidths[] = { sizeof( int64_t ), sizeof( int32_t ), sizeof( int16_t ), sizeof( int8_t ) };
+
+  size_t offset = 0;
+  for ( size_t width : c_SlotWidths )
+  {
+    for ( int pass = 0; pass < 2; ++ pass )
+    {
+      bool wantReferences = ( 0 == pass );
+
+      for ( const auto &pField : fields )
+      {
+        if ( pField->IsStatic() || width != pField->GetByteSize() )
+        {
+          continue;
+        }
+
+        bool isReference = e_JavaVariableTypes::Object == pField->GetVariableType() || e_JavaVariableTypes::Array == pField->GetVariableType();
+        if ( isReference != wantReferences )
+        {
+          continue;
+        }
+
+        pField->SetOffset( offset );
+        offset += width;
+      }
+    }
+  }
+}
+
 uint16_t DefaultClassLoader::ReadMethodCount()
 {
   try
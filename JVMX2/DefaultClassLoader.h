@@ -49,6 +49,7 @@ protected:
   virtual InterfaceInfoList ReadInterfaces( const ConstantPool &pPool, size_t count );
   virtual uint16_t ReadFieldCount();
   virtual FieldInfoList ReadFields( const ConstantPool &pPool, size_t count );
+  static void LayOutInstanceFields( const FieldInfoList &fields );
   virtual uint16_t ReadMethodCount();
   virtual MethodInfoList ReadMethods( const ConstantPool &pPool, size_t count );
   virtual uint16_t ReadAttributeCount();
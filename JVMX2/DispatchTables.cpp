@@ -0,0 +1,253 @@
+#include "ObjectReference.h"
+#include "JavaClass.h"
+#include "SuperTypeDisplay.h"
+
+#include "DispatchTables.h"
+
+namespace
+{
+  bool IsVirtualMethod( const MethodInfo &method )
+  {
+    // Static and private methods are never selected on the receiver, and neither are <init> or <clinit>.
+    if ( method.IsStatic() || method.IsPrivate() )
+    {
+      return false;
+    }
+
+    const JavaString &name = *method.GetName();
+    return name.IsEmpty() || JVMX_T( '<' ) != name.At( 0 );
+  }
+
+  // Classes are in the same runtime package if they have the same package name and the same defining loader.
+  bool IsInSameRuntimePackage( const JavaClass &left, const JavaClass &right )
+  {
+    boost::intrusive_ptr<ObjectReference> pLeftLoader = left.GetClassLoader();
+    boost::intrusive_ptr<ObjectReference> pRightLoader = right.GetClassLoader();
+
+    ObjectIndexT leftLoader = nullptr == pLeftLoader ? 0 : pLeftLoader->GetIndex();
+    ObjectIndexT rightLoader = nullptr == pRightLoader ? 0 : pRightLoader->GetIndex();
+
+    return leftLoader == rightLoader && left.GetPackageName() == right.GetPackageName();
+  }
+
+  // Whether method, declared in a subclass, overrides inheritedMethod, which has the same name and type. The inherited
+  // method is the most recent override in its slot, so a package private method that was overridden by a public one
+  // in its own package can be overridden from anywhere.
+  bool CanOverride( const MethodInfo &method, const MethodInfo &inheritedMethod )
+  {
+    if ( inheritedMethod.IsPublic() || inheritedMethod.IsProtected() )
+    {
+      return true;
+    }
+
+    return IsInSameRuntimePackage( *method.GetClass(), *inheritedMethod.GetClass() );
+  }
+}
+
+DispatchTables::DispatchTables( const MethodInfoList &methods, const DispatchTables *pSuperClassTables )
+  : m_pInterfaceMethodTables( nullptr )
+{
+  size_t inheritedMethodCount = 0;
+  if ( nullptr != pSuperClassTables )
+  {
+    m_VirtualMethods = pSuperClassTables->m_VirtualMethods;
+    inheritedMethodCount = m_VirtualMethods.size();
+  }
+
+  for ( const auto &method : methods )
+  {
+    const std::shared_ptr<MethodInfo> &pMethod = method.second;
+    if ( !IsVirtualMethod( *pMethod ) )
+    {
+      continue;
+    }
+
+    // A method can override more than one inherited slot, if a package private method was redeclared in another
+    // package and this class is back in the first package. It takes over all of them.
+    size_t methodIndex = c_InvalidVirtualTableIndex;
+    for ( size_t index = 0; index < inheritedMethodCount; ++ index )
+    {
+      const MethodInfo &inheritedMethod = *m_VirtualMethods[ index ];
+      if ( *pMethod->GetName() == *inheritedMethod.GetName() && *pMethod->GetType() == *inheritedMethod.GetType() && CanOverride( *pMethod, inheritedMethod ) )
+      {
+        m_VirtualMethods[ index ] = pMethod;
+        if ( c_InvalidVirtualTableIndex == methodIndex )
+        {
+          methodIndex = index;
+        }
+      }
+    }
+
+    if ( c_InvalidVirtualTableIndex == methodIndex )
+    {
+      methodIndex = m_VirtualMethods.size();
+      m_VirtualMethods.push_back( pMethod );
+    }
+
+    pMethod->SetVirtualTableIndex( methodIndex );
+  }
+}
+
+DispatchTables::~DispatchTables()
+{
+  InterfaceMethodTable *pTable = m_pInterfaceMethodTables.load( std::memory_order_acquire );
+  while ( nullptr != pTable )
+  {
+    InterfaceMethodTable *pNext = pTable->m_pNext;
+    delete pTable;
+    pTable = pNext;
+  }
+}
+
+std::shared_ptr<MethodInfo> DispatchTables::GetVirtualMethod( size_t index ) const JVMX_NOEXCEPT
+{
+  if ( index >= m_VirtualMethods.size() )
+  {
+    return nullptr;
+  }
+
+  return m_VirtualMethods[ index ];
+}
+
+size_t DispatchTables::GetVirtualMethodCount() const JVMX_NOEXCEPT
+{
+  return m_VirtualMethods.size();
+}
+
+std::shared_ptr<MethodInfo> DispatchTables::GetInterfaceMethod( const JavaClass &implementingClass, const JavaClass *pInterface, const DispatchTables &interfaceTables, size_t index )
+{
+  for ( InterfaceMethodTable *pTable = m_pInterfaceMethodTables.load( std::memory_order_acquire ); nullptr != pTable; pTable = pTable->m_pNext )
+  {
+    if ( pTable->m_pInterface == pInterface )
+    {
+      return index < pTable->m_Methods.size() ? pTable->m_Methods[ index ] : nullptr;
+    }
+  }
+
+  // Needed to find default methods. Nothing is built until it is available, so that the itable is never missing one.
+  const SuperTypeDisplay *pClassDisplay = implementingClass.GetSuperTypeDisplay();
+  if ( nullptr == pClassDisplay )
+  {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock( m_InterfaceMethodTablesMutex );
+
+  // Another thread may have built it while we were waiting for the lock.
+  InterfaceMethodTable *pFirst = m_pInterfaceMethodTables.load( std::memory_order_relaxed );
+  for ( InterfaceMethodTable *pTable = pFirst; nullptr != pTable; pTable = pTable->m_pNext )
+  {
+    if ( pTable->m_pInterface == pInterface )
+    {
+      return index < pTable->m_Methods.size() ? pTable->m_Methods[ index ] : nullptr;
+    }
+  }
+
+  std::unique_ptr<InterfaceMethodTable> pNewTable( new InterfaceMethodTable );
+  pNewTable->m_pInterface = pInterface;
+  pNewTable->m_pNext = pFirst;
+  pNewTable->m_Methods.reserve( interfaceTables.m_VirtualMethods.size() );
+
+  for ( const auto &pInterfaceMethod : interfaceTables.m_VirtualMethods )
+  {
+    std::shared_ptr<MethodInfo> pSelectedMethod = nullptr;
+
+    size_t selectedIndex = FindVirtualMethodIndex( *pInterfaceMethod->GetName(), *pInterfaceMethod->GetType() );
+    if ( c_InvalidVirtualTableIndex != selectedIndex )
+    {
+      pSelectedMethod = m_VirtualMethods[ selectedIndex ];
+    }
+    else
+    {
+      pSelectedMethod = SelectDefaultMethod( *pClassDisplay, *pInterfaceMethod->GetName(), *pInterfaceMethod->GetType() );
+    }
+
+    pNewTable->m_Methods.push_back( pSelectedMethod );
+  }
+
+  InterfaceMethodTable *pTable = pNewTable.release();
+  m_pInterfaceMethodTables.store( pTable, std::memory_order_release );
+
+  return index < pTable->m_Methods.size() ? pTable->m_Methods[ index ] : nullptr;
+}
+
+size_t DispatchTables::FindVirtualMethodIndex( const JavaString &name, const JavaString &type ) const JVMX_NOEXCEPT
+{
+  // Interface methods are public, so a public match is preferred over a package private method of the same name and
+  // type that sits in another slot.
+  size_t result = c_InvalidVirtualTableIndex;
+  for ( size_t index = 0; index < m_VirtualMethods.size(); ++ index )
+  {
+    const std::shared_ptr<MethodInfo> &pMethod = m_VirtualMethods[ index ];
+    if ( name == *pMethod->GetName() && type == *pMethod->GetType() )
+    {
+      if ( pMethod->IsPublic() )
+      {
+        return index;
+      }
+
+      if ( c_InvalidVirtualTableIndex == result )
+      {
+        result = index;
+      }
+    }
+  }
+
+  return result;
+}
+
+std::shared_ptr<MethodInfo> DispatchTables::SelectDefaultMethod( const SuperTypeDisplay &classDisplay, const JavaString &name, const JavaString &type )
+{
+  // The candidates are the instance methods with this name and type in every superinterface of the class, abstract or
+  // not. The maximally specific ones are those whose interface has no subinterface among the other candidates'.
+  std::vector<std::shared_ptr<MethodInfo> > candidates;
+  for ( const JavaClass *pSuperType : classDisplay.GetSecondarySuperTypes() )
+  {
+    if ( !pSuperType->IsInterface() )
+    {
+      continue;
+    }
+
+    std::shared_ptr<MethodInfo> pMethod = pSuperType->GetMethodByNameAndType( name, type );
+    if ( nullptr != pMethod && !pMethod->IsStatic() && !pMethod->IsPrivate() )
+    {
+      candidates.push_back( pMethod );
+    }
+  }
+
+  // Only selected if exactly one of the maximally specific methods is not abstract.
+  std::shared_ptr<MethodInfo> pResult = nullptr;
+  for ( const auto &pCandidate : candidates )
+  {
+    if ( pCandidate->IsAbstract() )
+    {
+      continue;
+    }
+
+    const SuperTypeDisplay *pCandidateDisplay = pCandidate->GetClass()->GetSuperTypeDisplay();
+    bool isMaximallySpecific = true;
+    for ( const auto &pOther : candidates )
+    {
+      const SuperTypeDisplay *pOtherDisplay = pOther->GetClass()->GetSuperTypeDisplay();
+      if ( pOther != pCandidate && nullptr != pCandidateDisplay && nullptr != pOtherDisplay && pOtherDisplay->IsSubtypeOf( *pCandidateDisplay ) )
+      {
+        isMaximallySpecific = false;
+        break;
+      }
+    }
+
+    if ( !isMaximallySpecific )
+    {
+      continue;
+    }
+
+    if ( nullptr != pResult )
+    {
+      return nullptr;
+    }
+
+    pResult = pCandidate;
+  }
+
+  return pResult;
+}
@@ -0,0 +1,61 @@
+#ifndef _DISPATCHTABLES__H_
+#define _DISPATCHTABLES__H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "GlobalConstants.h"
+#include "MethodInfo.h"
+
+class JavaClass;
+class SuperTypeDisplay;
+
+// The virtual method table of a class, and the interface method tables for the interfaces it is called through.
+// The vtable starts as a copy of the superclass's vtable. A method that overrides one of those takes over its slot and
+// every other virtual method is appended, so a method keeps the same index in the vtable of every subclass. A package
+// private method is only overridden from its own runtime package; elsewhere a method with the same name and type gets
+// a slot of its own.
+// Interfaces have a vtable too, which is what gives each interface method its index into an itable.
+class DispatchTables
+{
+public:
+  // Assigns vtable indices to the virtual methods in methods.
+  DispatchTables( const MethodInfoList &methods, const DispatchTables *pSuperClassTables );
+  ~DispatchTables();
+
+  // Returns nullptr if index is out of range.
+  std::shared_ptr<MethodInfo> GetVirtualMethod( size_t index ) const JVMX_NOEXCEPT;
+  size_t GetVirtualMethodCount() const JVMX_NOEXCEPT;
+
+  // Selects the implementation of the interface method at index in the interface's vtable, for implementingClass, which
+  // owns these tables. The itable for an interface is built the first time the class is called through it. When no
+  // class declares the method, the maximally specific default method is selected. Returns nullptr if there is no
+  // implementation, if the default methods are ambiguous, or if the class's interfaces have not all been loaded yet.
+  std::shared_ptr<MethodInfo> GetInterfaceMethod( const JavaClass &implementingClass, const JavaClass *pInterface, const DispatchTables &interfaceTables, size_t index );
+
+private:
+  DispatchTables( const DispatchTables &other ) JVMX_FN_DELETE;
+  DispatchTables &operator=( const DispatchTables &other ) JVMX_FN_DELETE;
+
+  size_t FindVirtualMethodIndex( const JavaString &name, const JavaString &type ) const JVMX_NOEXCEPT;
+
+  static std::shared_ptr<MethodInfo> SelectDefaultMethod( const SuperTypeDisplay &classDisplay, const JavaString &name, const JavaString &type );
+
+private:
+  struct InterfaceMethodTable
+  {
+    const JavaClass *m_pInterface;
+    std::vector<std::shared_ptr<MethodInfo> > m_Methods;
+    InterfaceMethodTable *m_pNext;
+  };
+
+  std::vector<std::shared_ptr<MethodInfo> > m_VirtualMethods;
+
+  // Itables are only ever pushed onto the front of the list, under the mutex, so they can be probed without locking.
+  std::atomic<InterfaceMethodTable *> m_pInterfaceMethodTables;
+  std::mutex m_InterfaceMethodTablesMutex;
+};
+
+#endif // _DISPATCHTABLES__H_
@@ -9,6 +9,7 @@
 #include "ConstantPool.h"
 
 #include "TypeParser.h"
+#include "IObjectRegistry.h"
 #include "GlobalCatalog.h"
 
 #include "FieldInfo.h"
@@ -19,6 +20,7 @@ FieldInfo::FieldInfo( const ConstantPool &pPool, uint16_t flags, boost::intrusiv
   , m_Attributes( attributes )
   , m_Prepared( false )
   , m_Offset( offset )
+  , m_VariableType( TypeParser::ConvertTypeDescriptorToVariableType( descriptor->At( 0 ) ) )
 {
   m_Flags.m_FlagsAsInt = flags;
 
@@ -51,6 +53,7 @@ FieldInfo::FieldInfo( const FieldInfo &other )
   , m_pStaticValue( other.m_pStaticValue )
   , m_Prepared( other.m_Prepared )
   , m_Offset( other.m_Offset )
+  , m_VariableType( other.m_VariableType )
 {}
 
 FieldInfo::FieldInfo( FieldInfo &&other )
@@ -61,6 +64,7 @@ FieldInfo::FieldInfo( FieldInfo &&other )
   , m_pStaticValue( std::move( other.m_pStaticValue ) )
   , m_Prepared( std::move( other.m_Prepared ) )
   , m_Offset( std::move( other.m_Offset ) )
+  , m_VariableType( other.m_VariableType )
 {}
 
 FieldInfo FieldInfo::operator=( FieldInfo other ) JVMX_NOEXCEPT
@@ -81,59 +85,50 @@ const CodeAttributeList &FieldInfo::GetAttributes() const
 
 size_t FieldInfo::GetByteSize() const
 {
-  switch ( TypeParser::ConvertTypeDescriptorToVariableType( m_Descriptor->At( 0 ) ) )
+  switch ( m_VariableType )
   {
     case e_JavaVariableTypes::Object:
-      return sizeof( ObjectReference );
+    case e_JavaVariableTypes::Array:
+      return sizeof( ObjectIndexT );
       break;
     case e_JavaVariableTypes::Char:
-      return sizeof( JavaChar );
+      return sizeof( char16_t );
       break;
     case e_JavaVariableTypes::Byte:
-      return sizeof( JavaByte );
+      return sizeof( int8_t );
       break;
     case e_JavaVariableTypes::Short:
-      return sizeof( JavaShort );
+      return sizeof( int16_t );
       break;
     case e_JavaVariableTypes::Integer:
-      return sizeof( JavaInteger );
+      return sizeof( int32_t );
       break;
     case e_JavaVariableTypes::Long:
-      return sizeof( JavaLong );
+      return sizeof( int64_t );
       break;
     case e_JavaVariableTypes::Float:
-      return sizeof( JavaFloat );
+      return sizeof( float );
       break;
     case e_JavaVariableTypes::Double:
-      return sizeof( JavaDouble );
-      break;
-    case e_JavaVariableTypes::String:
-      return sizeof( JavaString );
-      break;
-    case e_JavaVariableTypes::NullReference:
-      return sizeof( ObjectReference );
-      break;
-    case e_JavaVariableTypes::ReturnAddress:
-      return sizeof( intptr_t );
-      break;
-    case e_JavaVariableTypes::ClassReference:
-      return sizeof( JavaClassReference );
+      return sizeof( double );
       break;
     case e_JavaVariableTypes::Bool:
-      return sizeof( JavaBool );
-      break;
-    case e_JavaVariableTypes::Array:
-      return sizeof( ObjectReference );
+      return sizeof( bool );
       break;
 
     default:
-      throw InvalidStateException( __FUNCTION__ " - Unknown type." );
+      throw InvalidStateException( __FUNCTION__ " - Unexpected field type." );
       break;
   }
 
   return 0;
 }
 
+e_JavaVariableTypes FieldInfo::GetVariableType() const JVMX_NOEXCEPT
+{
+  return m_VariableType;
+}
+
 void FieldInfo::swap( FieldInfo &left, FieldInfo &right ) JVMX_NOEXCEPT
 {
   std::swap( left.m_Flags, right.m_Flags );
@@ -143,6 +138,7 @@ void FieldInfo::swap( FieldInfo &left, FieldInfo &right ) JVMX_NOEXCEPT
   std::swap( left.m_pStaticValue, right.m_pStaticValue );
   std::swap( left.m_Prepared, right.m_Prepared );
   std::swap( left.m_Offset, right.m_Offset );
+  std::swap( left.m_VariableType, right.m_VariableType );
 }
 
 boost::intrusive_ptr<JavaString> FieldInfo::GetName() const
@@ -160,6 +156,11 @@ size_t FieldInfo::GetOffset() const
   return m_Offset;
 }
 
+void FieldInfo::SetOffset( size_t offset ) JVMX_NOEXCEPT
+{
+  m_Offset = offset;
+}
+
 bool FieldInfo::IsStatic() const JVMX_NOEXCEPT
 {
   return 0 != ( m_Flags.m_FlagsAsInt & static_cast<uint16_t>( e_JavaFieldAccessFlags::Static ) );
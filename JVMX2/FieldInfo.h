@@ -34,9 +34,12 @@ public:
   boost::intrusive_ptr<JavaString> GetName() const;
   boost::intrusive_ptr<JavaString> GetType() const;
   virtual size_t GetOffset() const;
+  void SetOffset( size_t offset ) JVMX_NOEXCEPT;
   const CodeAttributeList &GetAttributes() const;
 
+  // The width of the field's unboxed slot in an instance.
   virtual size_t GetByteSize() const;
+  e_JavaVariableTypes GetVariableType() const JVMX_NOEXCEPT;
 
   static void swap( FieldInfo &left, FieldInfo &right ) JVMX_NOEXCEPT;
   bool IsStatic() const JVMX_NOEXCEPT;
@@ -88,6 +91,7 @@ private:
   bool m_Prepared;
 
   size_t m_Offset;
+  e_JavaVariableTypes m_VariableType;
 };
 
 typedef std::vector<std::shared_ptr<FieldInfo> > FieldInfoList;
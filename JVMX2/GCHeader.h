@@ -0,0 +1,37 @@
+#ifndef _GCHEADER__H_
+#define _GCHEADER__H_
+
+#include <atomic>
+
+#include "GlobalConstants.h"
+
+enum class e_GarbageCollectionObjectTypes : uint8_t
+{
+  Invalid = 0,
+  Object = 1,
+  Array = 2,
+  Bytes = 3,
+  Free = 4 // Unused space in the old generation.
+};
+
+// Every block in the heap starts with one of these.
+struct GCHeader
+{
+  e_GarbageCollectionObjectTypes type;
+
+  // The number of nursery collections the object has survived.
+  uint8_t age;
+
+  // Only used while the old generation is being marked.
+  bool isMarked;
+
+  // Set when the object is queued for finalization, so that finalize is run on it at most once.
+  bool isFinalized;
+
+  size_t size;
+
+  // Parallel collections claim an object by swapping this from nullptr, so only one worker ever copies it.
+  std::atomic<char *> forwardingAddress;
+};
+
+#endif // _GCHEADER__H_
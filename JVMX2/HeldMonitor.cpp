@@ -0,0 +1,34 @@
+#include "ObjectReference.h"
+
+#include "HeldMonitor.h"
+
+HeldMonitor::HeldMonitor( std::shared_ptr<Lockable> pClassMonitor )
+  : m_pClassMonitor( pClassMonitor )
+{
+}
+
+HeldMonitor::HeldMonitor( boost::intrusive_ptr<ObjectReference> pObject )
+  : m_pObject( pObject )
+{
+}
+
+void HeldMonitor::Unlock( const char *pFunctionName )
+{
+  if ( nullptr != m_pClassMonitor )
+  {
+    m_pClassMonitor->Unlock( pFunctionName );
+  }
+  else if ( e_JavaVariableTypes::Array == m_pObject->GetVariableType() )
+  {
+    m_pObject->GetContainedArray()->MonitorExit( pFunctionName );
+  }
+  else
+  {
+    m_pObject->GetContainedObject()->MonitorExit( pFunctionName );
+  }
+}
+
+boost::intrusive_ptr<ObjectReference> HeldMonitor::GetObject() const
+{
+  return m_pObject;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef _HELDMONITOR__H_
+#define _HELDMONITOR__H_
+
+#include <memory>
+
+#include <boost/intrusive_ptr.hpp>
+
+#include "GlobalConstants.h"
+#include "Lockable.h"
+
+class ObjectReference;
+
+// An entry on a thread's monitor stack. Class monitors are Lockables. Object and array monitors are thin locks in the
+// object's header, and the object may be moved while its monitor is held, so they are found again through the reference.
+class HeldMonitor
+{
+public:
+  explicit HeldMonitor( std::shared_ptr<Lockable> pClassMonitor );
+  explicit HeldMonitor( boost::intrusive_ptr<ObjectReference> pObject );
+
+  void Unlock( const char *pFunctionName );
+
+  // The locked object, or null for a class monitor.
+  boost::intrusive_ptr<ObjectReference> GetObject() const;
+
+private:
+  std::shared_ptr<Lockable> m_pClassMonitor;
+  boost::intrusive_ptr<ObjectReference> m_pObject;
+};
+
+#endif // _HELDMONITOR__H_
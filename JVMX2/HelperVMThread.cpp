@@ -99,10 +99,16 @@ void JNICALL HelperVMThread::java_lang_VMThread_interrupt( JNIEnv *pEnv, jobject
   pLogger->LogDebug( "*** Inside native Method: java_lang_VMThread_interrupt()\n" );
 #endif // _DEBUG
 
-  JNIEnvExported *pInternal = reinterpret_cast<JNIEnvExported *>( pEnv );
-  IVirtualMachineState *pVirtualMachineState = reinterpret_cast<IVirtualMachineState *>( pInternal->m_pInternal );
+  // obj is the VMThread of the thread being interrupted, which is usually not the one calling this.
+  boost::intrusive_ptr<ObjectReference> pVMThreadObject = JNIEnvInternal::ConvertJObjectToObjectPointer( obj );
+  boost::intrusive_ptr<ObjectReference> pThreadObject = boost::dynamic_pointer_cast<ObjectReference>( pVMThreadObject->GetContainedObject()->GetFieldByName( JavaString::FromCString( u"thread" ) ) );
 
-  pVirtualMachineState->Interrupt();
+  std::shared_ptr<IThreadManager> pThreadManager = GlobalCatalog::GetInstance().Get( "ThreadManager" );
+  std::shared_ptr<IVirtualMachineState> pThreadState = pThreadManager->GetThreadState( *pThreadObject );
+  if ( nullptr != pThreadState )
+  {
+    pThreadState->Interrupt();
+  }
 }
 
 
@@ -31,6 +31,8 @@ public:
 
   virtual void Halt() JVMX_PURE;
 
+  virtual void LogStatistics( const std::shared_ptr<ILogger> &pLogger ) JVMX_PURE;
+
 protected:
   IExecutionEngine() {};
 };
@@ -5,6 +5,8 @@
 
 #include "GlobalConstants.h"
 
+#include <functional>
+
 #include <wallaroo/part.h>
 
 #include "IIterator.h"
@@ -47,6 +49,11 @@ public:
 
   virtual void Cleanup() JVMX_PURE;
 
+  // As Cleanup(), for a generational collector. Objects between pOldStart and pOldEnd are not moved by a nursery
+  // collection, so whether they were updated says nothing about whether they are live. If isOldObjectLive is empty
+  // they are all kept. Otherwise it decides, updated or not, so that the old generation can be swept straight after.
+  virtual void Cleanup( const void *pOldStart, const void *pOldEnd, const std::function<bool( const IJavaVariableType *pObject )> &isOldObjectLive ) JVMX_PURE;
+
   virtual void VerifyEntry( ObjectIndexT ref ) JVMX_PURE;
 
 protected:
@@ -34,6 +34,13 @@ public:
   virtual intptr_t GetProcessID() JVMX_PURE;
 
   virtual std::string GetHostName() JVMX_PURE;
+
+  // Reserves address space without any memory behind it. Returns nullptr if the range could not be reserved.
+  virtual void *ReserveMemory( size_t sizeInBytes ) JVMX_PURE;
+  // Backs part of a reservation with zeroed, read/write memory. Returns false if the memory is not available.
+  virtual bool CommitMemory( void *pAddress, size_t sizeInBytes ) JVMX_PURE;
+  virtual void DecommitMemory( void *pAddress, size_t sizeInBytes ) JVMX_PURE;
+  virtual void ReleaseMemory( void *pAddress, size_t sizeInBytes ) JVMX_PURE;
 };
 
 #endif // __IOPERATINGSYSTEMDELEGATE_H__
@@ -32,6 +32,12 @@ public:
   virtual std::vector<boost::intrusive_ptr<IJavaVariableType>> GetRoots() JVMX_PURE;
 
   virtual std::shared_ptr<IVirtualMachineState> GetCurrentThreadState() JVMX_PURE;
+
+  // As GetCurrentThreadState, but null if the calling thread is not a Java thread, such as while the VM is starting up.
+  virtual std::shared_ptr<IVirtualMachineState> FindCurrentThreadState() JVMX_PURE;
+
+  // The state of the thread whose java.lang.Thread object is threadObject, or null if it isn't running.
+  virtual std::shared_ptr<IVirtualMachineState> GetThreadState( const ObjectReference &threadObject ) JVMX_PURE;
 };
 
 
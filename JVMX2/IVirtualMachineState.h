@@ -11,6 +11,7 @@
 #include "MethodInfo.h"
 #include "JavaTypes.h"
 #include "Lockable.h"
+#include "HeldMonitor.h"
 
 // Forward Declarations
 class IMemoryManager;
@@ -61,7 +62,8 @@ public:
 
   virtual std::shared_ptr<MethodInfo> GetMethodByNameAndType( const JavaString &className, const JavaString &methodName, const JavaString &methodType, std::shared_ptr<IClassLibrary> pConstantPool ) JVMX_PURE;
 
-  virtual void PushState( const JavaString &newClassName, const JavaString &newMethodName, const JavaString &newMethodType, std::shared_ptr<MethodInfo> pNewMethodInfo ) JVMX_PURE;
+  // The current class and method names are derived from pNewMethodInfo.
+  virtual void PushState( std::shared_ptr<MethodInfo> pNewMethodInfo ) JVMX_PURE;
   virtual void PopState() JVMX_PURE;
 
   virtual const JavaString &GetCurrentClassAndMethodName() const JVMX_PURE;
@@ -76,15 +78,39 @@ public:
   virtual boost::intrusive_ptr<IJavaVariableType> PeekOperand() JVMX_PURE;
   virtual boost::intrusive_ptr<IJavaVariableType> PeekOperandFromBack( uint8_t count ) JVMX_PURE;
 
+  // Unboxed access for the interpreter hot path. Primitives pushed here are only boxed if something later asks for
+  // them through PopOperand(), PeekOperand() or GetLocalVariable().
+  virtual void PushInteger( int32_t value ) JVMX_PURE;
+  virtual void PushLong( int64_t value ) JVMX_PURE;
+  virtual void PushFloat( float value ) JVMX_PURE;
+  virtual void PushDouble( double value ) JVMX_PURE;
+
+  virtual int32_t PopInteger() JVMX_PURE;
+  virtual int64_t PopLong() JVMX_PURE;
+  virtual float PopFloat() JVMX_PURE;
+  virtual double PopDouble() JVMX_PURE;
+
+  virtual e_JavaVariableTypes PeekOperandType() const JVMX_PURE;
+  virtual void DiscardOperand() JVMX_PURE;
+  virtual void DuplicateTopOperand() JVMX_PURE;
+
   virtual boost::intrusive_ptr<ObjectReference> SetupLocalVariables( std::shared_ptr<MethodInfo> pMethodInfo ) JVMX_PURE;
   virtual void SetupLocalVariables( std::shared_ptr<MethodInfo> pMethodInfo, boost::intrusive_ptr<ObjectReference> pObject, const std::vector<boost::intrusive_ptr<IJavaVariableType> > &paramArray ) JVMX_PURE;
 
   virtual boost::intrusive_ptr<IJavaVariableType> GetLocalVariable( uint16_t localVariableIndex ) JVMX_PURE;
   virtual void SetLocalVariable( uint16_t localVariableIndex, boost::intrusive_ptr<IJavaVariableType> pValue ) JVMX_PURE;
 
-  virtual std::shared_ptr<JavaClass> LoadClass( const JavaString &className, const JavaString &path = JavaString::EmptyString() ) JVMX_PURE;
+  virtual e_JavaVariableTypes GetLocalVariableType( uint16_t localVariableIndex ) const JVMX_PURE;
+  virtual int32_t GetLocalInteger( uint16_t localVariableIndex ) const JVMX_PURE;
+  virtual int64_t GetLocalLong( uint16_t localVariableIndex ) const JVMX_PURE;
+  virtual float GetLocalFloat( uint16_t localVariableIndex ) const JVMX_PURE;
+  virtual double GetLocalDouble( uint16_t localVariableIndex ) const JVMX_PURE;
+  virtual void SetLocalInteger( uint16_t localVariableIndex, int32_t value ) JVMX_PURE;
 
-  virtual void UpdateCurrentClassName( boost::intrusive_ptr<JavaString> pNewName ) JVMX_PURE;
+  // Moves the top of the operand stack into a local variable without boxing it.
+  virtual void StoreOperandInLocalVariable( uint16_t localVariableIndex ) JVMX_PURE;
+
+  virtual std::shared_ptr<JavaClass> LoadClass( const JavaString &className, const JavaString &path = JavaString::EmptyString() ) JVMX_PURE;
 
   virtual void ReleaseLocalVariables() JVMX_PURE;
 
@@ -119,7 +145,7 @@ public:
 
   virtual void ExecuteMethod( const JavaString &className, const JavaString &methodName, const JavaString &methodType, std::shared_ptr<MethodInfo> pInitialMethod ) JVMX_PURE;
 
-  virtual size_t CalculateNumberOfStackItemsToClear( size_t exceptionRegionStart ) const JVMX_PURE;
+  virtual size_t CalculateNumberOfStackItemsToClear() const JVMX_PURE;
 
   virtual void DoGarbageCollection() JVMX_PURE;
 
@@ -140,7 +166,8 @@ public:
   virtual void ResetException() JVMX_PURE;
 
   virtual void PushMonitor( std::shared_ptr<Lockable> pMutex ) JVMX_PURE;
-  virtual std::shared_ptr<Lockable> PopMonitor() JVMX_PURE;
+  virtual void PushMonitor( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_PURE;
+  virtual HeldMonitor PopMonitor() JVMX_PURE;
 
   virtual void PushAndZeroCallStackDepth() JVMX_PURE;
   virtual uint16_t PopCallStackDepth() JVMX_PURE;
@@ -171,6 +198,10 @@ public:
   virtual bool GetInterruptedFlag() JVMX_PURE;
   virtual void Interrupt() JVMX_PURE;
 
+  // Waits on monitor, which this thread must own, until notified, interrupted, or the timeout expires. A zero timeout
+  // never expires. Interrupt wakes the thread directly. Returns true, and clears the interrupted flag, if interrupted.
+  virtual bool WaitOnMonitor( ObjectMonitor &monitor, std::chrono::nanoseconds timeout ) JVMX_PURE;
+
   virtual std::atomic_int64_t &GetStackLevel() JVMX_PURE;
 
   // Do not call. Used by the Execution Engine.
@@ -185,6 +216,11 @@ public:
   virtual void AddLocalReference( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_PURE;
   virtual void DeleteLocalReference( boost::intrusive_ptr<ObjectReference> pObject ) JVMX_PURE;
 
+  // Objects allocated on this thread, which C++ code may be holding only in locals. They stay roots until the thread next
+  // reaches a safepoint in the same call into Java, when the C++ code that allocated them has finished.
+  virtual void AddRecentAllocation( const boost::intrusive_ptr<ObjectReference> &pObject ) JVMX_PURE;
+  virtual void ReleaseRecentAllocations() JVMX_PURE;
+
   virtual void SetExecutingNative() JVMX_PURE;
   virtual void SetExecutingHosted() JVMX_PURE;
   virtual bool IsExecutingNative() const JVMX_PURE;
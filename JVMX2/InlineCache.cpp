@@ -0,0 +1,171 @@
+#include <algorithm>
+
+#include "DataBuffer.h"
+#include "JavaOpCodes.h"
+#include "PreDecodedMethod.h"
+
+#include "InlineCache.h"
+
+namespace
+{
+  bool IsVirtualOrInterfaceCall( uint8_t opCode )
+  {
+    switch ( static_cast<e_JavaOpCodes>( opCode ) )
+    {
+      case e_JavaOpCodes::InvokeVirtual:
+      case e_JavaOpCodes::InvokeInterface:
+      case e_JavaOpCodes::InvokeVirtualQuick:
+      case e_JavaOpCodes::InvokeInterfaceQuick:
+        return true;
+
+      default:
+        break;
+    }
+
+    return false;
+  }
+}
+
+InlineCacheStatistics::InlineCacheStatistics()
+{
+  for ( size_t index = 0; index < 4; ++ index )
+  {
+    m_CallSiteCount[ index ] = 0;
+    m_Hits[ index ] = 0;
+    m_Misses[ index ] = 0;
+  }
+}
+
+InlineCache::InlineCache()
+  : m_EntryCount( 0 )
+  , m_IsMegamorphic( false )
+  , m_Hits( 0 )
+  , m_Misses( 0 )
+{
+  for ( size_t index = 0; index < c_MaximumEntries; ++ index )
+  {
+    m_Entries[ index ].m_pReceiverClass = nullptr;
+  }
+}
+
+std::shared_ptr<MethodInfo> InlineCache::Lookup( const JavaClass *pReceiverClass ) JVMX_NOEXCEPT
+{
+  size_t entryCount = m_EntryCount.load( std::memory_order_acquire );
+  for ( size_t index = 0; index < entryCount; ++ index )
+  {
+    if ( m_Entries[ index ].m_pReceiverClass == pReceiverClass )
+    {
+      m_Hits.fetch_add( 1, std::memory_order_relaxed );
+      return m_Entries[ index ].m_pSelectedMethod;
+    }
+  }
+
+  m_Misses.fetch_add( 1, std::memory_order_relaxed );
+  return nullptr;
+}
+
+void InlineCache::Add( const JavaClass *pReceiverClass, const std::shared_ptr<MethodInfo> &pSelectedMethod )
+{
+  std::lock_guard<std::mutex> lock( m_AddMutex );
+
+  size_t entryCount = m_EntryCount.load( std::memory_order_relaxed );
+  for ( size_t index = 0; index < entryCount; ++ index )
+  {
+    if ( m_Entries[ index ].m_pReceiverClass == pReceiverClass )
+    {
+      // Another thread got here first.
+      return;
+    }
+  }
+
+  if ( entryCount == c_MaximumEntries )
+  {
+    m_IsMegamorphic.store( true, std::memory_order_relaxed );
+    return;
+  }
+
+  m_Entries[ entryCount ].m_pReceiverClass = pReceiverClass;
+  m_Entries[ entryCount ].m_pSelectedMethod = pSelectedMethod;
+  m_EntryCount.store( entryCount + 1, std::memory_order_release );
+}
+
+e_InlineCacheState InlineCache::GetState() const JVMX_NOEXCEPT
+{
+  if ( m_IsMegamorphic.load( std::memory_order_relaxed ) )
+  {
+    return e_InlineCacheState::Megamorphic;
+  }
+
+  switch ( m_EntryCount.load( std::memory_order_acquire ) )
+  {
+    case 0:
+      return e_InlineCacheState::Empty;
+
+    case 1:
+      return e_InlineCacheState::Monomorphic;
+
+    default:
+      break;
+  }
+
+  return e_InlineCacheState::Polymorphic;
+}
+
+bool InlineCache::IsMegamorphic() const JVMX_NOEXCEPT
+{
+  return m_IsMegamorphic.load( std::memory_order_relaxed );
+}
+
+void InlineCache::AddStatistics( InlineCacheStatistics &statistics ) const JVMX_NOEXCEPT
+{
+  size_t state = static_cast<size_t>( GetState() );
+
+  ++ statistics.m_CallSiteCount[ state ];
+  statistics.m_Hits[ state ] += m_Hits.load( std::memory_order_relaxed );
+  statistics.m_Misses[ state ] += m_Misses.load( std::memory_order_relaxed );
+}
+
+InlineCacheTable::InlineCacheTable( const DataBuffer &code )
+{
+  const uint8_t *pCode = code.ToByteArray();
+  size_t codeLength = code.GetByteLength();
+
+  uintptr_t programCounter = 0;
+  while ( programCounter < codeLength )
+  {
+    if ( IsVirtualOrInterfaceCall( pCode[ programCounter ] ) )
+    {
+      m_CallSiteProgramCounters.push_back( programCounter );
+    }
+
+    int32_t length = PreDecodedMethod::GetInstructionLength( pCode, codeLength, programCounter );
+    if ( length <= 0 )
+    {
+      // Call sites after an instruction that cannot be measured are simply not cached.
+      break;
+    }
+
+    programCounter += length;
+  }
+
+  m_pInlineCaches.reset( new InlineCache[ m_CallSiteProgramCounters.size() ] );
+}
+
+InlineCache *InlineCacheTable::GetInlineCache( uintptr_t programCounter ) JVMX_NOEXCEPT
+{
+  auto it = std::lower_bound( m_CallSiteProgramCounters.begin(), m_CallSiteProgramCounters.end(), programCounter );
+  if ( it == m_CallSiteProgramCounters.end() || *it != programCounter )
+  {
+    return nullptr;
+  }
+
+  return &m_pInlineCaches[ it - m_CallSiteProgramCounters.begin() ];
+}
+
+void InlineCacheTable::AddStatistics( InlineCacheStatistics &statistics ) const JVMX_NOEXCEPT
+{
+  for ( size_t index = 0; index < m_CallSiteProgramCounters.size(); ++ index )
+  {
+    m_pInlineCaches[ index ].AddStatistics( statistics );
+  }
+}
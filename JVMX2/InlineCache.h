@@ -0,0 +1,94 @@
+#ifndef _INLINECACHE__H_
+#define _INLINECACHE__H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "GlobalConstants.h"
+
+class JavaClass;
+class MethodInfo;
+class DataBuffer;
+
+enum class e_InlineCacheState
+{
+  Empty = 0,
+  Monomorphic,
+  Polymorphic,
+  Megamorphic
+};
+
+struct InlineCacheStatistics
+{
+  InlineCacheStatistics();
+
+  // Indexed by e_InlineCacheState. Hits and misses are counted against the state each call site is in now.
+  size_t m_CallSiteCount[ 4 ];
+  uint64_t m_Hits[ 4 ];
+  uint64_t m_Misses[ 4 ];
+};
+
+// Caches the methods selected at one virtual or interface call site, keyed by the class of the receiver. A call site is
+// monomorphic while it has seen one receiver class, polymorphic while it has seen up to c_MaximumEntries, and megamorphic
+// after that, at which point callers go straight to the receiver's vtable or itable instead.
+// Lookups never lock. Entries are added under a lock, and are never changed once they are visible to other threads.
+class InlineCache
+{
+public:
+  static const size_t c_MaximumEntries = 4;
+
+  InlineCache();
+
+  // Returns nullptr on a miss.
+  std::shared_ptr<MethodInfo> Lookup( const JavaClass *pReceiverClass ) JVMX_NOEXCEPT;
+  void Add( const JavaClass *pReceiverClass, const std::shared_ptr<MethodInfo> &pSelectedMethod );
+
+  e_InlineCacheState GetState() const JVMX_NOEXCEPT;
+  bool IsMegamorphic() const JVMX_NOEXCEPT;
+
+  void AddStatistics( InlineCacheStatistics &statistics ) const JVMX_NOEXCEPT;
+
+private:
+  InlineCache( const InlineCache &other ) JVMX_FN_DELETE;
+  InlineCache &operator=( const InlineCache &other ) JVMX_FN_DELETE;
+
+private:
+  struct Entry
+  {
+    const JavaClass *m_pReceiverClass;
+    std::shared_ptr<MethodInfo> m_pSelectedMethod;
+  };
+
+  Entry m_Entries[ c_MaximumEntries ];
+  std::atomic<size_t> m_EntryCount;
+  std::atomic<bool> m_IsMegamorphic;
+  std::mutex m_AddMutex;
+
+  std::atomic<uint64_t> m_Hits;
+  std::atomic<uint64_t> m_Misses;
+};
+
+// The inline caches for every virtual and interface call site in one method. Call sites are found by scanning the code
+// once, when the table is created.
+class InlineCacheTable
+{
+public:
+  explicit InlineCacheTable( const DataBuffer &code );
+
+  // Returns nullptr if there is no virtual or interface call at programCounter.
+  InlineCache *GetInlineCache( uintptr_t programCounter ) JVMX_NOEXCEPT;
+
+  void AddStatistics( InlineCacheStatistics &statistics ) const JVMX_NOEXCEPT;
+
+private:
+  InlineCacheTable( const InlineCacheTable &other ) JVMX_FN_DELETE;
+  InlineCacheTable &operator=( const InlineCacheTable &other ) JVMX_FN_DELETE;
+
+private:
+  std::vector<uintptr_t> m_CallSiteProgramCounters; // Sorted.
+  std::unique_ptr<InlineCache[]> m_pInlineCaches;
+};
+
+#endif // _INLINECACHE__H_
@@ -2,7 +2,11 @@
 //
 
 #include <tchar.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <memory>
 
 #include <boost/program_options.hpp>
@@ -12,6 +16,7 @@
 
 #include "BasicVirtualMachineState.h"
 #include "VirtualMachine.h"
+#include "VirtualMachineOptions.h"
 
 const char* pVersion = "v0.0.1-alpha";
 
@@ -28,6 +33,16 @@ void Usage(std::ostream& stream)
   stream << "Options:\n";
   stream << "  -cp, --class-path <class search path of directories>\n";
   stream << "\t\tA ; separated list of directories to search for class files.\n";
+  stream << "  --engine <basic|threaded>\n";
+  stream << "\t\tSelects the interpreter. basic is the default.\n";
+  stream << "  --engine-stats\tLogs execution engine statistics, such as inline cache hit rates, on exit.\n";
+  stream << "  --gc <copying|generational>\n";
+  stream << "\t\tSelects the garbage collector. copying is the default.\n";
+  stream << "  --gc-threads <count>\n";
+  stream << "\t\tThe number of threads that copy live objects. 0 uses one per core. 1 is the default.\n";
+  stream << "  -Xms<size>\t\tThe initial size of the copying heap, e.g. -Xms64m. 16m is the default.\n";
+  stream << "  -Xmx<size>\t\tThe maximum size of the copying heap, e.g. -Xmx1g. 100m is the default.\n";
+  stream << "\t\tSizes may not be more than half the address space.\n";
   stream << "  -h, --help\t\tPrint this message\n";
   stream << "  -v, --version\t\tPrints version information\n";
 }
@@ -40,6 +55,7 @@ public:
   std::vector<std::string> classPath;
   std::vector<std::string> classArguments;
   std::string currentExe;
+  VirtualMachineOptions options;
 };
 
 void PrintVersion()
@@ -47,6 +63,59 @@ void PrintVersion()
   std::cout << "JVMX 2 - Version " << pVersion << std::endl;
 }
 
+// Parses a size in bytes, with an optional k, m or g suffix. Sizes of more than half the address space are rejected,
+// as the heap could never reserve them, and rounding them up to whole pages could wrap around.
+bool ParseMemorySize(const char* pText, size_t& size)
+{
+  // strtoull would skip leading white space and negate a leading '-'.
+  if (!std::isdigit(static_cast<unsigned char>(*pText)))
+  {
+    return false;
+  }
+
+  char* pEnd = nullptr;
+  errno = 0;
+  unsigned long long value = std::strtoull(pText, &pEnd, 10);
+  if (errno == ERANGE)
+  {
+    return false;
+  }
+
+  unsigned long long multiplier = 1;
+  switch (*pEnd)
+  {
+  case 'k':
+  case 'K':
+    multiplier = 1024;
+    ++pEnd;
+    break;
+
+  case 'm':
+  case 'M':
+    multiplier = 1024 * 1024;
+    ++pEnd;
+    break;
+
+  case 'g':
+  case 'G':
+    multiplier = 1024 * 1024 * 1024;
+    ++pEnd;
+    break;
+
+  default:
+    break;
+  }
+
+  const unsigned long long maximumSize = std::numeric_limits<size_t>::max() / 2;
+  if (*pEnd != '\0' || value == 0 || value > maximumSize / multiplier)
+  {
+    return false;
+  }
+
+  size = static_cast<size_t>(value * multiplier);
+  return true;
+}
+
 std::vector<std::string> Split(const std::string& input, char delimiter)
 {
   std::vector<std::string> result;
@@ -134,6 +203,116 @@ int ProcessCommandLine(int argc, char* argv[], CommandLine& cmdLine)
       continue;
     }
 
+    if (arg == "--engine")
+    {
+      if (i + 1 >= argc)
+      {
+        std::cerr << "Error: missing engine name\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      std::string engine = argv[i + 1];
+      if (engine == "basic")
+      {
+        cmdLine.options.m_ExecutionEngineType = e_ExecutionEngineType::Basic;
+      }
+      else if (engine == "threaded")
+      {
+        cmdLine.options.m_ExecutionEngineType = e_ExecutionEngineType::Threaded;
+      }
+      else
+      {
+        std::cerr << "Error: unknown engine " << engine << "\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      ++i;
+      continue;
+    }
+
+    if (arg == "--gc")
+    {
+      if (i + 1 >= argc)
+      {
+        std::cerr << "Error: missing garbage collector name\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      std::string collector = argv[i + 1];
+      if (collector == "copying")
+      {
+        cmdLine.options.m_GarbageCollectorType = e_GarbageCollectorType::Copying;
+      }
+      else if (collector == "generational")
+      {
+        cmdLine.options.m_GarbageCollectorType = e_GarbageCollectorType::Generational;
+      }
+      else
+      {
+        std::cerr << "Error: unknown garbage collector " << collector << "\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      ++i;
+      continue;
+    }
+
+    if (arg == "--gc-threads")
+    {
+      if (i + 1 >= argc)
+      {
+        std::cerr << "Error: missing garbage collection thread count\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      char* pEnd = nullptr;
+      unsigned long threadCount = std::strtoul(argv[i + 1], &pEnd, 10);
+      if (pEnd == argv[i + 1] || *pEnd != '\0')
+      {
+        std::cerr << "Error: invalid garbage collection thread count " << argv[i + 1] << "\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      cmdLine.options.m_GarbageCollectionThreadCount = threadCount;
+
+      ++i;
+      continue;
+    }
+
+    if (arg == "--engine-stats")
+    {
+      cmdLine.options.m_LogEngineStatistics = true;
+      continue;
+    }
+
+    if (arg.compare(0, 4, "-Xms") == 0 || arg.compare(0, 4, "-Xmx") == 0)
+    {
+      size_t heapSize = 0;
+      if (!ParseMemorySize(arg.c_str() + 4, heapSize))
+      {
+        std::cerr << "Error: invalid heap size " << arg << "\n\n";
+        Usage(std::cerr);
+        return 1;
+      }
+
+      if (arg[3] == 's')
+      {
+        cmdLine.options.m_InitialHeapSize = heapSize;
+      }
+      else
+      {
+        cmdLine.options.m_MaximumHeapSize = heapSize;
+      }
+
+      continue;
+    }
+
     Usage(std::cerr);
     return 1;
   }
@@ -145,6 +324,13 @@ int ProcessCommandLine(int argc, char* argv[], CommandLine& cmdLine)
     return 1;
   }
 
+  if (cmdLine.options.m_MaximumHeapSize != 0 && cmdLine.options.m_InitialHeapSize > cmdLine.options.m_MaximumHeapSize)
+  {
+    std::cerr << "Error: the initial heap size is larger than the maximum heap size\n\n";
+    Usage(std::cerr);
+    return 1;
+  }
+
   return 0;
 }
 
@@ -162,7 +348,7 @@ int main(int argc, char* argv[])
 
   try
   {
-    std::shared_ptr<VirtualMachine> pJVM = VirtualMachine::Create();
+    std::shared_ptr<VirtualMachine> pJVM = VirtualMachine::Create(cmdLine.options);
     std::shared_ptr<BasicVirtualMachineState> pInitialState = std::make_shared<BasicVirtualMachineState>(pJVM);
 
     pJVM->Initialise(cmdLine.mainClass.empty() ? cmdLine.jarFile : cmdLine.mainClass, pInitialState);
@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "MallocFreeMemoryManager.h"
 
 #include "IndexOutOfBoundsException.h"
@@ -16,11 +18,11 @@
 #include "TypeParser.h"
 
 #include "JavaArray.h"
+#include "WriteBarrier.h"
 
 JavaArray::JavaArray( /*std::shared_ptr<IMemoryManager> pMemoryManager,*/ e_JavaArrayTypes type, size_t size )
   : m_ContainedType( type )
   , m_Size( size )
-  , m_pMonitor( new Lockable )
     //, m_pValues( size, TypeParser::GetDefaultValue( type ) )
 #ifdef _DEBUG
   , debugInitialLength( size )
@@ -49,39 +51,39 @@ size_t JavaArray::GetSizeOfValueType( e_JavaArrayTypes type )
   switch ( type )
   {
     case e_JavaArrayTypes::Boolean:
-      return sizeof( JavaBool );
+      return sizeof( bool );
       break;
 
     case e_JavaArrayTypes::Char:
-      return sizeof( JavaChar );
+      return sizeof( char16_t );
       break;
 
     case e_JavaArrayTypes::Float:
-      return sizeof( JavaFloat );
+      return sizeof( float );
       break;
 
     case e_JavaArrayTypes::Double:
-      return sizeof( JavaDouble );
+      return sizeof( double );
       break;
 
     case e_JavaArrayTypes::Byte:
-      return sizeof( JavaByte );
+      return sizeof( int8_t );
       break;
 
     case e_JavaArrayTypes::Short:
-      return sizeof( JavaShort );
+      return sizeof( int16_t );
       break;
 
     case e_JavaArrayTypes::Integer:
-      return sizeof( JavaInteger );
+      return sizeof( int32_t );
       break;
 
     case e_JavaArrayTypes::Long:
-      return sizeof( JavaLong );
+      return sizeof( int64_t );
       break;
 
     case e_JavaArrayTypes::Reference:
-      return sizeof( ObjectReference );
+      return sizeof( ObjectIndexT );
       break;
 
     default:
@@ -94,12 +96,6 @@ size_t JavaArray::GetSizeOfValueType( e_JavaArrayTypes type )
 
 JavaArray::~JavaArray()
 {
-
-  for ( size_t i = 0; i < m_Size; ++ i )
-  {
-    IJavaVariableType *pValue = GetValueAtIndex( i );
-    pValue->~IJavaVariableType();
-  }
 }
 
 // JavaArray::JavaArray( const JavaArray &other )
@@ -132,7 +128,7 @@ e_JavaVariableTypes JavaArray::GetVariableType() const
 bool JavaArray::operator==( const JavaArray &other ) const
 {
   DebugAssert();
-  return m_ContainedType == other.m_ContainedType && memcmp( m_pValues, other.m_pValues, CalculateSizeInBytes( m_ContainedType, m_Size ) );
+  return ElementsEqual( other );
 }
 
 bool JavaArray::operator==( const IJavaVariableType &other ) const
@@ -148,32 +144,59 @@ bool JavaArray::operator==( const IJavaVariableType &other ) const
   return *this == *( dynamic_cast<const ObjectReference *>( &other )->GetContainedArray() );
 }
 
-IJavaVariableType *JavaArray::At( size_t index )
+boost::intrusive_ptr<IJavaVariableType> JavaArray::At( size_t index ) const
 {
   DebugAssert();
 
-  if ( index > m_Size )
+  if ( index >= m_Size )
   {
     throw IndexOutOfBoundsException( __FUNCTION__ " - Invalid index passed into array." );
   }
 
-  DebugAssert();
-#ifdef _DEBUG
-  if ( GetValueAtIndex( index )->GetVariableType() == e_JavaVariableTypes::Object )
+  switch ( m_ContainedType )
   {
-    if ( reinterpret_cast<ObjectReference *>( GetValueAtIndex( index ) )->ToJObject() == ( void * )5079 )
-    {
-      int x = 0;
-    }
-  }
-#endif // _DEBUG
+    case e_JavaArrayTypes::Boolean:
+      return new JavaBool( JavaBool::FromBool( GetElementAt<bool>( index ) ) );
+      break;
 
-  return GetValueAtIndex( index );
-}
+    case e_JavaArrayTypes::Char:
+      return new JavaChar( JavaChar::FromChar16( GetElementAt<char16_t>( index ) ) );
+      break;
 
-const IJavaVariableType *JavaArray::At( size_t index ) const
-{
-  return const_cast<JavaArray *>( this )->At( index );
+    case e_JavaArrayTypes::Float:
+      return new JavaFloat( JavaFloat::FromHostFloat( GetElementAt<float>( index ) ) );
+      break;
+
+    case e_JavaArrayTypes::Double:
+      return new JavaDouble( JavaDouble::FromHostDouble( GetElementAt<double>( index ) ) );
+      break;
+
+    case e_JavaArrayTypes::Byte:
+      return new JavaByte( JavaByte::FromHostInt8( GetElementAt<int8_t>( index ) ) );
+      break;
+
+    case e_JavaArrayTypes::Short:
+      return new JavaShort( JavaShort::FromHostInt16( GetElementAt<int16_t>( index ) ) );
+      break;
+
+    case e_JavaArrayTypes::Integer:
+      return new JavaInteger( JavaInteger::FromHostInt32( GetElementAt<int32_t>( index ) ) );
+      break;
+
+    case e_JavaArrayTypes::Long:
+      return new JavaLong( JavaLong::FromHostInt64( GetElementAt<int64_t>( index ) ) );
+      break;
+
+    case e_JavaArrayTypes::Reference:
+      return new ObjectReference( GetElementAt<ObjectIndexT>( index ) );
+      break;
+
+    default:
+      throw InvalidStateException( __FUNCTION__ " - Unknown type." );
+      break;
+  }
+
+  return nullptr;
 }
 
 size_t JavaArray::GetNumberOfElements() const
@@ -270,18 +293,7 @@ void JavaArray::SetAt( const uint32_t &index, const JavaInteger &value )
     throw IndexOutOfBoundsException( __FUNCTION__ " - Invalid index passed in." );
   }
 
-  if ( GetValueAtIndex( 0 )->GetVariableType() != value.GetVariableType() &&
-       GetValueAtIndex( 0 )->IsIntegerCompatible() )
-  {
-    auto pInteger = TypeParser::UpCastToInteger( &value );
-    auto result = TypeParser::DownCastFromInteger( pInteger, GetValueAtIndex( 0 )->GetVariableType() );
-
-    InternalSetValue( index, result.get() );
-  }
-  else
-  {
-    InternalSetValue( index, &value );
-  }
+  StoreElement( index, value );
 }
 
 void JavaArray::SetAt( const uint32_t &index, const JavaChar &value )
@@ -296,12 +308,12 @@ void JavaArray::SetAt( const uint32_t &index, const JavaChar &value )
     throw IndexOutOfBoundsException( __FUNCTION__ " - Invalid index passed in. Less than zero." );
   }
 
-  if ( index > m_Size )
+  if ( index >= m_Size )
   {
     throw IndexOutOfBoundsException( __FUNCTION__ " - Invalid index passed in." );
   }
 
-  InternalSetValue( index, &value );
+  StoreElement( index, value );
 }
 
 void JavaArray::SetAt( const uint32_t &index, const IJavaVariableType *pValue )
@@ -316,24 +328,12 @@ void JavaArray::SetAt( const uint32_t &index, const IJavaVariableType *pValue )
     throw IndexOutOfBoundsException( __FUNCTION__ " - Invalid index passed in. Less than zero." );
   }
 
-  if ( index > m_Size )
+  if ( index >= m_Size )
   {
     throw IndexOutOfBoundsException( __FUNCTION__ " - Invalid index passed in." );
   }
 
-  if ( GetValueAtIndex( 0 )->GetVariableType() != pValue->GetVariableType() &&
-       GetValueAtIndex( 0 )->IsIntegerCompatible() && pValue->IsIntegerCompatible() )
-  {
-    auto pInteger = TypeParser::UpCastToInteger( pValue );
-    auto result = TypeParser::DownCastFromInteger( pInteger, GetValueAtIndex( 0 )->GetVariableType() );
-
-    InternalSetValue( index, result.get() );
-  }
-  else
-  {
-    InternalSetValue( index, pValue );
-  }
-
+  StoreElement( index, *pValue );
 }
 
 JavaString JavaArray::ConvertCharArrayToString() const
@@ -372,7 +372,7 @@ JavaString JavaArray::ConvertByteArrayToString() const
     //for ( auto it = m_pValues.begin(); it != m_pValues.end(); ++ it )
     for ( size_t index = 0; index < m_Size; ++ index )
     {
-      char chr = reinterpret_cast<const JavaByte *>( GetValueAtIndex( index ) )->ToHostInt8();
+      char chr = GetElementAt<int8_t>( index );
       pBuffer[ i++ ] = chr;
 
       // Exit after we have appended the null character.
@@ -401,82 +401,20 @@ void JavaArray::Initialise()
 {
   DebugAssert();
 
-  for ( size_t i = 0; i < m_Size; ++ i )
-  {
-    IJavaVariableType *pValue = GetValueAtIndex( i );
-    //*pValue = *TypeParser::GetDefaultValue( m_ContainedType );
-
-    switch ( m_ContainedType )
-    {
-      case e_JavaArrayTypes::Boolean:
-        new ( pValue ) JavaBool( JavaBool::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Char:
-        new ( pValue ) JavaChar( JavaChar::DefaultChar() );
-        break;
-
-      case e_JavaArrayTypes::Float:
-        new ( pValue ) JavaFloat( JavaFloat::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Double:
-        new ( pValue ) JavaDouble( JavaDouble::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Byte:
-        new ( pValue ) JavaByte( JavaByte::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Short:
-        new ( pValue ) JavaShort( JavaShort::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Integer:
-        new ( pValue ) JavaInteger( JavaInteger::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Long:
-        new ( pValue ) JavaLong( JavaLong::FromDefault() );
-        break;
-
-      case e_JavaArrayTypes::Reference:
-        new ( pValue ) ObjectReference( nullptr );
-        break;
-
-      default:
-        throw InvalidArgumentException( __FUNCTION__ " - Unknown type." );
-        break;
-    }
-  }
+  // Every element's default value is all zero bits, including the null reference.
+  memset( m_pValues, 0, CalculateSizeInBytes( m_ContainedType, m_Size ) );
 
   DebugAssert();
 }
 
-IJavaVariableType *JavaArray::GetValueAtIndex( size_t i )
+void JavaArray::MonitorEnter( const char *pFunctionName )
 {
-  char *pValue = m_pValues + ( GetSizeOfValueType( m_ContainedType ) * i );
-  JVMX_ASSERT( pValue >= m_pValues && pValue < m_pValues + CalculateSizeInBytes( m_ContainedType, m_Size ) );
-  return reinterpret_cast<IJavaVariableType *>( pValue );
-}
-
-const IJavaVariableType *JavaArray::GetValueAtIndex( size_t i ) const
-{
-  const char *pValue = m_pValues + ( GetSizeOfValueType( m_ContainedType ) * i );
-  JVMX_ASSERT( pValue >= m_pValues && pValue < m_pValues + CalculateSizeInBytes( m_ContainedType, m_Size ) );
-
-  return reinterpret_cast<const IJavaVariableType *>( pValue );
-}
-
-std::shared_ptr<Lockable> JavaArray::MonitorEnter( const char *pFunctionName )
-{
-  m_pMonitor->Lock( pFunctionName );
-  return m_pMonitor;
+  m_Lock.Lock();
 }
 
 void JavaArray::MonitorExit( const char *pFunctionName )
 {
-  m_pMonitor->Unlock( pFunctionName );
+  m_Lock.Unlock();
 }
 
 void JavaArray::CloneOther( const JavaArray *pObjectToClone )
@@ -490,17 +428,65 @@ void JavaArray::CloneOther( const JavaArray *pObjectToClone )
 
   JVMX_ASSERT( pObjectToClone->m_Size == m_Size );
 
-  for ( uint32_t i = 0; i < pObjectToClone->GetNumberOfElements(); ++ i )
+  CopyElements( *pObjectToClone, 0, *this, 0, m_Size );
+}
+
+void JavaArray::CopyElements( const JavaArray &source, size_t sourceIndex, JavaArray &destination, size_t destinationIndex, size_t count )
+{
+  if ( source.m_ContainedType != destination.m_ContainedType )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Contained types do not match." );
+  }
+
+  if ( sourceIndex > source.m_Size || count > source.m_Size - sourceIndex || destinationIndex > destination.m_Size || count > destination.m_Size - destinationIndex )
+  {
+    throw IndexOutOfBoundsException( __FUNCTION__ " - Range is outside the array." );
+  }
+
+  size_t elementSize = GetSizeOfValueType( source.m_ContainedType );
+
+  // memmove, as the source and destination may be the same array, with overlapping ranges.
+  memmove( destination.m_pValues + destinationIndex * elementSize, source.m_pValues + sourceIndex * elementSize, count * elementSize );
+
+  if ( e_JavaArrayTypes::Reference == destination.m_ContainedType )
   {
-    SetAt( JavaInteger::FromHostInt32( i ), pObjectToClone->At( i ) );
+    WriteBarrier::OnStore( &destination );
   }
 }
 
-void JavaArray::DeepClone( const JavaArray *pObjectToClone )
+void JavaArray::FillElements( size_t startIndex, size_t count, const IJavaVariableType &value )
 {
-  CloneOther( pObjectToClone );
+  if ( startIndex > m_Size || count > m_Size - startIndex )
+  {
+    throw IndexOutOfBoundsException( __FUNCTION__ " - Range is outside the array." );
+  }
+
+  if ( 0 == count )
+  {
+    return;
+  }
+
+  StoreElement( startIndex, value );
+
+  // Copy the filled part onto the part after it, doubling each time, so that the work is done by memcpy in ever larger
+  // blocks rather than one element at a time.
+  size_t elementSize = GetSizeOfValueType( m_ContainedType );
+  char *pStart = m_pValues + startIndex * elementSize;
+  size_t totalBytes = count * elementSize;
 
-  m_pMonitor = pObjectToClone->m_pMonitor;
+  for ( size_t filledBytes = elementSize; filledBytes < totalBytes; )
+  {
+    size_t blockSize = std::min( filledBytes, totalBytes - filledBytes );
+    memcpy( pStart + filledBytes, pStart, blockSize );
+    filledBytes += blockSize;
+  }
+}
+
+bool JavaArray::ElementsEqual( const JavaArray &other ) const
+{
+  // Bitwise, as Arrays.equals compares floating point elements by their bits.
+  return m_ContainedType == other.m_ContainedType && m_Size == other.m_Size &&
+         0 == memcmp( m_pValues, other.m_pValues, CalculateSizeInBytes( m_ContainedType, m_Size ) );
 }
 
 bool JavaArray::AreTypesCompatible( e_JavaArrayTypes arrayType, e_JavaVariableTypes variableType )
@@ -611,9 +597,7 @@ DataBuffer JavaArray::ConvertByteArrayToBuffer() const
   DataBuffer result = DataBuffer::EmptyBuffer();
   for ( size_t i = 0; i < m_Size; ++ i )
   {
-    const IJavaVariableType *pValue = GetValueAtIndex( i );
-    uint8_t byteValue = dynamic_cast<const JavaByte *>( pValue )->ToHostInt8();
-    result = result.AppendUint8( byteValue );
+    result = result.AppendUint8( static_cast<uint8_t>( GetElementAt<int8_t>( i ) ) );
   }
 
   return result;
@@ -689,8 +673,7 @@ JavaString JavaArray::ToString() const
   for ( size_t i = 0; i < m_Size; ++ i )
     //for ( auto value : m_pValues )
   {
-    const IJavaVariableType *pValue = GetValueAtIndex( i );
-    result = result.Append( pValue->ToString() );
+    result = result.Append( At( i )->ToString() );
     if ( i != m_Size )
     {
       result = result.Append( JVMX_T( ", " ) );
@@ -718,14 +701,104 @@ void JavaArray::DebugAssert() const
 #endif // _DEBUG
 }
 
-void JavaArray::InternalSetValue( size_t index, const IJavaVariableType *pFinalValue )
+void JavaArray::StoreElement( size_t index, const IJavaVariableType &value )
 {
-  IJavaVariableType *pValue = GetValueAtIndex( index );
-  *pValue = *pFinalValue;
+  // The integer types narrow the value as JavaInteger's conversions do. The others convert by assigning it to a
+  // temporary of the element's boxed type.
+  switch ( m_ContainedType )
+  {
+    case e_JavaArrayTypes::Boolean:
+      SetElementAt( index, 0 != ConvertToHostInt32( value ) );
+      break;
+
+    case e_JavaArrayTypes::Char:
+      SetElementAt( index, static_cast<char16_t>( ConvertToHostInt32( value ) ) );
+      break;
+
+    case e_JavaArrayTypes::Byte:
+      SetElementAt( index, static_cast<int8_t>( ConvertToHostInt32( value ) ) );
+      break;
+
+    case e_JavaArrayTypes::Short:
+      SetElementAt( index, static_cast<int16_t>( ConvertToHostInt32( value ) ) );
+      break;
+
+    case e_JavaArrayTypes::Integer:
+      SetElementAt( index, ConvertToHostInt32( value ) );
+      break;
+
+    case e_JavaArrayTypes::Float:
+      {
+        JavaFloat element = JavaFloat::FromDefault();
+        element = value;
+        SetElementAt( index, element.ToHostFloat() );
+      }
+      break;
+
+    case e_JavaArrayTypes::Double:
+      {
+        JavaDouble element = JavaDouble::FromDefault();
+        element = value;
+        SetElementAt( index, element.ToHostDouble() );
+      }
+      break;
+
+    case e_JavaArrayTypes::Long:
+      {
+        JavaLong element = JavaLong::FromDefault();
+        element = value;
+        SetElementAt( index, element.ToHostInt64() );
+      }
+      break;
+
+    case e_JavaArrayTypes::Reference:
+      {
+        ObjectReference element( nullptr );
+        element = value;
+        SetElementAt( index, element.GetIndex() );
+
+        WriteBarrier::OnStore( this );
+      }
+      break;
+
+    default:
+      throw InvalidStateException( __FUNCTION__ " - Unknown type." );
+      break;
+  }
 
   DebugAssert();
 }
 
+int32_t JavaArray::ConvertToHostInt32( const IJavaVariableType &value )
+{
+  switch ( value.GetVariableType() )
+  {
+    case e_JavaVariableTypes::Char:
+      return static_cast<const JavaChar &>( value ).ToUInt16();
+      break;
+
+    case e_JavaVariableTypes::Byte:
+      return static_cast<const JavaByte &>( value ).ToHostInt8();
+      break;
+
+    case e_JavaVariableTypes::Short:
+      return static_cast<const JavaShort &>( value ).ToHostInt16();
+      break;
+
+    case e_JavaVariableTypes::Integer:
+      return static_cast<const JavaInteger &>( value ).ToHostInt32();
+      break;
+
+    case e_JavaVariableTypes::Bool:
+      return static_cast<const JavaBool &>( value ).ToBool() ? 1 : 0;
+      break;
+
+    default:
+      throw InvalidArgumentException( __FUNCTION__ " - This type is not compatible with the integer type." );
+      break;
+  }
+}
+
 bool JavaArray::IsNull() const
 {
   return false;
@@ -3,19 +3,23 @@
 
 #include <vector>
 #include <mutex>
+#include <cstring>
 
 #include <boost/intrusive_ptr.hpp>
 
 #include "GlobalConstants.h"
 #include "IJavaVariableType.h"
+#include "IObjectRegistry.h"
 #include "JavaArrayTypes.h"
 #include "MemoryAllocator.h"
-#include "Lockable.h"
+#include "ThinLock.h"
 
 class JavaInteger;
 class JavaChar;
 class ObjectReference;
 
+// Arrays are relocatable, in the same way as JavaObjects. Elements are held unboxed, as a plain C array of the element's
+// host type. Reference elements are held as object indices.
 class JavaArray : protected IJavaVariableType
 {
   friend class BasicVirtualMachineState;
@@ -54,10 +58,20 @@ public:
 
   static boost::intrusive_ptr<ObjectReference> CreateFromCArray( /*std::shared_ptr<IMemoryManager> pMemoryManager,*/ const char *pBuffer );
 
-  virtual IJavaVariableType *At( size_t index );
-  virtual const IJavaVariableType *At( size_t index ) const;
+  // A boxed copy of the element. Use GetElementAt where the element type is known, as it doesn't allocate.
+  virtual boost::intrusive_ptr<IJavaVariableType> At( size_t index ) const;
   virtual size_t GetNumberOfElements() const;
 
+  // T is the element's host type: bool, char16_t, int8_t, int16_t, int32_t, int64_t, float or double, or ObjectIndexT for
+  // arrays of references. No bounds checks, no conversion and no write barrier, so don't use SetElementAt for references.
+  template <typename T> T GetElementAt( size_t index ) const;
+  template <typename T> void SetElementAt( size_t index, T value );
+
+  // Bulk operations on the raw elements. These go through memmove, memcmp and memcpy, which are vectorised.
+  static void CopyElements( const JavaArray &source, size_t sourceIndex, JavaArray &destination, size_t destinationIndex, size_t count );
+  void FillElements( size_t startIndex, size_t count, const IJavaVariableType &value );
+  bool ElementsEqual( const JavaArray &other ) const;
+
   void SetAt( const JavaInteger &index, const JavaInteger &value );
   void SetAt( const JavaInteger &index, const JavaChar &value );
   void SetAt( const JavaInteger &index, const IJavaVariableType *pValue );
@@ -73,22 +87,17 @@ public:
   boost::intrusive_ptr<IJavaVariableType> ConvertIntegerTypeForArrayStorage( const JavaInteger &value ) const;
   //boost::intrusive_ptr<IJavaVariableType> ConvertReferenceTypeForArrayStorage( const IJavaVariableType *pValue ) const;
 
-  std::shared_ptr<Lockable> MonitorEnter( const char *pFunctionName );
+  void MonitorEnter( const char *pFunctionName );
   void MonitorExit( const char *pFunctionName );
 
   void CloneOther( const JavaArray *pObjectToClone );
 
-  // ONLY TO BE USED FOR GARBAGE COLLECTION
-  void DeepClone( const JavaArray *pObjectToClone );
-
 private:
   void Initialise();
 
-  IJavaVariableType *GetValueAtIndex( size_t i );
-  const IJavaVariableType *GetValueAtIndex( size_t i ) const;
-
   void DebugAssert() const;
-  void InternalSetValue( const size_t index, const IJavaVariableType *pFinalValue );
+  void StoreElement( size_t index, const IJavaVariableType &value );
+  static int32_t ConvertToHostInt32( const IJavaVariableType &value );
 
 
 
@@ -111,16 +120,35 @@ private:
   size_t m_Size;
 
 private:
-  std::shared_ptr<Lockable> m_pMonitor;
+  ThinLock m_Lock;
 
 #ifdef _DEBUG
   size_t debugInitialLength;
 #endif // _DEBUG
 
 private:
-  char m_pValues[1];
+  alignas( 8 ) char m_pValues[1];
 public:
 
 };
 
+// memcpy rather than a cast, as the elements are only aligned relative to the start of the array.
+template <typename T>
+T JavaArray::GetElementAt( size_t index ) const
+{
+  JVMX_ASSERT( index < m_Size );
+
+  T value;
+  memcpy( &value, m_pValues + index * sizeof( T ), sizeof( T ) );
+  return value;
+}
+
+template <typename T>
+void JavaArray::SetElementAt( size_t index, T value )
+{
+  JVMX_ASSERT( index < m_Size );
+
+  memcpy( m_pValues + index * sizeof( T ), &value, sizeof( T ) );
+}
+
 #endif // _JAVAARRAY__H_
@@ -1,3 +1,4 @@
+#include <algorithm>
 
 #include "InvalidArgumentException.h"
 #include "InternalErrorException.h"
@@ -14,11 +15,18 @@
 #include "JavaTypes.h"
 
 #include "JavaClass.h"
+#include "DispatchTables.h"
+#include "SuperTypeDisplay.h"
+#include "ReferenceMap.h"
 #include "GlobalCatalog.h"
 #include "IClassLibrary.h"
 
 const ConstantPoolIndex c_DefaultIndex = 1;
 
+// Each class's field block is padded to this, so that a subclass's block starts as aligned as the widest slot in it.
+const size_t c_FieldBlockAlignment = sizeof( int64_t );
+const size_t c_InstanceSizeNotCalculated = SIZE_MAX;
+
 extern const JavaString c_JavaLangClassName;
 
 JavaClass::JavaClass( uint16_t minorVersion, uint16_t majorVersion, std::shared_ptr<ConstantPool> pConstantPool, uint16_t accessFlags, ConstantPoolIndex thisClassIndex, ConstantPoolIndex superClassIndex, InterfaceInfoList interfaces, FieldInfoList fields, MethodInfoList methods, CodeAttributeList attributes, boost::intrusive_ptr<ObjectReference> pClassLoader )
@@ -29,6 +37,7 @@ JavaClass::JavaClass( uint16_t minorVersion, uint16_t majorVersion, std::shared_
   , m_MinorVersion( minorVersion )
   , m_MajorVersion( majorVersion )
   , m_pConstantPool( pConstantPool )
+  , m_pResolvedConstantPool( nullptr )
   , m_ThisClassReferenceIndex( thisClassIndex )
   , m_SuperClassReferenceIndex( superClassIndex )
   , m_Interfaces( std::move( interfaces ) )
@@ -38,6 +47,10 @@ JavaClass::JavaClass( uint16_t minorVersion, uint16_t majorVersion, std::shared_
   , m_Initialised( false )
   , m_Initialising( false )
   , m_pMonitor( std::make_shared<Lockable>() )
+  , m_pPublishedDispatchTables( nullptr )
+  , m_pPublishedSuperTypeDisplay( nullptr )
+  , m_pPublishedReferenceMap( nullptr )
+  , m_InstanceSizeInBytes( c_InstanceSizeNotCalculated )
 {
   if ( nullptr == pConstantPool )
   {
@@ -45,6 +58,8 @@ JavaClass::JavaClass( uint16_t minorVersion, uint16_t majorVersion, std::shared_
       __FUNCTION__ " - NULL constant pool was passed on creation of JavaClassFile" );
   }
 
+  m_pResolvedConstantPool = std::make_shared<ResolvedConstantPool>( m_pConstantPool->GetCount() );
+
   SetupClassName();
   SetupSuperClassName();
   SetupMethods();
@@ -68,8 +83,13 @@ JavaClass::JavaClass( const JavaClass &other )
   , m_Initialised( other.m_Initialised )
   , m_Initialising( other.m_Initialising )
   , m_pMonitor( std::make_shared<Lockable>() ) // NOT copying m_pMonitor
+  , m_pPublishedDispatchTables( nullptr ) // The copy's tables are rebuilt on first use.
+  , m_pPublishedSuperTypeDisplay( nullptr )
+  , m_pPublishedReferenceMap( nullptr )
+  , m_InstanceSizeInBytes( c_InstanceSizeNotCalculated )
 {
   m_pConstantPool = std::make_shared<ConstantPool>( *other.m_pConstantPool );
+  m_pResolvedConstantPool = std::make_shared<ResolvedConstantPool>( m_pConstantPool->GetCount() );
   SetupMethods();
 
   SetupSuperClass();
@@ -80,6 +100,10 @@ JavaClass::JavaClass( JavaClass &&other ) JVMX_NOEXCEPT
 m_pSuperClass( other.m_pSuperClass )
 , m_ThisClassReferenceIndex( c_DefaultIndex )
 , m_SuperClassReferenceIndex( c_DefaultIndex )
+, m_pPublishedDispatchTables( nullptr )
+, m_pPublishedSuperTypeDisplay( nullptr )
+, m_pPublishedReferenceMap( nullptr )
+, m_InstanceSizeInBytes( c_InstanceSizeNotCalculated )
 {
   m_pConstantPool = nullptr;
 
@@ -94,9 +118,15 @@ JavaClass::~JavaClass()
 
 size_t JavaClass::CalculateInstanceSizeInBytes() const
 {
+  size_t result = m_InstanceSizeInBytes.load( std::memory_order_acquire );
+  if ( c_InstanceSizeNotCalculated != result )
+  {
+    return result;
+  }
+
   SetupSuperClass();
 
-  size_t result = 0;
+  result = 0;
 
   for ( auto field : m_Fields )
   {
@@ -105,14 +135,22 @@ size_t JavaClass::CalculateInstanceSizeInBytes() const
       continue;
     }
 
-    result += field->GetByteSize();
+    result = std::max( result, field->GetOffset() + field->GetByteSize() );
   }
 
+  result = ( result + c_FieldBlockAlignment - 1 ) & ~( c_FieldBlockAlignment - 1 );
+
   if ( nullptr != m_pSuperClass )
   {
     result += m_pSuperClass->CalculateInstanceSizeInBytes();
   }
+  else if ( !m_pSuperClassName->IsEmpty() )
+  {
+    // Not linked yet, so don't keep the answer.
+    return result;
+  }
 
+  m_InstanceSizeInBytes.store( result, std::memory_order_release );
   return result;
 }
 
@@ -154,6 +192,7 @@ void JavaClass::swap( JavaClass &left, JavaClass &right ) JVMX_NOEXCEPT
   std::swap( left.m_MajorVersion, right.m_MajorVersion );
   std::swap( left.m_MinorVersion, right.m_MinorVersion );
   std::swap( left.m_pConstantPool, right.m_pConstantPool );
+  std::swap( left.m_pResolvedConstantPool, right.m_pResolvedConstantPool );
   std::swap( left.m_AccessFlags, right.m_AccessFlags );
   std::swap( left.m_ThisClassReferenceIndex, right.m_ThisClassReferenceIndex );
   std::swap( left.m_SuperClassReferenceIndex, right.m_SuperClassReferenceIndex );
@@ -167,6 +206,21 @@ void JavaClass::swap( JavaClass &left, JavaClass &right ) JVMX_NOEXCEPT
   std::swap( left.m_Initialised, right.m_Initialised );
   std::swap( left.m_Initialising, right.m_Initialising );
   std::swap( left.m_pMonitor, right.m_pMonitor );
+  std::swap( left.m_pDispatchTables, right.m_pDispatchTables );
+
+  DispatchTables *pLeftDispatchTables = left.m_pPublishedDispatchTables.load();
+  left.m_pPublishedDispatchTables.store( right.m_pPublishedDispatchTables.load() );
+  right.m_pPublishedDispatchTables.store( pLeftDispatchTables );
+
+  std::swap( left.m_pReferenceMap, right.m_pReferenceMap );
+
+  const ReferenceMap *pLeftReferenceMap = left.m_pPublishedReferenceMap.load();
+  left.m_pPublishedReferenceMap.store( right.m_pPublishedReferenceMap.load() );
+  right.m_pPublishedReferenceMap.store( pLeftReferenceMap );
+
+  size_t leftInstanceSize = left.m_InstanceSizeInBytes.load();
+  left.m_InstanceSizeInBytes.store( right.m_InstanceSizeInBytes.load() );
+  right.m_InstanceSizeInBytes.store( leftInstanceSize );
 }
 
 bool JavaClass::IsPublic() const
@@ -318,6 +372,189 @@ void JavaClass::SetupSuperClass() const
     std::shared_ptr<IClassLibrary> pLibrary = GlobalCatalog::GetInstance().Get( "ClassLibrary" );
     m_pSuperClass = pLibrary->FindClass( *m_pSuperClassName );
   }
+
+  SetupDispatchTables();
+  SetupReferenceMap();
+}
+
+void JavaClass::SetupDispatchTables() const
+{
+  if ( nullptr != m_pPublishedDispatchTables.load( std::memory_order_acquire ) )
+  {
+    return;
+  }
+
+  const DispatchTables *pSuperClassTables = nullptr;
+  if ( !m_pSuperClassName->IsEmpty() )
+  {
+    if ( nullptr == m_pSuperClass )
+    {
+      // The superclass has not been loaded yet. This is tried again the next time the superclass is set up.
+      return;
+    }
+
+    pSuperClassTables = m_pSuperClass->GetDispatchTables();
+    if ( nullptr == pSuperClassTables )
+    {
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock( m_LinkingMutex );
+
+  if ( nullptr == m_pDispatchTables )
+  {
+    m_pDispatchTables = std::make_shared<DispatchTables>( m_Methods, pSuperClassTables );
+    m_pPublishedDispatchTables.store( m_pDispatchTables.get(), std::memory_order_release );
+  }
+}
+
+void JavaClass::SetupReferenceMap() const
+{
+  if ( nullptr != m_pPublishedReferenceMap.load( std::memory_order_acquire ) )
+  {
+    return;
+  }
+
+  const ReferenceMap *pSuperClassMap = nullptr;
+  size_t superClassInstanceSize = 0;
+  if ( !m_pSuperClassName->IsEmpty() )
+  {
+    if ( nullptr == m_pSuperClass )
+    {
+      return;
+    }
+
+    pSuperClassMap = m_pSuperClass->GetReferenceMap();
+    if ( nullptr == pSuperClassMap )
+    {
+      return;
+    }
+
+    superClassInstanceSize = m_pSuperClass->CalculateInstanceSizeInBytes();
+  }
+
+  std::lock_guard<std::mutex> lock( m_LinkingMutex );
+
+  if ( nullptr == m_pReferenceMap )
+  {
+    m_pReferenceMap = std::make_shared<ReferenceMap>( pSuperClassMap, superClassInstanceSize, m_Fields );
+    m_pPublishedReferenceMap.store( m_pReferenceMap.get(), std::memory_order_release );
+  }
+}
+
+const ReferenceMap *JavaClass::GetReferenceMap() const
+{
+  const ReferenceMap *pResult = m_pPublishedReferenceMap.load( std::memory_order_acquire );
+  if ( nullptr == pResult )
+  {
+    SetupSuperClass();
+    pResult = m_pPublishedReferenceMap.load( std::memory_order_acquire );
+  }
+
+  return pResult;
+}
+
+DispatchTables *JavaClass::GetDispatchTables() const
+{
+  DispatchTables *pResult = m_pPublishedDispatchTables.load( std::memory_order_acquire );
+  if ( nullptr == pResult )
+  {
+    SetupSuperClass();
+    pResult = m_pPublishedDispatchTables.load( std::memory_order_acquire );
+  }
+
+  return pResult;
+}
+
+const SuperTypeDisplay *JavaClass::GetSuperTypeDisplay() const
+{
+  const SuperTypeDisplay *pResult = m_pPublishedSuperTypeDisplay.load( std::memory_order_acquire );
+  if ( nullptr != pResult )
+  {
+    return pResult;
+  }
+
+  SetupSuperClass();
+
+  const SuperTypeDisplay *pSuperClassDisplay = nullptr;
+  if ( !m_pSuperClassName->IsEmpty() )
+  {
+    if ( nullptr == m_pSuperClass )
+    {
+      return nullptr;
+    }
+
+    pSuperClassDisplay = m_pSuperClass->GetSuperTypeDisplay();
+    if ( nullptr == pSuperClassDisplay )
+    {
+      return nullptr;
+    }
+  }
+
+  std::shared_ptr<IClassLibrary> pLibrary = GlobalCatalog::GetInstance().Get( "ClassLibrary" );
+
+  std::vector<const SuperTypeDisplay *> interfaceDisplays;
+  interfaceDisplays.reserve( m_Interfaces.size() );
+  for ( const auto &interfaceInfo : m_Interfaces )
+  {
+    std::shared_ptr<JavaClass> pInterface = pLibrary->FindClass( interfaceInfo.GetName() );
+    if ( nullptr == pInterface )
+    {
+      return nullptr;
+    }
+
+    const SuperTypeDisplay *pInterfaceDisplay = pInterface->GetSuperTypeDisplay();
+    if ( nullptr == pInterfaceDisplay )
+    {
+      return nullptr;
+    }
+
+    interfaceDisplays.push_back( pInterfaceDisplay );
+  }
+
+  std::lock_guard<std::mutex> lock( m_LinkingMutex );
+
+  if ( nullptr == m_pSuperTypeDisplay )
+  {
+    m_pSuperTypeDisplay = std::make_shared<SuperTypeDisplay>( this, IsInterface(), pSuperClassDisplay, interfaceDisplays );
+    m_pPublishedSuperTypeDisplay.store( m_pSuperTypeDisplay.get(), std::memory_order_release );
+  }
+
+  return m_pSuperTypeDisplay.get();
+}
+
+std::shared_ptr<MethodInfo> JavaClass::SelectVirtualMethod( const MethodInfo &resolvedMethod ) const
+{
+  DispatchTables *pTables = GetDispatchTables();
+  if ( nullptr == pTables )
+  {
+    return nullptr;
+  }
+
+  std::shared_ptr<MethodInfo> pResult = pTables->GetVirtualMethod( resolvedMethod.GetVirtualTableIndex() );
+  JVMX_ASSERT( nullptr == pResult || *pResult->GetName() == *resolvedMethod.GetName() );
+
+  return pResult;
+}
+
+std::shared_ptr<MethodInfo> JavaClass::SelectInterfaceMethod( const MethodInfo &resolvedMethod ) const
+{
+  const JavaClass *pInterface = resolvedMethod.GetClass();
+  if ( !pInterface->IsInterface() )
+  {
+    // Methods of java/lang/Object can be invoked through an interface too.
+    return SelectVirtualMethod( resolvedMethod );
+  }
+
+  DispatchTables *pTables = GetDispatchTables();
+  DispatchTables *pInterfaceTables = pInterface->GetDispatchTables();
+  if ( nullptr == pTables || nullptr == pInterfaceTables || c_InvalidVirtualTableIndex == resolvedMethod.GetVirtualTableIndex() )
+  {
+    return nullptr;
+  }
+
+  return pTables->GetInterfaceMethod( *this, pInterface, *pInterfaceTables, resolvedMethod.GetVirtualTableIndex() );
 }
 
 
@@ -570,4 +807,9 @@ std::recursive_mutex &JavaClass::GetInitialisationMutex()
 std::shared_ptr<ConstantPool> JavaClass::GetConstantPool()
 {
   return m_pConstantPool;
+}
+
+ResolvedConstantPool &JavaClass::GetResolvedConstantPool()
+{
+  return *m_pResolvedConstantPool;
 }
\ No newline at end of file
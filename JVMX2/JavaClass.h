@@ -1,6 +1,7 @@
 #ifndef __JAVACLASSFILE_H__
 #define __JAVACLASSFILE_H__
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
@@ -13,12 +14,16 @@
 #include "FieldInfo.h"
 #include "InterfaceInfo.h"
 #include "Lockable.h"
+#include "ResolvedConstantPool.h"
 
 // Forward Declarations
 class ObjectReference;
 class ConstantPoolEntry;
 class DefaultClassLoader; 
 class ConstantPoolNameAndTypeDescriptor;
+class DispatchTables;
+class SuperTypeDisplay;
+class ReferenceMap;
 
 enum class e_PublicOnly
 {
@@ -81,6 +86,24 @@ public:
 
   void SetupSuperClass() const;
 
+  // The vtable and itables, built once the superclass has been set up. Returns nullptr if the superclass has not been
+  // loaded yet.
+  DispatchTables *GetDispatchTables() const;
+
+  // Select the method to run when resolvedMethod is invoked on an instance of this class, through the vtable or the
+  // itable of the method's interface. Both return nullptr if the tables cannot answer, and the caller should fall back
+  // to looking the method up by name.
+  std::shared_ptr<MethodInfo> SelectVirtualMethod( const MethodInfo &resolvedMethod ) const;
+  std::shared_ptr<MethodInfo> SelectInterfaceMethod( const MethodInfo &resolvedMethod ) const;
+
+  // The display used for instanceof, checkcast and catch matching. Returns nullptr if the superclass or any of the
+  // interfaces the class implements, directly or not, has not been loaded yet.
+  const SuperTypeDisplay *GetSuperTypeDisplay() const;
+
+  // The offsets of the reference fields in an instance, for the garbage collector. Built with the dispatch tables, and
+  // nullptr until they are.
+  const ReferenceMap *GetReferenceMap() const;
+
   virtual std::shared_ptr<FieldInfo> GetFieldByIndex( size_t fieldIndex ) const;
   virtual std::shared_ptr<FieldInfo> GetFieldByName( const JavaString &fieldName ) const;
 
@@ -112,6 +135,9 @@ public:
   virtual ConstantPoolEntry GetConstant( size_t index ) const;
   virtual std::shared_ptr<ConstantPool> GetConstantPool();
 
+  // Symbolic references from this class's constant pool, resolved on first use.
+  ResolvedConstantPool &GetResolvedConstantPool();
+
   virtual void SetInitialised();
   virtual void SetInitialising();
 
@@ -130,6 +156,8 @@ protected:
   void SetupClassName();
   void SetupSuperClassName();
   void SetupMethods();
+  void SetupDispatchTables() const;
+  void SetupReferenceMap() const;
 
 private:
   boost::intrusive_ptr<JavaString> m_pClassName;
@@ -143,6 +171,7 @@ private:
   uint16_t m_MinorVersion;
   uint16_t m_MajorVersion;
   std::shared_ptr<ConstantPool> m_pConstantPool;
+  std::shared_ptr<ResolvedConstantPool> m_pResolvedConstantPool;
 
   ConstantPoolIndex m_ThisClassReferenceIndex;
   ConstantPoolIndex m_SuperClassReferenceIndex;
@@ -157,6 +186,25 @@ private:
 
   std::shared_ptr<Lockable> m_pMonitor;
   mutable std::recursive_mutex m_InitialisationMutex;
+
+  // m_pDispatchTables owns the tables. m_pPublishedDispatchTables is set after it, and is what readers use.
+  mutable std::shared_ptr<DispatchTables> m_pDispatchTables;
+  mutable std::atomic<DispatchTables *> m_pPublishedDispatchTables;
+
+  // Owned and published in the same way as the dispatch tables. The display refers to this object by address, so it is
+  // neither copied nor swapped.
+  mutable std::shared_ptr<SuperTypeDisplay> m_pSuperTypeDisplay;
+  mutable std::atomic<const SuperTypeDisplay *> m_pPublishedSuperTypeDisplay;
+
+  // Owned and published in the same way as the dispatch tables.
+  mutable std::shared_ptr<ReferenceMap> m_pReferenceMap;
+  mutable std::atomic<const ReferenceMap *> m_pPublishedReferenceMap;
+
+  // Superclass instance size plus this class's own field block. Calculated once the superclass is known.
+  mutable std::atomic<size_t> m_InstanceSizeInBytes;
+
+  // Held while the dispatch tables, the super type display or the reference map are built.
+  mutable std::mutex m_LinkingMutex;
 };
 
 #endif // __JAVACLASSFILE_H__
@@ -1,4 +1,7 @@
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "GlobalConstants.h"
 
 #include "IJavaVariableType.h"
@@ -21,149 +24,26 @@
 #include "JavaObject.h"
 #include "HelperTypes.h"
 #include "JavaExceptionConstants.h"
+#include "WriteBarrier.h"
 
 extern const JavaString c_SyntheticField_ClassName;
 
+static const int64_t c_MaxWaitMilliseconds = static_cast<int64_t>( 1 ) << 40;
+
 JavaObject::JavaObject( std::shared_ptr<JavaClass> pClass )
   : m_pClass( pClass )
-  , m_pMonitor( std::make_shared<Lockable>() )
-  , m_Waitable( std::make_shared<std::condition_variable_any>() )
-  , m_Notfied( false )
 {
   if ( nullptr == pClass )
   {
     throw InvalidArgumentException( __FUNCTION__ " - Expected a non-null class pointer." );
   }
 
-#ifdef _DEBUG
-  memset( m_pFields, 0xAC, pClass->CalculateInstanceSizeInBytes() );
-#endif // _DEBUG
-
-  InitialiseFields( m_pClass );
-}
-
-size_t JavaObject::InitialiseFields( const std::shared_ptr<JavaClass> &pClass )
-{
-  if ( nullptr == pClass )
-  {
-    return 0;
-  }
-
-#ifdef _DEBUG
-  size_t debugInstanceSize = pClass->CalculateInstanceSizeInBytes();
-  //memset( m_pFields, 0xAC, debugInstanceSize );
-#endif // _DEBUG
-
-  size_t startingOffset = InitialiseFields( pClass->GetSuperClass() );
-
-  //   std::shared_ptr<JavaClass> pSuperClass = m_pClass->GetSuperClass();
-  //   while ( nullptr != pSuperClass )
-  //   {
-  //     for ( size_t i = 0; i < pSuperClass->GetFieldCount(); ++i )
-  //     {
-  //       startingOffset += InitialiseField( pSuperClass, i, startingOffset );
-  //     }
-  //
-  //     pSuperClass = pSuperClass->GetSuperClass();
-  //   }
-
-  for ( size_t i = 0; i < pClass->GetLocalFieldCount( e_PublicOnly::No ); ++i )
-  {
-    InitialiseField( pClass, i, startingOffset );
-  }
-
-  return pClass->CalculateInstanceSizeInBytes();
-}
-
-size_t JavaObject::InitialiseField( std::shared_ptr<JavaClass> pClass, int i, size_t startingOffset )
-{
-  std::shared_ptr<FieldInfo> pInfo = pClass->GetFieldByIndex( i );
-  if ( pInfo->IsStatic() )
-  {
-    return 0;
-  }
-
-  char *pAddress = m_pFields + pInfo->GetOffset() + startingOffset;
-
-#ifdef _DEBUG
-  //  m_DebugList.push_back( std::pair<JavaString, size_t>( *pInfo->GetName(), pInfo->GetOffset() + startingOffset ) );
-#endif // _DEBUG
-
-#ifdef _DEBUG
-  char c = *pAddress;
-  if ( c != ( char )0xAC )
-  {
-    JVMX_ASSERT( false );
-  }
-#endif // _DEBUG
-
-  switch ( TypeParser::ConvertTypeDescriptorToVariableType( pInfo->GetType()->At( 0 ) ) )
-  {
-    case e_JavaVariableTypes::Char:
-      new ( pAddress ) JavaChar( JavaChar::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Byte:
-      new ( pAddress ) JavaByte( JavaByte::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Short:
-      new ( pAddress ) JavaShort( JavaShort::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Integer:
-      new ( pAddress ) JavaInteger( JavaInteger::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Long:
-      new ( pAddress ) JavaLong( JavaLong::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Float:
-      new ( pAddress ) JavaFloat( JavaFloat::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Double:
-      new ( pAddress ) JavaDouble( JavaDouble::FromDefault() );
-      break;
-    case e_JavaVariableTypes::String:
-      new ( pAddress ) JavaString( JavaString::EmptyString() );
-      break;
-    case e_JavaVariableTypes::NullReference:
-      JVMX_ASSERT( false );
-      new ( pAddress ) ObjectReference( nullptr );
-      break;
-    case e_JavaVariableTypes::ReturnAddress:
-      new ( pAddress ) JavaReturnAddress( JavaReturnAddress( 0 ) );
-      break;
-    case e_JavaVariableTypes::ClassReference:
-      JVMX_ASSERT( false );
-      throw InvalidStateException( __FUNCTION__ " - Unexpected field type." );
-      break;
-    case e_JavaVariableTypes::Bool:
-      new ( pAddress ) JavaBool( JavaBool::FromDefault() );
-      break;
-    case e_JavaVariableTypes::Array:
-      {
-        //new (pAddress) ObjectReference( *HelperTypes::CreateArray( e_JavaArrayTypes::Char, 0 ) );
-        new ( pAddress ) ObjectReference( nullptr );
-      }
-      break;
-    case e_JavaVariableTypes::Object:
-      new ( pAddress ) ObjectReference( nullptr );
-      break;
-    default:
-      throw InvalidStateException( __FUNCTION__ " - Invalid field type." );
-      break;
-  }
-
-  return pInfo->GetByteSize();
+  // Every field's default value is all zero bits, including the null reference.
+  memset( m_pFields, 0, pClass->CalculateInstanceSizeInBytes() );
 }
 
-bool JavaObject::ThrowJavaExceptionIfInterrupted() const
+void JavaObject::ThrowInterruptedException( const std::shared_ptr<IVirtualMachineState> &pCurrentThreadState )
 {
-  std::shared_ptr<IThreadManager> pThreadManager = GlobalCatalog::GetInstance().Get( "ThreadManager" );
-  std::shared_ptr<IVirtualMachineState> pCurrentThreadState = pThreadManager->GetCurrentThreadState();
-
-  if ( !pCurrentThreadState->GetInterruptedFlag() )
-  {
-    return false;
-  }
-
   auto pClass = pCurrentThreadState->LoadClass( JavaString::FromCString( c_JavaInterruptedException ) );
   if ( nullptr == pClass )
   {
@@ -177,8 +57,6 @@ bool JavaObject::ThrowJavaExceptionIfInterrupted() const
 
   auto pExceptionObject = pCurrentThreadState->CreateObject( pClass );
   pCurrentThreadState->SetExceptionThrown( pExceptionObject );
-
-  return true;
 }
 
 void JavaObject::Wait( JavaLong milliSeconds, JavaInteger nanoSeconds )
@@ -188,44 +66,17 @@ void JavaObject::Wait( JavaLong milliSeconds, JavaInteger nanoSeconds )
   pLogger->LogDebug( "Waiting on object : (%s)", ToString().ToUtf8String().c_str() );
 #endif // _DEBUG
 
-  // We don't set m_Notified to false here, because if the notify happens before the wait, it would be ignored.
-
-  size_t recursionLevel = m_pMonitor->GetRecursionLevel();
-  for ( size_t i = 0; i < recursionLevel; ++i )
-  {
-    m_pMonitor->Unlock( __FUNCTION__ );
-  }
-
-  if ( 0 == milliSeconds.ToHostInt64() && 0 == nanoSeconds.ToHostInt32() )
-  {
-    std::unique_lock<Lockable> lock( *m_pMonitor );
-    while ( !m_Notfied )
-    {
-      m_Waitable->wait_for( lock, std::chrono::milliseconds( 1000 ) + std::chrono::nanoseconds( nanoSeconds.ToHostInt32() ) );
-
-      if ( ThrowJavaExceptionIfInterrupted() )
-      {
-        break;
-      }
-      //m_Waitable->wait( lock );
-    }
-    lock.unlock();
-  }
-  else
-  {
-    std::unique_lock<Lockable> lock( *m_pMonitor );
-    m_Waitable->wait_for( lock, std::chrono::milliseconds( milliSeconds.ToHostInt64() ) + std::chrono::nanoseconds( nanoSeconds.ToHostInt32() ), [this] { return m_Notfied; } );
+  std::shared_ptr<IThreadManager> pThreadManager = GlobalCatalog::GetInstance().Get( "ThreadManager" );
+  std::shared_ptr<IVirtualMachineState> pCurrentThreadState = pThreadManager->GetCurrentThreadState();
 
-    ThrowJavaExceptionIfInterrupted();
-  }
+  // Clamped so that the timeout can't overflow when it is converted to nanoseconds. That is still decades.
+  std::chrono::nanoseconds timeout = std::chrono::milliseconds( std::min( milliSeconds.ToHostInt64(), c_MaxWaitMilliseconds ) ) + std::chrono::nanoseconds( nanoSeconds.ToHostInt32() );
 
-  for ( size_t i = 0; i < recursionLevel; ++i )
+  // The object may be moved while we wait, so nothing in it is touched after this. The monitor itself doesn't move.
+  if ( pCurrentThreadState->WaitOnMonitor( m_Lock.GetMonitor(), timeout ) )
   {
-    m_pMonitor->Lock( __FUNCTION__ );
+    ThrowInterruptedException( pCurrentThreadState );
   }
-
-  // We set m_Notified to false here so that it is reset for next time.
-  m_Notfied = false;
 }
 
 void JavaObject::NotifyOne()
@@ -235,8 +86,11 @@ void JavaObject::NotifyOne()
   pLogger->LogDebug( "Notifying one on object : (%s)", ToString().ToUtf8String().c_str() );
 #endif // _DEBUG
 
-  m_Notfied = true;
-  m_Waitable->notify_one();
+  ObjectMonitor *pMonitor = m_Lock.GetMonitorToNotify();
+  if ( nullptr != pMonitor )
+  {
+    pMonitor->NotifyOne();
+  }
 }
 
 void JavaObject::NotifyAll()
@@ -246,8 +100,11 @@ void JavaObject::NotifyAll()
   pLogger->LogDebug( "Notifying all on object : (%s)\n", ToString().ToUtf8String().c_str() );
 #endif // _DEBUG
 
-  m_Notfied = true;
-  m_Waitable->notify_all();
+  ObjectMonitor *pMonitor = m_Lock.GetMonitorToNotify();
+  if ( nullptr != pMonitor )
+  {
+    pMonitor->NotifyAll();
+  }
 }
 
 bool JavaObject::IsInstanceOf( const JavaString &pPossibleSuperClassName ) const
@@ -357,83 +214,170 @@ std::shared_ptr<FieldInfo>  JavaObject::ResolveField( const JavaString &name, si
 
 boost::intrusive_ptr<IJavaVariableType> JavaObject::GetFieldByNameConst( const JavaString &name ) const
 {
-  //  this does not take into account super classes :(
-
-  size_t startingOffset = 0; // CalculateStartingOffset();
+  size_t startingOffset = 0;
 
   std::shared_ptr<FieldInfo> pFieldInfo = ResolveField( name, startingOffset );
-
-  const IJavaVariableType *pFieldValue = reinterpret_cast<const IJavaVariableType *>( m_pFields + startingOffset + pFieldInfo->GetOffset() );
   if ( nullptr == pFieldInfo )
   {
     throw IndexOutOfBoundsException( __FUNCTION__ " - Field does not exist or is static." );
   }
 
-  JVMX_ASSERT( pFieldValue->IsNull() || pFieldValue->GetVariableType() == e_JavaVariableTypes::Array ||
-               pFieldValue->GetVariableType() == TypeParser::ConvertTypeDescriptorToVariableType( pFieldInfo->GetType()->At( 0 ) ) );
+  AssertValid();
+
+  return LoadField( startingOffset + pFieldInfo->GetOffset(), pFieldInfo->GetVariableType() );
+}
+
+boost::intrusive_ptr<IJavaVariableType> JavaObject::GetFieldAtOffset( size_t fieldOffset, e_JavaVariableTypes fieldType ) const
+{
+  AssertValid();
+
+  return LoadField( fieldOffset, fieldType );
+}
+
+ObjectIndexT JavaObject::GetReferenceIndexAtOffset( size_t fieldOffset ) const
+{
+  return GetSlotAtOffset<ObjectIndexT>( fieldOffset );
+}
+
+void JavaObject::SetFieldAtOffset( size_t fieldOffset, e_JavaVariableTypes fieldType, const IJavaVariableType *pNewValue )
+{
+  AssertValid();
+
+  JVMX_ASSERT( nullptr != pNewValue );
+
+  StoreField( fieldOffset, fieldType, *pNewValue );
+}
 
-  switch ( pFieldValue->GetVariableType() )
+boost::intrusive_ptr<IJavaVariableType> JavaObject::LoadField( size_t fieldOffset, e_JavaVariableTypes fieldType ) const
+{
+  switch ( fieldType )
   {
     case e_JavaVariableTypes::Char:
-      return new JavaChar( *dynamic_cast<const JavaChar *>( pFieldValue ) );
+      return new JavaChar( JavaChar::FromChar16( GetSlotAtOffset<char16_t>( fieldOffset ) ) );
       break;
     case e_JavaVariableTypes::Byte:
-      return new JavaByte( *dynamic_cast<const JavaByte *>( pFieldValue ) );
+      return new JavaByte( JavaByte::FromHostInt8( GetSlotAtOffset<int8_t>( fieldOffset ) ) );
       break;
     case e_JavaVariableTypes::Short:
-      return new JavaShort( *dynamic_cast<const JavaShort *>( pFieldValue ) );
+      return new JavaShort( JavaShort::FromHostInt16( GetSlotAtOffset<int16_t>( fieldOffset ) ) );
       break;
     case e_JavaVariableTypes::Integer:
-      return new JavaInteger( *dynamic_cast<const JavaInteger *>( pFieldValue ) );
+      return new JavaInteger( JavaInteger::FromHostInt32( GetSlotAtOffset<int32_t>( fieldOffset ) ) );
       break;
     case e_JavaVariableTypes::Long:
-      return new JavaLong( *dynamic_cast<const JavaLong *>( pFieldValue ) );
+      return new JavaLong( JavaLong::FromHostInt64( GetSlotAtOffset<int64_t>( fieldOffset ) ) );
       break;
     case e_JavaVariableTypes::Float:
-      return new JavaFloat( *dynamic_cast<const JavaFloat *>( pFieldValue ) );
+      return new JavaFloat( JavaFloat::FromHostFloat( GetSlotAtOffset<float>( fieldOffset ) ) );
       break;
     case e_JavaVariableTypes::Double:
-      return new JavaDouble( *dynamic_cast<const JavaDouble *>( pFieldValue ) );
+      return new JavaDouble( JavaDouble::FromHostDouble( GetSlotAtOffset<double>( fieldOffset ) ) );
+      break;
+    case e_JavaVariableTypes::Bool:
+      return new JavaBool( JavaBool::FromBool( GetSlotAtOffset<bool>( fieldOffset ) ) );
+      break;
+    case e_JavaVariableTypes::Array:
+    case e_JavaVariableTypes::Object:
+      return new ObjectReference( GetSlotAtOffset<ObjectIndexT>( fieldOffset ) );
+      break;
+    default:
+      throw InvalidStateException( __FUNCTION__ " - Invalid field type." );
+      break;
+  }
+
+  JVMX_ASSERT( false );
+  return nullptr;
+}
+
+void JavaObject::StoreField( size_t fieldOffset, e_JavaVariableTypes fieldType, const IJavaVariableType &newValue )
+{
+  // The value is converted by assigning it to a temporary of the field's boxed type, so stores convert exactly as they
+  // did when the fields themselves were boxed.
+  switch ( fieldType )
+  {
+    case e_JavaVariableTypes::Char:
+      {
+        JavaChar value = JavaChar::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToChar16() );
+      }
+      break;
+    case e_JavaVariableTypes::Byte:
+      {
+        JavaByte value = JavaByte::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToHostInt8() );
+      }
       break;
-    case e_JavaVariableTypes::String:
-      return new JavaString( *dynamic_cast<const JavaString *>( pFieldValue ) );
+    case e_JavaVariableTypes::Short:
+      {
+        JavaShort value = JavaShort::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToHostInt16() );
+      }
       break;
-    case e_JavaVariableTypes::NullReference:
-      return new ObjectReference( nullptr );
+    case e_JavaVariableTypes::Integer:
+      {
+        JavaInteger value = JavaInteger::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToHostInt32() );
+      }
       break;
-    case e_JavaVariableTypes::ReturnAddress:
-      return new JavaReturnAddress( *dynamic_cast<const JavaReturnAddress *>( pFieldValue ) );
+    case e_JavaVariableTypes::Long:
+      {
+        JavaLong value = JavaLong::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToHostInt64() );
+      }
       break;
-    case e_JavaVariableTypes::ClassReference:
-      JVMX_ASSERT( false );
-      throw InvalidStateException( __FUNCTION__ " - Unexpected field type." );
+    case e_JavaVariableTypes::Float:
+      {
+        JavaFloat value = JavaFloat::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToHostFloat() );
+      }
+      break;
+    case e_JavaVariableTypes::Double:
+      {
+        JavaDouble value = JavaDouble::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToHostDouble() );
+      }
       break;
     case e_JavaVariableTypes::Bool:
-      return new JavaBool( *dynamic_cast<const JavaBool *>( pFieldValue ) );
+      {
+        JavaBool value = JavaBool::FromDefault();
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.ToBool() );
+      }
       break;
     case e_JavaVariableTypes::Array:
     case e_JavaVariableTypes::Object:
-      return new ObjectReference( *dynamic_cast<const ObjectReference *>( pFieldValue ) );
+      {
+        ObjectReference value( nullptr );
+        value = newValue;
+        SetSlotAtOffset( fieldOffset, value.GetIndex() );
+
+        // Only references need the barrier. The collector doesn't care about primitive stores.
+        WriteBarrier::OnStore( this );
+      }
       break;
     default:
       throw InvalidStateException( __FUNCTION__ " - Invalid field type." );
       break;
   }
-
-  AssertValid();
-
-  JVMX_ASSERT( false );
-  return nullptr;
 }
 
 JavaObject &JavaObject::operator=( const JavaObject &other )
 {
   AssertValid();
 
-  // NB: Note that we are deliberately not copying the mutex or the notified field!
+  // NB: Note that we are deliberately not copying the lock word!
   m_pClass = other.m_pClass;
   memcpy( m_pFields, other.m_pFields, m_pClass->CalculateInstanceSizeInBytes() );
-  m_JVMXFields = other.m_JVMXFields;
+  m_pJVMXFields = CopyJVMXFields( other );
+
+  WriteBarrier::OnStore( this );
 
   AssertValid();
 
@@ -444,7 +388,7 @@ JavaObject::~JavaObject() JVMX_NOEXCEPT
 {
   m_pClass.reset();
   //m_Fields.clear();
-  m_JVMXFields.clear();
+  m_pJVMXFields.reset();
 }
 
 void JavaObject::operator delete ( void *pObject )
@@ -519,8 +463,7 @@ void JavaObject::SetField( const JavaString &name, IJavaVariableType *pNewValue,
     throw InvalidArgumentException( __FUNCTION__ " - Field is final." );
   }
 
-  IJavaVariableType *pFieldValue = reinterpret_cast<IJavaVariableType *>( m_pFields + startingOffset + pFieldInfo->GetOffset() );
-  *pFieldValue = *pNewValue;
+  StoreField( startingOffset + pFieldInfo->GetOffset(), pFieldInfo->GetVariableType(), *pNewValue );
 
   AssertValid();
 }
@@ -530,15 +473,14 @@ void JavaObject::SetField( const JavaString &name, boost::intrusive_ptr<IJavaVar
   SetField( name, pValue.get(), ignoreFieldAccess );
 }
 
-std::shared_ptr<Lockable> JavaObject::MonitorEnter( const char *pFuctionName )
+void JavaObject::MonitorEnter( const char *pFuctionName )
 {
-  m_pMonitor->Lock( pFuctionName );
-  return m_pMonitor;
+  m_Lock.Lock();
 }
 
 void JavaObject::MonitorExit( const char *pFuctionName )
 {
-  m_pMonitor->Unlock( pFuctionName );
+  m_Lock.Unlock();
 }
 
 bool JavaObject::IsReferenceType() const
@@ -587,8 +529,7 @@ JavaString JavaObject::ToString() const
     {
       for ( size_t i = 0; i < pBuckets->GetContainedArray()->GetNumberOfElements(); ++ i )
       {
-        IJavaVariableType *pValueAtI = pBuckets->GetContainedArray()->At( i );
-        ObjectReference *pEntry = static_cast< ObjectReference * >( static_cast< void * >( pValueAtI ) );
+        boost::intrusive_ptr<ObjectReference> pEntry = new ObjectReference( pBuckets->GetContainedArray()->GetElementAt<ObjectIndexT>( i ) );
 
         if ( !pEntry->IsNull() )
         {
@@ -627,10 +568,10 @@ JavaString JavaObject::ToString() const
     int32_t num = 0;
     if ( !pData->IsNull() && pData->GetContainedArray()->GetNumberOfElements() > 4 )
     {
-      num = ( ( JavaByte * )( pData->GetContainedArray()->At( 0 ) ) )->ToHostInt8();
-      num += ( ( JavaByte * )( pData->GetContainedArray()->At( 1 ) ) )->ToHostInt8() << 8;
-      num += ( ( JavaByte * )( pData->GetContainedArray()->At( 2 ) ) )->ToHostInt8() << 16;
-      num += ( ( JavaByte * )( pData->GetContainedArray()->At( 3 ) ) )->ToHostInt8() << 24;
+      num = pData->GetContainedArray()->GetElementAt<int8_t>( 0 );
+      num += pData->GetContainedArray()->GetElementAt<int8_t>( 1 ) << 8;
+      num += pData->GetContainedArray()->GetElementAt<int8_t>( 2 ) << 16;
+      num += pData->GetContainedArray()->GetElementAt<int8_t>( 3 ) << 24;
     }
 
     return JavaString::FromCString( JVMX_T( "{" ) ).Append( *( m_pClass->GetName() ) ).Append( JVMX_T( "} = {" ) ).Append( pSignature->ToString() ).Append( JVMX_T( "(0x" ) ).AppendHex( num ).Append( JVMX_T( ")" ) ).Append( JVMX_T( " = " ) ).Append( pData->ToString() ).Append( JVMX_T( "}" ) );
@@ -644,10 +585,10 @@ JavaString JavaObject::ToString() const
     int32_t num = 0;
     if ( !pBackingBuffer->IsNull() && pBackingBuffer->GetContainedArray()->GetNumberOfElements() > 4 )
     {
-      num = ( ( JavaByte * )( pBackingBuffer->GetContainedArray()->At( 0 ) ) )->ToHostInt8();
-      num += ( ( JavaByte * )( pBackingBuffer->GetContainedArray()->At( 1 ) ) )->ToHostInt8() << 8;;
-      num += ( ( JavaByte * )( pBackingBuffer->GetContainedArray()->At( 2 ) ) )->ToHostInt8() << 16;
-      num += ( ( JavaByte * )( pBackingBuffer->GetContainedArray()->At( 3 ) ) )->ToHostInt8() << 24;
+      num = pBackingBuffer->GetContainedArray()->GetElementAt<int8_t>( 0 );
+      num += pBackingBuffer->GetContainedArray()->GetElementAt<int8_t>( 1 ) << 8;;
+      num += pBackingBuffer->GetContainedArray()->GetElementAt<int8_t>( 2 ) << 16;
+      num += pBackingBuffer->GetContainedArray()->GetElementAt<int8_t>( 3 ) << 24;
     }
 
     return JavaString::FromCString( JVMX_T( "{" ) ).Append( *( m_pClass->GetName() ) ).Append( JVMX_T( "} = {" ) ).Append( pBackingBuffer->ToString() ).Append( JVMX_T( "(0x" ) ).AppendHex( num ).Append( JVMX_T( ")" ) ).Append( JVMX_T( " = " ) ).Append( pOffset->ToString() ).Append( JVMX_T( "}" ) );
@@ -691,21 +632,20 @@ void JavaObject::CloneOther( const JavaObject *pObjectToClone )
   memcpy( m_pFields, pObjectToClone->m_pFields, m_pClass->CalculateInstanceSizeInBytes() );
 
   //m_Fields = pObjectToClone->m_Fields;
-  m_JVMXFields = pObjectToClone->m_JVMXFields;
+  m_pJVMXFields = CopyJVMXFields( *pObjectToClone );
 
   // for Garbage Collection
+  WriteBarrier::OnStore( this );
 }
 
-void JavaObject::DeepClone( const JavaObject *pObjectToClone )
+std::unique_ptr<JavaObject::JVMXFieldMap> JavaObject::CopyJVMXFields( const JavaObject &other )
 {
-  CloneOther( pObjectToClone );
+  if ( nullptr == other.m_pJVMXFields )
+  {
+    return nullptr;
+  }
 
-  //m_Fields = pObjectToClone->m_Fields;
-  m_JVMXFields = pObjectToClone->m_JVMXFields;
-  m_pMonitor = pObjectToClone->m_pMonitor;
-  m_Notfied = pObjectToClone->m_Notfied;
-  m_Waitable = pObjectToClone->m_Waitable;
-  m_pClass = pObjectToClone->m_pClass;
+  return std::unique_ptr<JVMXFieldMap>( new JVMXFieldMap( *other.m_pJVMXFields ) );
 }
 
 // const IJavaVariableType *JavaObject::GetFieldByIndex( size_t index ) const
@@ -727,10 +667,24 @@ int JavaObject::CompareFields( const JavaObject &other ) const
 {
   AssertValid();
 
-  for ( size_t i = 0; i < m_pClass->GetNonStaticFieldCount(); ++ i )
+  size_t startingOffset = 0;
+  std::shared_ptr<JavaClass> pSuperClass = m_pClass->GetSuperClass();
+  if ( nullptr != pSuperClass )
   {
-    const IJavaVariableType *pThisFieldValue = reinterpret_cast<const IJavaVariableType *>( m_pFields + m_pClass->GetFieldByIndex( i )->GetOffset() );
-    const IJavaVariableType *pOtherFieldValue = reinterpret_cast<const IJavaVariableType *>( other.m_pFields + m_pClass->GetFieldByIndex( i )->GetOffset() );
+    startingOffset = pSuperClass->CalculateInstanceSizeInBytes();
+  }
+
+  for ( size_t i = 0; i < m_pClass->GetLocalFieldCount( e_PublicOnly::No ); ++ i )
+  {
+    std::shared_ptr<FieldInfo> pFieldInfo = m_pClass->GetFieldByIndex( i );
+    if ( pFieldInfo->IsStatic() )
+    {
+      continue;
+    }
+
+    size_t fieldOffset = startingOffset + pFieldInfo->GetOffset();
+    boost::intrusive_ptr<IJavaVariableType> pThisFieldValue = LoadField( fieldOffset, pFieldInfo->GetVariableType() );
+    boost::intrusive_ptr<IJavaVariableType> pOtherFieldValue = other.LoadField( fieldOffset, pFieldInfo->GetVariableType() );
 
     if ( *pThisFieldValue < *pOtherFieldValue )
     {
@@ -750,10 +704,21 @@ int JavaObject::CompareFields( const JavaObject &other ) const
 
 boost::intrusive_ptr<IJavaVariableType> JavaObject::GetJVMXFieldByName( const JavaString &name ) const
 {
-  return m_JVMXFields.at( name );
+  if ( nullptr == m_pJVMXFields )
+  {
+    // The same as at() on an empty map.
+    throw std::out_of_range( __FUNCTION__ " - JVMX field not found." );
+  }
+
+  return m_pJVMXFields->at( name );
 }
 
 void JavaObject::SetJVMXField( const JavaString &name, boost::intrusive_ptr<IJavaVariableType> pValue )
 {
-  m_JVMXFields[ name ] = pValue;
+  if ( nullptr == m_pJVMXFields )
+  {
+    m_pJVMXFields.reset( new JVMXFieldMap );
+  }
+
+  ( *m_pJVMXFields )[ name ] = pValue;
 }
\ No newline at end of file
@@ -4,22 +4,26 @@
 #include <unordered_map>
 #include <memory>
 #include <mutex>
-#include <condition_variable>
+#include <cstring>
 
 //#include "OsFunctions.h"
 
 #include "GlobalConstants.h"
 #include "IJavaVariableType.h"
+#include "IObjectRegistry.h"
 //#include "VariableComparison.h"
 #include "JavaString.h"
 #include "MemoryAllocator.h"
-#include "Lockable.h"
+#include "ThinLock.h"
 
 class JavaClass; // Forward declaration
 class FieldInfo; // Forward declaration
 class ObjectFactory;
 class IMemoryManager;
+class IVirtualMachineState;
 
+// Objects are relocatable. The garbage collector moves them with memcpy, and never destroys the copy it moved from, so no
+// member may point into the object itself. Anything that would, such as a standard container, is held by pointer.
 class JavaObject : protected IJavaVariableType
 {
   friend class BasicVirtualMachineState;
@@ -59,12 +63,25 @@ public:
   virtual void SetField( const JavaString &name, boost::intrusive_ptr<IJavaVariableType> pValue, bool allowNonPublic = true );
   virtual void SetField( const JavaString &name, IJavaVariableType *pValue, bool allowNonPublic = true );
 
+  // Direct access for callers that have already resolved the field, and cached its offset. Fields are held unboxed, so
+  // the value is boxed on the way out, and converted to the field's type on the way in.
+  boost::intrusive_ptr<IJavaVariableType> GetFieldAtOffset( size_t fieldOffset, e_JavaVariableTypes fieldType ) const;
+  void SetFieldAtOffset( size_t fieldOffset, e_JavaVariableTypes fieldType, const IJavaVariableType *pValue );
+
+  // The raw slot at fieldOffset, for callers that know the field's type. No boxing, no conversion and no write barrier,
+  // so don't use these to store references.
+  template <typename T> T GetSlotAtOffset( size_t fieldOffset ) const;
+  template <typename T> void SetSlotAtOffset( size_t fieldOffset, T value );
+
+  // The object index in the reference field at fieldOffset. For the garbage collector's reference maps.
+  ObjectIndexT GetReferenceIndexAtOffset( size_t fieldOffset ) const;
+
   virtual boost::intrusive_ptr<IJavaVariableType> GetJVMXFieldByName( const JavaString &name ) const;
   virtual void SetJVMXField( const JavaString &name, boost::intrusive_ptr<IJavaVariableType> pValue );
 
   virtual std::shared_ptr<JavaClass> GetClass() const;
 
-  virtual std::shared_ptr<Lockable> MonitorEnter( const char *pFuctionName );
+  virtual void MonitorEnter( const char *pFuctionName );
   virtual void MonitorExit( const char *pFuctionName );
 
   void CloneOther( const JavaObject *pObjectToClone );
@@ -77,9 +94,6 @@ public:
 
   size_t GetSizeInBytes() const;
 
-  // ONLY TO BE USED FOR GARBAGE COLLECTION
-  void DeepClone( const JavaObject *pObjectToClone );
-
 private:
   void AssertValid() const;
 
@@ -88,29 +102,42 @@ private:
   JavaObject( const JavaObject &other ) JVMX_FN_DELETE;
   JavaObject( JavaObject &&other ) JVMX_FN_DELETE;
 
-  size_t InitialiseFields( const std::shared_ptr<JavaClass> &pClass );
-  size_t InitialiseField( std::shared_ptr<JavaClass> pClass,  int i, size_t startingOffset );
+  static void ThrowInterruptedException( const std::shared_ptr<IVirtualMachineState> &pCurrentThreadState );
+
+  boost::intrusive_ptr<IJavaVariableType> LoadField( size_t fieldOffset, e_JavaVariableTypes fieldType ) const;
+  void StoreField( size_t fieldOffset, e_JavaVariableTypes fieldType, const IJavaVariableType &newValue );
+
+  typedef std::unordered_map < JavaString, boost::intrusive_ptr<IJavaVariableType>, std::hash<JavaString>, std::equal_to<JavaString>> JVMXFieldMap;
 
-  bool ThrowJavaExceptionIfInterrupted() const;
+  static std::unique_ptr<JVMXFieldMap> CopyJVMXFields( const JavaObject &other );
 
 private:
   std::shared_ptr<JavaClass> m_pClass;
 
-  std::unordered_map < JavaString, boost::intrusive_ptr<IJavaVariableType>, std::hash<JavaString>, std::equal_to<JavaString>> m_JVMXFields;
+  // Only a few objects have any, so the map is created on first use.
+  std::unique_ptr<JVMXFieldMap> m_pJVMXFields;
 
 private:
-  std::shared_ptr<Lockable> m_pMonitor;
-  std::shared_ptr<std::condition_variable_any> m_Waitable;
+  ThinLock m_Lock;
 
-  volatile bool m_Notfied; // To protect against spurious wake-ups.
-
-#ifdef _DEBUG
-  std::vector<std::pair<JavaString, size_t>> m_DebugList;
-#endif // _DEBUG
+  // NB that this HAS to be the last field! The class loader lays the slots out so that each is naturally aligned
+  // relative to this.
+  alignas( 8 ) char m_pFields[1];
+};
 
+// memcpy rather than a cast, as the slots are only aligned relative to the start of the object.
+template <typename T>
+T JavaObject::GetSlotAtOffset( size_t fieldOffset ) const
+{
+  T value;
+  memcpy( &value, m_pFields + fieldOffset, sizeof( T ) );
+  return value;
+}
 
-  // NB that this HAS to be the last field!
-  char m_pFields[1];
-};
+template <typename T>
+void JavaObject::SetSlotAtOffset( size_t fieldOffset, T value )
+{
+  memcpy( m_pFields + fieldOffset, &value, sizeof( T ) );
+}
 
 #endif // _JAVAOBJECT__H_
@@ -203,6 +203,17 @@ enum class e_JavaOpCodes : uint16_t
   , NewMultiDimentionalArray = 0xc5
   , BranchIfNull = 0xc6
   , BranchIfNotNull = 0xc7
+
+  // Internal opcodes that never appear in class files. Once an instruction has been resolved, the interpreter rewrites
+  // it in place to its quick form. The operands are left unchanged.
+  , GetStaticQuick = 0xcb
+  , PutStaticQuick = 0xcc
+  , GetFieldQuick = 0xcd
+  , PutFieldQuick = 0xce
+  , InvokeVirtualQuick = 0xcf
+  , InvokeSpecialQuick = 0xd0
+  , InvokeStaticQuick = 0xd1
+  , InvokeInterfaceQuick = 0xd2
 };
 
 #endif // _JAVAOPCODES__H_
@@ -343,8 +343,7 @@ JavaString JavaString::FromArray( const JavaArray &array )
   std::u16string result;
   for ( size_t i = 0; i < array.GetNumberOfElements(); ++ i )
   {
-    const JavaChar *pChar = dynamic_cast<const JavaChar *>( array.At( i ) );
-    char16_t ch = pChar->ToChar16();
+    char16_t ch = array.GetElementAt<char16_t>( i );
 
     // We assume that the null character ends the string.
     if ( u'\u0000' == ch )
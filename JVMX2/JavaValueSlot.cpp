@@ -0,0 +1,200 @@
+#include "InvalidStateException.h"
+#include "InvalidArgumentException.h"
+
+#include "JavaTypes.h"
+
+#include "JavaValueSlot.h"
+
+JavaValueSlot::JavaValueSlot() JVMX_NOEXCEPT
+  : m_Long( 0 )
+  , m_pBoxedValue( nullptr )
+  , m_Type( e_JavaVariableTypes::NullReference )
+  , m_IsEmpty( true )
+{}
+
+JavaValueSlot JavaValueSlot::FromBoxed( const boost::intrusive_ptr<IJavaVariableType> &pValue )
+{
+  if ( nullptr == pValue )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Value was NULL." );
+  }
+
+  JavaValueSlot result;
+  result.m_pBoxedValue = pValue;
+  result.m_Type = pValue->GetVariableType();
+  result.m_IsEmpty = false;
+
+  // Keep a raw copy as well, so that the unboxed accessors never need to go through the box.
+  switch ( result.m_Type )
+  {
+    case e_JavaVariableTypes::Integer:
+      result.m_Integer = static_cast<const JavaInteger *>( pValue.get() )->ToHostInt32();
+      break;
+
+    case e_JavaVariableTypes::Long:
+      result.m_Long = static_cast<const JavaLong *>( pValue.get() )->ToHostInt64();
+      break;
+
+    case e_JavaVariableTypes::Float:
+      result.m_Float = static_cast<const JavaFloat *>( pValue.get() )->ToHostFloat();
+      break;
+
+    case e_JavaVariableTypes::Double:
+      result.m_Double = static_cast<const JavaDouble *>( pValue.get() )->ToHostDouble();
+      break;
+
+    default:
+      break;
+  }
+
+  return result;
+}
+
+JavaValueSlot JavaValueSlot::FromHostInt32( int32_t value ) JVMX_NOEXCEPT
+{
+  JavaValueSlot result;
+  result.m_Integer = value;
+  result.m_Type = e_JavaVariableTypes::Integer;
+  result.m_IsEmpty = false;
+
+  return result;
+}
+
+JavaValueSlot JavaValueSlot::FromHostInt64( int64_t value ) JVMX_NOEXCEPT
+{
+  JavaValueSlot result;
+  result.m_Long = value;
+  result.m_Type = e_JavaVariableTypes::Long;
+  result.m_IsEmpty = false;
+
+  return result;
+}
+
+JavaValueSlot JavaValueSlot::FromHostFloat( float value ) JVMX_NOEXCEPT
+{
+  JavaValueSlot result;
+  result.m_Float = value;
+  result.m_Type = e_JavaVariableTypes::Float;
+  result.m_IsEmpty = false;
+
+  return result;
+}
+
+JavaValueSlot JavaValueSlot::FromHostDouble( double value ) JVMX_NOEXCEPT
+{
+  JavaValueSlot result;
+  result.m_Double = value;
+  result.m_Type = e_JavaVariableTypes::Double;
+  result.m_IsEmpty = false;
+
+  return result;
+}
+
+e_JavaVariableTypes JavaValueSlot::GetVariableType() const JVMX_NOEXCEPT
+{
+  return m_Type;
+}
+
+bool JavaValueSlot::IsEmpty() const JVMX_NOEXCEPT
+{
+  return m_IsEmpty;
+}
+
+bool JavaValueSlot::IsObjectOrArray() const JVMX_NOEXCEPT
+{
+  return e_JavaVariableTypes::Object == m_Type || e_JavaVariableTypes::Array == m_Type;
+}
+
+int32_t JavaValueSlot::ToHostInt32() const
+{
+  switch ( m_Type )
+  {
+    case e_JavaVariableTypes::Integer:
+      return m_Integer;
+
+    case e_JavaVariableTypes::Char:
+      return static_cast<const JavaChar *>( m_pBoxedValue.get() )->ToUInt16();
+
+    case e_JavaVariableTypes::Bool:
+      return static_cast<const JavaBool *>( m_pBoxedValue.get() )->ToUint16();
+
+    case e_JavaVariableTypes::Byte:
+      return static_cast<const JavaByte *>( m_pBoxedValue.get() )->ToHostInt8();
+
+    case e_JavaVariableTypes::Short:
+      return static_cast<const JavaShort *>( m_pBoxedValue.get() )->ToHostInt16();
+
+    default:
+      break;
+  }
+
+  throw InvalidStateException( __FUNCTION__ " - Value was not of type integer." );
+}
+
+int64_t JavaValueSlot::ToHostInt64() const
+{
+  if ( e_JavaVariableTypes::Long == m_Type )
+  {
+    return m_Long;
+  }
+
+  // Integer compatible values are widened, as the boxed code path always allowed.
+  return ToHostInt32();
+}
+
+float JavaValueSlot::ToHostFloat() const
+{
+  if ( e_JavaVariableTypes::Float != m_Type )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Value was not of type float." );
+  }
+
+  return m_Float;
+}
+
+double JavaValueSlot::ToHostDouble() const
+{
+  if ( e_JavaVariableTypes::Double != m_Type )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Value was not of type double." );
+  }
+
+  return m_Double;
+}
+
+const boost::intrusive_ptr<IJavaVariableType> &JavaValueSlot::ToBoxed()
+{
+  if ( nullptr != m_pBoxedValue || m_IsEmpty )
+  {
+    return m_pBoxedValue;
+  }
+
+  switch ( m_Type )
+  {
+    case e_JavaVariableTypes::Integer:
+      m_pBoxedValue = new JavaInteger( JavaInteger::FromHostInt32( m_Integer ) );
+      break;
+
+    case e_JavaVariableTypes::Long:
+      m_pBoxedValue = new JavaLong( JavaLong::FromHostInt64( m_Long ) );
+      break;
+
+    case e_JavaVariableTypes::Float:
+      m_pBoxedValue = new JavaFloat( JavaFloat::FromHostFloat( m_Float ) );
+      break;
+
+    case e_JavaVariableTypes::Double:
+      m_pBoxedValue = new JavaDouble( JavaDouble::FromHostDouble( m_Double ) );
+      break;
+
+    default:
+      throw InvalidStateException( __FUNCTION__ " - Unboxed value had an unexpected type." );
+  }
+
+  return m_pBoxedValue;
+}
+
+const boost::intrusive_ptr<IJavaVariableType> &JavaValueSlot::GetExistingBox() const JVMX_NOEXCEPT
+{
+  return m_pBoxedValue;
+}
@@ -0,0 +1,56 @@
+#ifndef __JAVAVALUESLOT_H__
+#define __JAVAVALUESLOT_H__
+
+#include "GlobalConstants.h"
+#include "IJavaVariableType.h"
+
+// A single operand stack or local variable slot. int, long, float and double values are held unboxed, and are only
+// boxed into an IJavaVariableType when something asks for the boxed form (JNI, reflection, logging, field storage).
+// All other types (references, and the narrow types produced by array and field loads) are always held boxed.
+// The slot is not a single tagged 64 bit word. Every value, long and double included, takes one slot here, so the raw
+// value needs all 64 bits. References also have to stay in their ObjectReference box, which is what the collector sees
+// as a root. So a slot is the raw value, the box pointer and a tag, laid out in that order, which is 16 bytes on Win32.
+class JavaValueSlot
+{
+public:
+  JavaValueSlot() JVMX_NOEXCEPT;
+
+  static JavaValueSlot FromBoxed( const boost::intrusive_ptr<IJavaVariableType> &pValue );
+  static JavaValueSlot FromHostInt32( int32_t value ) JVMX_NOEXCEPT;
+  static JavaValueSlot FromHostInt64( int64_t value ) JVMX_NOEXCEPT;
+  static JavaValueSlot FromHostFloat( float value ) JVMX_NOEXCEPT;
+  static JavaValueSlot FromHostDouble( double value ) JVMX_NOEXCEPT;
+
+  e_JavaVariableTypes GetVariableType() const JVMX_NOEXCEPT;
+  bool IsEmpty() const JVMX_NOEXCEPT;
+
+  // True if the slot holds an object or an array, and must therefore be reported to the garbage collector.
+  bool IsObjectOrArray() const JVMX_NOEXCEPT;
+
+  int32_t ToHostInt32() const;
+  int64_t ToHostInt64() const;
+  float ToHostFloat() const;
+  double ToHostDouble() const;
+
+  // Boxes the value on first use, and keeps the box so that repeated calls do not allocate again.
+  const boost::intrusive_ptr<IJavaVariableType> &ToBoxed();
+
+  // Returns the box if one exists, without allocating.
+  const boost::intrusive_ptr<IJavaVariableType> &GetExistingBox() const JVMX_NOEXCEPT;
+
+private:
+  union
+  {
+    int32_t m_Integer;
+    int64_t m_Long;
+    float m_Float;
+    double m_Double;
+  };
+
+  boost::intrusive_ptr<IJavaVariableType> m_pBoxedValue;
+
+  e_JavaVariableTypes m_Type;
+  bool m_IsEmpty;
+};
+
+#endif // __JAVAVALUESLOT_H__
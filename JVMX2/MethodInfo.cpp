@@ -14,6 +14,7 @@ MethodInfo::MethodInfo( uint16_t flags, boost::intrusive_ptr<JavaString> name, b
   , m_Attributes( attributes )
   , m_pFrameInfo( nullptr )
   , m_pCodeInfo( nullptr )
+  , m_VirtualTableIndex( c_InvalidVirtualTableIndex )
   , m_pClass( nullptr )
 {
   m_Flags.m_FlagsAsInt = flags;
@@ -39,6 +40,7 @@ MethodInfo::MethodInfo( const MethodInfo &other )
   , m_Attributes( other.m_Attributes )
   , m_pFrameInfo( other.m_pFrameInfo )
   , m_pCodeInfo( other.m_pCodeInfo )
+  , m_VirtualTableIndex( other.m_VirtualTableIndex.load( std::memory_order_acquire ) )
   , m_pClass( other.m_pClass )
 {
   AssertValid();
@@ -51,6 +53,9 @@ MethodInfo::MethodInfo( MethodInfo &&other )
   , m_Attributes( std::move( other.m_Attributes ) )
   , m_pFrameInfo( std::move( other.m_pFrameInfo ) )
   , m_pCodeInfo( std::move( other.m_pCodeInfo ) )
+  , m_pPreDecodedCode( std::move( other.m_pPreDecodedCode ) )
+  , m_pInlineCaches( std::move( other.m_pInlineCaches ) )
+  , m_VirtualTableIndex( other.m_VirtualTableIndex.load( std::memory_order_acquire ) )
   , m_pClass( std::move( other.m_pClass ) )
 {
   AssertValid();
@@ -87,6 +92,11 @@ void MethodInfo::swap( MethodInfo &left, MethodInfo &right ) JVMX_NOEXCEPT
   std::swap( left.m_Attributes, right.m_Attributes );
   std::swap( left.m_pFrameInfo, right.m_pFrameInfo );
   std::swap( left.m_pCodeInfo, right.m_pCodeInfo );
+  std::swap( left.m_pPreDecodedCode, right.m_pPreDecodedCode );
+  std::swap( left.m_pInlineCaches, right.m_pInlineCaches );
+  size_t leftVirtualTableIndex = left.m_VirtualTableIndex.load();
+  left.m_VirtualTableIndex.store( right.m_VirtualTableIndex.load() );
+  right.m_VirtualTableIndex.store( leftVirtualTableIndex );
   std::swap( left.m_pClass, right.m_pClass );
 }
 
@@ -118,6 +128,27 @@ const ClassAttributeCode *MethodInfo::GetCodeInfo() const JVMX_NOEXCEPT
   return m_pCodeInfo;
 }
 
+std::shared_ptr<PreDecodedMethod> MethodInfo::GetPreDecodedCode() const
+{
+  return std::atomic_load( &m_pPreDecodedCode );
+}
+
+void MethodInfo::SetPreDecodedCode( std::shared_ptr<PreDecodedMethod> pPreDecodedCode ) const
+{
+  std::atomic_store( &m_pPreDecodedCode, pPreDecodedCode );
+}
+
+std::shared_ptr<InlineCacheTable> MethodInfo::GetInlineCaches() const
+{
+  return std::atomic_load( &m_pInlineCaches );
+}
+
+bool MethodInfo::SetInlineCaches( std::shared_ptr<InlineCacheTable> pInlineCaches ) const
+{
+  std::shared_ptr<InlineCacheTable> pExpected = nullptr;
+  return std::atomic_compare_exchange_strong( &m_pInlineCaches, &pExpected, pInlineCaches );
+}
+
 bool MethodInfo::IsAbstract() const JVMX_NOEXCEPT
 {
   AssertValid();
@@ -136,12 +167,24 @@ bool MethodInfo::IsNative() const JVMX_NOEXCEPT
   return MatchFlag( e_JavaMethodAccessFlags::Native );
 }
 
+bool MethodInfo::IsPublic() const JVMX_NOEXCEPT
+{
+  AssertValid();
+  return MatchFlag( e_JavaMethodAccessFlags::Public );
+}
+
 bool MethodInfo::IsProtected() const JVMX_NOEXCEPT
 {
   AssertValid();
   return MatchFlag( e_JavaMethodAccessFlags::Protected );
 }
 
+bool MethodInfo::IsPrivate() const JVMX_NOEXCEPT
+{
+  AssertValid();
+  return MatchFlag( e_JavaMethodAccessFlags::Private );
+}
+
 bool MethodInfo::IsSignaturePolymorphic() const JVMX_NOEXCEPT
 {
   // TODO: Fix this
@@ -165,6 +208,16 @@ JavaString MethodInfo::GetPackageName() const JVMX_NOEXCEPT
   return HelperTypes::GetPackageNameFromClassName( *m_pClass->GetName() );
 }
 
+size_t MethodInfo::GetVirtualTableIndex() const JVMX_NOEXCEPT
+{
+  return m_VirtualTableIndex.load( std::memory_order_acquire );
+}
+
+void MethodInfo::SetVirtualTableIndex( size_t index ) JVMX_NOEXCEPT
+{
+  m_VirtualTableIndex.store( index, std::memory_order_release );
+}
+
 void MethodInfo::SetClass( JavaClass *pClass ) JVMX_NOEXCEPT
 {
   m_pClass = pClass;
@@ -1,7 +1,9 @@
 #ifndef _METHODINFO__H_
 #define _METHODINFO__H_
 
+#include <atomic>
 #include <map>
+#include <memory>
 
 #include "GlobalConstants.h"
 #include "ConstantPoolMethodReference.h"
@@ -10,6 +12,10 @@
 
 class CodeAttributeStackMapTable;
 class ClassAttributeCode;
+class PreDecodedMethod;
+class InlineCacheTable;
+
+const size_t c_InvalidVirtualTableIndex = static_cast<size_t>( -1 );
 
 enum class e_JavaMethodAccessFlags : uint16_t
 {
@@ -48,12 +54,29 @@ public:
   virtual bool IsSynchronised() const JVMX_NOEXCEPT;
 
   virtual bool IsNative() const JVMX_NOEXCEPT;
+  virtual bool IsPublic() const JVMX_NOEXCEPT;
   virtual bool IsProtected() const JVMX_NOEXCEPT;
+  virtual bool IsPrivate() const JVMX_NOEXCEPT;
   virtual bool IsSignaturePolymorphic() const JVMX_NOEXCEPT;
 
   virtual const CodeAttributeStackMapTable *GetFrame() const JVMX_NOEXCEPT;
   virtual const ClassAttributeCode *GetCodeInfo() const JVMX_NOEXCEPT;
 
+  // The pre-decoded instruction stream is built lazily by the execution engine and may be shared between threads.
+  std::shared_ptr<PreDecodedMethod> GetPreDecodedCode() const;
+  void SetPreDecodedCode( std::shared_ptr<PreDecodedMethod> pPreDecodedCode ) const;
+
+  // Likewise for the inline caches of the method's call sites. SetInlineCaches returns false, and keeps the existing
+  // table, if another thread set one first.
+  std::shared_ptr<InlineCacheTable> GetInlineCaches() const;
+  bool SetInlineCaches( std::shared_ptr<InlineCacheTable> pInlineCaches ) const;
+
+  // The method's slot in the vtable of its class, or c_InvalidVirtualTableIndex if it is not dispatched virtually or
+  // the vtable has not been built yet. It is set while the vtable is built, and may be read by other threads before
+  // the tables are published. A method that overrides more than one slot reports the lowest.
+  size_t GetVirtualTableIndex() const JVMX_NOEXCEPT;
+  void SetVirtualTableIndex( size_t index ) JVMX_NOEXCEPT;
+
   virtual void SetClass( JavaClass *pClass ) JVMX_NOEXCEPT;
   virtual JavaClass *GetClass() JVMX_NOEXCEPT;
   virtual const JavaClass *GetClass() const JVMX_NOEXCEPT;
@@ -99,6 +122,9 @@ private:
   CodeAttributeList m_Attributes;
   const CodeAttributeStackMapTable* m_pFrameInfo;
   const ClassAttributeCode* m_pCodeInfo;
+  mutable std::shared_ptr<PreDecodedMethod> m_pPreDecodedCode;
+  mutable std::shared_ptr<InlineCacheTable> m_pInlineCaches;
+  std::atomic<size_t> m_VirtualTableIndex;
 
   JavaClass *m_pClass;
 };
@@ -2,10 +2,15 @@
 #include "InvalidStateException.h"
 #include "InvalidArgumentException.h"
 #include "ObjectReference.h"
+#include "ObjectRegistryHandleTable.h"
 #include "GlobalCatalog.h"
 
 const intptr_t c_NullIndex = 0;
 
+std::shared_ptr<IObjectRegistry> ObjectReference::s_pObjectRegistry;
+std::atomic<IObjectRegistry *> ObjectReference::s_pCachedObjectRegistry( nullptr );
+std::atomic<ObjectRegistryHandleTable *> ObjectReference::s_pHandleTable( nullptr );
+
 //#define JVMX_DEBUG_OBJECTREF 1
 
 ObjectReference::ObjectReference( ObjectIndexT index )
@@ -423,6 +428,27 @@ JavaString ObjectReference::ToString() const
 
 IJavaVariableType *ObjectReference::InternalGetObject( ObjectIndexT ref ) const
 {
+  // This is on the path of every field and array access, so the common case must not touch the GlobalCatalog.
+  ObjectRegistryHandleTable *pHandleTable = s_pHandleTable.load( std::memory_order_relaxed );
+  if ( nullptr != pHandleTable )
+  {
+    return pHandleTable->Translate( ref );
+  }
+
+  IObjectRegistry *pCachedObjectRegistry = s_pCachedObjectRegistry.load( std::memory_order_relaxed );
+  if ( nullptr != pCachedObjectRegistry )
+  {
+    return pCachedObjectRegistry->GetObject_( ref );
+  }
+
   std::shared_ptr<IObjectRegistry> pObjectRegistry = GlobalCatalog::GetInstance().Get( "ObjectRegistry" );
   return pObjectRegistry->GetObject_( ref );
 }
+
+void ObjectReference::SetObjectRegistry( const std::shared_ptr<IObjectRegistry> &pObjectRegistry )
+{
+  // Keep hold of the registry, so that the cached pointers stay valid until the next one replaces it.
+  s_pObjectRegistry = pObjectRegistry;
+  s_pCachedObjectRegistry.store( pObjectRegistry.get(), std::memory_order_relaxed );
+  s_pHandleTable.store( dynamic_cast<ObjectRegistryHandleTable *>( pObjectRegistry.get() ), std::memory_order_relaxed );
+}
@@ -4,11 +4,19 @@
 #ifndef _OBJECTREFERENCE__H_
 #define _OBJECTREFERENCE__H_
 
+#include <atomic>
+
 #include "ObjectRegistryLocalMachine.h"
 #include "JavaTypes.h"
 
 #include "jni_internal.h"
 
+class ObjectRegistryHandleTable;
+
+// A handle to an object or array: an index into the object registry, which holds the object's current address. The
+// collector moves objects by updating the registry, so references held anywhere, including on the C++ stack and in
+// native code, stay valid. There is no mode in which references are raw heap pointers. The collector could not find and
+// rewrite the copies held by C++ code, so following the handle is made cheap instead, see SetObjectRegistry.
 class ObjectReference : public IJavaVariableType
 {
 protected:
@@ -34,6 +42,9 @@ public:
   void AssertValid() const;
 #endif // _DEBUG
 
+  // References are resolved through this registry from now on, rather than by looking it up in the GlobalCatalog each time.
+  static void SetObjectRegistry( const std::shared_ptr<IObjectRegistry> &pObjectRegistry );
+
 public:
 //   virtual void AddField( const JavaString &name, std::shared_ptr<FieldInfo> pFieldInfo );
 //   virtual boost::intrusive_ptr<IJavaVariableType> GetFieldByName( const JavaString &name ) const;
@@ -75,6 +86,10 @@ private:
 private:
   ObjectIndexT m_Index;
 
+  static std::shared_ptr<IObjectRegistry> s_pObjectRegistry;
+  static std::atomic<IObjectRegistry *> s_pCachedObjectRegistry;
+  static std::atomic<ObjectRegistryHandleTable *> s_pHandleTable;
+
 #ifdef _DEBUG
   mutable IJavaVariableType const *m_pDebugPointer;
 #endif // _DEBUG
@@ -0,0 +1,404 @@
+
+#include <cstring>
+
+#include "IndexOutOfBoundsException.h"
+#include "InvalidArgumentException.h"
+#include "OutOfMemoryException.h"
+
+#include "ObjectReference.h"
+#include "ObjectRegistryHandleTable.h"
+
+// We don't want this to be 0, because we want to be able to detect invalid ObjectReferences with 0 as their index.
+const intptr_t c_StartingIndex = 100;
+
+// Index 0 is never handed out, so it doubles as the empty free list and the end of iteration.
+const uint32_t c_NoIndex = 0;
+
+const uint64_t c_FreeListIndexMask = 0xFFFFFFFFull;
+const size_t c_FreeListTagShift = 32;
+
+ObjectRegistryHandleTable_Chunk::ObjectRegistryHandleTable_Chunk()
+{
+  for ( size_t i = 0; i < c_EntryCount; ++ i )
+  {
+    objects[ i ] = nullptr;
+    nextFree[ i ].store( c_NoIndex, std::memory_order_relaxed );
+  }
+
+  for ( size_t i = 0; i < c_WordCount; ++ i )
+  {
+    allocated[ i ].store( 0, std::memory_order_relaxed );
+    updated[ i ].store( 0, std::memory_order_relaxed );
+  }
+}
+
+ObjectRegistryHandleTable_Iterator::ObjectRegistryHandleTable_Iterator( const ObjectRegistryHandleTable *pTable, ObjectIndexT index )
+  : m_pTable( pTable )
+  , m_Index( index )
+{
+}
+
+std::shared_ptr<const IIterator> ObjectRegistryHandleTable_Iterator::GetNext() const
+{
+  return std::make_shared<const ObjectRegistryHandleTable_Iterator>( m_pTable, m_pTable->FindAllocatedFrom( m_Index + 1 ) );
+}
+
+std::shared_ptr<const IIterator> ObjectRegistryHandleTable_Iterator::GetPrevious() const
+{
+  ObjectIndexT from = m_Index;
+  if ( c_NoIndex == from )
+  {
+    from = m_pTable->m_NextUnusedIndex.load( std::memory_order_acquire );
+  }
+
+  return std::make_shared<const ObjectRegistryHandleTable_Iterator>( m_pTable, m_pTable->FindAllocatedBefore( from ) );
+}
+
+ObjectIndexT ObjectRegistryHandleTable_Iterator::GetIndex() const
+{
+  return m_Index;
+}
+
+ObjectRegistryHandleTable::ObjectRegistryHandleTable()
+  : m_FreeListHead( c_NoIndex )
+  , m_NextUnusedIndex( c_StartingIndex )
+  , m_Count( 0 )
+{
+  for ( size_t i = 0; i < c_MaximumChunkCount; ++ i )
+  {
+    m_pChunks[ i ].store( nullptr, std::memory_order_relaxed );
+  }
+}
+
+ObjectRegistryHandleTable::~ObjectRegistryHandleTable() JVMX_NOEXCEPT
+{
+  for ( size_t i = 0; i < c_MaximumChunkCount; ++ i )
+  {
+    delete m_pChunks[ i ].load( std::memory_order_relaxed );
+  }
+}
+
+size_t ObjectRegistryHandleTable::GetCount() const
+{
+  return m_Count.load( std::memory_order_relaxed );
+}
+
+std::shared_ptr<const IIterator> ObjectRegistryHandleTable::GetFirst() const
+{
+  return std::make_shared<Iterator>( this, FindAllocatedFrom( c_StartingIndex ) );
+}
+
+bool ObjectRegistryHandleTable::HasMore( const std::shared_ptr<const IIterator> &it ) const
+{
+  std::shared_ptr<const Iterator> internalIterator = std::dynamic_pointer_cast<const Iterator>(it);
+  return c_NoIndex != internalIterator->GetIndex();
+}
+
+std::shared_ptr<const IIterator> ObjectRegistryHandleTable::GetNext( const std::shared_ptr<const IIterator> &it ) const
+{
+  return it->GetNext();
+}
+
+ObjectIndexT ObjectRegistryHandleTable::GetIndexAt( const std::shared_ptr<const IIterator> &it ) const
+{
+  std::shared_ptr<const Iterator> internalIterator = std::dynamic_pointer_cast<const Iterator>(it);
+  return internalIterator->GetIndex();
+}
+
+bool ObjectRegistryHandleTable::HasBeenUpdatedAt( const std::shared_ptr<const IIterator> &it ) const
+{
+  std::shared_ptr<const Iterator> internalIterator = std::dynamic_pointer_cast<const Iterator>(it);
+  return HasBeenUpdated( internalIterator->GetIndex() );
+}
+
+ObjectReference ObjectRegistryHandleTable::AddObject( JavaObject *pObject )
+{
+  return AddEntry( reinterpret_cast<IJavaVariableType *>(pObject) );
+}
+
+ObjectReference ObjectRegistryHandleTable::AddObject( JavaArray *pArray )
+{
+  return AddEntry( reinterpret_cast<IJavaVariableType *>(pArray) );
+}
+
+ObjectReference ObjectRegistryHandleTable::AddEntry( IJavaVariableType *pObject )
+{
+  ObjectIndexT ref = AllocateIndex();
+  ObjectRegistryHandleTable_Chunk *pChunk = GetChunk( ref );
+  size_t entry = ref & ObjectRegistryHandleTable_Chunk::c_EntryMask;
+
+  pChunk->objects[ entry ] = pObject;
+  pChunk->allocated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].fetch_or( static_cast<uint64_t>( 1 ) << ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord ), std::memory_order_release );
+  ++ m_Count;
+
+  return ObjectReference( ref );
+}
+
+void ObjectRegistryHandleTable::RemoveObject( ObjectIndexT ref )
+{
+  if ( !IsAllocated( ref ) )
+  {
+    return;
+  }
+
+  ReleaseIndex( ref );
+}
+
+void ObjectRegistryHandleTable::UpdateObjectPointer( const ObjectReference &ref, IJavaVariableType *pObject )
+{
+  ObjectIndexT index = ref.GetIndex();
+
+#ifdef _DEBUG
+  if ( !IsAllocated( index ) )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Expected object to be found, before updating." );
+  }
+#endif // _DEBUG
+
+  ObjectRegistryHandleTable_Chunk *pChunk = GetChunk( index );
+  size_t entry = index & ObjectRegistryHandleTable_Chunk::c_EntryMask;
+
+  // Several copying threads may mark entries in the same word at once, so the bit is set atomically.
+  pChunk->objects[ entry ] = pObject;
+  pChunk->updated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].fetch_or( static_cast<uint64_t>( 1 ) << ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord ), std::memory_order_relaxed );
+}
+
+void ObjectRegistryHandleTable::Cleanup()
+{
+  Cleanup( nullptr, nullptr, nullptr );
+}
+
+void ObjectRegistryHandleTable::Cleanup( const void *pOldStart, const void *pOldEnd, const std::function<bool( const IJavaVariableType *pObject )> &isOldObjectLive )
+{
+  for ( size_t chunkIndex = 0; chunkIndex < c_MaximumChunkCount; ++ chunkIndex )
+  {
+    ObjectRegistryHandleTable_Chunk *pChunk = m_pChunks[ chunkIndex ].load( std::memory_order_acquire );
+    if ( nullptr == pChunk )
+    {
+      continue;
+    }
+
+    for ( size_t word = 0; word < ObjectRegistryHandleTable_Chunk::c_WordCount; ++ word )
+    {
+      uint64_t allocated = pChunk->allocated[ word ].load( std::memory_order_acquire );
+      uint64_t updated = pChunk->updated[ word ].exchange( 0, std::memory_order_relaxed );
+
+      // Unless old objects are being tested, only the entries that were not updated can be freed.
+      uint64_t candidates = isOldObjectLive ? allocated : ( allocated & ~updated );
+
+      for ( size_t bit = 0; 0 != candidates; ++ bit, candidates >>= 1 )
+      {
+        if ( 0 == ( candidates & 1 ) )
+        {
+          continue;
+        }
+
+        size_t entry = word * ObjectRegistryHandleTable_Chunk::c_BitsPerWord + bit;
+        const void *pObject = pChunk->objects[ entry ];
+
+        bool isLive = 0 != ( updated & ( static_cast<uint64_t>( 1 ) << bit ) );
+        if ( pObject >= pOldStart && pObject < pOldEnd )
+        {
+          isLive = !isOldObjectLive || isOldObjectLive( pChunk->objects[ entry ] );
+        }
+
+        if ( isLive )
+        {
+          continue;
+        }
+
+        pChunk->objects[ entry ]->~IJavaVariableType();
+        ReleaseIndex( static_cast<ObjectIndexT>( ( chunkIndex << ObjectRegistryHandleTable_Chunk::c_EntryCountShift ) + entry ) );
+      }
+    }
+  }
+}
+
+void ObjectRegistryHandleTable::VerifyEntry( ObjectIndexT ref )
+{
+  if ( 0 == ref )
+  {
+    return;
+  }
+
+  if ( !IsAllocated( ref ) )
+  {
+    throw IndexOutOfBoundsException( __FUNCTION__ " - Requested object not found." );
+  }
+
+  char *pObj = (char *)(GetChunk( ref )->objects[ ref & ObjectRegistryHandleTable_Chunk::c_EntryMask ]);
+
+  int32_t baba = 0xbabababa;
+  if ( 0 == memcmp( pObj, &baba, 4 ) )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Object not valid." );
+  }
+
+  int32_t cccc = 0xcccccccc;
+  if ( 0 == memcmp( pObj, &cccc, 4 ) )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Object not valid." );
+  }
+}
+
+IJavaVariableType *ObjectRegistryHandleTable::GetObject_( ObjectIndexT ref )
+{
+#if defined( _DEBUG ) && defined (JVMX_DEBUG_OBJECTREF)
+  if ( !IsAllocated( ref ) )
+  {
+    throw IndexOutOfBoundsException( __FUNCTION__ " - Requested object not found." );
+  }
+#endif // _DEBUG
+
+  return Translate( ref );
+}
+
+ObjectIndexT ObjectRegistryHandleTable::AllocateIndex()
+{
+  uint64_t head = m_FreeListHead.load( std::memory_order_acquire );
+  while ( c_NoIndex != ( head & c_FreeListIndexMask ) )
+  {
+    ObjectIndexT ref = static_cast<ObjectIndexT>( head & c_FreeListIndexMask );
+
+    // If another thread takes this entry first, the tag will have changed and the exchange below will fail, so reading a stale link here is harmless.
+    uint64_t next = GetChunk( ref )->nextFree[ ref & ObjectRegistryHandleTable_Chunk::c_EntryMask ].load( std::memory_order_relaxed );
+    uint64_t newHead = ( ( ( head >> c_FreeListTagShift ) + 1 ) << c_FreeListTagShift ) | next;
+
+    if ( m_FreeListHead.compare_exchange_weak( head, newHead, std::memory_order_acq_rel, std::memory_order_acquire ) )
+    {
+      return ref;
+    }
+  }
+
+  ObjectIndexT ref = m_NextUnusedIndex++;
+  EnsureChunk( ref );
+
+  return ref;
+}
+
+void ObjectRegistryHandleTable::ReleaseIndex( ObjectIndexT ref )
+{
+  ObjectRegistryHandleTable_Chunk *pChunk = GetChunk( ref );
+  size_t entry = ref & ObjectRegistryHandleTable_Chunk::c_EntryMask;
+  uint64_t mask = ~( static_cast<uint64_t>( 1 ) << ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord ) );
+
+  pChunk->objects[ entry ] = nullptr;
+  pChunk->allocated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].fetch_and( mask, std::memory_order_relaxed );
+  pChunk->updated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].fetch_and( mask, std::memory_order_relaxed );
+  -- m_Count;
+
+  uint64_t head = m_FreeListHead.load( std::memory_order_relaxed );
+  uint64_t newHead = 0;
+  do
+  {
+    pChunk->nextFree[ entry ].store( static_cast<uint32_t>( head & c_FreeListIndexMask ), std::memory_order_relaxed );
+    newHead = ( ( ( head >> c_FreeListTagShift ) + 1 ) << c_FreeListTagShift ) | static_cast<uint64_t>( ref );
+  }
+  while ( !m_FreeListHead.compare_exchange_weak( head, newHead, std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+ObjectRegistryHandleTable_Chunk *ObjectRegistryHandleTable::GetChunk( ObjectIndexT ref ) const
+{
+  return m_pChunks[ static_cast<size_t>( ref ) >> ObjectRegistryHandleTable_Chunk::c_EntryCountShift ].load( std::memory_order_acquire );
+}
+
+ObjectRegistryHandleTable_Chunk *ObjectRegistryHandleTable::EnsureChunk( ObjectIndexT ref )
+{
+  size_t chunkIndex = static_cast<size_t>( ref ) >> ObjectRegistryHandleTable_Chunk::c_EntryCountShift;
+  if ( chunkIndex >= c_MaximumChunkCount )
+  {
+    throw OutOfMemoryException( __FUNCTION__ " - Object registry is full." );
+  }
+
+  ObjectRegistryHandleTable_Chunk *pChunk = m_pChunks[ chunkIndex ].load( std::memory_order_acquire );
+  if ( nullptr != pChunk )
+  {
+    return pChunk;
+  }
+
+  // Growing is rare, so it is the only place that takes a lock.
+  std::lock_guard<std::mutex> lock( m_ChunkMutex );
+
+  pChunk = m_pChunks[ chunkIndex ].load( std::memory_order_acquire );
+  if ( nullptr == pChunk )
+  {
+    pChunk = new ObjectRegistryHandleTable_Chunk;
+    m_pChunks[ chunkIndex ].store( pChunk, std::memory_order_release );
+  }
+
+  return pChunk;
+}
+
+bool ObjectRegistryHandleTable::IsAllocated( ObjectIndexT ref ) const
+{
+  if ( ref < c_StartingIndex || ref >= m_NextUnusedIndex.load( std::memory_order_acquire ) )
+  {
+    return false;
+  }
+
+  ObjectRegistryHandleTable_Chunk *pChunk = GetChunk( ref );
+  if ( nullptr == pChunk )
+  {
+    return false;
+  }
+
+  size_t entry = ref & ObjectRegistryHandleTable_Chunk::c_EntryMask;
+  return 0 != ( pChunk->allocated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].load( std::memory_order_acquire ) & ( static_cast<uint64_t>( 1 ) << ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord ) ) );
+}
+
+bool ObjectRegistryHandleTable::HasBeenUpdated( ObjectIndexT ref ) const
+{
+  ObjectRegistryHandleTable_Chunk *pChunk = GetChunk( ref );
+  size_t entry = ref & ObjectRegistryHandleTable_Chunk::c_EntryMask;
+
+  return 0 != ( pChunk->updated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].load( std::memory_order_relaxed ) & ( static_cast<uint64_t>( 1 ) << ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord ) ) );
+}
+
+ObjectIndexT ObjectRegistryHandleTable::FindAllocatedFrom( ObjectIndexT ref ) const
+{
+  ObjectIndexT end = m_NextUnusedIndex.load( std::memory_order_acquire );
+
+  while ( ref < end )
+  {
+    ObjectRegistryHandleTable_Chunk *pChunk = GetChunk( ref );
+    size_t entry = ref & ObjectRegistryHandleTable_Chunk::c_EntryMask;
+
+    if ( nullptr == pChunk )
+    {
+      // The chunk is still being created, so it cannot hold any objects yet.
+      ref += ObjectRegistryHandleTable_Chunk::c_EntryCount - entry;
+      continue;
+    }
+
+    uint64_t word = pChunk->allocated[ entry / ObjectRegistryHandleTable_Chunk::c_BitsPerWord ].load( std::memory_order_acquire ) >> ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord );
+    if ( 0 == word )
+    {
+      ref += ObjectRegistryHandleTable_Chunk::c_BitsPerWord - ( entry % ObjectRegistryHandleTable_Chunk::c_BitsPerWord );
+      continue;
+    }
+
+    while ( 0 == ( word & 1 ) )
+    {
+      word >>= 1;
+      ++ ref;
+    }
+
+    return ( ref < end ) ? ref : c_NoIndex;
+  }
+
+  return c_NoIndex;
+}
+
+ObjectIndexT ObjectRegistryHandleTable::FindAllocatedBefore( ObjectIndexT ref ) const
+{
+  while ( ref > c_StartingIndex )
+  {
+    -- ref;
+    if ( IsAllocated( ref ) )
+    {
+      return ref;
+    }
+  }
+
+  return c_NoIndex;
+}
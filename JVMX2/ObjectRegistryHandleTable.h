@@ -0,0 +1,128 @@
+#pragma once
+
+#ifndef _OBJECTREGISTRYHANDLETABLE__H_
+#define _OBJECTREGISTRYHANDLETABLE__H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "IJavaVariableType.h"
+#include "IObjectRegistry.h"
+
+class JavaArray;
+class JavaObject;
+class ObjectReference;
+class ObjectRegistryHandleTable;
+
+// A fixed-size block of handles. Object pointers are kept in their own array so that translating an index only touches one cache line.
+struct ObjectRegistryHandleTable_Chunk
+{
+  static const size_t c_EntryCountShift = 12;
+  static const size_t c_EntryCount = static_cast<size_t>( 1 ) << c_EntryCountShift;
+  static const size_t c_EntryMask = c_EntryCount - 1;
+  static const size_t c_BitsPerWord = 64;
+  static const size_t c_WordCount = c_EntryCount / c_BitsPerWord;
+
+  ObjectRegistryHandleTable_Chunk();
+
+  IJavaVariableType *objects[ c_EntryCount ];
+  std::atomic<uint32_t> nextFree[ c_EntryCount ];
+  std::atomic<uint64_t> allocated[ c_WordCount ];
+  std::atomic<uint64_t> updated[ c_WordCount ];
+};
+
+class ObjectRegistryHandleTable_Iterator : public IIterator
+{
+public:
+  ObjectRegistryHandleTable_Iterator( const ObjectRegistryHandleTable *pTable, ObjectIndexT index );
+  virtual ~ObjectRegistryHandleTable_Iterator() JVMX_NOEXCEPT JVMX_OVERRIDE {};
+
+  virtual std::shared_ptr<const IIterator> GetNext() const JVMX_OVERRIDE;
+  virtual std::shared_ptr<const IIterator> GetPrevious() const JVMX_OVERRIDE;
+
+  ObjectIndexT GetIndex() const;
+
+private:
+  const ObjectRegistryHandleTable *m_pTable;
+  ObjectIndexT m_Index;
+};
+
+// An object registry backed by a chunked table of handles. An index maps directly to its slot, so looking up an object never takes a lock.
+// Freed slots are recycled through a lock-free free list, and liveness for the garbage collector is tracked in a side bitmap.
+class ObjectRegistryHandleTable : public IObjectRegistry
+{
+public:
+  friend class ObjectReference;
+  friend class ObjectRegistryHandleTable_Iterator;
+
+public:
+  ObjectRegistryHandleTable();
+  virtual ~ObjectRegistryHandleTable() JVMX_NOEXCEPT JVMX_OVERRIDE;
+
+  ObjectRegistryHandleTable( const ObjectRegistryHandleTable &other ) JVMX_FN_DELETE;
+  ObjectRegistryHandleTable &operator=( const ObjectRegistryHandleTable &other ) JVMX_FN_DELETE;
+
+public:
+  virtual size_t GetCount() const JVMX_OVERRIDE;
+
+  typedef ObjectRegistryHandleTable_Iterator Iterator;
+
+  virtual std::shared_ptr<const IIterator> GetFirst() const JVMX_OVERRIDE;
+  virtual bool HasMore( const std::shared_ptr<const IIterator> &it ) const JVMX_OVERRIDE;
+  virtual std::shared_ptr<const IIterator> GetNext( const std::shared_ptr<const IIterator> &it ) const JVMX_OVERRIDE;
+
+  virtual ObjectIndexT GetIndexAt( const std::shared_ptr<const IIterator> &it ) const JVMX_OVERRIDE;
+  virtual bool HasBeenUpdatedAt( const std::shared_ptr<const IIterator> &it ) const JVMX_OVERRIDE;
+
+public:
+  virtual ObjectReference AddObject( JavaObject *pObject ) JVMX_OVERRIDE;
+  virtual ObjectReference AddObject( JavaArray *pArray ) JVMX_OVERRIDE;
+
+  // For use by the Garbage Collector
+  virtual void RemoveObject( ObjectIndexT ref ) JVMX_OVERRIDE;
+  virtual void UpdateObjectPointer( const ObjectReference &ref, IJavaVariableType *pObject ) JVMX_OVERRIDE;
+
+  virtual void Cleanup() JVMX_OVERRIDE;
+  virtual void Cleanup( const void *pOldStart, const void *pOldEnd, const std::function<bool( const IJavaVariableType *pObject )> &isOldObjectLive ) JVMX_OVERRIDE;
+
+  virtual void VerifyEntry( ObjectIndexT ref ) JVMX_OVERRIDE;
+
+  // The same as GetObject_(), but can be inlined into callers that know which registry they have.
+  IJavaVariableType *Translate( ObjectIndexT ref ) const
+  {
+    return m_pChunks[ static_cast<size_t>( ref ) >> ObjectRegistryHandleTable_Chunk::c_EntryCountShift ].load( std::memory_order_acquire )->objects[ ref & ObjectRegistryHandleTable_Chunk::c_EntryMask ];
+  }
+
+protected:
+  virtual IJavaVariableType *GetObject_( ObjectIndexT ref ) JVMX_OVERRIDE;
+
+private:
+  ObjectIndexT AllocateIndex();
+  void ReleaseIndex( ObjectIndexT ref );
+  ObjectReference AddEntry( IJavaVariableType *pObject );
+
+  ObjectRegistryHandleTable_Chunk *GetChunk( ObjectIndexT ref ) const;
+  ObjectRegistryHandleTable_Chunk *EnsureChunk( ObjectIndexT ref );
+
+  bool IsAllocated( ObjectIndexT ref ) const;
+  bool HasBeenUpdated( ObjectIndexT ref ) const;
+
+  // Returns the first allocated index at or after ref, or 0 if there is none.
+  ObjectIndexT FindAllocatedFrom( ObjectIndexT ref ) const;
+  // Returns the last allocated index before ref, or 0 if there is none.
+  ObjectIndexT FindAllocatedBefore( ObjectIndexT ref ) const;
+
+private:
+  static const size_t c_MaximumChunkCount = 16384;
+
+  std::atomic<ObjectRegistryHandleTable_Chunk *> m_pChunks[ c_MaximumChunkCount ];
+  std::mutex m_ChunkMutex;
+
+  // The low 32 bits hold the index at the top of the free list, the high 32 bits a counter that changes on every push and pop.
+  std::atomic<uint64_t> m_FreeListHead;
+  std::atomic_intptr_t m_NextUnusedIndex;
+  std::atomic_size_t m_Count;
+};
+
+#endif // _OBJECTREGISTRYHANDLETABLE__H_
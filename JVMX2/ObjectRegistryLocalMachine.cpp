@@ -25,7 +25,7 @@ bool ObjectRegistryLocalMachine::HasMore( const std::shared_ptr<const IIterator>
   std::lock_guard<std::recursive_mutex> lock( m_Mutex );
 
   std::shared_ptr<const Iterator> internalIterator = std::dynamic_pointer_cast<const Iterator>(it);
-  return internalIterator->IsEnd( m_Objects );
+  return !internalIterator->IsEnd( m_Objects );
 }
 
 std::shared_ptr<const IIterator> ObjectRegistryLocalMachine::GetNext( const std::shared_ptr<const IIterator> &it ) const
@@ -103,17 +103,28 @@ void ObjectRegistryLocalMachine::UpdateObjectPointer( const ObjectReference &ref
 }
 
 void ObjectRegistryLocalMachine::Cleanup()
+{
+  Cleanup( nullptr, nullptr, nullptr );
+}
+
+void ObjectRegistryLocalMachine::Cleanup( const void *pOldStart, const void *pOldEnd, const std::function<bool( const IJavaVariableType *pObject )> &isOldObjectLive )
 {
   std::lock_guard<std::recursive_mutex> lock( m_Mutex );
 
   auto it = m_Objects.begin();
   while ( it != m_Objects.end() )
   {
-    if ( it->second.hasBeenUpdated )
+    const void *pObject = it->second.pObject;
+
+    bool isLive = it->second.hasBeenUpdated;
+    it->second.hasBeenUpdated = false;
+
+    if ( pObject >= pOldStart && pObject < pOldEnd )
     {
-      it->second.hasBeenUpdated = false;
+      isLive = !isOldObjectLive || isOldObjectLive( it->second.pObject );
     }
-    else
+
+    if ( !isLive )
     {
       it->second.pObject->~IJavaVariableType();
       m_Objects.erase( it++ );
@@ -54,6 +54,7 @@ public:
   virtual void UpdateObjectPointer( const ObjectReference &ref, IJavaVariableType *pObject ) JVMX_OVERRIDE;
 
   virtual void Cleanup() JVMX_OVERRIDE;
+  virtual void Cleanup( const void *pOldStart, const void *pOldEnd, const std::function<bool( const IJavaVariableType *pObject )> &isOldObjectLive ) JVMX_OVERRIDE;
 
   virtual void VerifyEntry( ObjectIndexT ref ) JVMX_OVERRIDE;
 
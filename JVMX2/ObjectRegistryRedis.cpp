@@ -213,6 +213,12 @@ void ObjectRegistryRedis::Cleanup()
   }
 }
 
+void ObjectRegistryRedis::Cleanup( const void *pOldStart, const void *pOldEnd, const std::function<bool( const IJavaVariableType *pObject )> &isOldObjectLive )
+{
+  // Objects are not moved into this registry by a generational collector, so there is nothing to retain.
+  Cleanup();
+}
+
 void ObjectRegistryRedis::VerifyEntry( ObjectIndexT ref )
 {
 }
@@ -0,0 +1,219 @@
+#include <algorithm>
+
+#include "InvalidArgumentException.h"
+#include "WriteBarrier.h"
+
+#include "OldGeneration.h"
+
+namespace
+{
+  const size_t c_BlockAlignment = sizeof( void * );
+
+  // Leftovers smaller than this are handed out with the block they were split from, rather than kept as free blocks.
+  const size_t c_MinimumFreeBlockSize = sizeof( GCHeader ) + 32;
+
+  const size_t c_CardSize = static_cast<size_t>( 1 ) << WriteBarrier::c_CardShift;
+  const uint16_t c_NoBlockStart = 0xFFFF;
+
+  size_t AlignBlockSize( size_t blockSize )
+  {
+    return ( blockSize + c_BlockAlignment - 1 ) & ~( c_BlockAlignment - 1 );
+  }
+}
+
+OldGeneration::OldGeneration( size_t sizeInBytes )
+  : m_SizeInBytes( sizeInBytes & ~( c_BlockAlignment - 1 ) )
+  , m_FreeSpace( 0 )
+  , m_CardCount( 0 )
+{
+  if ( m_SizeInBytes < c_MinimumFreeBlockSize )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Old generation is too small." );
+  }
+
+  m_pMemory.reset( new char[ m_SizeInBytes ] );
+
+  m_CardCount = ( m_SizeInBytes + c_CardSize - 1 ) >> WriteBarrier::c_CardShift;
+  m_pCards.reset( new uint8_t[ m_CardCount ] );
+  m_pFirstBlockInCard.reset( new uint16_t[ m_CardCount ] );
+
+  std::fill( m_pCards.get(), m_pCards.get() + m_CardCount, WriteBarrier::c_CleanCard );
+  std::fill( m_pFirstBlockInCard.get(), m_pFirstBlockInCard.get() + m_CardCount, c_NoBlockStart );
+
+  AddFreeBlock( m_pMemory.get(), m_SizeInBytes );
+
+  WriteBarrier::SetOldGeneration( GetStart(), GetEnd(), m_pCards.get() );
+}
+
+OldGeneration::~OldGeneration()
+{
+  WriteBarrier::SetOldGeneration( nullptr, nullptr, nullptr );
+}
+
+bool OldGeneration::Contains( const void *pAddress ) const JVMX_NOEXCEPT
+{
+  return pAddress >= GetStart() && pAddress < GetEnd();
+}
+
+const char *OldGeneration::GetStart() const JVMX_NOEXCEPT
+{
+  return m_pMemory.get();
+}
+
+const char *OldGeneration::GetEnd() const JVMX_NOEXCEPT
+{
+  return m_pMemory.get() + m_SizeInBytes;
+}
+
+size_t OldGeneration::GetSize() const JVMX_NOEXCEPT
+{
+  return m_SizeInBytes;
+}
+
+size_t OldGeneration::GetFreeSpace() const JVMX_NOEXCEPT
+{
+  return m_FreeSpace;
+}
+
+GCHeader *OldGeneration::Allocate( size_t sizeInBytes )
+{
+  size_t blockSize = AlignBlockSize( sizeInBytes + sizeof( GCHeader ) );
+
+  auto it = m_FreeBlocks.lower_bound( blockSize );
+  if ( m_FreeBlocks.end() == it )
+  {
+    return nullptr;
+  }
+
+  size_t freeBlockSize = it->first;
+  GCHeader *pHeader = it->second;
+
+  m_FreeBlocks.erase( it );
+  m_FreeSpace -= freeBlockSize;
+
+  if ( freeBlockSize - blockSize >= c_MinimumFreeBlockSize )
+  {
+    AddFreeBlock( reinterpret_cast<char *>( pHeader ) + blockSize, freeBlockSize - blockSize );
+  }
+  else
+  {
+    blockSize = freeBlockSize;
+  }
+
+  pHeader->type = e_GarbageCollectionObjectTypes::Invalid;
+  pHeader->age = 0;
+  pHeader->isMarked = false;
+  pHeader->isFinalized = false;
+  pHeader->size = blockSize - sizeof( GCHeader );
+  pHeader->forwardingAddress = nullptr;
+
+  return pHeader;
+}
+
+void OldGeneration::GetObjectsInDirtyCards( std::vector<GCHeader *> &objects ) const
+{
+  for ( size_t card = 0; card < m_CardCount; ++ card )
+  {
+    if ( WriteBarrier::c_CleanCard == m_pCards[ card ] || c_NoBlockStart == m_pFirstBlockInCard[ card ] )
+    {
+      continue;
+    }
+
+    const char *pCardStart = GetStart() + ( card << WriteBarrier::c_CardShift );
+    const char *pCardEnd = std::min( pCardStart + c_CardSize, GetEnd() );
+
+    for ( const char *pBlock = pCardStart + m_pFirstBlockInCard[ card ]; pBlock < pCardEnd; )
+    {
+      GCHeader *pHeader = reinterpret_cast<GCHeader *>( const_cast<char *>( pBlock ) );
+      if ( e_GarbageCollectionObjectTypes::Object == pHeader->type || e_GarbageCollectionObjectTypes::Array == pHeader->type )
+      {
+        objects.push_back( pHeader );
+      }
+
+      pBlock += sizeof( GCHeader ) + pHeader->size;
+    }
+  }
+}
+
+void OldGeneration::ClearCards() JVMX_NOEXCEPT
+{
+  std::fill( m_pCards.get(), m_pCards.get() + m_CardCount, WriteBarrier::c_CleanCard );
+}
+
+void OldGeneration::DirtyCard( const GCHeader *pHeader ) JVMX_NOEXCEPT
+{
+  m_pCards[ GetCardIndex( pHeader ) ] = WriteBarrier::c_DirtyCard;
+}
+
+void OldGeneration::Sweep()
+{
+  m_FreeBlocks.clear();
+  m_FreeSpace = 0;
+  std::fill( m_pFirstBlockInCard.get(), m_pFirstBlockInCard.get() + m_CardCount, c_NoBlockStart );
+
+  char *pFreeRunStart = nullptr;
+  char *pBlock = m_pMemory.get();
+  char *pEnd = m_pMemory.get() + m_SizeInBytes;
+
+  while ( pBlock < pEnd )
+  {
+    GCHeader *pHeader = reinterpret_cast<GCHeader *>( pBlock );
+    size_t blockSize = sizeof( GCHeader ) + pHeader->size;
+
+    if ( e_GarbageCollectionObjectTypes::Free != pHeader->type && pHeader->isMarked )
+    {
+      if ( nullptr != pFreeRunStart )
+      {
+        AddFreeBlock( pFreeRunStart, pBlock - pFreeRunStart );
+        pFreeRunStart = nullptr;
+      }
+
+      pHeader->isMarked = false;
+      RecordBlockStart( pHeader );
+    }
+    else if ( nullptr == pFreeRunStart )
+    {
+      pFreeRunStart = pBlock;
+    }
+
+    pBlock += blockSize;
+  }
+
+  if ( nullptr != pFreeRunStart )
+  {
+    AddFreeBlock( pFreeRunStart, pEnd - pFreeRunStart );
+  }
+}
+
+void OldGeneration::AddFreeBlock( char *pBlock, size_t blockSize )
+{
+  GCHeader *pHeader = reinterpret_cast<GCHeader *>( pBlock );
+  pHeader->type = e_GarbageCollectionObjectTypes::Free;
+  pHeader->age = 0;
+  pHeader->isMarked = false;
+  pHeader->isFinalized = false;
+  pHeader->size = blockSize - sizeof( GCHeader );
+  pHeader->forwardingAddress = nullptr;
+
+  m_FreeBlocks.insert( std::make_pair( blockSize, pHeader ) );
+  m_FreeSpace += blockSize;
+
+  RecordBlockStart( pHeader );
+}
+
+void OldGeneration::RecordBlockStart( const GCHeader *pHeader ) JVMX_NOEXCEPT
+{
+  size_t offset = reinterpret_cast<const char *>( pHeader ) - GetStart();
+  size_t card = offset >> WriteBarrier::c_CardShift;
+  uint16_t offsetInCard = static_cast<uint16_t>( offset & ( c_CardSize - 1 ) );
+
+  if ( c_NoBlockStart == m_pFirstBlockInCard[ card ] || offsetInCard < m_pFirstBlockInCard[ card ] )
+  {
+    m_pFirstBlockInCard[ card ] = offsetInCard;
+  }
+}
+
+size_t OldGeneration::GetCardIndex( const void *pAddress ) const JVMX_NOEXCEPT
+{
+  return static_cast<size_t>( reinterpret_cast<const char *>( pAddress ) - GetStart() ) >> WriteBarrier::c_CardShift;
+}
@@ -0,0 +1,62 @@
+#ifndef _OLDGENERATION__H_
+#define _OLDGENERATION__H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "GlobalConstants.h"
+#include "GCHeader.h"
+
+// The old generation of the generational collector. Objects are copied in when they are promoted out of the nursery,
+// and never move again. Unused space is kept as Free blocks with headers of their own, so the generation can always be
+// walked from one end to the other, and it is reclaimed by mark-sweep.
+// A card table covers the generation for the write barrier. For each card we also keep where the first block starting
+// in it is, so that the objects in a dirty card can be found without walking from the start.
+class OldGeneration
+{
+public:
+  explicit OldGeneration( size_t sizeInBytes );
+  ~OldGeneration();
+
+  bool Contains( const void *pAddress ) const JVMX_NOEXCEPT;
+  const char *GetStart() const JVMX_NOEXCEPT;
+  const char *GetEnd() const JVMX_NOEXCEPT;
+
+  size_t GetSize() const JVMX_NOEXCEPT;
+  size_t GetFreeSpace() const JVMX_NOEXCEPT;
+
+  // Returns a block with room for at least sizeInBytes after its header, or nullptr if no free block is big enough.
+  // The block's size may be rounded up. The caller sets the type. Only called with the world stopped.
+  GCHeader *Allocate( size_t sizeInBytes );
+
+  // The objects whose headers are in dirty cards, which may refer to objects in the nursery.
+  void GetObjectsInDirtyCards( std::vector<GCHeader *> &objects ) const;
+  void ClearCards() JVMX_NOEXCEPT;
+  void DirtyCard( const GCHeader *pHeader ) JVMX_NOEXCEPT;
+
+  // Frees every object that is not marked, and unmarks the rest. Adjacent free blocks are merged.
+  void Sweep();
+
+private:
+  OldGeneration( const OldGeneration &other ) JVMX_FN_DELETE;
+  OldGeneration &operator=( const OldGeneration &other ) JVMX_FN_DELETE;
+
+  void AddFreeBlock( char *pBlock, size_t blockSize );
+  void RecordBlockStart( const GCHeader *pHeader ) JVMX_NOEXCEPT;
+  size_t GetCardIndex( const void *pAddress ) const JVMX_NOEXCEPT;
+
+private:
+  size_t m_SizeInBytes;
+  std::unique_ptr<char[]> m_pMemory;
+  size_t m_FreeSpace;
+
+  // Keyed on the size of the block, including its header.
+  std::multimap<size_t, GCHeader *> m_FreeBlocks;
+
+  size_t m_CardCount;
+  std::unique_ptr<uint8_t[]> m_pCards;
+  std::unique_ptr<uint16_t[]> m_pFirstBlockInCard;
+};
+
+#endif // _OLDGENERATION__H_
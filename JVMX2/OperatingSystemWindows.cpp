@@ -205,3 +205,24 @@ std::string OperatingSystemWindows::GetHostName()
 
   return std::string(pBuffer);
 }
+
+void *OperatingSystemWindows::ReserveMemory( size_t sizeInBytes )
+{
+  return VirtualAlloc( nullptr, sizeInBytes, MEM_RESERVE, PAGE_NOACCESS );
+}
+
+bool OperatingSystemWindows::CommitMemory( void *pAddress, size_t sizeInBytes )
+{
+  return nullptr != VirtualAlloc( pAddress, sizeInBytes, MEM_COMMIT, PAGE_READWRITE );
+}
+
+void OperatingSystemWindows::DecommitMemory( void *pAddress, size_t sizeInBytes )
+{
+  VirtualFree( pAddress, sizeInBytes, MEM_DECOMMIT );
+}
+
+void OperatingSystemWindows::ReleaseMemory( void *pAddress, size_t sizeInBytes )
+{
+  // The whole reservation is released at once, so Windows wants a size of 0.
+  VirtualFree( pAddress, 0, MEM_RELEASE );
+}
@@ -33,6 +33,11 @@ public:
   virtual intptr_t GetProcessID() JVMX_OVERRIDE;
 
   virtual std::string GetHostName() JVMX_OVERRIDE;
+
+  virtual void *ReserveMemory( size_t sizeInBytes ) JVMX_OVERRIDE;
+  virtual bool CommitMemory( void *pAddress, size_t sizeInBytes ) JVMX_OVERRIDE;
+  virtual void DecommitMemory( void *pAddress, size_t sizeInBytes ) JVMX_OVERRIDE;
+  virtual void ReleaseMemory( void *pAddress, size_t sizeInBytes ) JVMX_OVERRIDE;
 };
 
 #endif // __OPERATINGSYSTEMWINDOWS_H__
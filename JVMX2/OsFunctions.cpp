@@ -16,6 +16,26 @@ std::string OsFunctions::GetHostName()
   return m_pDelegate->GetHostName();
 }
 
+void *OsFunctions::ReserveMemory( size_t sizeInBytes )
+{
+  return m_pDelegate->ReserveMemory( sizeInBytes );
+}
+
+bool OsFunctions::CommitMemory( void *pAddress, size_t sizeInBytes )
+{
+  return m_pDelegate->CommitMemory( pAddress, sizeInBytes );
+}
+
+void OsFunctions::DecommitMemory( void *pAddress, size_t sizeInBytes )
+{
+  m_pDelegate->DecommitMemory( pAddress, sizeInBytes );
+}
+
+void OsFunctions::ReleaseMemory( void *pAddress, size_t sizeInBytes )
+{
+  m_pDelegate->ReleaseMemory( pAddress, sizeInBytes );
+}
+
 void OsFunctions::SetThreadName( const char *name )
 {
   return m_pDelegate->SetThreadName( name );
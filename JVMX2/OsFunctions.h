@@ -45,6 +45,11 @@ public:
   intptr_t GetProcessID();
   std::string GetHostName();
 
+  void *ReserveMemory( size_t sizeInBytes );
+  bool CommitMemory( void *pAddress, size_t sizeInBytes );
+  void DecommitMemory( void *pAddress, size_t sizeInBytes );
+  void ReleaseMemory( void *pAddress, size_t sizeInBytes );
+
 private:
   IOperatingSystemDelegate *m_pDelegate;
 
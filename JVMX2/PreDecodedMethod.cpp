@@ -0,0 +1,315 @@
+#include "DataBuffer.h"
+#include "JavaOpCodes.h"
+
+#include "InvalidArgumentException.h"
+
+#include "PreDecodedMethod.h"
+
+namespace
+{
+  const uint8_t c_OpCodeWide = 0xc4;
+  const uint8_t c_OpCodeLastDefined = 0xc9; // jsr_w
+
+  int16_t ReadInt16( const uint8_t *pCode, uintptr_t offset )
+  {
+    return static_cast<int16_t>( ( pCode[ offset ] << 8 ) | pCode[ offset + 1 ] );
+  }
+
+  int32_t ReadInt32( const uint8_t *pCode, uintptr_t offset )
+  {
+    return static_cast<int32_t>( ( pCode[ offset ] << 24 ) | ( pCode[ offset + 1 ] << 16 ) | ( pCode[ offset + 2 ] << 8 ) | pCode[ offset + 3 ] );
+  }
+
+  uint16_t ReadUInt16( const uint8_t *pCode, uintptr_t offset )
+  {
+    return static_cast<uint16_t>( ( pCode[ offset ] << 8 ) | pCode[ offset + 1 ] );
+  }
+
+  bool IsShortBranch( uint8_t opCode )
+  {
+    return ( opCode >= static_cast<uint8_t>( e_JavaOpCodes::BranchIfEquals ) && opCode <= static_cast<uint8_t>( e_JavaOpCodes::Goto ) ) ||
+           opCode == static_cast<uint8_t>( e_JavaOpCodes::BranchIfNull ) ||
+           opCode == static_cast<uint8_t>( e_JavaOpCodes::BranchIfNotNull );
+  }
+}
+
+PreDecodedMethod::PreDecodedMethod( const DataBuffer &code, const DecodedInstructionHandler *pHandlerTable )
+  : m_IsValid( false )
+{
+  if ( nullptr == pHandlerTable )
+  {
+    throw InvalidArgumentException( __FUNCTION__ " - Handler table was NULL." );
+  }
+
+  Decode( code.ToByteArray(), code.GetByteLength(), pHandlerTable );
+}
+
+bool PreDecodedMethod::IsValid() const JVMX_NOEXCEPT
+{
+  return m_IsValid;
+}
+
+const DecodedInstruction *PreDecodedMethod::GetInstructionAt( uintptr_t programCounter ) const
+{
+  if ( !m_IsValid || programCounter >= m_InstructionIndexAtProgramCounter.size() )
+  {
+    return nullptr;
+  }
+
+  int32_t index = m_InstructionIndexAtProgramCounter[ programCounter ];
+  if ( index < 0 )
+  {
+    return nullptr;
+  }
+
+  return &m_Instructions[ index ];
+}
+
+bool PreDecodedMethod::IsEndOfCode( const DecodedInstruction *pInstruction ) const JVMX_NOEXCEPT
+{
+  return m_Instructions.empty() || pInstruction == &m_Instructions.back();
+}
+
+int32_t PreDecodedMethod::GetInstructionLength( const uint8_t *pCode, size_t codeLength, uintptr_t programCounter )
+{
+  uint8_t opCode = pCode[ programCounter ];
+
+  switch ( opCode )
+  {
+    case 0x10: // bipush
+    case 0x12: // ldc
+    case 0x15: // iload
+    case 0x16: // lload
+    case 0x17: // fload
+    case 0x18: // dload
+    case 0x19: // aload
+    case 0x36: // istore
+    case 0x37: // lstore
+    case 0x38: // fstore
+    case 0x39: // dstore
+    case 0x3a: // astore
+    case 0xa9: // ret
+    case 0xbc: // newarray
+      return 2;
+
+    case 0x11: // sipush
+    case 0x13: // ldc_w
+    case 0x14: // ldc2_w
+    case 0x84: // iinc
+    case 0xa8: // jsr
+    case 0xb2: // getstatic
+    case 0xb3: // putstatic
+    case 0xb4: // getfield
+    case 0xb5: // putfield
+    case 0xb6: // invokevirtual
+    case 0xb7: // invokespecial
+    case 0xb8: // invokestatic
+    case 0xbb: // new
+    case 0xbd: // anewarray
+    case 0xc0: // checkcast
+    case 0xc1: // instanceof
+    case 0xcb: // getstatic (quick)
+    case 0xcc: // putstatic (quick)
+    case 0xcd: // getfield (quick)
+    case 0xce: // putfield (quick)
+    case 0xcf: // invokevirtual (quick)
+    case 0xd0: // invokespecial (quick)
+    case 0xd1: // invokestatic (quick)
+      return 3;
+
+    case 0xc5: // multianewarray
+      return 4;
+
+    case 0xc4: // wide
+      if ( programCounter + 1 >= codeLength )
+      {
+        return -1;
+      }
+
+      switch ( pCode[ programCounter + 1 ] )
+      {
+        case 0x15: // iload
+        case 0x16: // lload
+        case 0x17: // fload
+        case 0x18: // dload
+        case 0x19: // aload
+        case 0x36: // istore
+        case 0x37: // lstore
+        case 0x38: // fstore
+        case 0x39: // dstore
+        case 0x3a: // astore
+          return 4;
+
+        case 0x84: // iinc
+          return 6;
+
+        default:
+          // Includes wide ret, which the switch based engine doesn't implement either.
+          return -1;
+      }
+
+    case 0xb9: // invokeinterface
+    case 0xba: // invokedynamic
+    case 0xc8: // goto_w
+    case 0xc9: // jsr_w
+    case 0xd2: // invokeinterface (quick)
+      return 5;
+
+    case 0xaa: // tableswitch
+    {
+      uintptr_t position = programCounter + 1;
+      position += ( 4 - ( position % 4 ) ) % 4;
+      if ( position + 12 > codeLength )
+      {
+        return -1;
+      }
+
+      int32_t low = ReadInt32( pCode, position + 4 );
+      int32_t high = ReadInt32( pCode, position + 8 );
+      if ( high < low )
+      {
+        return -1;
+      }
+
+      position += 12 + ( static_cast<uintptr_t>( high - low ) + 1 ) * 4;
+      return static_cast<int32_t>( position - programCounter );
+    }
+
+    case 0xab: // lookupswitch
+    {
+      uintptr_t position = programCounter + 1;
+      position += ( 4 - ( position % 4 ) ) % 4;
+      if ( position + 8 > codeLength )
+      {
+        return -1;
+      }
+
+      int32_t pairCount = ReadInt32( pCode, position + 4 );
+      if ( pairCount < 0 )
+      {
+        return -1;
+      }
+
+      position += 8 + static_cast<uintptr_t>( pairCount ) * 8;
+      return static_cast<int32_t>( position - programCounter );
+    }
+
+    default:
+      if ( IsShortBranch( opCode ) )
+      {
+        return 3;
+      }
+
+      if ( opCode > c_OpCodeLastDefined )
+      {
+        // Not supported by the pre-decoder. The whole method falls back to the switch based engine.
+        return -1;
+      }
+
+      return 1;
+  }
+}
+
+void PreDecodedMethod::Decode( const uint8_t *pCode, size_t codeLength, const DecodedInstructionHandler *pHandlerTable )
+{
+  m_InstructionIndexAtProgramCounter.assign( codeLength + 1, -1 );
+
+  uintptr_t programCounter = 0;
+  while ( programCounter < codeLength )
+  {
+    int32_t length = GetInstructionLength( pCode, codeLength, programCounter );
+    if ( length <= 0 || programCounter + length > codeLength )
+    {
+      m_Instructions.clear();
+      m_InstructionIndexAtProgramCounter.clear();
+      return;
+    }
+
+    uint8_t opCode = pCode[ programCounter ];
+
+    DecodedInstruction instruction = { pHandlerTable[ opCode ], nullptr, static_cast<uint32_t>( programCounter ), 0, 0, opCode };
+
+    if ( c_OpCodeWide == opCode )
+    {
+      // The switch based engine has no wide support, so a wide instruction is always run by the handler of the opcode
+      // it modifies, with the 16 bit local index (and iinc constant) decoded here.
+      opCode = pCode[ programCounter + 1 ];
+      instruction.m_pHandler = pHandlerTable[ opCode ];
+      instruction.m_OpCode = opCode;
+      instruction.m_Operand1 = ReadUInt16( pCode, programCounter + 2 );
+      if ( opCode == static_cast<uint8_t>( e_JavaOpCodes::IncrementLocalVariable ) )
+      {
+        instruction.m_Operand2 = ReadInt16( pCode, programCounter + 4 );
+      }
+    }
+    else if ( opCode >= static_cast<uint8_t>( e_JavaOpCodes::PushInt_Minus1 ) && opCode <= static_cast<uint8_t>( e_JavaOpCodes::PushInt_5 ) )
+    {
+      instruction.m_Operand1 = opCode - static_cast<uint8_t>( e_JavaOpCodes::PushInt_0 );
+    }
+    else if ( opCode >= static_cast<uint8_t>( e_JavaOpCodes::LoadIntegerFromLocal_0 ) && opCode <= static_cast<uint8_t>( e_JavaOpCodes::LoadReferenceFromLocal_3 ) )
+    {
+      instruction.m_Operand1 = ( opCode - static_cast<uint8_t>( e_JavaOpCodes::LoadIntegerFromLocal_0 ) ) % 4;
+    }
+    else if ( opCode >= static_cast<uint8_t>( e_JavaOpCodes::StoreIntegerInLocal_0 ) && opCode <= static_cast<uint8_t>( e_JavaOpCodes::StoreReferenceInLocal_3 ) )
+    {
+      instruction.m_Operand1 = ( opCode - static_cast<uint8_t>( e_JavaOpCodes::StoreIntegerInLocal_0 ) ) % 4;
+    }
+    else if ( opCode == static_cast<uint8_t>( e_JavaOpCodes::PushInt_ImmediateByte ) )
+    {
+      instruction.m_Operand1 = static_cast<int8_t>( pCode[ programCounter + 1 ] );
+    }
+    else if ( opCode == static_cast<uint8_t>( e_JavaOpCodes::PushShortConstant ) )
+    {
+      instruction.m_Operand1 = ReadInt16( pCode, programCounter + 1 );
+    }
+    else if ( opCode == static_cast<uint8_t>( e_JavaOpCodes::IncrementLocalVariable ) )
+    {
+      instruction.m_Operand1 = pCode[ programCounter + 1 ];
+      instruction.m_Operand2 = static_cast<int8_t>( pCode[ programCounter + 2 ] );
+    }
+    else if ( 2 == length )
+    {
+      instruction.m_Operand1 = pCode[ programCounter + 1 ];
+    }
+    else if ( IsShortBranch( opCode ) )
+    {
+      instruction.m_Operand1 = ReadInt16( pCode, programCounter + 1 );
+    }
+
+    m_InstructionIndexAtProgramCounter[ programCounter ] = static_cast<int32_t>( m_Instructions.size() );
+    m_Instructions.push_back( instruction );
+
+    programCounter += length;
+  }
+
+  // The sentinel sits at the end of the code segment so that falling off the end leaves the pre-decoded stream.
+  DecodedInstruction sentinel = { nullptr, nullptr, static_cast<uint32_t>( codeLength ), 0, 0, 0 };
+  m_InstructionIndexAtProgramCounter[ codeLength ] = static_cast<int32_t>( m_Instructions.size() );
+  m_Instructions.push_back( sentinel );
+
+  LinkBranchTargets( pCode );
+
+  m_IsValid = true;
+}
+
+void PreDecodedMethod::LinkBranchTargets( const uint8_t *pCode )
+{
+  // m_Instructions is not resized after this point, so the target pointers stay valid.
+  for ( DecodedInstruction &instruction : m_Instructions )
+  {
+    if ( nullptr == instruction.m_pHandler || !IsShortBranch( pCode[ instruction.m_ProgramCounter ] ) )
+    {
+      continue;
+    }
+
+    int64_t target = static_cast<int64_t>( instruction.m_ProgramCounter ) + instruction.m_Operand1;
+    if ( target < 0 || target >= static_cast<int64_t>( m_InstructionIndexAtProgramCounter.size() ) || m_InstructionIndexAtProgramCounter[ static_cast<size_t>( target ) ] < 0 )
+    {
+      // Malformed target. Let the switch based engine deal with it.
+      instruction.m_pHandler = nullptr;
+      continue;
+    }
+
+    instruction.m_pBranchTarget = &m_Instructions[ m_InstructionIndexAtProgramCounter[ static_cast<size_t>( target ) ] ];
+  }
+}
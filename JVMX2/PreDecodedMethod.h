@@ -0,0 +1,56 @@
+#ifndef _PREDECODEDMETHOD__H_
+#define _PREDECODEDMETHOD__H_
+
+#include <memory>
+#include <vector>
+
+#include "GlobalConstants.h"
+
+class DataBuffer;
+class IVirtualMachineState;
+class ThreadedExecutionEngine;
+struct DecodedInstruction;
+
+// A handler executes one pre-decoded instruction and returns the next instruction to execute. Handlers never touch the
+// program counter of the virtual machine state; the engine writes it back when it leaves the pre-decoded stream.
+typedef const DecodedInstruction *( *DecodedInstructionHandler )( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+struct DecodedInstruction
+{
+  DecodedInstructionHandler m_pHandler; // nullptr means the instruction must be executed by the switch based engine.
+  const DecodedInstruction *m_pBranchTarget;
+  uint32_t m_ProgramCounter;
+  int32_t m_Operand1; // Local variable index, or immediate value.
+  int32_t m_Operand2; // iinc constant.
+  uint16_t m_OpCode;
+};
+
+class PreDecodedMethod
+{
+public:
+  static const size_t c_HandlerTableSize = 256;
+
+  PreDecodedMethod( const DataBuffer &code, const DecodedInstructionHandler *pHandlerTable );
+
+  bool IsValid() const JVMX_NOEXCEPT;
+
+  // Returns the instruction starting at programCounter. programCounter == code length returns a sentinel with no handler.
+  const DecodedInstruction *GetInstructionAt( uintptr_t programCounter ) const;
+  bool IsEndOfCode( const DecodedInstruction *pInstruction ) const JVMX_NOEXCEPT;
+
+  static int32_t GetInstructionLength( const uint8_t *pCode, size_t codeLength, uintptr_t programCounter );
+
+private:
+  PreDecodedMethod( const PreDecodedMethod &other ) JVMX_FN_DELETE;
+  PreDecodedMethod &operator=( const PreDecodedMethod &other ) JVMX_FN_DELETE;
+
+  void Decode( const uint8_t *pCode, size_t codeLength, const DecodedInstructionHandler *pHandlerTable );
+  void LinkBranchTargets( const uint8_t *pCode );
+
+private:
+  std::vector<DecodedInstruction> m_Instructions;
+  std::vector<int32_t> m_InstructionIndexAtProgramCounter; // -1 where no instruction starts.
+  bool m_IsValid;
+};
+
+#endif // _PREDECODEDMETHOD__H_
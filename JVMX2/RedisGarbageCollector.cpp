@@ -4,6 +4,7 @@
 #include "GlobalCatalog.h"
 
 #include "InternalErrorException.h"
+#include "Safepoint.h"
 
 #include "RedisGarbageCollector.h"
 
@@ -52,6 +53,11 @@ void *RedisGarbageCollector::AllocateBytes( size_t sizeInBytes )
 {
   void *pNewObject = new char [sizeInBytes];
 
+  if ( MustCollect() )
+  {
+    Safepoint::RequestCollection();
+  }
+
   //m_Pointers.push_back( pNewObject );
 
   return pNewObject;
@@ -0,0 +1,39 @@
+#include "TypeParser.h"
+
+#include "ReferenceMap.h"
+
+ReferenceMap::ReferenceMap( const ReferenceMap *pSuperClassMap, size_t superClassInstanceSize, const FieldInfoList &fields )
+{
+  if ( nullptr != pSuperClassMap )
+  {
+    m_Offsets = pSuperClassMap->m_Offsets;
+  }
+
+  // The class loader hands out offsets in declaration order within each slot width, and all references share one width,
+  // so the class's own offsets are already sorted.
+  for ( const auto &pField : fields )
+  {
+    if ( pField->IsStatic() )
+    {
+      continue;
+    }
+
+    e_JavaVariableTypes type = pField->GetVariableType();
+    if ( e_JavaVariableTypes::Object == type || e_JavaVariableTypes::Array == type )
+    {
+      m_Offsets.push_back( static_cast<uint32_t>( superClassInstanceSize + pField->GetOffset() ) );
+    }
+  }
+
+  m_Offsets.shrink_to_fit();
+}
+
+size_t ReferenceMap::GetCount() const JVMX_NOEXCEPT
+{
+  return m_Offsets.size();
+}
+
+const uint32_t *ReferenceMap::GetOffsets() const JVMX_NOEXCEPT
+{
+  return m_Offsets.data();
+}
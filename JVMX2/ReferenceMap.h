@@ -0,0 +1,29 @@
+#ifndef _REFERENCEMAP__H_
+#define _REFERENCEMAP__H_
+
+#include <vector>
+
+#include "GlobalConstants.h"
+#include "FieldInfo.h"
+
+// Where the references are in an instance of a class: the offset into the object's fields of every non-static field
+// holding an object or an array, the superclasses' included. The garbage collector walks this instead of the fields.
+class ReferenceMap
+{
+public:
+  // pSuperClassMap is nullptr for java/lang/Object only. The class's own fields start at superClassInstanceSize.
+  ReferenceMap( const ReferenceMap *pSuperClassMap, size_t superClassInstanceSize, const FieldInfoList &fields );
+
+  size_t GetCount() const JVMX_NOEXCEPT;
+  const uint32_t *GetOffsets() const JVMX_NOEXCEPT;
+
+private:
+  ReferenceMap( const ReferenceMap &other ) JVMX_FN_DELETE;
+  ReferenceMap &operator=( const ReferenceMap &other ) JVMX_FN_DELETE;
+
+private:
+  // In ascending order, so that a scan walks the object from front to back.
+  std::vector<uint32_t> m_Offsets;
+};
+
+#endif // _REFERENCEMAP__H_
@@ -0,0 +1,64 @@
+#include "IndexOutOfBoundsException.h"
+
+#include "ConstantPoolFieldReference.h"
+#include "ConstantPoolMethodReference.h"
+#include "JavaClass.h"
+
+#include "ResolvedConstantPool.h"
+
+ResolvedConstantPoolEntry::ResolvedConstantPoolEntry()
+  : m_FieldOffset( 0 )
+  , m_ArgumentCount( 0 )
+{}
+
+ResolvedConstantPool::Slot::Slot()
+  : m_IsResolved( false )
+  , m_IsClassInitialised( false )
+{}
+
+ResolvedConstantPool::ResolvedConstantPool( size_t constantPoolCount )
+  : m_pSlots( new Slot[ constantPoolCount ] )
+  , m_SlotCount( constantPoolCount )
+{}
+
+const ResolvedConstantPoolEntry *ResolvedConstantPool::Find( ConstantPoolIndex index ) const JVMX_NOEXCEPT
+{
+  if ( index >= m_SlotCount || !m_pSlots[ index ].m_IsResolved.load( std::memory_order_acquire ) )
+  {
+    return nullptr;
+  }
+
+  return &m_pSlots[ index ].m_Entry;
+}
+
+const ResolvedConstantPoolEntry *ResolvedConstantPool::Store( ConstantPoolIndex index, const ResolvedConstantPoolEntry &entry )
+{
+  if ( index >= m_SlotCount )
+  {
+    throw IndexOutOfBoundsException( __FUNCTION__ " - Constant pool index was out of range." );
+  }
+
+  std::lock_guard<std::mutex> lock( m_StoreMutex );
+
+  Slot &slot = m_pSlots[ index ];
+  if ( !slot.m_IsResolved.load( std::memory_order_relaxed ) )
+  {
+    slot.m_Entry = entry;
+    slot.m_IsResolved.store( true, std::memory_order_release );
+  }
+
+  return &slot.m_Entry;
+}
+
+bool ResolvedConstantPool::IsClassInitialised( ConstantPoolIndex index ) const JVMX_NOEXCEPT
+{
+  return index < m_SlotCount && m_pSlots[ index ].m_IsClassInitialised.load( std::memory_order_acquire );
+}
+
+void ResolvedConstantPool::SetClassInitialised( ConstantPoolIndex index ) JVMX_NOEXCEPT
+{
+  if ( index < m_SlotCount )
+  {
+    m_pSlots[ index ].m_IsClassInitialised.store( true, std::memory_order_release );
+  }
+}
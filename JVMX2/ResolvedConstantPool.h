@@ -0,0 +1,69 @@
+#ifndef _RESOLVEDCONSTANTPOOL__H_
+#define _RESOLVEDCONSTANTPOOL__H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "GlobalConstants.h"
+
+class JavaClass;
+class FieldInfo;
+class MethodInfo;
+class ConstantPoolFieldReference;
+class ConstantPoolMethodReference;
+
+// The result of resolving one symbolic reference in a class's constant pool. Only the members relevant to the kind of
+// reference are set.
+struct ResolvedConstantPoolEntry
+{
+  ResolvedConstantPoolEntry();
+
+  std::shared_ptr<ConstantPoolFieldReference> m_pFieldReference;
+  std::shared_ptr<ConstantPoolMethodReference> m_pMethodReference;
+
+  std::shared_ptr<JavaClass> m_pClass; // The class named by the reference.
+  std::shared_ptr<FieldInfo> m_pField;
+  std::shared_ptr<MethodInfo> m_pMethod;
+
+  size_t m_FieldOffset; // Offset of an instance field from the start of the object's field storage.
+  size_t m_ArgumentCount; // Number of arguments a method takes, not counting the object reference.
+};
+
+// Per class cache of resolved constant pool entries, indexed by ConstantPoolIndex. An entry is stored once, under a
+// lock, and is read without taking any lock after that.
+class ResolvedConstantPool
+{
+public:
+  explicit ResolvedConstantPool( size_t constantPoolCount );
+
+  // Returns nullptr if the entry has not been resolved yet.
+  const ResolvedConstantPoolEntry *Find( ConstantPoolIndex index ) const JVMX_NOEXCEPT;
+
+  // If another thread stored the entry first, its entry is kept and returned instead.
+  const ResolvedConstantPoolEntry *Store( ConstantPoolIndex index, const ResolvedConstantPoolEntry &entry );
+
+  // Records that the class named by the entry has been initialised, so later uses can skip the check.
+  bool IsClassInitialised( ConstantPoolIndex index ) const JVMX_NOEXCEPT;
+  void SetClassInitialised( ConstantPoolIndex index ) JVMX_NOEXCEPT;
+
+private:
+  ResolvedConstantPool( const ResolvedConstantPool &other ) JVMX_FN_DELETE;
+  ResolvedConstantPool &operator=( const ResolvedConstantPool &other ) JVMX_FN_DELETE;
+
+private:
+  struct Slot
+  {
+    Slot();
+
+    std::atomic<bool> m_IsResolved;
+    std::atomic<bool> m_IsClassInitialised;
+    ResolvedConstantPoolEntry m_Entry;
+  };
+
+  std::unique_ptr<Slot[]> m_pSlots;
+  size_t m_SlotCount;
+  std::mutex m_StoreMutex;
+};
+
+#endif // _RESOLVEDCONSTANTPOOL__H_
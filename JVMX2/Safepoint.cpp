@@ -0,0 +1,143 @@
+#include "IVirtualMachineState.h"
+
+#include "Safepoint.h"
+
+std::atomic<uint32_t> Safepoint::s_PollWord( 0 );
+
+std::mutex Safepoint::s_Mutex;
+std::condition_variable Safepoint::s_Stopped;
+std::condition_variable Safepoint::s_Resumed;
+
+size_t Safepoint::s_OutstandingThreads = 0;
+std::chrono::steady_clock::time_point Safepoint::s_StopRequestTime;
+SafepointStatistics Safepoint::s_Statistics;
+
+SafepointStatistics::SafepointStatistics()
+  : m_TimeToSafepoint( 0 )
+  , m_SlowestThreadTime( 0 )
+  , m_ThreadsParked( 0 )
+  , m_ThreadsInNativeCode( 0 )
+  , m_ThreadsNotStopped( 0 )
+{}
+
+void Safepoint::BeginStop()
+{
+  std::lock_guard<std::mutex> lock( s_Mutex );
+
+  s_OutstandingThreads = 0;
+  s_StopRequestTime = std::chrono::steady_clock::now();
+  s_Statistics = SafepointStatistics();
+}
+
+void Safepoint::StopThread( IVirtualMachineState &state )
+{
+  std::lock_guard<std::mutex> lock( s_Mutex );
+
+  // Pause marks a thread that is in native code as paused straight away. Anything else has to acknowledge.
+  state.Pause();
+  if ( state.IsPaused() )
+  {
+    ++ s_Statistics.m_ThreadsInNativeCode;
+  }
+  else
+  {
+    ++ s_OutstandingThreads;
+  }
+}
+
+void Safepoint::RequestPause() JVMX_NOEXCEPT
+{
+  s_PollWord.fetch_or( c_PauseRequested, std::memory_order_seq_cst );
+}
+
+void Safepoint::ReleasePause() JVMX_NOEXCEPT
+{
+  s_PollWord.fetch_and( ~c_PauseRequested, std::memory_order_seq_cst );
+}
+
+bool Safepoint::WaitForStop( std::chrono::milliseconds timeout )
+{
+  std::unique_lock<std::mutex> lock( s_Mutex );
+
+  bool allStopped = s_Stopped.wait_for( lock, timeout, []() { return 0 == s_OutstandingThreads; } );
+
+  s_Statistics.m_TimeToSafepoint = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - s_StopRequestTime );
+  s_Statistics.m_ThreadsNotStopped = s_OutstandingThreads;
+
+  return allStopped;
+}
+
+SafepointStatistics Safepoint::GetLastStopStatistics()
+{
+  std::lock_guard<std::mutex> lock( s_Mutex );
+  return s_Statistics;
+}
+
+void Safepoint::RequestCollection() JVMX_NOEXCEPT
+{
+  if ( 0 == ( s_PollWord.load( std::memory_order_relaxed ) & c_CollectionRequested ) )
+  {
+    s_PollWord.fetch_or( c_CollectionRequested, std::memory_order_relaxed );
+  }
+}
+
+bool Safepoint::TakeCollectionRequest() JVMX_NOEXCEPT
+{
+  return 0 != ( s_PollWord.fetch_and( ~c_CollectionRequested, std::memory_order_relaxed ) & c_CollectionRequested );
+}
+
+void Safepoint::Park( IVirtualMachineState &state )
+{
+  std::unique_lock<std::mutex> lock( s_Mutex );
+
+  // Resume takes the same lock, so a thread resumed after it saw the request, but before it got here, does not park.
+  if ( state.IsPausing() && !state.IsPaused() )
+  {
+    Acknowledge( state );
+    ++ s_Statistics.m_ThreadsParked;
+  }
+  else if ( !state.IsPaused() )
+  {
+    return;
+  }
+
+  s_Resumed.wait( lock, [&state]() { return !state.IsPaused(); } );
+}
+
+void Safepoint::AcknowledgeFromNative( IVirtualMachineState &state )
+{
+  std::lock_guard<std::mutex> lock( s_Mutex );
+
+  // StopThread may have seen the thread in native code already, in which case it was never counted.
+  if ( state.IsPausing() && !state.IsPaused() )
+  {
+    Acknowledge( state );
+    ++ s_Statistics.m_ThreadsInNativeCode;
+  }
+}
+
+void Safepoint::Resume( IVirtualMachineState &state )
+{
+  std::lock_guard<std::mutex> lock( s_Mutex );
+
+  state.Resume();
+  s_Resumed.notify_all();
+}
+
+void Safepoint::Acknowledge( IVirtualMachineState &state )
+{
+  state.ConfirmPaused();
+
+  std::chrono::microseconds timeToSafepoint = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - s_StopRequestTime );
+  if ( timeToSafepoint >= s_Statistics.m_SlowestThreadTime )
+  {
+    s_Statistics.m_SlowestThreadTime = timeToSafepoint;
+    s_Statistics.m_SlowestThreadLocation = state.GetCurrentClassAndMethodName().ToUtf8String();
+  }
+
+  JVMX_ASSERT( s_OutstandingThreads > 0 );
+  if ( 0 == -- s_OutstandingThreads )
+  {
+    s_Stopped.notify_all();
+  }
+}
@@ -0,0 +1,91 @@
+#ifndef _SAFEPOINT__H_
+#define _SAFEPOINT__H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "GlobalConstants.h"
+
+class IVirtualMachineState;
+
+// How long the last stop-the-world took to reach its safepoint.
+struct SafepointStatistics
+{
+  SafepointStatistics();
+
+  // From the stop being requested until the last thread acknowledged it, or until the wait timed out.
+  std::chrono::microseconds m_TimeToSafepoint;
+
+  // The thread that took longest to acknowledge, and the method it was in when it did.
+  std::chrono::microseconds m_SlowestThreadTime;
+  std::string m_SlowestThreadLocation;
+
+  size_t m_ThreadsParked;
+  size_t m_ThreadsInNativeCode;
+  size_t m_ThreadsNotStopped;
+};
+
+// The global safepoint poll word, and the place threads park while the world is stopped.
+// Running threads only look at the poll word on method entry and on backward branches, so straight line code never pays
+// for a pause check. When the word is clear the check is a single relaxed load and a compare.
+// A stop is a handshake: every thread asked to stop is counted, and each one acknowledges exactly once, either by
+// parking at a safepoint or by calling into native code. Threads already in native code are safe and are not counted.
+class Safepoint
+{
+public:
+  static const uint32_t c_PauseRequested = 0x1;
+  static const uint32_t c_CollectionRequested = 0x2;
+
+  static bool IsRequested() JVMX_NOEXCEPT
+  {
+    return 0 != s_PollWord.load( std::memory_order_relaxed );
+  }
+
+  // A stop is made by BeginStop, StopThread for each thread other than the caller, RequestPause, and then WaitForStop.
+  // It ends with ReleasePause, followed by Resume for each thread.
+  static void BeginStop();
+  static void StopThread( IVirtualMachineState &state );
+  static void RequestPause() JVMX_NOEXCEPT;
+  static void ReleasePause() JVMX_NOEXCEPT;
+
+  // Waits for every counted thread to acknowledge the stop. Returns false if the timeout expires first.
+  static bool WaitForStop( std::chrono::milliseconds timeout );
+  static SafepointStatistics GetLastStopStatistics();
+
+  // Asks the next thread to reach a safepoint to run the garbage collector.
+  static void RequestCollection() JVMX_NOEXCEPT;
+
+  // Returns true, and clears the request, for exactly one of the threads that sees a collection request.
+  static bool TakeCollectionRequest() JVMX_NOEXCEPT;
+
+  // Blocks the calling thread until it is resumed, if it has been asked to pause.
+  static void Park( IVirtualMachineState &state );
+
+  // Called by a thread that has just entered native code while it is being asked to pause. It does not block.
+  static void AcknowledgeFromNative( IVirtualMachineState &state );
+
+  // Resumes a thread, waking it if it is parked.
+  static void Resume( IVirtualMachineState &state );
+
+private:
+  Safepoint() JVMX_FN_DELETE;
+
+  // s_Mutex must be held.
+  static void Acknowledge( IVirtualMachineState &state );
+
+private:
+  static std::atomic<uint32_t> s_PollWord;
+
+  static std::mutex s_Mutex;
+  static std::condition_variable s_Stopped;
+  static std::condition_variable s_Resumed;
+
+  static size_t s_OutstandingThreads;
+  static std::chrono::steady_clock::time_point s_StopRequestTime;
+  static SafepointStatistics s_Statistics;
+};
+
+#endif // _SAFEPOINT__H_
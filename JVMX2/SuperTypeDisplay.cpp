@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "SuperTypeDisplay.h"
+
+SuperTypeDisplay::SuperTypeDisplay( const JavaClass *pClass, bool isInterface, const SuperTypeDisplay *pSuperClassDisplay, const std::vector<const SuperTypeDisplay *> &interfaceDisplays )
+  : m_pClass( pClass )
+  , m_IsPrimary( false )
+  , m_Depth( 0 )
+  , m_pSecondarySuperTypeCache( nullptr )
+{
+  for ( size_t index = 0; index < c_PrimaryDepth; ++ index )
+  {
+    m_PrimarySuperTypes[ index ] = nullptr;
+  }
+
+  if ( nullptr != pSuperClassDisplay )
+  {
+    m_Depth = pSuperClassDisplay->m_Depth + 1;
+    for ( size_t index = 0; index < c_PrimaryDepth; ++ index )
+    {
+      m_PrimarySuperTypes[ index ] = pSuperClassDisplay->m_PrimarySuperTypes[ index ];
+    }
+
+    m_SecondarySuperTypes = pSuperClassDisplay->m_SecondarySuperTypes;
+  }
+
+  if ( isInterface )
+  {
+    // An interface's superclass is java/lang/Object. Its depth is only kept so that the display above stays valid.
+    m_IsPrimary = false;
+  }
+  else if ( m_Depth < c_PrimaryDepth )
+  {
+    m_IsPrimary = true;
+    m_PrimarySuperTypes[ m_Depth ] = pClass;
+  }
+  else
+  {
+    // Too deep for the display, so subclasses will find this class in their secondary super types instead.
+    AddSecondarySuperType( pClass );
+  }
+
+  for ( const SuperTypeDisplay *pInterfaceDisplay : interfaceDisplays )
+  {
+    AddSecondarySuperType( pInterfaceDisplay->m_pClass );
+    for ( const JavaClass *pSuperInterface : pInterfaceDisplay->m_SecondarySuperTypes )
+    {
+      AddSecondarySuperType( pSuperInterface );
+    }
+  }
+}
+
+const JavaClass *SuperTypeDisplay::GetClass() const JVMX_NOEXCEPT
+{
+  return m_pClass;
+}
+
+bool SuperTypeDisplay::IsSubtypeOf( const SuperTypeDisplay &other ) const JVMX_NOEXCEPT
+{
+  if ( m_pClass == other.m_pClass )
+  {
+    return true;
+  }
+
+  if ( other.m_IsPrimary )
+  {
+    return m_PrimarySuperTypes[ other.m_Depth ] == other.m_pClass;
+  }
+
+  if ( m_pSecondarySuperTypeCache.load( std::memory_order_relaxed ) == other.m_pClass )
+  {
+    return true;
+  }
+
+  if ( m_SecondarySuperTypes.cend() == std::find( m_SecondarySuperTypes.cbegin(), m_SecondarySuperTypes.cend(), other.m_pClass ) )
+  {
+    return false;
+  }
+
+  m_pSecondarySuperTypeCache.store( other.m_pClass, std::memory_order_relaxed );
+  return true;
+}
+
+const std::vector<const JavaClass *> &SuperTypeDisplay::GetSecondarySuperTypes() const JVMX_NOEXCEPT
+{
+  return m_SecondarySuperTypes;
+}
+
+void SuperTypeDisplay::AddSecondarySuperType( const JavaClass *pClass )
+{
+  if ( m_SecondarySuperTypes.cend() == std::find( m_SecondarySuperTypes.cbegin(), m_SecondarySuperTypes.cend(), pClass ) )
+  {
+    m_SecondarySuperTypes.push_back( pClass );
+  }
+}
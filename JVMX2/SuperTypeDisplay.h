@@ -0,0 +1,49 @@
+#ifndef _SUPERTYPEDISPLAY__H_
+#define _SUPERTYPEDISPLAY__H_
+
+#include <atomic>
+#include <vector>
+
+#include "GlobalConstants.h"
+
+class JavaClass;
+
+// Every type a class can be assigned to, laid out so that a subtype check is a handful of pointer compares.
+// The superclasses up to c_PrimaryDepth deep are kept in a display indexed by their depth below java/lang/Object, so
+// checking against one of them is a single load and compare. Interfaces, and superclasses deeper than the display, are
+// kept in a list of secondary super types that is scanned, with the last one found cached in front of it.
+class SuperTypeDisplay
+{
+public:
+  static const size_t c_PrimaryDepth = 8;
+
+  // pSuperClassDisplay is nullptr for java/lang/Object only. interfaceDisplays are those of the class's direct interfaces.
+  SuperTypeDisplay( const JavaClass *pClass, bool isInterface, const SuperTypeDisplay *pSuperClassDisplay, const std::vector<const SuperTypeDisplay *> &interfaceDisplays );
+
+  const JavaClass *GetClass() const JVMX_NOEXCEPT;
+
+  // True if the class can be assigned to the type described by other, including when they are the same class.
+  bool IsSubtypeOf( const SuperTypeDisplay &other ) const JVMX_NOEXCEPT;
+
+  // Every interface the class implements, directly or not, and any superclasses too deep for the display.
+  const std::vector<const JavaClass *> &GetSecondarySuperTypes() const JVMX_NOEXCEPT;
+
+private:
+  SuperTypeDisplay( const SuperTypeDisplay &other ) JVMX_FN_DELETE;
+  SuperTypeDisplay &operator=( const SuperTypeDisplay &other ) JVMX_FN_DELETE;
+
+  void AddSecondarySuperType( const JavaClass *pClass );
+
+private:
+  const JavaClass *m_pClass;
+
+  // Classes are primary types if they are no deeper than the display. Interfaces never are.
+  bool m_IsPrimary;
+  size_t m_Depth;
+  const JavaClass *m_PrimarySuperTypes[ c_PrimaryDepth ];
+
+  std::vector<const JavaClass *> m_SecondarySuperTypes;
+  mutable std::atomic<const JavaClass *> m_pSecondarySuperTypeCache;
+};
+
+#endif // _SUPERTYPEDISPLAY__H_
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <memory>
+
+#include "InvalidStateException.h"
+
+#include "ThinLock.h"
+
+namespace
+{
+  // Lock word layout. Bit 0 set means the rest of the word is a pointer to an ObjectMonitor, which is at least 2 byte
+  // aligned. Otherwise the top 32 bits are the owning thread and bits 1 to 31 are the recursion count. 0 is unlocked.
+  const uint64_t c_Unlocked = 0;
+  const uint64_t c_InflatedBit = 0x1;
+  const uint32_t c_OwnerShift = 32;
+  const uint64_t c_RecursionMask = 0xFFFFFFFEull;
+  const uint32_t c_MaxThinRecursionLevel = 0x7FFFFFFF;
+
+  std::atomic<uint32_t> s_NextThreadId( 1 );
+  thread_local uint32_t t_ThreadId = 0;
+}
+
+ObjectMonitor::Waiter::Waiter( const std::atomic<bool> &isInterrupted )
+  : m_IsInterrupted( isInterrupted )
+  , m_IsNotified( false )
+{
+}
+
+ObjectMonitor::ObjectMonitor( uint32_t owner, uint32_t recursionLevel )
+  : m_Owner( owner )
+  , m_RecursionLevel( recursionLevel )
+{
+}
+
+void ObjectMonitor::Enter( uint32_t thread )
+{
+  std::unique_lock<std::mutex> lock( m_Mutex );
+
+  if ( thread == m_Owner )
+  {
+    ++ m_RecursionLevel;
+    return;
+  }
+
+  m_Released.wait( lock, [this]() { return c_NoOwner == m_Owner; } );
+
+  m_Owner = thread;
+  m_RecursionLevel = 1;
+}
+
+void ObjectMonitor::Exit( uint32_t thread )
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+
+  if ( thread != m_Owner || 0 == m_RecursionLevel )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Exiting a monitor that the thread does not own." );
+  }
+
+  if ( 0 == -- m_RecursionLevel )
+  {
+    m_Owner = c_NoOwner;
+    m_Released.notify_one();
+  }
+}
+
+ObjectMonitor::e_WaitResult ObjectMonitor::Wait( uint32_t thread, std::chrono::nanoseconds timeout, const std::atomic<bool> &isInterrupted )
+{
+  std::unique_lock<std::mutex> lock( m_Mutex );
+
+  if ( thread != m_Owner )
+  {
+    throw InvalidStateException( __FUNCTION__ " - Waiting on a monitor that the thread does not own." );
+  }
+
+  // The thread joins the wait set before it lets go of the monitor, so a notify from the next owner can't be missed.
+  Waiter waiter( isInterrupted );
+  m_WaitSet.push_back( &waiter );
+
+  uint32_t recursionLevel = m_RecursionLevel;
+  m_Owner = c_NoOwner;
+  m_RecursionLevel = 0;
+  m_Released.notify_one();
+
+  auto isWoken = [&waiter]() { return waiter.m_IsNotified || waiter.m_IsInterrupted.load(); };
+  if ( 0 == timeout.count() )
+  {
+    waiter.m_WakeUp.wait( lock, isWoken );
+  }
+  else
+  {
+    waiter.m_WakeUp.wait_for( lock, timeout, isWoken );
+  }
+
+  if ( !waiter.m_IsNotified )
+  {
+    m_WaitSet.erase( std::find( m_WaitSet.begin(), m_WaitSet.end(), &waiter ) );
+  }
+
+  m_Released.wait( lock, [this]() { return c_NoOwner == m_Owner; } );
+
+  m_Owner = thread;
+  m_RecursionLevel = recursionLevel;
+
+  if ( waiter.m_IsNotified )
+  {
+    return e_WaitResult::Notified;
+  }
+
+  return isInterrupted.load() ? e_WaitResult::Interrupted : e_WaitResult::TimedOut;
+}
+
+void ObjectMonitor::NotifyOne()
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+
+  if ( m_WaitSet.empty() )
+  {
+    return;
+  }
+
+  Waiter *pWaiter = m_WaitSet.front();
+  m_WaitSet.pop_front();
+
+  pWaiter->m_IsNotified = true;
+  pWaiter->m_WakeUp.notify_one();
+}
+
+void ObjectMonitor::NotifyAll()
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+
+  for ( Waiter *pWaiter : m_WaitSet )
+  {
+    pWaiter->m_IsNotified = true;
+    pWaiter->m_WakeUp.notify_one();
+  }
+
+  m_WaitSet.clear();
+}
+
+void ObjectMonitor::Interrupt()
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+
+  for ( Waiter *pWaiter : m_WaitSet )
+  {
+    if ( pWaiter->m_IsInterrupted.load() )
+    {
+      pWaiter->m_WakeUp.notify_one();
+    }
+  }
+}
+
+ThinLock::ThinLock() JVMX_NOEXCEPT
+  : m_Word( c_Unlocked )
+{
+}
+
+ThinLock::~ThinLock() JVMX_NOEXCEPT
+{
+  // The object is only destroyed once it is unreachable, so no thread can be holding, entering or waiting on the monitor.
+  uint64_t word = m_Word.load( std::memory_order_acquire );
+  if ( IsInflated( word ) )
+  {
+    delete GetInflatedMonitor( word );
+  }
+}
+
+void ThinLock::Lock()
+{
+  const uint32_t self = GetCurrentThreadId();
+
+  uint64_t word = m_Word.load( std::memory_order_acquire );
+  for ( ;; )
+  {
+    if ( c_Unlocked == word )
+    {
+      if ( m_Word.compare_exchange_weak( word, MakeThinWord( self, 1 ), std::memory_order_acquire, std::memory_order_acquire ) )
+      {
+        return;
+      }
+    }
+    else if ( IsInflated( word ) )
+    {
+      GetInflatedMonitor( word )->Enter( self );
+      return;
+    }
+    else if ( self == GetOwner( word ) )
+    {
+      // Only the owner changes the count, but the CAS is still needed, as another thread may inflate the lock under us.
+      JVMX_ASSERT( GetRecursionLevel( word ) < c_MaxThinRecursionLevel );
+      if ( m_Word.compare_exchange_weak( word, MakeThinWord( self, GetRecursionLevel( word ) + 1 ), std::memory_order_acquire, std::memory_order_acquire ) )
+      {
+        return;
+      }
+    }
+    else
+    {
+      // Contended. Hand the owner's thin lock over to a full monitor, so that this thread can block on it.
+      Inflate( word );
+    }
+  }
+}
+
+void ThinLock::Unlock()
+{
+  const uint32_t self = GetCurrentThreadId();
+
+  uint64_t word = m_Word.load( std::memory_order_acquire );
+  for ( ;; )
+  {
+    if ( IsInflated( word ) )
+    {
+      GetInflatedMonitor( word )->Exit( self );
+      return;
+    }
+
+    JVMX_ASSERT( c_Unlocked != word && self == GetOwner( word ) );
+
+    uint32_t recursionLevel = GetRecursionLevel( word );
+    uint64_t newWord = 1 == recursionLevel ? c_Unlocked : MakeThinWord( self, recursionLevel - 1 );
+    if ( m_Word.compare_exchange_weak( word, newWord, std::memory_order_acq_rel, std::memory_order_acquire ) )
+    {
+      return;
+    }
+  }
+}
+
+ObjectMonitor &ThinLock::GetMonitor()
+{
+  uint64_t word = m_Word.load( std::memory_order_acquire );
+  while ( !IsInflated( word ) )
+  {
+    Inflate( word );
+  }
+
+  return *GetInflatedMonitor( word );
+}
+
+ObjectMonitor *ThinLock::GetMonitorToNotify()
+{
+  uint64_t word = m_Word.load( std::memory_order_acquire );
+  if ( !IsInflated( word ) && c_Unlocked != word && GetCurrentThreadId() == GetOwner( word ) )
+  {
+    // Waiting inflates the lock, and only the owner can wait, so nobody can be waiting on it. Another thread may inflate
+    // it in the meantime, but the new monitor's wait set starts out empty.
+    return nullptr;
+  }
+
+  return &GetMonitor();
+}
+
+uint32_t ThinLock::GetCurrentThreadId() JVMX_NOEXCEPT
+{
+  if ( 0 == t_ThreadId )
+  {
+    t_ThreadId = s_NextThreadId.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  return t_ThreadId;
+}
+
+void ThinLock::Inflate( uint64_t &word )
+{
+  std::unique_ptr<ObjectMonitor> pMonitor;
+  if ( c_Unlocked == word )
+  {
+    pMonitor.reset( new ObjectMonitor( ObjectMonitor::c_NoOwner, 0 ) );
+  }
+  else
+  {
+    pMonitor.reset( new ObjectMonitor( GetOwner( word ), GetRecursionLevel( word ) ) );
+  }
+
+  uint64_t inflatedWord = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( pMonitor.get() ) ) | c_InflatedBit;
+
+  // acq_rel so that the monitor's initial state is visible to whoever loads the new word.
+  if ( m_Word.compare_exchange_strong( word, inflatedWord, std::memory_order_acq_rel, std::memory_order_acquire ) )
+  {
+    word = inflatedWord;
+
+    // The lock owns the monitor from now on.
+    pMonitor.release();
+  }
+}
+
+bool ThinLock::IsInflated( uint64_t word ) JVMX_NOEXCEPT
+{
+  return 0 != ( word & c_InflatedBit );
+}
+
+ObjectMonitor *ThinLock::GetInflatedMonitor( uint64_t word ) JVMX_NOEXCEPT
+{
+  return reinterpret_cast<ObjectMonitor *>( static_cast<uintptr_t>( word & ~c_InflatedBit ) );
+}
+
+uint64_t ThinLock::MakeThinWord( uint32_t owner, uint32_t recursionLevel ) JVMX_NOEXCEPT
+{
+  return ( static_cast<uint64_t>( owner ) << c_OwnerShift ) | ( static_cast<uint64_t>( recursionLevel ) << 1 );
+}
+
+uint32_t ThinLock::GetOwner( uint64_t word ) JVMX_NOEXCEPT
+{
+  return static_cast<uint32_t>( word >> c_OwnerShift );
+}
+
+uint32_t ThinLock::GetRecursionLevel( uint64_t word ) JVMX_NOEXCEPT
+{
+  return static_cast<uint32_t>( ( word & c_RecursionMask ) >> 1 );
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef _THINLOCK__H_
+#define _THINLOCK__H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "GlobalConstants.h"
+
+// The full monitor behind an inflated ThinLock. It keeps its own owner and recursion count, rather than using a
+// recursive mutex, so that a thread that doesn't own the lock can inflate it on behalf of the thread that does.
+class ObjectMonitor
+{
+public:
+  static const uint32_t c_NoOwner = 0;
+
+  enum class e_WaitResult
+  {
+    Notified,
+    TimedOut,
+    Interrupted
+  };
+
+  ObjectMonitor( uint32_t owner, uint32_t recursionLevel );
+
+  void Enter( uint32_t thread );
+  void Exit( uint32_t thread );
+
+  // Releases the monitor, however many times it has been entered, and joins the back of the wait set until it is
+  // notified, isInterrupted is set, or the timeout expires. A zero timeout never expires. The monitor is always held
+  // again, at the same recursion level, on return. A thread that was both notified and interrupted reports the
+  // notification, so that it isn't lost, and the interrupt stays pending.
+  e_WaitResult Wait( uint32_t thread, std::chrono::nanoseconds timeout, const std::atomic<bool> &isInterrupted );
+
+  // Wakes the longest waiting thread, or every waiting thread. Each one then competes to enter the monitor again.
+  void NotifyOne();
+  void NotifyAll();
+
+  // Wakes any waiting thread whose interrupted flag has been set. The flag must be set before this is called.
+  void Interrupt();
+
+private:
+  ObjectMonitor( const ObjectMonitor & ) JVMX_FN_DELETE;
+  ObjectMonitor &operator=( const ObjectMonitor & ) JVMX_FN_DELETE;
+
+private:
+  // A thread in the wait set. It lives on the waiting thread's stack, and is woken on its own condition variable, so
+  // that a notify wakes exactly the thread it picked. Notifying a waiter takes it out of the set.
+  struct Waiter
+  {
+    explicit Waiter( const std::atomic<bool> &isInterrupted );
+
+    std::condition_variable m_WakeUp;
+    const std::atomic<bool> &m_IsInterrupted;
+    bool m_IsNotified;
+  };
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Released;
+
+  uint32_t m_Owner;
+  uint32_t m_RecursionLevel;
+
+  // In the order the threads started waiting.
+  std::deque<Waiter *> m_WaitSet;
+};
+
+// A Java monitor held in one word of the object header, so that objects which are never locked don't pay for a mutex.
+// Uncontended enter and exit are a compare and swap on the word, which holds the owning thread and the recursion count.
+// The first time the lock is contended, or is waited or notified on, the word is replaced by a pointer to an
+// ObjectMonitor, and it stays inflated until the object is destroyed, which frees the monitor. The word moves with the
+// object when it is relocated, and the copy left behind is never destroyed, so the monitor is only freed once.
+class ThinLock
+{
+public:
+  ThinLock() JVMX_NOEXCEPT;
+  ~ThinLock() JVMX_NOEXCEPT;
+
+  void Lock();
+  void Unlock();
+
+  // Inflates the lock if it isn't already, and returns the full monitor, for wait and notify.
+  ObjectMonitor &GetMonitor();
+
+  // As GetMonitor, but returns null without inflating if the calling thread holds the lock thin, as no thread can be
+  // waiting on it then.
+  ObjectMonitor *GetMonitorToNotify();
+
+  // A small non-zero number identifying the calling thread, for the lock word.
+  static uint32_t GetCurrentThreadId() JVMX_NOEXCEPT;
+
+private:
+  ThinLock( const ThinLock & ) JVMX_FN_DELETE;
+  ThinLock &operator=( const ThinLock & ) JVMX_FN_DELETE;
+
+  // Replaces word, which must be unlocked or thin, with a monitor that has the same owner and recursion count. If the
+  // word has changed in the meantime nothing is replaced. Either way word is left holding the current value.
+  void Inflate( uint64_t &word );
+
+  static bool IsInflated( uint64_t word ) JVMX_NOEXCEPT;
+  static ObjectMonitor *GetInflatedMonitor( uint64_t word ) JVMX_NOEXCEPT;
+  static uint64_t MakeThinWord( uint32_t owner, uint32_t recursionLevel ) JVMX_NOEXCEPT;
+  static uint32_t GetOwner( uint64_t word ) JVMX_NOEXCEPT;
+  static uint32_t GetRecursionLevel( uint64_t word ) JVMX_NOEXCEPT;
+
+private:
+  std::atomic<uint64_t> m_Word;
+};
+
+#endif // _THINLOCK__H_
@@ -5,6 +5,7 @@
 #include "IVirtualMachineState.h"
 
 #include "ObjectReference.h"
+#include "Safepoint.h"
 
 #include "ThreadManager.h"
 #include "GlobalCatalog.h"
@@ -66,6 +67,15 @@ void ThreadManager::DetachDaemons()
 
     for ( auto element : m_JavaThreads )
     {
+      // Threads the VM starts for itself, such as the finalizer thread, have no java.lang.Thread, and are daemons.
+      if ( nullptr == element.second.m_pThreadObject && nullptr != element.second.m_pThread )
+      {
+        element.second.m_pThread->detach();
+        m_JavaThreads.erase( element.first );
+        moreElementsToCheck = true;
+        break; // Break out of for loop
+      }
+
       boost::intrusive_ptr<JavaBool> pIsDeamon = boost::dynamic_pointer_cast<JavaBool>( element.second.m_pThreadObject->GetContainedObject()->GetFieldByName( JavaString::FromCString( u"daemon" ) ) );
       if ( nullptr != pIsDeamon && pIsDeamon->ToBool() )
       {
@@ -133,51 +143,31 @@ bool ThreadManager::JoinEachThread()
 
 bool ThreadManager::WaitForThreadsToPause()
 {
-  bool allPaused = false;
-  std::chrono::system_clock::time_point startTime = std::chrono::system_clock::now();
-
-  while ( !allPaused )
-  {
-    allPaused = true;
-    for ( auto element : m_JavaThreads )
-    {
-      if ( element.first != boost::this_thread::get_id() && !element.second.m_pVMState->IsPaused() )
-      {
-        if ( !element.second.m_pVMState->IsExecutingNative() )
-        {
-          allPaused = false;
-        }
-      }
-    }
-
-    std::chrono::system_clock::time_point endTime = std::chrono::system_clock::now();
-    auto int_ms = std::chrono::duration_cast<std::chrono::milliseconds>( endTime - startTime );
-
-    if ( !allPaused && int_ms.count() > c_MillisecondsToWaitForAllThreadsdToPause )
-    {
-      return false;
-    }
-  }
-
-  return true;
+  return Safepoint::WaitForStop( std::chrono::milliseconds( c_MillisecondsToWaitForAllThreadsdToPause ) );
 }
 
 void ThreadManager::PauseAllThreads()
 {
+  Safepoint::BeginStop();
+
   for ( auto element : m_JavaThreads )
   {
     if ( element.first != boost::this_thread::get_id() && !element.second.m_pVMState->IsPaused() )
     {
-      element.second.m_pVMState->Pause();
+      Safepoint::StopThread( *element.second.m_pVMState );
     }
   }
+
+  Safepoint::RequestPause();
 }
 
 void ThreadManager::ResumeAllThreads()
 {
+  Safepoint::ReleasePause();
+
   for ( auto element : m_JavaThreads )
   {
-    element.second.m_pVMState->Resume();
+    Safepoint::Resume( *element.second.m_pVMState );
   }
 }
 
@@ -210,4 +200,32 @@ std::shared_ptr<IVirtualMachineState> ThreadManager::GetCurrentThreadState()
   return GetCurrentThreadInfo().m_pVMState;
 }
 
+std::shared_ptr<IVirtualMachineState> ThreadManager::FindCurrentThreadState()
+{
+  std::lock_guard<std::recursive_mutex> lock( m_Mutex );
+
+  auto it = m_JavaThreads.find( boost::this_thread::get_id() );
+  if ( m_JavaThreads.end() == it )
+  {
+    return nullptr;
+  }
+
+  return it->second.m_pVMState;
+}
+
+std::shared_ptr<IVirtualMachineState> ThreadManager::GetThreadState( const ObjectReference &threadObject )
+{
+  std::lock_guard<std::recursive_mutex> lock( m_Mutex );
+
+  for ( const auto &element : m_JavaThreads )
+  {
+    if ( nullptr != element.second.m_pThreadObject && *element.second.m_pThreadObject == threadObject )
+    {
+      return element.second.m_pVMState;
+    }
+  }
+
+  return nullptr;
+}
+
 
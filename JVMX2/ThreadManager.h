@@ -36,6 +36,8 @@ public:
   virtual std::vector<boost::intrusive_ptr<IJavaVariableType>> GetRoots() JVMX_OVERRIDE;
 
   virtual std::shared_ptr<IVirtualMachineState> GetCurrentThreadState() JVMX_OVERRIDE;
+  virtual std::shared_ptr<IVirtualMachineState> FindCurrentThreadState() JVMX_OVERRIDE;
+  virtual std::shared_ptr<IVirtualMachineState> GetThreadState( const ObjectReference &threadObject ) JVMX_OVERRIDE;
 
 private:
   bool JoinEachThread();
@@ -0,0 +1,488 @@
+#include "IVirtualMachineState.h"
+#include "ILogger.h"
+
+#include "ClassAttributeCode.h"
+#include "MethodInfo.h"
+
+#include "JavaTypes.h"
+#include "JavaOpCodes.h"
+
+#include "ThreadedExecutionEngine.h"
+
+namespace
+{
+  // Small per-thread, direct mapped cache from code segment start to its pre-decoded instructions. Only code segments
+  // that belong to a MethodInfo are ever cached positively, and those are never freed, so a matching address is
+  // always the same code. A negative entry only ever costs performance.
+  struct PreDecodedMethodCacheEntry
+  {
+    const uint8_t *m_pCodeSegmentStart;
+    std::shared_ptr<PreDecodedMethod> m_pPreDecodedMethod;
+  };
+
+  const size_t c_PreDecodedMethodCacheSize = 64;
+
+  thread_local PreDecodedMethodCacheEntry t_PreDecodedMethodCache[ c_PreDecodedMethodCacheSize ];
+
+  size_t GetPreDecodedMethodCacheSlot( const uint8_t *pCodeSegmentStart )
+  {
+    return ( reinterpret_cast<uintptr_t>( pCodeSegmentStart ) >> 4 ) % c_PreDecodedMethodCacheSize;
+  }
+}
+
+ThreadedExecutionEngine::ThreadedExecutionEngine()
+{}
+
+ThreadedExecutionEngine::~ThreadedExecutionEngine()
+{}
+
+e_ImmediateReturnRequired ThreadedExecutionEngine::DispatchNextInstruction( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const PreDecodedMethod *pMethod = GetPreDecodedMethod( pVirtualMachineState );
+  if ( nullptr == pMethod )
+  {
+    return ProcessNextOpcode( pVirtualMachineState, GetLogger() );
+  }
+
+  const uintptr_t startingProgramCounter = pVirtualMachineState->GetProgramCounter();
+  const DecodedInstruction *pInstruction = pMethod->GetInstructionAt( startingProgramCounter );
+  if ( nullptr == pInstruction || nullptr == pInstruction->m_pHandler )
+  {
+    return ProcessNextOpcode( pVirtualMachineState, GetLogger() );
+  }
+
+  // Run decoded instructions until one needs the full engine, or a backward branch is taken. Backward branches are
+  // safepoints, so they hand control back here to poll once the program counter is up to date.
+  const DecodedInstruction *pNext = nullptr;
+  bool isBackwardBranch = false;
+  do
+  {
+    pNext = pInstruction->m_pHandler( *this, pVirtualMachineState, pInstruction );
+
+    if ( pNext <= pInstruction )
+    {
+      pInstruction = pNext;
+      isBackwardBranch = true;
+      break;
+    }
+
+    pInstruction = pNext;
+  }
+  while ( nullptr != pInstruction->m_pHandler );
+
+  pVirtualMachineState->AdvanceProgramCounter( static_cast<int>( static_cast<intptr_t>( pInstruction->m_ProgramCounter ) - static_cast<intptr_t>( startingProgramCounter ) ) );
+
+  if ( isBackwardBranch )
+  {
+    PollSafepoint( pVirtualMachineState );
+  }
+
+  if ( nullptr != pInstruction->m_pHandler || pMethod->IsEndOfCode( pInstruction ) )
+  {
+    return e_ImmediateReturnRequired::No;
+  }
+
+  return ProcessNextOpcode( pVirtualMachineState, GetLogger() );
+}
+
+const PreDecodedMethod *ThreadedExecutionEngine::GetPreDecodedMethod( const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState )
+{
+  const uint8_t *pCodeSegmentStart = pVirtualMachineState->GetCodeSegmentStart();
+
+  PreDecodedMethodCacheEntry &entry = t_PreDecodedMethodCache[ GetPreDecodedMethodCacheSlot( pCodeSegmentStart ) ];
+  if ( entry.m_pCodeSegmentStart == pCodeSegmentStart )
+  {
+    return entry.m_pPreDecodedMethod.get();
+  }
+
+  std::shared_ptr<PreDecodedMethod> pResult = nullptr;
+
+  std::shared_ptr<MethodInfo> pMethodInfo = pVirtualMachineState->GetCurrentMethodInfo();
+  if ( nullptr != pMethodInfo && nullptr != pMethodInfo->GetCodeInfo() && pMethodInfo->GetCodeInfo()->GetCode().ToByteArray() == pCodeSegmentStart )
+  {
+    pResult = pMethodInfo->GetPreDecodedCode();
+    if ( nullptr == pResult )
+    {
+      // Two threads may decode the same method at the same time. Both results are identical, so the last one wins.
+      pResult = std::make_shared<PreDecodedMethod>( pMethodInfo->GetCodeInfo()->GetCode(), GetHandlerTable() );
+      pMethodInfo->SetPreDecodedCode( pResult );
+    }
+
+    if ( !pResult->IsValid() )
+    {
+      pResult = nullptr;
+    }
+  }
+
+  entry.m_pCodeSegmentStart = pCodeSegmentStart;
+  entry.m_pPreDecodedMethod = pResult;
+
+  return pResult.get();
+}
+
+const DecodedInstructionHandler *ThreadedExecutionEngine::GetHandlerTable()
+{
+  static DecodedInstructionHandler s_HandlerTable[ PreDecodedMethod::c_HandlerTableSize ] = {};
+  static const DecodedInstructionHandler *s_pHandlerTable = [] ()
+  {
+    auto set = [] ( e_JavaOpCodes opCode, DecodedInstructionHandler pHandler )
+    {
+      s_HandlerTable[ static_cast<uint8_t>( opCode ) ] = pHandler;
+    };
+
+    set( e_JavaOpCodes::NoOperation, &HandleNoOperation );
+    set( e_JavaOpCodes::PushNull, &HandlePushNull );
+    set( e_JavaOpCodes::PushInt_Minus1, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_0, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_1, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_2, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_3, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_4, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_5, &HandlePushInt );
+    set( e_JavaOpCodes::PushInt_ImmediateByte, &HandlePushInt );
+    set( e_JavaOpCodes::PushShortConstant, &HandlePushInt );
+
+    set( e_JavaOpCodes::LoadIntegerFromLocal, &HandleLoadIntegerFromLocal );
+    set( e_JavaOpCodes::LoadIntegerFromLocal_0, &HandleLoadIntegerFromLocal );
+    set( e_JavaOpCodes::LoadIntegerFromLocal_1, &HandleLoadIntegerFromLocal );
+    set( e_JavaOpCodes::LoadIntegerFromLocal_2, &HandleLoadIntegerFromLocal );
+    set( e_JavaOpCodes::LoadIntegerFromLocal_3, &HandleLoadIntegerFromLocal );
+    set( e_JavaOpCodes::LoadLongFromLocal, &HandleLoadLongFromLocal );
+    set( e_JavaOpCodes::LoadLongFromLocal_0, &HandleLoadLongFromLocal );
+    set( e_JavaOpCodes::LoadLongFromLocal_1, &HandleLoadLongFromLocal );
+    set( e_JavaOpCodes::LoadLongFromLocal_2, &HandleLoadLongFromLocal );
+    set( e_JavaOpCodes::LoadLongFromLocal_3, &HandleLoadLongFromLocal );
+    set( e_JavaOpCodes::LoadFloatFromLocal, &HandleLoadFloatFromLocal );
+    set( e_JavaOpCodes::LoadFloatFromLocal_0, &HandleLoadFloatFromLocal );
+    set( e_JavaOpCodes::LoadFloatFromLocal_1, &HandleLoadFloatFromLocal );
+    set( e_JavaOpCodes::LoadFloatFromLocal_2, &HandleLoadFloatFromLocal );
+    set( e_JavaOpCodes::LoadFloatFromLocal_3, &HandleLoadFloatFromLocal );
+    set( e_JavaOpCodes::LoadDoubleFromLocal, &HandleLoadDoubleFromLocal );
+    set( e_JavaOpCodes::LoadDoubleFromLocal_0, &HandleLoadDoubleFromLocal );
+    set( e_JavaOpCodes::LoadDoubleFromLocal_1, &HandleLoadDoubleFromLocal );
+    set( e_JavaOpCodes::LoadDoubleFromLocal_2, &HandleLoadDoubleFromLocal );
+    set( e_JavaOpCodes::LoadDoubleFromLocal_3, &HandleLoadDoubleFromLocal );
+    set( e_JavaOpCodes::LoadReferenceFromLocal, &HandleLoadReferenceFromLocal );
+    set( e_JavaOpCodes::LoadReferenceFromLocal_0, &HandleLoadReferenceFromLocal );
+    set( e_JavaOpCodes::LoadReferenceFromLocal_1, &HandleLoadReferenceFromLocal );
+    set( e_JavaOpCodes::LoadReferenceFromLocal_2, &HandleLoadReferenceFromLocal );
+    set( e_JavaOpCodes::LoadReferenceFromLocal_3, &HandleLoadReferenceFromLocal );
+
+    set( e_JavaOpCodes::StoreIntegerInLocal, &HandleStoreIntegerInLocal );
+    set( e_JavaOpCodes::StoreIntegerInLocal_0, &HandleStoreIntegerInLocal );
+    set( e_JavaOpCodes::StoreIntegerInLocal_1, &HandleStoreIntegerInLocal );
+    set( e_JavaOpCodes::StoreIntegerInLocal_2, &HandleStoreIntegerInLocal );
+    set( e_JavaOpCodes::StoreIntegerInLocal_3, &HandleStoreIntegerInLocal );
+    set( e_JavaOpCodes::StoreLongInLocal, &HandleStoreLongInLocal );
+    set( e_JavaOpCodes::StoreLongInLocal_0, &HandleStoreLongInLocal );
+    set( e_JavaOpCodes::StoreLongInLocal_1, &HandleStoreLongInLocal );
+    set( e_JavaOpCodes::StoreLongInLocal_2, &HandleStoreLongInLocal );
+    set( e_JavaOpCodes::StoreLongInLocal_3, &HandleStoreLongInLocal );
+    set( e_JavaOpCodes::StoreFloatInLocal, &HandleStoreFloatInLocal );
+    set( e_JavaOpCodes::StoreFloatInLocal_0, &HandleStoreFloatInLocal );
+    set( e_JavaOpCodes::StoreFloatInLocal_1, &HandleStoreFloatInLocal );
+    set( e_JavaOpCodes::StoreFloatInLocal_2, &HandleStoreFloatInLocal );
+    set( e_JavaOpCodes::StoreFloatInLocal_3, &HandleStoreFloatInLocal );
+    set( e_JavaOpCodes::StoreDoubleInLocal, &HandleStoreDoubleInLocal );
+    set( e_JavaOpCodes::StoreDoubleInLocal_0, &HandleStoreDoubleInLocal );
+    set( e_JavaOpCodes::StoreDoubleInLocal_1, &HandleStoreDoubleInLocal );
+    set( e_JavaOpCodes::StoreDoubleInLocal_2, &HandleStoreDoubleInLocal );
+    set( e_JavaOpCodes::StoreDoubleInLocal_3, &HandleStoreDoubleInLocal );
+    set( e_JavaOpCodes::StoreReferenceInLocal, &HandleStoreReferenceInLocal );
+    set( e_JavaOpCodes::StoreReferenceInLocal_0, &HandleStoreReferenceInLocal );
+    set( e_JavaOpCodes::StoreReferenceInLocal_1, &HandleStoreReferenceInLocal );
+    set( e_JavaOpCodes::StoreReferenceInLocal_2, &HandleStoreReferenceInLocal );
+    set( e_JavaOpCodes::StoreReferenceInLocal_3, &HandleStoreReferenceInLocal );
+
+    set( e_JavaOpCodes::IncrementLocalVariable, &HandleIncrementLocalVariable );
+
+    set( e_JavaOpCodes::PopOperandStack, &HandlePopOperandStack );
+    set( e_JavaOpCodes::DuplicateTopOperand, &HandleDuplicateTopOperand );
+
+    set( e_JavaOpCodes::IntegerAdd, &HandleIntegerAdd );
+    set( e_JavaOpCodes::IntegerSubtract, &HandleIntegerSubtract );
+    set( e_JavaOpCodes::IntegerMultiply, &HandleIntegerMultiply );
+    set( e_JavaOpCodes::IntegerAND, &HandleIntegerAND );
+    set( e_JavaOpCodes::IntegerOR, &HandleIntegerOR );
+    set( e_JavaOpCodes::IntegerXOR, &HandleIntegerXOR );
+    set( e_JavaOpCodes::NegateInteger, &HandleNegateInteger );
+    set( e_JavaOpCodes::ShiftIntegerLeft, &HandleShiftIntegerLeft );
+    set( e_JavaOpCodes::ShiftIntegerRightArithmetic, &HandleShiftIntegerRightArithmetic );
+    set( e_JavaOpCodes::ShiftIntegerRightLogical, &HandleShiftIntegerRightLogical );
+    set( e_JavaOpCodes::LongComparison, &HandleLongComparison );
+
+    set( e_JavaOpCodes::BranchIfEquals, &HandleBranchIfEquals );
+    set( e_JavaOpCodes::BranchIfNotEquals, &HandleBranchIfNotEquals );
+    set( e_JavaOpCodes::BranchIfLessThan, &HandleBranchIfLessThan );
+    set( e_JavaOpCodes::BranchIfGreaterThanEquals, &HandleBranchIfGreaterThanOrEqual );
+    set( e_JavaOpCodes::BranchIfGreaterThan, &HandleBranchIfGreaterThan );
+    set( e_JavaOpCodes::BranchIfLessThanEquals, &HandleBranchIfLessThanOrEqual );
+    set( e_JavaOpCodes::BranchIfIntegerEquals, &HandleBranchIfIntegerEquals );
+    set( e_JavaOpCodes::BranchIfIntegerNotEquals, &HandleBranchIfIntegerNotEquals );
+    set( e_JavaOpCodes::BranchIfIntegerLessThan, &HandleBranchIfIntegerLessThan );
+    set( e_JavaOpCodes::BranchIfIntegerGreaterThanEquals, &HandleBranchIfIntegerGreaterThanOrEqual );
+    set( e_JavaOpCodes::BranchIfIntegerGreaterThan, &HandleBranchIfIntegerGreaterThan );
+    set( e_JavaOpCodes::BranchIfIntegerLessThanEquals, &HandleBranchIfIntegerLessThanOrEqual );
+    set( e_JavaOpCodes::BranchIfNull, &HandleBranchIfNull );
+    set( e_JavaOpCodes::BranchIfNotNull, &HandleBranchIfNotNull );
+    set( e_JavaOpCodes::Goto, &HandleGoto );
+
+    return s_HandlerTable;
+  }();
+
+  return s_pHandlerTable;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleNoOperation( ThreadedExecutionEngine & /* engine */, const std::shared_ptr<IVirtualMachineState> & /* pVirtualMachineState */, const DecodedInstruction *pInstruction )
+{
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandlePushNull( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodePushNull( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandlePushInt( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodePushInt( pVirtualMachineState, pInstruction->m_Operand1 );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleLoadIntegerFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeLoadIntegerFromLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleLoadLongFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeLoadLongFromLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleLoadFloatFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpLoadFloatFromLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleLoadDoubleFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeLoadDoubleFromLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleLoadReferenceFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeLoadReferenceFromLocalIndex( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleStoreIntegerInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeStoreIntegerInLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleStoreLongInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeStoreLongInLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleStoreFloatInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeStoreFloatInLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleStoreDoubleInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeStoreDoubleInLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleStoreReferenceInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeStoreReferenceInLocal( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIncrementLocalVariable( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.IncrementLocalVariable( pVirtualMachineState, static_cast<uint16_t>( pInstruction->m_Operand1 ), static_cast<int16_t>( pInstruction->m_Operand2 ) );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandlePopOperandStack( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodePopOperandStack( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleDuplicateTopOperand( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeDuplicateTopOperand( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIntegerAdd( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeIntegerAdd( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIntegerSubtract( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeIntegerSubtract( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIntegerMultiply( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeIntegerMultiply( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIntegerAND( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeANDInteger( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIntegerOR( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeORInteger( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleIntegerXOR( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeXORInteger( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleNegateInteger( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeNegateInteger( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleShiftIntegerLeft( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeShiftIntegerLeft( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleShiftIntegerRightArithmetic( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeShiftIntegerRightArithmetic( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleShiftIntegerRightLogical( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeShiftIntegerRightLogical( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleLongComparison( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  engine.ExecuteOpCodeLongComparison( pVirtualMachineState );
+  return pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return ( engine.GetIntegerFromOperandStack( pVirtualMachineState ) == 0 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfNotEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return ( engine.GetIntegerFromOperandStack( pVirtualMachineState ) != 0 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfLessThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return ( engine.GetIntegerFromOperandStack( pVirtualMachineState ) < 0 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfGreaterThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return ( engine.GetIntegerFromOperandStack( pVirtualMachineState ) >= 0 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfGreaterThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return ( engine.GetIntegerFromOperandStack( pVirtualMachineState ) > 0 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfLessThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return ( engine.GetIntegerFromOperandStack( pVirtualMachineState ) <= 0 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfIntegerEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  int32_t value2 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+  int32_t value1 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+
+  return ( value1 == value2 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfIntegerNotEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  int32_t value2 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+  int32_t value1 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+
+  return ( value1 != value2 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfIntegerLessThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  int32_t value2 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+  int32_t value1 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+
+  return ( value1 < value2 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfIntegerGreaterThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  int32_t value2 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+  int32_t value1 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+
+  return ( value1 >= value2 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfIntegerGreaterThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  int32_t value2 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+  int32_t value1 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+
+  return ( value1 > value2 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfIntegerLessThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  int32_t value2 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+  int32_t value1 = engine.GetIntegerFromOperandStack( pVirtualMachineState );
+
+  return ( value1 <= value2 ) ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfNull( ThreadedExecutionEngine & /* engine */, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return pVirtualMachineState->PopOperand()->IsNull() ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleBranchIfNotNull( ThreadedExecutionEngine & /* engine */, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction )
+{
+  return !pVirtualMachineState->PopOperand()->IsNull() ? pInstruction->m_pBranchTarget : pInstruction + 1;
+}
+
+const DecodedInstruction *ThreadedExecutionEngine::HandleGoto( ThreadedExecutionEngine & /* engine */, const std::shared_ptr<IVirtualMachineState> & /* pVirtualMachineState */, const DecodedInstruction *pInstruction )
+{
+  return pInstruction->m_pBranchTarget;
+}
@@ -0,0 +1,84 @@
+#ifndef _THREADEDEXECUTIONENGINE__H_
+#define _THREADEDEXECUTIONENGINE__H_
+
+#include "PreDecodedMethod.h"
+#include "BasicExecutionEngine.h"
+
+// Execution engine that decodes each method once into a compact instruction stream, and then dispatches through the
+// handler pointer stored in each decoded instruction. The program counter is kept in a local while a run of decoded
+// instructions executes, and is written back to the virtual machine state only when the run ends.
+// Instructions without a decoded handler fall back to BasicExecutionEngine::ProcessNextOpcode, one at a time, and the
+// decoded run resumes after them. Handlers cover constants, local loads and stores (including their wide forms), iinc,
+// int arithmetic, lcmp and the 16 bit branches; invocations, field and array access and object creation are left to
+// the switch. The operand stack and local variables are still reached through IVirtualMachineState, as the garbage
+// collector and the rest of the VM read them there, so only the program counter lives in a register.
+class ThreadedExecutionEngine : public BasicExecutionEngine
+{
+public:
+  ThreadedExecutionEngine();
+
+  virtual ~ThreadedExecutionEngine();
+
+protected:
+  virtual e_ImmediateReturnRequired DispatchNextInstruction( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState ) JVMX_OVERRIDE;
+
+private:
+  const PreDecodedMethod *GetPreDecodedMethod( const std::shared_ptr<IVirtualMachineState> & pVirtualMachineState );
+
+  static const DecodedInstructionHandler *GetHandlerTable();
+
+  // Handlers
+private:
+  static const DecodedInstruction *HandleNoOperation( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandlePushNull( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandlePushInt( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleLoadIntegerFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleLoadLongFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleLoadFloatFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleLoadDoubleFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleLoadReferenceFromLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleStoreIntegerInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleStoreLongInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleStoreFloatInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleStoreDoubleInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleStoreReferenceInLocal( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleIncrementLocalVariable( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandlePopOperandStack( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleDuplicateTopOperand( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleIntegerAdd( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleIntegerSubtract( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleIntegerMultiply( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleIntegerAND( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleIntegerOR( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleIntegerXOR( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleNegateInteger( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleShiftIntegerLeft( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleShiftIntegerRightArithmetic( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleShiftIntegerRightLogical( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleLongComparison( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleBranchIfEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfNotEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfLessThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfGreaterThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfGreaterThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfLessThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleBranchIfIntegerEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfIntegerNotEquals( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfIntegerLessThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfIntegerGreaterThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfIntegerGreaterThan( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfIntegerLessThanOrEqual( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+
+  static const DecodedInstruction *HandleBranchIfNull( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleBranchIfNotNull( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+  static const DecodedInstruction *HandleGoto( ThreadedExecutionEngine &engine, const std::shared_ptr<IVirtualMachineState> &pVirtualMachineState, const DecodedInstruction *pInstruction );
+};
+
+#endif // _THREADEDEXECUTIONENGINE__H_
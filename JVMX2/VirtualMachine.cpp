@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <thread>
 #include <cmath>
 #include <memory>
@@ -45,10 +46,12 @@
 
 #include "BasicClassLibrary.h"
 #include "BasicExecutionEngine.h"
+#include "ThreadedExecutionEngine.h"
 #include "BasicVirtualMachineState.h"
 #include "DefaultJavaLangClassList.h"
 #include "NativeLibraryContainer.h"
 #include "ObjectRegistryLocalMachine.h"
+#include "ObjectRegistryHandleTable.h"
 #include "FileSearchPathCollection.h"
 #ifdef REDIS_SUPPORT
 #include "ObjectRegistryRedis.h"
@@ -63,9 +66,11 @@ WALLAROO_REGISTER( AgregateLogger );
 //WALLAROO_REGISTER( MallocFreeMemoryManager );
 //WALLAROO_REGISTER( SimpleGreedyMemoryManager );
 WALLAROO_REGISTER( ObjectRegistryLocalMachine );
+WALLAROO_REGISTER( ObjectRegistryHandleTable );
 
 WALLAROO_REGISTER( CheneyGarbageCollector, std::shared_ptr<ThreadManager>, size_t );
 WALLAROO_REGISTER( BasicExecutionEngine );
+WALLAROO_REGISTER( ThreadedExecutionEngine );
 WALLAROO_REGISTER( JavaNativeInterface );
 WALLAROO_REGISTER( DefaultJavaLangClassList );
 WALLAROO_REGISTER( ThreadManager );
@@ -88,8 +93,15 @@ const JVMX_CHAR_TYPE c_PathSeparator = JVMX_T( '\\' );
 const JVMX_CHAR_TYPE c_PathSeparator = JVMX_T('/');
 #endif
 
+// The copying heap starts small, and grows towards the maximum as the live data needs it.
+static const size_t c_DefaultInitialGarbageCollectionPoolSize = ( 1024 * 1024 ) * 16;
 static const size_t c_DefaultGarbageCollectionPoolSize = ( 1024 * 1024 ) * 100;
 
+// Both semi-spaces of the nursery together. Most objects should die before they leave it.
+static const size_t c_DefaultNurseryPoolSize = ( 1024 * 1024 ) * 32;
+static const size_t c_DefaultOldGenerationSize = ( 1024 * 1024 ) * 256;
+static const uint8_t c_DefaultPromotionAge = 2;
+
 extern const JavaString c_ClassInitialisationMethodType;
 extern const JavaString c_ClassInitialisationMethodName;
 extern const JavaString c_InstanceInitialisationMethodName;
@@ -524,8 +536,7 @@ std::unique_ptr<jvalue[]> VirtualMachine::ConvertJArrayToArrayOfObjects( jarray
 
   for ( size_t index = 0; index < pArray->GetNumberOfElements(); ++index )
   {
-    IJavaVariableType *pElementValue = pArray->At( index );
-    boost::intrusive_ptr<ObjectReference> ref = new ObjectReference( *dynamic_cast<const ObjectReference *>( pElementValue ) );
+    boost::intrusive_ptr<ObjectReference> ref = new ObjectReference( pArray->GetElementAt<ObjectIndexT>( index ) );
 
     pResult[ index ] = ConvertJavaVariableToJValue( ref, methodType.parameters[index] );
   }
@@ -818,6 +829,11 @@ void VirtualMachine::Stop( const std::shared_ptr<IVirtualMachineState> &pInitial
     pInitialState->StartShutdown( 0 );
     m_pThreadManager->JoinAll();
 
+    if ( m_Options.m_LogEngineStatistics )
+    {
+      m_pEngine->LogStatistics( m_pLogger );
+    }
+
     m_pLogger->LogInformation( "JVMX Shut down." );
   }
   catch ( JVMXException &ex )
@@ -843,10 +859,12 @@ void VirtualMachine::AddThread( std::shared_ptr<boost::thread> pNewThread, boost
   m_pThreadManager->AddThread( pNewThread, pObject, pNewState );
 }
 
-void VirtualMachine::SetupDependencies( std::shared_ptr<VirtualMachine> pThis )
+void VirtualMachine::SetupDependencies( std::shared_ptr<VirtualMachine> pThis, const VirtualMachineOptions &options )
 {
   GlobalCatalog &mainCatalog = GlobalCatalog::GetInstance();
 
+  m_Options = options;
+
   std::shared_ptr<AgregateLogger> pLogger = std::make_shared<AgregateLogger>();
 
   std::shared_ptr<ConsoleLogger> pConsoleLogger = std::make_shared<ConsoleLogger>();
@@ -858,14 +876,57 @@ void VirtualMachine::SetupDependencies( std::shared_ptr<VirtualMachine> pThis )
 
   m_pLogger = pLogger;
   m_pThreadManager = std::make_shared<ThreadManager>();
-  m_pGarbageCollector = std::make_shared<CheneyGarbageCollector>( m_pThreadManager, c_DefaultGarbageCollectionPoolSize );
+  std::shared_ptr<CheneyGarbageCollector> pGarbageCollector;
+  if ( e_GarbageCollectorType::Generational == options.m_GarbageCollectorType )
+  {
+    pGarbageCollector = std::make_shared<CheneyGarbageCollector>( m_pThreadManager, c_DefaultNurseryPoolSize, c_DefaultOldGenerationSize, c_DefaultPromotionAge );
+  }
+  else
+  {
+    size_t maximumHeapSize = options.m_MaximumHeapSize;
+    if ( 0 == maximumHeapSize )
+    {
+      maximumHeapSize = std::max( c_DefaultGarbageCollectionPoolSize, options.m_InitialHeapSize );
+    }
+
+    size_t initialHeapSize = options.m_InitialHeapSize;
+    if ( 0 == initialHeapSize )
+    {
+      initialHeapSize = std::min( c_DefaultInitialGarbageCollectionPoolSize, maximumHeapSize );
+    }
+
+    pGarbageCollector = std::make_shared<CheneyGarbageCollector>( m_pThreadManager, initialHeapSize, maximumHeapSize );
+  }
+
+  size_t garbageCollectionThreadCount = options.m_GarbageCollectionThreadCount;
+  if ( 0 == garbageCollectionThreadCount )
+  {
+    garbageCollectionThreadCount = std::thread::hardware_concurrency();
+  }
+
+  if ( 0 == garbageCollectionThreadCount )
+  {
+    // hardware_concurrency() returns 0 when it can't tell.
+    garbageCollectionThreadCount = 1;
+  }
+
+  pGarbageCollector->SetCopyThreadCount( garbageCollectionThreadCount );
+  m_pGarbageCollector = pGarbageCollector;
   //m_pGarbageCollector = std::make_shared<RedisGarbageCollector>( "fpwalpink1" );
   m_pRuntimeConstantPool = std::make_shared<BasicClassLibrary>();
-  m_pEngine = std::make_shared<BasicExecutionEngine>();
+  if ( e_ExecutionEngineType::Threaded == options.m_ExecutionEngineType )
+  {
+    m_pEngine = std::make_shared<ThreadedExecutionEngine>();
+  }
+  else
+  {
+    m_pEngine = std::make_shared<BasicExecutionEngine>();
+  }
   m_pJavaLangClassList = std::make_shared<DefaultJavaLangClassList>();
   m_pNativeLibraryContainer = std::make_shared<NativeLibraryContainer>();
   //m_pObjectRegistry = std::make_shared<ObjectRegistryRedis>();
-  m_pObjectRegistry = std::make_shared<ObjectRegistryLocalMachine>();
+  //m_pObjectRegistry = std::make_shared<ObjectRegistryLocalMachine>();
+  m_pObjectRegistry = std::make_shared<ObjectRegistryHandleTable>();
   m_pFileSearchPathCollection = std::make_shared<FileSearchPathCollection>();
   // ************************************************************************************
   // If you want to change a mapping, instantiate the new class above, and change it here
@@ -878,15 +939,16 @@ void VirtualMachine::SetupDependencies( std::shared_ptr<VirtualMachine> pThis )
   mainCatalog.Add( "ThreadManager", m_pThreadManager );
   mainCatalog.Add( "NativeLibraryContainer", m_pNativeLibraryContainer );
   mainCatalog.Add( "ObjectRegistry", m_pObjectRegistry );
+  ObjectReference::SetObjectRegistry( m_pObjectRegistry );
   mainCatalog.Add("SearchPaths", m_pFileSearchPathCollection);
   // ************************************************************************************
 }
 
-std::shared_ptr<VirtualMachine> VirtualMachine::Create()
+std::shared_ptr<VirtualMachine> VirtualMachine::Create( const VirtualMachineOptions &options )
 {
   std::shared_ptr<VirtualMachine> pThis = std::shared_ptr<VirtualMachine>( new VirtualMachine() );
 
-  pThis->SetupDependencies( pThis );
+  pThis->SetupDependencies( pThis, options );
 
   return pThis;
 }
@@ -1090,7 +1152,8 @@ void VirtualMachine::CallThreadConstructor( const std::shared_ptr<IVirtualMachin
 
   if ( pMethodInfo->IsSynchronised() )
   {
-    pInitialState->PushMonitor( pThread->GetContainedObject()->MonitorEnter( pInitialState->GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+    pThread->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+    pInitialState->PushMonitor( pThread );
   }
 
   pInitialState->PushOperand( pThread );
@@ -1111,7 +1174,8 @@ void VirtualMachine::CallVMThreadConstructor( const std::shared_ptr<IVirtualMach
 
   if ( pMethodInfo->IsSynchronised() )
   {
-    pInitialState->PushMonitor( pThread->GetContainedObject()->MonitorEnter( pInitialState->GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+    pThread->GetContainedObject()->MonitorEnter( __FUNCTION__ );
+    pInitialState->PushMonitor( pThread );
   }
 
   pInitialState->PushOperand( pVMThread );
@@ -1137,7 +1201,7 @@ void VirtualMachine::AddToInheritableThreadLocal( const std::shared_ptr<IVirtual
 
   if ( pMethodInfo->IsSynchronised() )
   {
-    pInitialState->PushMonitor( pThredLocalClass->MonitorEnter( pInitialState->GetCurrentClassAndMethodName().ToUtf8String().c_str() ) );
+    pInitialState->PushMonitor( pThredLocalClass->MonitorEnter( __FUNCTION__ ) );
   }
 
   pInitialState->PushOperand( pThread );
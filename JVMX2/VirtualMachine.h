@@ -18,6 +18,7 @@
 #include "ThreadManager.h"
 #include "TypeParser.h"
 #include "NativeLibraryContainer.h"
+#include "VirtualMachineOptions.h"
 
 // Forward Declarations
 class IMemoryManager;
@@ -39,7 +40,7 @@ protected:
   VirtualMachine();
 
 public:
-  static std::shared_ptr<VirtualMachine> Create();
+  static std::shared_ptr<VirtualMachine> Create( const VirtualMachineOptions &options = VirtualMachineOptions() );
 
   void Initialise(const std::string& startingClassfile, const std::shared_ptr<IVirtualMachineState> &pInitialState );
   void Run( const JVMX_CHAR_TYPE *pFileName, const std::shared_ptr<IVirtualMachineState> &pInitialState, bool userCode = true );
@@ -70,7 +71,7 @@ public:
 private:
   void LoadFile( const JVMX_CHAR_TYPE *pFileName );
 
-  void SetupDependencies( std::shared_ptr<VirtualMachine> pThis );
+  void SetupDependencies( std::shared_ptr<VirtualMachine> pThis, const VirtualMachineOptions &options );
 
   void InitialiseClass( const JVMX_CHAR_TYPE *pClassName, const std::shared_ptr<IVirtualMachineState> &pInitialState );
 
@@ -131,6 +132,8 @@ private:
   std::shared_ptr<NativeLibraryContainer> m_pNativeLibraryContainer;
   std::shared_ptr<IObjectRegistry> m_pObjectRegistry;
   std::shared_ptr<FileSearchPathCollection> m_pFileSearchPathCollection;
+
+  VirtualMachineOptions m_Options;
 };
 
 #endif // _VIRTUALMACHINE__H_
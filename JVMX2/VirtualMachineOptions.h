@@ -0,0 +1,39 @@
+#ifndef _VIRTUALMACHINEOPTIONS__H_
+#define _VIRTUALMACHINEOPTIONS__H_
+
+#include "GlobalConstants.h"
+
+enum class e_ExecutionEngineType
+{
+  Basic = 0,   // Switch based interpreter.
+  Threaded     // Pre-decoded, direct threaded interpreter.
+};
+
+enum class e_GarbageCollectorType
+{
+  Copying = 0,  // A single semi-space copying heap.
+  Generational  // A copying nursery, with survivors promoted into a mark-sweep old generation.
+};
+
+class VirtualMachineOptions
+{
+public:
+  VirtualMachineOptions()
+    : m_ExecutionEngineType( e_ExecutionEngineType::Basic )
+    , m_LogEngineStatistics( false )
+    , m_GarbageCollectorType( e_GarbageCollectorType::Copying )
+    , m_GarbageCollectionThreadCount( 1 )
+    , m_InitialHeapSize( 0 )
+    , m_MaximumHeapSize( 0 )
+  {}
+
+public:
+  e_ExecutionEngineType m_ExecutionEngineType;
+  bool m_LogEngineStatistics; // Log the execution engine's statistics (inline cache hit rates etc.) on shut down.
+  e_GarbageCollectorType m_GarbageCollectorType;
+  size_t m_GarbageCollectionThreadCount; // Threads that copy live objects during a collection. 0 means one per core.
+  size_t m_InitialHeapSize; // Bytes committed to the copying heap at start up. 0 means the default.
+  size_t m_MaximumHeapSize; // Bytes the copying heap may grow to. 0 means the default.
+};
+
+#endif // _VIRTUALMACHINEOPTIONS__H_
@@ -0,0 +1,12 @@
+#include "WriteBarrier.h"
+
+const char *WriteBarrier::s_pOldGenerationStart = nullptr;
+const char *WriteBarrier::s_pOldGenerationEnd = nullptr;
+uint8_t *WriteBarrier::s_pCards = nullptr;
+
+void WriteBarrier::SetOldGeneration( const char *pStart, const char *pEnd, uint8_t *pCards ) JVMX_NOEXCEPT
+{
+  s_pOldGenerationStart = pStart;
+  s_pOldGenerationEnd = pEnd;
+  s_pCards = pCards;
+}
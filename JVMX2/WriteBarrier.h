@@ -0,0 +1,39 @@
+#ifndef _WRITEBARRIER__H_
+#define _WRITEBARRIER__H_
+
+#include "GlobalConstants.h"
+#include "GCHeader.h"
+
+// Called whenever a field or array element is stored into an object. If the object lives in the old generation its
+// card is dirtied, so that the next nursery collection knows to look at it for references to young objects.
+// Until a generational collector registers an old generation the range is empty, and the barrier is two compares.
+class WriteBarrier
+{
+public:
+  static const size_t c_CardShift = 9;
+  static const uint8_t c_CleanCard = 0;
+  static const uint8_t c_DirtyCard = 1;
+
+  static void OnStore( const void *pObject ) JVMX_NOEXCEPT
+  {
+    // The card is that of the object's header, which is where the collector starts walking from.
+    const char *pHeader = reinterpret_cast<const char *>( pObject ) - sizeof( GCHeader );
+    if ( pHeader >= s_pOldGenerationStart && pHeader < s_pOldGenerationEnd )
+    {
+      s_pCards[ static_cast<size_t>( pHeader - s_pOldGenerationStart ) >> c_CardShift ] = c_DirtyCard;
+    }
+  }
+
+  // Must be called before any Java threads are started.
+  static void SetOldGeneration( const char *pStart, const char *pEnd, uint8_t *pCards ) JVMX_NOEXCEPT;
+
+private:
+  WriteBarrier() JVMX_FN_DELETE;
+
+private:
+  static const char *s_pOldGenerationStart;
+  static const char *s_pOldGenerationEnd;
+  static uint8_t *s_pCards;
+};
+
+#endif // _WRITEBARRIER__H_
@@ -98,8 +98,7 @@ extern "C"
 
     boost::intrusive_ptr<ObjectReference> pArray = ConvertJArrayToArrayPointer( array );
 
-    IJavaVariableType *pTempReference = pArray->GetContainedArray()->At( index );
-    boost::intrusive_ptr<ObjectReference> ref = new ObjectReference( *dynamic_cast<const ObjectReference *>( pTempReference ) );
+    boost::intrusive_ptr<ObjectReference> ref = boost::dynamic_pointer_cast<ObjectReference>( pArray->GetContainedArray()->At( index ) );
 
     return  ConvertObjectPointerToJObject( pVirtualMachineState, ref );
   }
@@ -114,10 +113,7 @@ extern "C"
 
     if ( nullptr != initialElement )
     {
-      for ( size_t i = 0; i < pArray->GetContainedArray()->GetNumberOfElements(); ++i )
-      {
-        pArray->GetContainedArray()->SetAt( i, ConvertJObjectToObjectPointer( initialElement ).get() );
-      }
+      pArray->GetContainedArray()->FillElements( 0, pArray->GetContainedArray()->GetNumberOfElements(), *ConvertJObjectToObjectPointer( initialElement ) );
     }
 
     return reinterpret_cast<jobjectArray>( ConvertArrayPointerToJArray( pVirtualMachineState, pArray ) );
@@ -1947,24 +1943,22 @@ extern "C"
 
   JNIEXPORT void JNICALL JNIEnvInternal::JVMX_arraycopy( JNIEnv *pEnv, jobject obj, jobject src, int srcOffset, jobject dest, int destOffset, int length )
   {
-    if ( 0 == length )
+    boost::intrusive_ptr<ObjectReference> pSource( ConvertJArrayToArrayPointer( static_cast<jarray>( src ) ) );
+    boost::intrusive_ptr<ObjectReference> pDestination( ConvertJArrayToArrayPointer( static_cast<jarray>( dest ) ) );
+
+    if ( pSource->IsNull() || pDestination->IsNull() )
     {
+      pEnv->ThrowNew( pEnv, FindClass( pEnv, c_JavaNullPointerExceptionException ), "Null array passed to arraycopy." );
       return;
     }
 
-    JNIEnvExported *pInternal = reinterpret_cast<JNIEnvExported *>( pEnv );
-    IVirtualMachineState *pVirtualMachineState = reinterpret_cast<IVirtualMachineState *>( pInternal->m_pInternal );
-
-    boost::intrusive_ptr<ObjectReference> pSource( ConvertJArrayToArrayPointer( static_cast<jarray>( src ) ) );
-    boost::intrusive_ptr<ObjectReference> pDestination( ConvertJArrayToArrayPointer( static_cast<jarray>( dest ) ) );
-
-    if ( nullptr == pSource || pSource->GetVariableType() != e_JavaVariableTypes::Array )
+    if ( pSource->GetVariableType() != e_JavaVariableTypes::Array )
     {
       pEnv->ThrowNew( pEnv, FindClass( pEnv, c_JavaArrayStoreException ), "Expected an array in argument [src]." );
       return;
     }
 
-    if ( nullptr == pDestination || pDestination->GetVariableType() != e_JavaVariableTypes::Array )
+    if ( pDestination->GetVariableType() != e_JavaVariableTypes::Array )
     {
       pEnv->ThrowNew( pEnv, FindClass( pEnv, c_JavaArrayStoreException ), "Expected an array in argument [dest]." );
       return;
@@ -1976,18 +1970,24 @@ extern "C"
       return;
     }
 
-    try
+    // All the bounds are checked before anything is copied, so a failed copy leaves the destination untouched. The sums
+    // are done in 64 bits so that they can't overflow.
+    if ( srcOffset < 0 || destOffset < 0 || length < 0 ||
+         static_cast<int64_t>( srcOffset ) + length > static_cast<int64_t>( pSource->GetContainedArray()->GetNumberOfElements() ) ||
+         static_cast<int64_t>( destOffset ) + length > static_cast<int64_t>( pDestination->GetContainedArray()->GetNumberOfElements() ) )
     {
-      for ( int i = 0; i < length; ++ i )
-      {
-        pDestination->GetContainedArray()->SetAt( destOffset + i, pSource->GetContainedArray()->At( srcOffset + i ) );
-      }
+      pEnv->ThrowNew( pEnv, FindClass( pEnv, c_JavaArrayIndexOutOfBoundsException ), "Range is outside the bounds of the array." );
+      return;
     }
-    catch ( IndexOutOfBoundsException & )
+
+    if ( 0 == length )
     {
-      pEnv->ThrowNew( pEnv, FindClass( pEnv, c_JavaArrayIndexOutOfBoundsException ), "Trying to copy arrays of different types. Containted types should match." );
       return;
     }
+
+    // Arrays don't record their component class, so once the contained types match every element is storable and
+    // reference arrays take the same single memmove as primitive ones. memmove handles src and dest being the same array.
+    JavaArray::CopyElements( *pSource->GetContainedArray(), srcOffset, *pDestination->GetContainedArray(), destOffset, length );
   }
 
   //   jmethodID JNIEnvInternal::ConvertSizeTToJMethodID( size_t methodIndex )
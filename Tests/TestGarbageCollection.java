@@ -0,0 +1,201 @@
+// Run with each collector, e.g.
+//   JVMX2 Tests/TestGarbageCollection.class
+//   JVMX2 --gc generational --gc-threads 4 -Xms4m Tests/TestGarbageCollection.class
+// A small initial heap makes collections happen early and often.
+public class TestGarbageCollection {
+
+    static final int c_GarbageRounds = 200;
+    static final int c_GarbageArraySize = 4096;
+
+    public static String RedOrGreen(boolean success) {
+        if (success) {
+            return ConsoleColors.GREEN;
+        }
+
+        return ConsoleColors.RED;
+    }
+
+    public static void main(String[] args) {
+
+        System.out.println("Starting Garbage Collection Tests");
+
+        finalizationTest();
+        allocationTriggeredCollectionTest();
+        parallelCopyTest();
+        oldGenerationSweepTest();
+    }
+
+    // Allocates and drops enough short lived arrays to force several collections.
+    public static void makeGarbage() {
+        int total = 0;
+        for (int i = 0; i < c_GarbageRounds; ++i) {
+            int[] garbage = new int[c_GarbageArraySize];
+            garbage[i % c_GarbageArraySize] = i;
+            total += garbage.length;
+        }
+
+        if (total != c_GarbageRounds * c_GarbageArraySize) {
+            System.out.println(ConsoleColors.RED + "makeGarbage lost an allocation" + ConsoleColors.RESET);
+        }
+    }
+
+    static class Finalizable {
+        static final int c_Count = 100;
+        static final int[] s_TimesFinalized = new int[c_Count];
+        static volatile int s_FinalizedCount = 0;
+
+        private final int m_Id;
+
+        Finalizable(int id) {
+            m_Id = id;
+        }
+
+        @Override
+        protected void finalize() {
+            synchronized (s_TimesFinalized) {
+                s_TimesFinalized[m_Id]++;
+                s_FinalizedCount++;
+            }
+        }
+    }
+
+    public static void finalizationTest() {
+        for (int i = 0; i < Finalizable.c_Count; ++i) {
+            new Finalizable(i);
+        }
+
+        // Finalizers run on their own thread once the world has resumed, so give it time to catch up.
+        for (int attempt = 0; attempt < 50 && Finalizable.s_FinalizedCount < Finalizable.c_Count; ++attempt) {
+            makeGarbage();
+            try {
+                Thread.sleep(20);
+            } catch (InterruptedException e) {
+                break;
+            }
+        }
+
+        int finalizedCount = Finalizable.s_FinalizedCount;
+        System.out.println("Unreachable objects finalized = " + RedOrGreen(finalizedCount > 0) + finalizedCount
+                + ConsoleColors.RESET + " (expected: at least 1, at most " + Finalizable.c_Count + ")");
+
+        int finalizedTwice = 0;
+        synchronized (Finalizable.s_TimesFinalized) {
+            for (int i = 0; i < Finalizable.c_Count; ++i) {
+                if (Finalizable.s_TimesFinalized[i] > 1) {
+                    ++finalizedTwice;
+                }
+            }
+        }
+        System.out.println("Objects finalized more than once = " + RedOrGreen(finalizedTwice == 0) + finalizedTwice
+                + ConsoleColors.RESET + " (expected: 0)");
+    }
+
+    // Every collection here starts inside an allocation, including the allocations that build the rows of a
+    // multidimensional array, so the partly built array must already be reachable.
+    public static void allocationTriggeredCollectionTest() {
+        final int size = 200;
+        int[][] grid = new int[size][size];
+        for (int row = 0; row < size; ++row) {
+            for (int column = 0; column < size; ++column) {
+                grid[row][column] = row * size + column;
+            }
+        }
+
+        int[] large = new int[1024 * 1024];
+        large[large.length - 1] = 42;
+
+        makeGarbage();
+
+        int wrongCells = 0;
+        for (int row = 0; row < size; ++row) {
+            if (grid[row].length != size) {
+                wrongCells += size;
+                continue;
+            }
+
+            for (int column = 0; column < size; ++column) {
+                if (grid[row][column] != row * size + column) {
+                    ++wrongCells;
+                }
+            }
+        }
+        System.out.println("Corrupted cells after collecting = " + RedOrGreen(wrongCells == 0) + wrongCells
+                + ConsoleColors.RESET + " (expected: 0)");
+
+        System.out.println("Large array survives collecting = " + RedOrGreen(large[large.length - 1] == 42)
+                + large[large.length - 1] + ConsoleColors.RESET + " (expected: 42)");
+    }
+
+    static class Node {
+        final int m_Value;
+        final Node m_Next;
+        final int[] m_Payload;
+
+        Node(int value, Node next) {
+            m_Value = value;
+            m_Next = next;
+            m_Payload = new int[] { value, -value };
+        }
+    }
+
+    // A long chain of small objects interleaved with garbage, so that with --gc-threads above 1 the copy workers
+    // share out, and steal, the chain between them.
+    public static void parallelCopyTest() {
+        final int length = 20000;
+        Node head = null;
+        for (int i = 0; i < length; ++i) {
+            head = new Node(i, head);
+            if (0 == i % 1000) {
+                makeGarbage();
+            }
+        }
+
+        makeGarbage();
+
+        int count = 0;
+        int wrongNodes = 0;
+        int expected = length - 1;
+        for (Node node = head; node != null; node = node.m_Next) {
+            if (node.m_Value != expected || node.m_Payload[0] != expected || node.m_Payload[1] != -expected) {
+                ++wrongNodes;
+            }
+            --expected;
+            ++count;
+        }
+
+        System.out.println("Nodes in chain after copying = " + RedOrGreen(count == length) + count
+                + ConsoleColors.RESET + " (expected: " + length + ")");
+        System.out.println("Corrupted nodes after copying = " + RedOrGreen(wrongNodes == 0) + wrongNodes
+                + ConsoleColors.RESET + " (expected: 0)");
+    }
+
+    // Run with --gc generational. The table survives enough collections to be promoted, and then half of its entries
+    // are replaced on every round, so promoted objects die and the old generation has to be swept to make room. The
+    // replacements are young objects stored into an old array, which the collector must still treat as reachable.
+    public static void oldGenerationSweepTest() {
+        final int entries = 1000;
+        final int rounds = 50;
+        int[][] table = new int[entries][];
+        for (int i = 0; i < entries; ++i) {
+            table[i] = new int[] { i, 0 };
+        }
+
+        for (int round = 1; round <= rounds; ++round) {
+            for (int i = round % 2; i < entries; i += 2) {
+                table[i] = new int[] { i, round };
+            }
+            makeGarbage();
+        }
+
+        int wrongEntries = 0;
+        for (int i = 0; i < entries; ++i) {
+            int expectedRound = (0 == i % 2) ? rounds : rounds - 1;
+            if (table[i].length != 2 || table[i][0] != i || table[i][1] != expectedRound) {
+                ++wrongEntries;
+            }
+        }
+
+        System.out.println("Corrupted entries after sweeping = " + RedOrGreen(wrongEntries == 0) + wrongEntries
+                + ConsoleColors.RESET + " (expected: 0)");
+    }
+}
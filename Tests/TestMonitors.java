@@ -0,0 +1,255 @@
+public class TestMonitors {
+
+    public static String RedOrGreen(boolean success) {
+        if (success) {
+            return ConsoleColors.GREEN;
+        }
+
+        return ConsoleColors.RED;
+    }
+
+    public static void main(String[] args) {
+
+        System.out.println("Starting Monitor Tests");
+
+        recursiveLockTest();
+        contendedLockTest();
+        notifyOrderTest();
+        notifyAllTest();
+        interruptWaitTest();
+    }
+
+    public static int enterRecursively(Object lock, int depth) {
+        synchronized (lock) {
+            if (0 == depth) {
+                return 0;
+            }
+
+            return 1 + enterRecursively(lock, depth - 1);
+        }
+    }
+
+    // An uncontended lock stays thin, however deeply it is entered, and is free again afterwards.
+    public static void recursiveLockTest() {
+        final Object lock = new Object();
+        final int depth = 100;
+
+        int entered = enterRecursively(lock, depth);
+        System.out.println("Recursive entries = " + RedOrGreen(entered == depth) + entered + ConsoleColors.RESET
+                + " (expected: " + depth + ")");
+
+        final boolean[] acquired = { false };
+        Thread other = new Thread(new Runnable() {
+            @Override
+            public void run() {
+                synchronized (lock) {
+                    acquired[0] = true;
+                }
+            }
+        });
+        other.start();
+
+        try {
+            other.join();
+        } catch (InterruptedException e) {
+        }
+
+        System.out.println("Lock free after recursive exit = " + RedOrGreen(acquired[0]) + acquired[0]
+                + ConsoleColors.RESET + " (expected: true)");
+    }
+
+    // Several threads fight over one lock, so it inflates while it is held, possibly recursively. No increment may be
+    // lost when the thin lock is handed over to the full monitor.
+    public static void contendedLockTest() {
+        final Object lock = new Object();
+        final int[] counter = { 0 };
+        final int threadCount = 4;
+        final int increments = 10000;
+
+        Thread[] threads = new Thread[threadCount];
+        for (int i = 0; i < threadCount; ++i) {
+            threads[i] = new Thread(new Runnable() {
+                @Override
+                public void run() {
+                    for (int j = 0; j < increments; ++j) {
+                        synchronized (lock) {
+                            if (0 == j % 2) {
+                                counter[0]++;
+                            } else {
+                                synchronized (lock) {
+                                    counter[0]++;
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        for (int i = 0; i < threadCount; ++i) {
+            threads[i].start();
+        }
+
+        try {
+            for (int i = 0; i < threadCount; ++i) {
+                threads[i].join();
+            }
+        } catch (InterruptedException e) {
+        }
+
+        int expected = threadCount * increments;
+        System.out.println("Contended increments = " + RedOrGreen(counter[0] == expected) + counter[0]
+                + ConsoleColors.RESET + " (expected: " + expected + ")");
+    }
+
+    static class WaitSet {
+        final Object m_Lock = new Object();
+        int m_WaitingCount = 0;
+        int m_WokenCount = 0;
+        final int[] m_WokenOrder;
+
+        WaitSet(int size) {
+            m_WokenOrder = new int[size];
+        }
+
+        // Starts a thread that waits on the lock once, then records the order in which it woke up. Returns once the
+        // thread is in the wait set, as it only lets go of the lock by waiting.
+        Thread startWaiter(final int id) {
+            Thread waiter = new Thread(new Runnable() {
+                @Override
+                public void run() {
+                    synchronized (m_Lock) {
+                        m_WaitingCount++;
+                        try {
+                            m_Lock.wait();
+                        } catch (InterruptedException e) {
+                            return;
+                        }
+                        m_WokenOrder[m_WokenCount++] = id;
+                    }
+                }
+            });
+            waiter.start();
+
+            awaitCount(id + 1, true);
+            return waiter;
+        }
+
+        void awaitCount(int count, boolean waiting) {
+            for (;;) {
+                synchronized (m_Lock) {
+                    if ((waiting ? m_WaitingCount : m_WokenCount) >= count) {
+                        return;
+                    }
+                }
+
+                try {
+                    Thread.sleep(1);
+                } catch (InterruptedException e) {
+                    return;
+                }
+            }
+        }
+    }
+
+    public static void joinAll(Thread[] threads) {
+        try {
+            for (int i = 0; i < threads.length; ++i) {
+                threads[i].join();
+            }
+        } catch (InterruptedException e) {
+        }
+    }
+
+    // Each notify wakes the thread that has been waiting longest.
+    public static void notifyOrderTest() {
+        final int waiterCount = 5;
+        WaitSet waitSet = new WaitSet(waiterCount);
+
+        Thread[] waiters = new Thread[waiterCount];
+        for (int i = 0; i < waiterCount; ++i) {
+            waiters[i] = waitSet.startWaiter(i);
+        }
+
+        for (int i = 0; i < waiterCount; ++i) {
+            synchronized (waitSet.m_Lock) {
+                waitSet.m_Lock.notify();
+            }
+            waitSet.awaitCount(i + 1, false);
+        }
+
+        joinAll(waiters);
+
+        boolean inOrder = true;
+        String order = "";
+        for (int i = 0; i < waiterCount; ++i) {
+            inOrder = inOrder && waitSet.m_WokenOrder[i] == i;
+            order += waitSet.m_WokenOrder[i];
+        }
+        System.out.println("Notify wake order = " + RedOrGreen(inOrder) + order + ConsoleColors.RESET
+                + " (expected: 01234)");
+    }
+
+    public static void notifyAllTest() {
+        final int waiterCount = 5;
+        WaitSet waitSet = new WaitSet(waiterCount);
+
+        Thread[] waiters = new Thread[waiterCount];
+        for (int i = 0; i < waiterCount; ++i) {
+            waiters[i] = waitSet.startWaiter(i);
+        }
+
+        synchronized (waitSet.m_Lock) {
+            waitSet.m_Lock.notifyAll();
+        }
+
+        joinAll(waiters);
+
+        System.out.println("Threads woken by notifyAll = " + RedOrGreen(waitSet.m_WokenCount == waiterCount)
+                + waitSet.m_WokenCount + ConsoleColors.RESET + " (expected: " + waiterCount + ")");
+    }
+
+    // Interrupting a waiting thread wakes it with an InterruptedException, without any notify.
+    public static void interruptWaitTest() {
+        final Object lock = new Object();
+        final boolean[] interrupted = { false };
+        final boolean[] waiting = { false };
+
+        Thread waiter = new Thread(new Runnable() {
+            @Override
+            public void run() {
+                synchronized (lock) {
+                    waiting[0] = true;
+                    try {
+                        lock.wait();
+                    } catch (InterruptedException e) {
+                        interrupted[0] = true;
+                    }
+                }
+            }
+        });
+        waiter.start();
+
+        for (;;) {
+            synchronized (lock) {
+                if (waiting[0]) {
+                    break;
+                }
+            }
+            try {
+                Thread.sleep(1);
+            } catch (InterruptedException e) {
+            }
+        }
+
+        waiter.interrupt();
+
+        try {
+            waiter.join();
+        } catch (InterruptedException e) {
+        }
+
+        System.out.println("Interrupted waiter threw = " + RedOrGreen(interrupted[0]) + interrupted[0]
+                + ConsoleColors.RESET + " (expected: true)");
+    }
+}